@@ -0,0 +1,520 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+
+#include "graph/node_binary.h"
+
+#include "render/background.h"
+#include "render/camera.h"
+#include "render/film.h"
+#include "render/graph.h"
+#include "render/hair.h"
+#include "render/integrator.h"
+#include "render/light.h"
+#include "render/mesh.h"
+#include "render/nodes.h"
+#include "render/object.h"
+#include "render/particles.h"
+#include "render/scene.h"
+#include "render/shader.h"
+#include "render/volume.h"
+
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+#include "util/util_path.h"
+#include "util/util_time.h"
+
+#include "app/cycles_binary.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* File layout:
+ *
+ * - Header: magic, version and sizes of the vector types, which depend on the architecture.
+ * - Shaders with their graphs.
+ * - Geometry with attributes.
+ * - Particle systems, objects and lights.
+ * - Film, integrator, camera and background settings.
+ *
+ * Nodes are written in an order where references only point to nodes which are already read, and
+ * both sides register them in the same order. */
+
+static const char binary_magic[8] = {'C', 'Y', 'C', 'L', 'E', 'S', 'B', 'N'};
+static const uint32_t binary_version = 1;
+
+struct BinaryHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t sizeof_float3;
+  uint32_t sizeof_transform;
+  uint32_t alignment;
+};
+
+static BinaryHeader binary_header()
+{
+  BinaryHeader header;
+  memcpy(header.magic, binary_magic, sizeof(binary_magic));
+  header.version = binary_version;
+  header.sizeof_float3 = sizeof(float3);
+  header.sizeof_transform = sizeof(Transform);
+  header.alignment = BINARY_ARRAY_ALIGNMENT;
+  return header;
+}
+
+/* Default shaders are created by the scene, their graphs and settings are replaced instead of
+ * adding new shaders. */
+static Shader **binary_default_shader(Scene *scene, int slot)
+{
+  Shader **defaults[] = {&scene->default_surface,
+                         &scene->default_volume,
+                         &scene->default_light,
+                         &scene->default_background,
+                         &scene->default_empty};
+  return (slot >= 0 && slot < 5) ? defaults[slot] : NULL;
+}
+
+static int binary_default_shader_slot(Scene *scene, const Shader *shader)
+{
+  for (int slot = 0; slot < 5; slot++) {
+    if (*binary_default_shader(scene, slot) == shader) {
+      return slot;
+    }
+  }
+  return -1;
+}
+
+/* Writing */
+
+/* Check for data which can not be written, a partially exported scene would render
+ * differently without any notice. */
+static bool binary_scene_is_supported(Scene *scene)
+{
+  bool supported = true;
+
+  foreach (Shader *shader, scene->shaders) {
+    /* OSL script nodes have types which are created at runtime, they can not be created from
+     * the type name when reading. */
+    foreach (ShaderNode *node, shader->graph->nodes) {
+      if (NodeType::find(node->type->name) != node->type) {
+        fprintf(stderr,
+                "Shader node \"%s\" of type \"%s\" in shader \"%s\" can not be exported.\n",
+                node->name.c_str(),
+                node->type->name.c_str(),
+                shader->name.c_str());
+        supported = false;
+      }
+    }
+  }
+
+  foreach (Geometry *geom, scene->geometry) {
+    /* Voxel attributes are image handles, the voxel data is not part of the scene. */
+    foreach (const Attribute &attr, geom->attributes.attributes) {
+      if (attr.element == ATTR_ELEMENT_VOXEL) {
+        fprintf(stderr,
+                "Volume attribute \"%s\" of \"%s\" can not be exported.\n",
+                attr.name.c_str(),
+                geom->name.c_str());
+        supported = false;
+      }
+    }
+  }
+
+  return supported;
+}
+
+static void binary_write_shader_graph(BinaryWriter &writer, ShaderGraph *graph)
+{
+  map<ShaderNode *, uint32_t> node_index;
+  vector<ShaderNode *> nodes;
+
+  foreach (ShaderNode *node, graph->nodes) {
+    node_index[node] = nodes.size();
+    nodes.push_back(node);
+  }
+
+  writer.write<uint32_t>(nodes.size());
+  foreach (ShaderNode *node, nodes) {
+    writer.write_string(node->type->name.string());
+    writer.write_node(node);
+  }
+
+  uint32_t num_links = 0;
+  foreach (ShaderNode *node, nodes) {
+    foreach (ShaderInput *input, node->inputs) {
+      if (input->link) {
+        num_links++;
+      }
+    }
+  }
+
+  writer.write<uint32_t>(num_links);
+  foreach (ShaderNode *node, nodes) {
+    foreach (ShaderInput *input, node->inputs) {
+      if (input->link) {
+        writer.write<uint32_t>(node_index[input->link->parent]);
+        writer.write_string(input->link->socket_type.name.string());
+        writer.write<uint32_t>(node_index[node]);
+        writer.write_string(input->socket_type.name.string());
+      }
+    }
+  }
+}
+
+static void binary_write_attributes(BinaryWriter &writer, const AttributeSet &attributes)
+{
+  writer.write<uint32_t>(attributes.attributes.size());
+  foreach (const Attribute &attr, attributes.attributes) {
+    writer.write_string(attr.name.string());
+    writer.write<int32_t>(attr.std);
+    writer.write(attr.type);
+    writer.write<int32_t>(attr.element);
+    writer.write<uint32_t>(attr.flags);
+    writer.write_array(attr.data(), attr.buffer.size(), 1);
+  }
+}
+
+bool binary_write_file(Scene *scene, const char *filepath)
+{
+  const double start_time = time_dt();
+
+  if (!binary_scene_is_supported(scene)) {
+    fprintf(stderr, "Scene can not be written to \"%s\".\n", filepath);
+    return false;
+  }
+
+  BinaryWriter writer;
+  if (!writer.open(filepath)) {
+    fprintf(stderr, "Failed to open \"%s\" for writing.\n", filepath);
+    return false;
+  }
+
+  writer.write(binary_header());
+
+  /* Shaders. */
+  writer.write<uint32_t>(scene->shaders.size());
+  foreach (Shader *shader, scene->shaders) {
+    writer.add_node(shader);
+    writer.write<int32_t>(binary_default_shader_slot(scene, shader));
+    writer.write_node(shader);
+    binary_write_shader_graph(writer, shader->graph);
+  }
+
+  /* Geometry. */
+  writer.write<uint32_t>(scene->geometry.size());
+  foreach (Geometry *geom, scene->geometry) {
+    writer.add_node(geom);
+    writer.write_string(geom->type->name.string());
+    writer.write_node(geom);
+    binary_write_attributes(writer, geom->attributes);
+
+    if (geom->is_mesh()) {
+      binary_write_attributes(writer, static_cast<Mesh *>(geom)->subd_attributes);
+    }
+  }
+
+  /* Particle systems. */
+  writer.write<uint32_t>(scene->particle_systems.size());
+  foreach (ParticleSystem *psys, scene->particle_systems) {
+    writer.add_node(psys);
+    writer.write_node(psys);
+    writer.write_array(psys->particles.data(), psys->particles.size(), sizeof(Particle));
+  }
+
+  /* Objects. */
+  writer.write<uint32_t>(scene->objects.size());
+  foreach (Object *object, scene->objects) {
+    writer.add_node(object);
+    writer.write_node(object);
+  }
+
+  /* Lights. */
+  writer.write<uint32_t>(scene->lights.size());
+  foreach (Light *light, scene->lights) {
+    writer.add_node(light);
+    writer.write_node(light);
+  }
+
+  /* Settings. */
+  writer.write_node(scene->film);
+  writer.write_node(scene->integrator);
+  writer.write_node(scene->camera);
+  writer.write_node(scene->background);
+
+  if (!writer.close()) {
+    fprintf(stderr, "Failed to write \"%s\".\n", filepath);
+    return false;
+  }
+
+  VLOG(1) << "Binary scene written to " << filepath << " in " << time_dt() - start_time
+          << " seconds.";
+
+  return true;
+}
+
+/* Reading */
+
+static bool binary_read_header(BinaryReader &reader)
+{
+  const BinaryHeader header = reader.read<BinaryHeader>();
+  const BinaryHeader expected = binary_header();
+
+  if (reader.has_error() || memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0) {
+    fprintf(stderr, "Not a Cycles binary scene file.\n");
+    return false;
+  }
+  if (header.version != expected.version) {
+    fprintf(stderr, "Unsupported binary scene file version %u.\n", header.version);
+    return false;
+  }
+  if (header.sizeof_float3 != expected.sizeof_float3 ||
+      header.sizeof_transform != expected.sizeof_transform ||
+      header.alignment != expected.alignment) {
+    fprintf(stderr, "Binary scene file was written for a different architecture.\n");
+    return false;
+  }
+
+  return true;
+}
+
+static bool binary_read_shader_graph(BinaryReader &reader, Shader *shader)
+{
+  ShaderGraph *graph = new ShaderGraph();
+  vector<ShaderNode *> nodes;
+
+  const uint32_t num_nodes = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_nodes && !reader.has_error(); i++) {
+    const ustring type_name(reader.read_string());
+    const NodeType *node_type = NodeType::find(type_name);
+    ShaderNode *snode = NULL;
+
+    if (node_type == NULL || node_type->type != NodeType::SHADER || node_type->create == NULL) {
+      /* Socket values of unknown nodes can not be skipped without knowing their types. */
+      fprintf(stderr, "Unknown shader node type \"%s\".\n", type_name.c_str());
+      delete graph;
+      return false;
+    }
+
+    if (node_type == OutputNode::get_node_type()) {
+      snode = graph->output();
+    }
+    else {
+      snode = (ShaderNode *)node_type->create(node_type);
+      snode->set_owner(graph);
+      graph->add(snode);
+    }
+
+    reader.read_node(snode);
+    nodes.push_back(snode);
+  }
+
+  const uint32_t num_links = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_links && !reader.has_error(); i++) {
+    const uint32_t from_index = reader.read<uint32_t>();
+    const ustring from_name(reader.read_string());
+    const uint32_t to_index = reader.read<uint32_t>();
+    const ustring to_name(reader.read_string());
+
+    ShaderNode *from_node = (from_index < nodes.size()) ? nodes[from_index] : NULL;
+    ShaderNode *to_node = (to_index < nodes.size()) ? nodes[to_index] : NULL;
+    if (from_node == NULL || to_node == NULL) {
+      continue;
+    }
+
+    ShaderOutput *output = NULL;
+    foreach (ShaderOutput *out, from_node->outputs) {
+      if (out->socket_type.name == from_name) {
+        output = out;
+      }
+    }
+
+    ShaderInput *input = NULL;
+    foreach (ShaderInput *in, to_node->inputs) {
+      if (in->socket_type.name == to_name) {
+        input = in;
+      }
+    }
+
+    if (output && input) {
+      graph->connect(output, input);
+    }
+    else {
+      fprintf(stderr,
+              "Can't connect \"%s\" to \"%s\", socket not found.\n",
+              from_name.c_str(),
+              to_name.c_str());
+    }
+  }
+
+  shader->set_graph(graph);
+  return true;
+}
+
+static void binary_read_attributes(BinaryReader &reader, AttributeSet &attributes)
+{
+  const uint32_t num_attributes = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_attributes && !reader.has_error(); i++) {
+    const ustring name(reader.read_string());
+    const AttributeStandard std = (AttributeStandard)reader.read<int32_t>();
+    const TypeDesc type = reader.read<TypeDesc>();
+    const AttributeElement element = (AttributeElement)reader.read<int32_t>();
+    const uint flags = reader.read<uint32_t>();
+
+    size_t size;
+    const void *data = reader.read_array(&size, 1);
+    if (data == NULL) {
+      break;
+    }
+
+    Attribute *attr = attributes.add(name, type, element);
+    attr->std = std;
+    attr->flags = flags;
+    attr->buffer.resize(size);
+    if (size) {
+      memcpy(attr->data(), data, size);
+    }
+  }
+}
+
+static Geometry *binary_create_geometry(Scene *scene, ustring type_name)
+{
+  if (type_name == Mesh::get_node_type()->name) {
+    return scene->create_node<Mesh>();
+  }
+  if (type_name == Hair::get_node_type()->name) {
+    return scene->create_node<Hair>();
+  }
+  if (type_name == Volume::get_node_type()->name) {
+    return scene->create_node<Volume>();
+  }
+  return NULL;
+}
+
+bool binary_is_scene_file(const char *filepath)
+{
+  FILE *f = path_fopen(filepath, "rb");
+  if (f == NULL) {
+    return false;
+  }
+
+  char magic[sizeof(binary_magic)];
+  const bool is_binary = fread(magic, 1, sizeof(magic), f) == sizeof(magic) &&
+                         memcmp(magic, binary_magic, sizeof(magic)) == 0;
+  fclose(f);
+
+  return is_binary;
+}
+
+bool binary_read_file(Scene *scene, const char *filepath)
+{
+  const double start_time = time_dt();
+  BinaryReader reader;
+
+  if (!reader.open(filepath)) {
+    fprintf(stderr, "Failed to read \"%s\".\n", filepath);
+    return false;
+  }
+
+  if (!binary_read_header(reader)) {
+    return false;
+  }
+
+  /* Shaders. */
+  const uint32_t num_shaders = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_shaders && !reader.has_error(); i++) {
+    Shader **default_shader = binary_default_shader(scene, reader.read<int32_t>());
+    Shader *shader = (default_shader) ? *default_shader : scene->create_node<Shader>();
+
+    reader.add_node(shader);
+    reader.read_node(shader);
+    if (!binary_read_shader_graph(reader, shader)) {
+      return false;
+    }
+    shader->tag_update(scene);
+  }
+
+  /* Geometry. */
+  const uint32_t num_geometry = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_geometry && !reader.has_error(); i++) {
+    const ustring type_name(reader.read_string());
+    Geometry *geom = binary_create_geometry(scene, type_name);
+
+    if (geom == NULL) {
+      fprintf(stderr, "Unknown geometry type \"%s\".\n", type_name.c_str());
+      return false;
+    }
+
+    reader.add_node(geom);
+    reader.read_node(geom);
+    binary_read_attributes(reader, geom->attributes);
+
+    if (geom->is_mesh()) {
+      binary_read_attributes(reader, static_cast<Mesh *>(geom)->subd_attributes);
+    }
+  }
+
+  /* Particle systems. */
+  const uint32_t num_particle_systems = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_particle_systems && !reader.has_error(); i++) {
+    ParticleSystem *psys = scene->create_node<ParticleSystem>();
+
+    reader.add_node(psys);
+    reader.read_node(psys);
+
+    size_t num_particles;
+    const void *particles = reader.read_array(&num_particles, sizeof(Particle));
+    if (particles) {
+      psys->particles.resize(num_particles);
+      memcpy(psys->particles.data(), particles, num_particles * sizeof(Particle));
+    }
+  }
+
+  /* Objects. */
+  const uint32_t num_objects = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_objects && !reader.has_error(); i++) {
+    Object *object = scene->create_node<Object>();
+    reader.add_node(object);
+    reader.read_node(object);
+  }
+
+  /* Lights. */
+  const uint32_t num_lights = reader.read<uint32_t>();
+  for (uint32_t i = 0; i < num_lights && !reader.has_error(); i++) {
+    Light *light = scene->create_node<Light>();
+    reader.add_node(light);
+    reader.read_node(light);
+  }
+
+  /* Settings. */
+  reader.read_node(scene->film);
+  reader.read_node(scene->integrator);
+  reader.read_node(scene->camera);
+  reader.read_node(scene->background);
+
+  if (reader.has_error()) {
+    fprintf(stderr, "Binary scene file \"%s\" is truncated or corrupted.\n", filepath);
+    return false;
+  }
+
+  scene->params.bvh_type = BVH_TYPE_STATIC;
+
+  VLOG(1) << "Binary scene read from " << filepath << " in " << time_dt() - start_time
+          << " seconds.";
+
+  return true;
+}
+
+CCL_NAMESPACE_END
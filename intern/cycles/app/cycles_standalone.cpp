@@ -20,6 +20,7 @@
 #include "render/buffers.h"
 #include "render/camera.h"
 #include "render/integrator.h"
+#include "render/merge.h"
 #include "render/scene.h"
 #include "render/session.h"
 
@@ -36,6 +37,7 @@
 #include "util/util_unique_ptr.h"
 #include "util/util_version.h"
 
+#include "app/cycles_binary.h"
 #include "app/cycles_xml.h"
 #include "app/oiio_output_driver.h"
 
@@ -58,6 +60,10 @@ struct Options {
   bool show_help, interactive, pause;
   string output_filepath;
   string output_pass;
+  string export_filepath;
+  int start_sample;
+  bool merge;
+  vector<string> merge_filepaths;
 } options;
 
 static void session_print(const string &str)
@@ -108,8 +114,15 @@ static void scene_init()
 {
   options.scene = options.session->scene;
 
-  /* Read XML */
-  xml_read_file(options.scene, options.filepath.c_str());
+  /* Read binary or XML scene. */
+  if (binary_is_scene_file(options.filepath.c_str())) {
+    if (!binary_read_file(options.scene, options.filepath.c_str())) {
+      exit(EXIT_FAILURE);
+    }
+  }
+  else {
+    xml_read_file(options.scene, options.filepath.c_str());
+  }
 
   /* Camera width/height override? */
   if (!(options.width == 0 || options.height == 0)) {
@@ -131,8 +144,12 @@ static void session_init()
   options.session = new Session(options.session_params, options.scene_params);
 
   if (!options.output_filepath.empty()) {
-    options.session->set_output_driver(make_unique<OIIOOutputDriver>(
-        options.output_filepath, options.output_pass, session_print));
+    unique_ptr<OIIOOutputDriver> output_driver = make_unique<OIIOOutputDriver>(
+        options.output_filepath, options.output_pass, session_print);
+    if (options.start_sample != -1) {
+      output_driver->set_sample_range(options.start_sample, options.session_params.samples);
+    }
+    options.session->set_output_driver(std::move(output_driver));
   }
 
   if (options.session_params.background && !options.quiet)
@@ -150,10 +167,49 @@ static void session_init()
   pass->set_name(ustring(options.output_pass.c_str()));
   pass->set_type(PASS_COMBINED);
 
+  /* Per-pixel sample counts for merging sample ranges. */
+  if (options.start_sample != -1) {
+    Pass *sample_count_pass = options.scene->create_node<Pass>();
+    sample_count_pass->set_name(ustring("Debug Sample Count"));
+    sample_count_pass->set_type(PASS_SAMPLE_COUNT);
+  }
+
   options.session->reset(options.session_params, session_buffer_params());
   options.session->start();
 }
 
+/* Convert the scene to a binary scene file, without rendering. */
+static bool scene_export()
+{
+  options.session = new Session(options.session_params, options.scene_params);
+  scene_init();
+
+  const bool success = binary_write_file(options.scene, options.export_filepath.c_str());
+  if (success && !options.quiet) {
+    printf("Exported scene to %s\n", options.export_filepath.c_str());
+  }
+
+  delete options.session;
+  options.session = NULL;
+
+  return success;
+}
+
+/* Merge renders of sample ranges into the output file. */
+static bool images_merge()
+{
+  ImageMerger merger;
+  merger.input = options.merge_filepaths;
+  merger.output = options.output_filepath;
+
+  if (!merger.run()) {
+    fprintf(stderr, "%s\n", merger.error.c_str());
+    return false;
+  }
+
+  return true;
+}
+
 static void session_exit()
 {
   if (options.session) {
@@ -344,6 +400,10 @@ static int files_parse(int argc, const char *argv[])
   if (argc > 0)
     options.filepath = argv[0];
 
+  for (int i = 0; i < argc; i++) {
+    options.merge_filepaths.push_back(argv[i]);
+  }
+
   return 0;
 }
 
@@ -352,6 +412,8 @@ static void options_parse(int argc, const char **argv)
   options.width = 1024;
   options.height = 512;
   options.filepath = "";
+  options.start_sample = -1;
+  options.merge = false;
   options.session = NULL;
   options.quiet = false;
   options.session_params.use_auto_tile = false;
@@ -379,7 +441,7 @@ static void options_parse(int argc, const char **argv)
   bool help = false, debug = false, version = false;
   int verbosity = 1;
 
-  ap.options("Usage: cycles [options] file.xml",
+  ap.options("Usage: cycles [options] file.xml|file.bin",
              "%*",
              files_parse,
              "",
@@ -403,6 +465,15 @@ static void options_parse(int argc, const char **argv)
              "--output %s",
              &options.output_filepath,
              "File path to write output image",
+             "--start-sample %d",
+             &options.start_sample,
+             "Render samples starting from this one, and write them as a partial image to merge",
+             "--merge",
+             &options.merge,
+             "Merge partial images given as input files into the output file",
+             "--export-binary %s",
+             &options.export_filepath,
+             "Write the scene to a binary scene file instead of rendering it",
              "--threads %d",
              &options.session_params.threads,
              "CPU Rendering Threads",
@@ -415,6 +486,9 @@ static void options_parse(int argc, const char **argv)
              "--tile-size %d",
              &options.session_params.tile_size,
              "Tile size in pixels",
+             "--quantized-attributes",
+             &options.scene_params.use_quantized_attributes,
+             "Store normals, UVs and colors of meshes with reduced precision to save memory",
              "--list-devices",
              &list,
              "List information about all available devices",
@@ -514,6 +588,19 @@ static void options_parse(int argc, const char **argv)
     fprintf(stderr, "No file path specified\n");
     exit(EXIT_FAILURE);
   }
+  else if (options.start_sample != -1 &&
+           !string_endswith(string_to_lower(options.output_filepath), ".exr")) {
+    fprintf(stderr, "Rendering a sample range requires an OpenEXR output file\n");
+    exit(EXIT_FAILURE);
+  }
+  else if (options.merge && options.output_filepath.empty()) {
+    fprintf(stderr, "No output file path specified for merging\n");
+    exit(EXIT_FAILURE);
+  }
+
+  if (options.start_sample != -1) {
+    options.session_params.start_sample = options.start_sample;
+  }
 }
 
 CCL_NAMESPACE_END
@@ -526,6 +613,13 @@ int main(int argc, const char **argv)
   path_init();
   options_parse(argc, argv);
 
+  if (options.merge) {
+    return images_merge() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+  if (!options.export_filepath.empty()) {
+    return scene_export() ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
 #ifdef WITH_CYCLES_STANDALONE_GUI
   if (options.session_params.background) {
 #endif
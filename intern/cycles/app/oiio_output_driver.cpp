@@ -29,6 +29,12 @@ OIIOOutputDriver::~OIIOOutputDriver()
 {
 }
 
+void OIIOOutputDriver::set_sample_range(int start_sample, int num_samples)
+{
+  start_sample_ = start_sample;
+  num_samples_ = num_samples;
+}
+
 void OIIOOutputDriver::write_render_tile(const Tile &tile)
 {
   /* Only write the full buffer, no intermediate tiles. */
@@ -38,6 +44,13 @@ void OIIOOutputDriver::write_render_tile(const Tile &tile)
 
   log_(string_printf("Writing image %s", filepath_.c_str()));
 
+  if (start_sample_ != -1) {
+    if (!write_partial_render_tile(tile)) {
+      log_("Failed to write partial render image");
+    }
+    return;
+  }
+
   unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath_));
   if (image_output == nullptr) {
     log_("Failed to create image file");
@@ -68,4 +81,62 @@ void OIIOOutputDriver::write_render_tile(const Tile &tile)
   image_output->close();
 }
 
+bool OIIOOutputDriver::write_partial_render_tile(const Tile &tile)
+{
+  /* Same naming of the channels and metadata as multilayer images written by Blender, which is
+   * what the image merger expects. */
+  const string layer = (tile.layer.empty()) ? "RenderLayer" : tile.layer;
+  const int width = tile.size.x;
+  const int height = tile.size.y;
+  const int num_channels = 5;
+
+  vector<float> combined(width * height * 4);
+  vector<float> sample_count(width * height);
+  if (!tile.get_pass_pixels(pass_, 4, combined.data()) ||
+      !tile.get_pass_pixels("Debug Sample Count", 1, sample_count.data())) {
+    return false;
+  }
+
+  /* Interleave channels, and convert from bottom-up to top-down convention. */
+  vector<float> pixels(width * height * num_channels);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const int in_index = (height - 1 - y) * width + x;
+      float *pixel = &pixels[(y * width + x) * num_channels];
+      pixel[0] = combined[in_index * 4 + 0];
+      pixel[1] = combined[in_index * 4 + 1];
+      pixel[2] = combined[in_index * 4 + 2];
+      pixel[3] = combined[in_index * 4 + 3];
+      pixel[4] = sample_count[in_index];
+    }
+  }
+
+  ImageSpec spec(width, height, num_channels, TypeDesc::FLOAT);
+  spec.channelnames.clear();
+  spec.channelnames.push_back(layer + ".Combined.R");
+  spec.channelnames.push_back(layer + ".Combined.G");
+  spec.channelnames.push_back(layer + ".Combined.B");
+  spec.channelnames.push_back(layer + ".Combined.A");
+  spec.channelnames.push_back(layer + ".Debug Sample Count.X");
+  spec.alpha_channel = 3;
+
+  const string prefix = "cycles." + layer + ".";
+  spec.attribute(prefix + "samples", TypeDesc::STRING, string_printf("%d", num_samples_));
+  spec.attribute(
+      prefix + "range_start_sample", TypeDesc::STRING, string_printf("%d", start_sample_));
+  spec.attribute(
+      prefix + "range_num_samples", TypeDesc::STRING, string_printf("%d", num_samples_));
+
+  unique_ptr<ImageOutput> image_output(ImageOutput::create(filepath_));
+  if (image_output == nullptr) {
+    return false;
+  }
+  if (!image_output->open(filepath_, spec)) {
+    return false;
+  }
+
+  const bool ok = image_output->write_image(TypeDesc::FLOAT, pixels.data());
+  return image_output->close() && ok;
+}
+
 CCL_NAMESPACE_END
@@ -31,12 +31,20 @@ class OIIOOutputDriver : public OutputDriver {
   OIIOOutputDriver(const string_view filepath, const string_view pass, LogFunction log);
   virtual ~OIIOOutputDriver();
 
+  /* Write a multilayer image with per-pixel sample counts and the sample range in the metadata,
+   * to be merged with the renders of the other sample ranges of the frame. */
+  void set_sample_range(int start_sample, int num_samples);
+
   void write_render_tile(const Tile &tile) override;
 
  protected:
+  bool write_partial_render_tile(const Tile &tile);
+
   string filepath_;
   string pass_;
   LogFunction log_;
+  int start_sample_ = -1;
+  int num_samples_ = 0;
 };
 
 CCL_NAMESPACE_END
@@ -31,6 +31,15 @@ def _configure_argument_parser():
                              "Valid options are 'CPU', 'CUDA', 'OPTIX', or 'HIP'"
                              "Additionally, you can append '+CPU' to any GPU type for hybrid rendering.",
                         default=None)
+    parser.add_argument("--cycles-start-sample",
+                        help="Render samples starting from this one, to merge with the renders of "
+                             "the other sample ranges of the frame afterwards",
+                        type=int,
+                        default=0)
+    parser.add_argument("--cycles-num-samples",
+                        help="Number of samples to render starting from --cycles-start-sample",
+                        type=int,
+                        default=0)
     return parser
 
 
@@ -52,6 +61,10 @@ def _parse_command_line():
         import _cycles
         _cycles.set_device_override(args.cycles_device)
 
+    if args.cycles_num_samples:
+        import _cycles
+        _cycles.set_sample_range(args.cycles_start_sample, args.cycles_num_samples)
+
 
 def init():
     import bpy
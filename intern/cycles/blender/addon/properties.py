@@ -351,6 +351,12 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=0.0, max=1.0,
         default=0.01,
     )
+    use_light_tree: BoolProperty(
+        name="Light Tree",
+        description="Pick lights to sample using a tree of their positions, orientations and power, "
+        "which reduces noise in scenes with many lights. When disabled, lights are picked proportionally to their area",
+        default=False,
+    )
 
     use_adaptive_sampling: BoolProperty(
         name="Use Adaptive Sampling",
@@ -750,6 +756,26 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         min=8, max=16384,
     )
 
+    use_texture_cache: BoolProperty(
+        name="Texture Cache",
+        description="Read image textures on demand in tiles and mipmap levels chosen from ray differentials, "
+        "instead of loading them fully into memory. Uses .tx files next to images when available. "
+        "Only supported on the CPU and with SVM",
+        default=False,
+    )
+    texture_cache_size: IntProperty(
+        name="Cache Size",
+        description="Memory budget of the texture cache in megabytes",
+        default=1024,
+        min=16, max=65536,
+    )
+    use_quantized_attributes: BoolProperty(
+        name="Quantized Attributes",
+        description="Store normals, UVs and colors of meshes with reduced precision, to save memory "
+        "on large meshes. Can cause visible artifacts with high resolution textures or smooth reflections",
+        default=False,
+    )
+
     # Various fine-tuning debug flags
 
     def _devices_update_callback(self, context):
@@ -767,6 +793,11 @@ class CyclesRenderSettings(bpy.types.PropertyGroup):
         items=enum_bvh_layouts,
         default='EMBREE',
     )
+    debug_use_cpu_wavefront: BoolProperty(
+        name="Wavefront",
+        description="Advance paths of a tile together one kernel at a time, sorting shading by shader, instead of tracing one path at a time",
+        default=False
+    )
 
     debug_use_cuda_adaptive_compile: BoolProperty(name="Adaptive Compile", default=False)
 
@@ -117,6 +117,10 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     sync = geometry_map.update(geom, b_key_id);
   }
 
+  /* Geometry which is not tagged for update is only synced again for its shaders or
+   * attributes. */
+  const bool geometry_modified = sync;
+
   if (!sync) {
     /* If transform was applied to geometry, need full update. */
     if (object_updated && geom->transform_applied) {
@@ -168,7 +172,7 @@ Geometry *BlenderSync::sync_geometry(BL::Depsgraph &b_depsgraph,
     }
     else {
       Mesh *mesh = static_cast<Mesh *>(geom);
-      sync_mesh(b_depsgraph, b_ob_info, mesh);
+      sync_mesh(b_depsgraph, b_ob_info, mesh, geometry_modified);
     }
   };
 
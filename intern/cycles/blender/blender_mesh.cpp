@@ -33,11 +33,38 @@
 #include "util/util_hash.h"
 #include "util/util_logging.h"
 #include "util/util_math.h"
+#include "util/util_tbb.h"
 
 #include "mikktspace.h"
 
+#include "DNA_customdata_types.h"
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+
 CCL_NAMESPACE_BEGIN
 
+/* Mesh Data Access
+ *
+ * Per-element RNA access is slow for large meshes and can not be used from multiple threads, so
+ * the mesh is converted from the DNA arrays behind the RNA collections instead. */
+
+template<typename T, typename Collection>
+static const T *rna_collection_data(Collection &collection)
+{
+  if (collection.length() == 0) {
+    return NULL;
+  }
+  return static_cast<const T *>(collection[0].ptr.data);
+}
+
+static inline float3 mvert_normal(const MVert &mvert)
+{
+  return make_float3(mvert.no[0], mvert.no[1], mvert.no[2]) * (1.0f / 32767.0f);
+}
+
+/* Number of elements converted by a single task. */
+static const int MESH_ELEMENTS_PER_TASK = 1024;
+
 /* Tangent Space */
 
 struct MikkUserData {
@@ -318,26 +345,38 @@ static void fill_generic_attribute(BL::Mesh &b_mesh,
 {
   switch (element) {
     case ATTR_ELEMENT_CORNER: {
-      for (BL::MeshLoopTriangle &t : b_mesh.loop_triangles) {
-        const int index = t.index() * 3;
-        BL::Array<int, 3> loops = t.loops();
-        data[index] = get_value_at_index(loops[0]);
-        data[index + 1] = get_value_at_index(loops[1]);
-        data[index + 2] = get_value_at_index(loops[2]);
-      }
+      const MLoopTri *looptris = rna_collection_data<MLoopTri>(b_mesh.loop_triangles);
+      const int num_tris = b_mesh.loop_triangles.length();
+      parallel_for(blocked_range<size_t>(0, num_tris, MESH_ELEMENTS_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       const MLoopTri &looptri = looptris[i];
+                       data[i * 3] = get_value_at_index(looptri.tri[0]);
+                       data[i * 3 + 1] = get_value_at_index(looptri.tri[1]);
+                       data[i * 3 + 2] = get_value_at_index(looptri.tri[2]);
+                     }
+                   });
       break;
     }
     case ATTR_ELEMENT_VERTEX: {
       const int num_verts = b_mesh.vertices.length();
-      for (int i = 0; i < num_verts; i++) {
-        data[i] = get_value_at_index(i);
-      }
+      parallel_for(blocked_range<size_t>(0, num_verts, MESH_ELEMENTS_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       data[i] = get_value_at_index(i);
+                     }
+                   });
       break;
     }
     case ATTR_ELEMENT_FACE: {
-      for (BL::MeshLoopTriangle &t : b_mesh.loop_triangles) {
-        data[t.index()] = get_value_at_index(t.polygon_index());
-      }
+      const MLoopTri *looptris = rna_collection_data<MLoopTri>(b_mesh.loop_triangles);
+      const int num_tris = b_mesh.loop_triangles.length();
+      parallel_for(blocked_range<size_t>(0, num_tris, MESH_ELEMENTS_PER_TASK),
+                   [&](const blocked_range<size_t> &r) {
+                     for (size_t i = r.begin(); i != r.end(); i++) {
+                       data[i] = get_value_at_index(looptris[i].poly);
+                     }
+                   });
       break;
     }
     default: {
@@ -356,6 +395,10 @@ static void attr_create_motion(Mesh *mesh, BL::Attribute &b_attribute, const flo
 
   BL::FloatVectorAttribute b_vector_attribute(b_attribute);
   const int numverts = mesh->get_verts().size();
+  if (numverts == 0 || b_vector_attribute.data.length() != numverts) {
+    return;
+  }
+  const float *b_velocity = rna_collection_data<float>(b_vector_attribute.data);
 
   /* Find or add attribute */
   float3 *P = &mesh->get_verts()[0];
@@ -371,9 +414,14 @@ static void attr_create_motion(Mesh *mesh, BL::Attribute &b_attribute, const flo
     const float relative_time = motion_times[step] * 0.5f * motion_scale;
     float3 *mP = attr_mP->data_float3() + step * numverts;
 
-    for (int i = 0; i < numverts; i++) {
-      mP[i] = P[i] + get_float3(b_vector_attribute.data[i].vector()) * relative_time;
-    }
+    parallel_for(blocked_range<size_t>(0, numverts, MESH_ELEMENTS_PER_TASK),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     const float *velocity = b_velocity + i * 3;
+                     mP[i] = P[i] + make_float3(velocity[0], velocity[1], velocity[2]) *
+                                        relative_time;
+                   }
+                 });
   }
 }
 
@@ -429,54 +477,75 @@ static void attr_create_generic(Scene *scene,
     switch (b_data_type) {
       case BL::Attribute::data_type_FLOAT: {
         BL::FloatAttribute b_float_attribute{b_attribute};
+        const float *b_data = rna_collection_data<float>(b_float_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeFloat, element);
         float *data = attr->data_float();
-        fill_generic_attribute(
-            b_mesh, data, element, [&](int i) { return b_float_attribute.data[i].value(); });
+        fill_generic_attribute(b_mesh, data, element, [&](int i) { return b_data[i]; });
         break;
       }
       case BL::Attribute::data_type_BOOLEAN: {
         BL::BoolAttribute b_bool_attribute{b_attribute};
+        const bool *b_data = rna_collection_data<bool>(b_bool_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeFloat, element);
         float *data = attr->data_float();
-        fill_generic_attribute(
-            b_mesh, data, element, [&](int i) { return (float)b_bool_attribute.data[i].value(); });
+        fill_generic_attribute(b_mesh, data, element, [&](int i) { return (float)b_data[i]; });
         break;
       }
       case BL::Attribute::data_type_INT: {
         BL::IntAttribute b_int_attribute{b_attribute};
+        const int *b_data = rna_collection_data<int>(b_int_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeFloat, element);
         float *data = attr->data_float();
-        fill_generic_attribute(
-            b_mesh, data, element, [&](int i) { return (float)b_int_attribute.data[i].value(); });
+        fill_generic_attribute(b_mesh, data, element, [&](int i) { return (float)b_data[i]; });
         break;
       }
       case BL::Attribute::data_type_FLOAT_VECTOR: {
         BL::FloatVectorAttribute b_vector_attribute{b_attribute};
+        const float *b_data = rna_collection_data<float>(b_vector_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeVector, element);
         float3 *data = attr->data_float3();
         fill_generic_attribute(b_mesh, data, element, [&](int i) {
-          BL::Array<float, 3> v = b_vector_attribute.data[i].vector();
+          const float *v = b_data + i * 3;
           return make_float3(v[0], v[1], v[2]);
         });
         break;
       }
       case BL::Attribute::data_type_FLOAT_COLOR: {
         BL::FloatColorAttribute b_color_attribute{b_attribute};
+        const MPropCol *b_data = rna_collection_data<MPropCol>(b_color_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeRGBA, element);
         float4 *data = attr->data_float4();
         fill_generic_attribute(b_mesh, data, element, [&](int i) {
-          BL::Array<float, 4> v = b_color_attribute.data[i].color();
+          const float *v = b_data[i].color;
           return make_float4(v[0], v[1], v[2], v[3]);
         });
         break;
       }
       case BL::Attribute::data_type_FLOAT2: {
         BL::Float2Attribute b_float2_attribute{b_attribute};
+        const float *b_data = rna_collection_data<float>(b_float2_attribute.data);
+        if (b_data == NULL) {
+          break;
+        }
         Attribute *attr = attributes.add(name, TypeFloat2, element);
         float2 *data = attr->data_float2();
         fill_generic_attribute(b_mesh, data, element, [&](int i) {
-          BL::Array<float, 2> v = b_float2_attribute.data[i].vector();
+          const float *v = b_data + i * 2;
           return make_float2(v[0], v[1]);
         });
         break;
@@ -583,14 +652,19 @@ static void attr_create_uv_map(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh)
         }
 
         float2 *fdata = uv_attr->data_float2();
-
-        for (BL::MeshLoopTriangle &t : b_mesh.loop_triangles) {
-          int3 li = get_int3(t.loops());
-          fdata[0] = get_float2(l.data[li[0]].uv());
-          fdata[1] = get_float2(l.data[li[1]].uv());
-          fdata[2] = get_float2(l.data[li[2]].uv());
-          fdata += 3;
-        }
+        const MLoopUV *b_uvs = rna_collection_data<MLoopUV>(l.data);
+        const MLoopTri *looptris = rna_collection_data<MLoopTri>(b_mesh.loop_triangles);
+        const int num_tris = b_mesh.loop_triangles.length();
+
+        parallel_for(blocked_range<size_t>(0, num_tris, MESH_ELEMENTS_PER_TASK),
+                     [&](const blocked_range<size_t> &r) {
+                       for (size_t i = r.begin(); i != r.end(); i++) {
+                         for (int j = 0; j < 3; j++) {
+                           const float *uv = b_uvs[looptris[i].tri[j]].uv;
+                           fdata[i * 3 + j] = make_float2(uv[0], uv[1]);
+                         }
+                       }
+                     });
       }
 
       /* UV tangent */
@@ -650,11 +724,15 @@ static void attr_create_subd_uv_map(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh,
         }
 
         float2 *fdata = uv_attr->data_float2();
-
-        for (BL::MeshPolygon &p : b_mesh.polygons) {
-          int n = p.loop_total();
-          for (int j = 0; j < n; j++) {
-            *(fdata++) = get_float2(l->data[p.loop_start() + j].uv());
+        const MLoopUV *b_uvs = rna_collection_data<MLoopUV>(l->data);
+        const MPoly *polys = rna_collection_data<MPoly>(b_mesh.polygons);
+        const int num_polys = b_mesh.polygons.length();
+
+        for (int p = 0; p < num_polys; p++) {
+          const MPoly &poly = polys[p];
+          for (int j = 0; j < poly.totloop; j++) {
+            const float *uv = b_uvs[poly.loopstart + j].uv;
+            *(fdata++) = make_float2(uv[0], uv[1]);
           }
         }
       }
@@ -769,8 +847,9 @@ static void attr_create_pointiness(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh, b
    */
   vector<float3> vert_normal(num_verts, zero_float3());
   /* First we accumulate all vertex normals in the original index. */
+  const MVert *verts = rna_collection_data<MVert>(b_mesh.vertices);
   for (int vert_index = 0; vert_index < num_verts; ++vert_index) {
-    const float3 normal = get_float3(b_mesh.vertices[vert_index].normal());
+    const float3 normal = mvert_normal(verts[vert_index]);
     const int orig_index = vert_orig_index[vert_index];
     vert_normal[orig_index] += normal;
   }
@@ -785,18 +864,19 @@ static void attr_create_pointiness(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh, b
   vector<int> counter(num_verts, 0);
   vector<float> raw_data(num_verts, 0.0f);
   vector<float3> edge_accum(num_verts, zero_float3());
-  BL::Mesh::edges_iterator e;
+  const MEdge *edges = rna_collection_data<MEdge>(b_mesh.edges);
+  const int num_edges = b_mesh.edges.length();
   EdgeMap visited_edges;
-  int edge_index = 0;
   memset(&counter[0], 0, sizeof(int) * counter.size());
-  for (b_mesh.edges.begin(e); e != b_mesh.edges.end(); ++e, ++edge_index) {
-    const int v0 = vert_orig_index[b_mesh.edges[edge_index].vertices()[0]],
-              v1 = vert_orig_index[b_mesh.edges[edge_index].vertices()[1]];
+  for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
+    const int v0 = vert_orig_index[edges[edge_index].v1],
+              v1 = vert_orig_index[edges[edge_index].v2];
     if (visited_edges.exists(v0, v1)) {
       continue;
     }
     visited_edges.insert(v0, v1);
-    float3 co0 = get_float3(b_mesh.vertices[v0].co()), co1 = get_float3(b_mesh.vertices[v1].co());
+    float3 co0 = make_float3(verts[v0].co[0], verts[v0].co[1], verts[v0].co[2]);
+    float3 co1 = make_float3(verts[v1].co[0], verts[v1].co[1], verts[v1].co[2]);
     float3 edge = normalize(co1 - co0);
     edge_accum[v0] += edge;
     edge_accum[v1] += -edge;
@@ -824,11 +904,10 @@ static void attr_create_pointiness(Scene *scene, Mesh *mesh, BL::Mesh &b_mesh, b
   float *data = attr->data_float();
   memcpy(data, &raw_data[0], sizeof(float) * raw_data.size());
   memset(&counter[0], 0, sizeof(int) * counter.size());
-  edge_index = 0;
   visited_edges.clear();
-  for (b_mesh.edges.begin(e); e != b_mesh.edges.end(); ++e, ++edge_index) {
-    const int v0 = vert_orig_index[b_mesh.edges[edge_index].vertices()[0]],
-              v1 = vert_orig_index[b_mesh.edges[edge_index].vertices()[1]];
+  for (int edge_index = 0; edge_index < num_edges; ++edge_index) {
+    const int v0 = vert_orig_index[edges[edge_index].v1],
+              v1 = vert_orig_index[edges[edge_index].v2];
     if (visited_edges.exists(v0, v1)) {
       continue;
     }
@@ -874,8 +953,10 @@ static void attr_create_random_per_island(Scene *scene,
 
   DisjointSet vertices_sets(number_of_vertices);
 
-  for (BL::MeshEdge &e : b_mesh.edges) {
-    vertices_sets.join(e.vertices()[0], e.vertices()[1]);
+  const MEdge *edges = rna_collection_data<MEdge>(b_mesh.edges);
+  const int num_edges = b_mesh.edges.length();
+  for (int i = 0; i < num_edges; i++) {
+    vertices_sets.join(edges[i].v1, edges[i].v2);
   }
 
   AttributeSet &attributes = (subdivision) ? mesh->subd_attributes : mesh->attributes;
@@ -903,7 +984,8 @@ static void create_mesh(Scene *scene,
                         const bool need_motion,
                         const float motion_scale,
                         const bool subdivision = false,
-                        const bool subdivide_uvs = true)
+                        const bool subdivide_uvs = true,
+                        const Mesh *unchanged_mesh = NULL)
 {
   /* count vertices and faces */
   int numverts = b_mesh.vertices.length();
@@ -919,35 +1001,72 @@ static void create_mesh(Scene *scene,
     return;
   }
 
+  const MVert *verts = rna_collection_data<MVert>(b_mesh.vertices);
+  const MPoly *polys = rna_collection_data<MPoly>(b_mesh.polygons);
+  const MLoop *loops = rna_collection_data<MLoop>(b_mesh.loops);
+  const int num_polys = b_mesh.polygons.length();
+
   if (!subdivision) {
     numtris = numfaces;
   }
   else {
-    for (BL::MeshPolygon &p : b_mesh.polygons) {
-      numngons += (p.loop_total() == 4) ? 0 : 1;
-      numcorners += p.loop_total();
+    for (int p = 0; p < num_polys; p++) {
+      numngons += (polys[p].totloop == 4) ? 0 : 1;
+      numcorners += polys[p].totloop;
     }
   }
 
+  /* Positions and triangles of a mesh which was only synced again for its shaders or
+   * attributes are still the same as the ones of the previous sync, skip converting them.
+   * Positions moved by true displacement would be displaced once more, so convert those. */
+  const bool reuse_geometry = unchanged_mesh != NULL && !subdivision &&
+                              unchanged_mesh->get_subdivision_type() ==
+                                  Mesh::SUBDIVISION_NONE &&
+                              !unchanged_mesh->transform_applied &&
+                              !unchanged_mesh->displacement_applied &&
+                              unchanged_mesh->get_verts().size() == (size_t)numverts &&
+                              unchanged_mesh->num_triangles() == (size_t)numtris;
+
   /* allocate memory */
   if (subdivision) {
     mesh->reserve_subd_faces(numfaces, numngons, numcorners);
   }
 
-  mesh->reserve_mesh(numverts, numtris);
+  mesh->resize_mesh(numverts, numtris);
 
   /* create vertex coordinates and normals */
-  BL::Mesh::vertices_iterator v;
-  for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v)
-    mesh->add_vertex(get_float3(v->co()));
+  float3 *P = mesh->get_verts().data();
+  if (reuse_geometry) {
+    memcpy(P, unchanged_mesh->get_verts().data(), sizeof(float3) * numverts);
+  }
+  else {
+    parallel_for(blocked_range<size_t>(0, numverts, MESH_ELEMENTS_PER_TASK),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     P[i] = make_float3(verts[i].co[0], verts[i].co[1], verts[i].co[2]);
+                   }
+                 });
+  }
+  mesh->tag_verts_modified();
+
+  if (subdivision) {
+    float2 *vert_patch_uv = mesh->get_vert_patch_uv().data();
+    for (int i = 0; i < numverts; i++) {
+      vert_patch_uv[i] = zero_float2();
+    }
+    mesh->tag_vert_patch_uv_modified();
+  }
 
   AttributeSet &attributes = (subdivision) ? mesh->subd_attributes : mesh->attributes;
   Attribute *attr_N = attributes.add(ATTR_STD_VERTEX_NORMAL);
   float3 *N = attr_N->data_float3();
 
-  for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v, ++N)
-    *N = get_float3(v->normal());
-  N = attr_N->data_float3();
+  parallel_for(blocked_range<size_t>(0, numverts, MESH_ELEMENTS_PER_TASK),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   N[i] = mvert_normal(verts[i]);
+                 }
+               });
 
   /* create generated coordinates from undeformed coordinates */
   const bool need_default_tangent = (subdivision == false) && (b_mesh.uv_layers.length() == 0) &&
@@ -962,6 +1081,7 @@ static void create_mesh(Scene *scene,
     float3 *generated = attr->data_float3();
     size_t i = 0;
 
+    BL::Mesh::vertices_iterator v;
     for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end(); ++v) {
       generated[i++] = get_float3(v->undeformed_co()) * size - loc;
     }
@@ -969,40 +1089,69 @@ static void create_mesh(Scene *scene,
 
   /* create faces */
   if (!subdivision) {
-    for (BL::MeshLoopTriangle &t : b_mesh.loop_triangles) {
-      BL::MeshPolygon p = b_mesh.polygons[t.polygon_index()];
-      int3 vi = get_int3(t.vertices());
-
-      int shader = clamp(p.material_index(), 0, used_shaders.size() - 1);
-      bool smooth = p.use_smooth() || use_loop_normals;
+    const MLoopTri *looptris = rna_collection_data<MLoopTri>(b_mesh.loop_triangles);
+    const int max_shader = used_shaders.size() - 1;
+    int *triangles = mesh->get_triangles().data();
+    int *shader = mesh->get_shader().data();
+    bool *smooth = mesh->get_smooth().data();
+
+    if (reuse_geometry) {
+      memcpy(triangles, unchanged_mesh->get_triangles().data(), sizeof(int) * numtris * 3);
+    }
 
-      if (use_loop_normals) {
-        BL::Array<float, 9> loop_normals = t.split_normals();
-        for (int i = 0; i < 3; i++) {
-          N[vi[i]] = make_float3(
-              loop_normals[i * 3], loop_normals[i * 3 + 1], loop_normals[i * 3 + 2]);
+    /* Create triangles.
+     *
+     * NOTE: Autosmooth is already taken care about.
+     */
+    parallel_for(blocked_range<size_t>(0, numtris, MESH_ELEMENTS_PER_TASK),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     const MLoopTri &looptri = looptris[i];
+                     const MPoly &poly = polys[looptri.poly];
+                     if (!reuse_geometry) {
+                       triangles[i * 3] = loops[looptri.tri[0]].v;
+                       triangles[i * 3 + 1] = loops[looptri.tri[1]].v;
+                       triangles[i * 3 + 2] = loops[looptri.tri[2]].v;
+                     }
+                     shader[i] = clamp((int)poly.mat_nr, 0, max_shader);
+                     smooth[i] = (poly.flag & ME_SMOOTH) || use_loop_normals;
+                   }
+                 });
+
+    mesh->tag_triangles_modified();
+    mesh->tag_shader_modified();
+    mesh->tag_smooth_modified();
+
+    if (use_loop_normals) {
+      /* Split normals are written to the vertices of the triangles, which are shared between
+       * triangles. Done on a single thread so the result is the same as before. */
+      const ::Mesh *me = static_cast<const ::Mesh *>(b_mesh.ptr.data);
+      const float(*lnors)[3] = static_cast<const float(*)[3]>(
+          CustomData_get_layer(&me->ldata, CD_NORMAL));
+      if (lnors) {
+        for (int i = 0; i < numtris; i++) {
+          for (int j = 0; j < 3; j++) {
+            const int loop_index = looptris[i].tri[j];
+            N[loops[loop_index].v] = make_float3(
+                lnors[loop_index][0], lnors[loop_index][1], lnors[loop_index][2]);
+          }
         }
       }
-
-      /* Create triangles.
-       *
-       * NOTE: Autosmooth is already taken care about.
-       */
-      mesh->add_triangle(vi[0], vi[1], vi[2], shader, smooth);
     }
   }
   else {
     vector<int> vi;
 
-    for (BL::MeshPolygon &p : b_mesh.polygons) {
-      int n = p.loop_total();
-      int shader = clamp(p.material_index(), 0, used_shaders.size() - 1);
-      bool smooth = p.use_smooth() || use_loop_normals;
+    for (int p = 0; p < num_polys; p++) {
+      const MPoly &poly = polys[p];
+      int n = poly.totloop;
+      int shader = clamp((int)poly.mat_nr, 0, used_shaders.size() - 1);
+      bool smooth = (poly.flag & ME_SMOOTH) || use_loop_normals;
 
       vi.resize(n);
       for (int i = 0; i < n; i++) {
         /* NOTE: Autosmooth is already taken care about. */
-        vi[i] = b_mesh.loops[p.loop_start() + i].vertex_index();
+        vi[i] = loops[poly.loopstart + i].v;
       }
 
       /* create subd faces */
@@ -1058,19 +1207,21 @@ static void create_subd_mesh(Scene *scene,
   create_mesh(scene, mesh, b_mesh, used_shaders, need_motion, motion_scale, true, subdivide_uvs);
 
   /* export creases */
+  const MEdge *edges = rna_collection_data<MEdge>(b_mesh.edges);
+  const int num_edges = b_mesh.edges.length();
   size_t num_creases = 0;
 
-  for (BL::MeshEdge &e : b_mesh.edges) {
-    if (e.crease() != 0.0f) {
+  for (int i = 0; i < num_edges; i++) {
+    if (edges[i].crease != 0) {
       num_creases++;
     }
   }
 
   mesh->reserve_subd_creases(num_creases);
 
-  for (BL::MeshEdge &e : b_mesh.edges) {
-    if (e.crease() != 0.0f) {
-      mesh->add_crease(e.vertices()[0], e.vertices()[1], e.crease());
+  for (int i = 0; i < num_edges; i++) {
+    if (edges[i].crease != 0) {
+      mesh->add_crease(edges[i].v1, edges[i].v2, edges[i].crease * (1.0f / 255.0f));
     }
   }
 
@@ -1119,7 +1270,10 @@ static bool mesh_need_motion_attribute(BObjectInfo &b_ob_info, Scene *scene)
   return true;
 }
 
-void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph, BObjectInfo &b_ob_info, Mesh *mesh)
+void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph,
+                            BObjectInfo &b_ob_info,
+                            Mesh *mesh,
+                            const bool geometry_modified)
 {
   /* make a copy of the shaders as the caller in the main thread still need them for syncing the
    * attributes */
@@ -1167,7 +1321,9 @@ void BlenderSync::sync_mesh(BL::Depsgraph b_depsgraph, BObjectInfo &b_ob_info, M
                     new_mesh.get_used_shaders(),
                     need_motion,
                     motion_scale,
-                    false);
+                    false,
+                    true,
+                    (geometry_modified) ? NULL : mesh);
 
       free_object_to_mesh(b_data, b_ob_info, b_mesh);
     }
@@ -1244,13 +1400,16 @@ void BlenderSync::sync_mesh_motion(BL::Depsgraph b_depsgraph,
     /* NOTE: We don't copy more that existing amount of vertices to prevent
      * possible memory corruption.
      */
-    BL::Mesh::vertices_iterator v;
-    int i = 0;
-    for (b_mesh.vertices.begin(v); v != b_mesh.vertices.end() && i < numverts; ++v, ++i) {
-      mP[i] = get_float3(v->co());
-      if (mN)
-        mN[i] = get_float3(v->normal());
-    }
+    const MVert *verts = rna_collection_data<MVert>(b_mesh.vertices);
+    const size_t num_copy_verts = min(numverts, (size_t)b_mesh.vertices.length());
+    parallel_for(blocked_range<size_t>(0, num_copy_verts, MESH_ELEMENTS_PER_TASK),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     mP[i] = make_float3(verts[i].co[0], verts[i].co[1], verts[i].co[2]);
+                     if (mN)
+                       mN[i] = mvert_normal(verts[i]);
+                   }
+                 });
     if (new_attribute) {
       /* In case of new attribute, we verify if there really was any motion. */
       if (b_mesh.vertices.length() != numverts ||
@@ -53,6 +53,8 @@ CCL_NAMESPACE_BEGIN
 DeviceTypeMask BlenderSession::device_override = DEVICE_MASK_ALL;
 bool BlenderSession::headless = false;
 bool BlenderSession::print_render_stats = false;
+int BlenderSession::sample_range_start = 0;
+int BlenderSession::sample_range_num_samples = 0;
 
 BlenderSession::BlenderSession(BL::RenderEngine &b_engine,
                                BL::Preferences &b_userpref,
@@ -307,15 +309,12 @@ void BlenderSession::stamp_view_layer_metadata(Scene *scene, const string &view_
                             to_string(session->params.samples).c_str());
 
   /* Store ranged samples information. */
-  /* TODO(sergey): Need to bring this information back. */
-#if 0
-  if (session->tile_manager.range_num_samples != -1) {
+  if (sample_range_num_samples != 0) {
     b_rr.stamp_data_add_field((prefix + "range_start_sample").c_str(),
-                              to_string(session->tile_manager.range_start_sample).c_str());
+                              to_string(session->params.start_sample).c_str());
     b_rr.stamp_data_add_field((prefix + "range_num_samples").c_str(),
-                              to_string(session->tile_manager.range_num_samples).c_str());
+                              to_string(session->params.samples).c_str());
   }
-#endif
 
   /* Write cryptomatte metadata. */
   if (scene->film->get_cryptomatte_passes() & CRYPT_OBJECT) {
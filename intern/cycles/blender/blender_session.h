@@ -130,6 +130,11 @@ class BlenderSession {
 
   static bool print_render_stats;
 
+  /* Sample range to render from the command line, for splitting a frame across multiple
+   * renders. Number of samples is 0 when the full range is rendered. */
+  static int sample_range_start;
+  static int sample_range_num_samples;
+
  protected:
   void stamp_view_layer_metadata(Scene *scene, const string &view_layer_name);
 
@@ -335,6 +335,7 @@ void BlenderSync::sync_integrator(BL::ViewLayer &b_view_layer, bool background)
   }
 
   integrator->set_light_sampling_threshold(get_float(cscene, "light_sampling_threshold"));
+  integrator->set_use_light_tree(get_boolean(cscene, "use_light_tree"));
 
   SamplingPattern sampling_pattern = (SamplingPattern)get_enum(
       cscene, "sampling_pattern", SAMPLING_NUM_PATTERNS, SAMPLING_PATTERN_SOBOL);
@@ -608,7 +609,9 @@ void BlenderSync::sync_render_passes(BL::RenderLayer &b_rlay, BL::ViewLayer &b_v
     b_engine.add_pass("Debug Render Time", 1, "X", b_view_layer.name().c_str());
     pass_add(scene, PASS_RENDER_TIME, "Debug Render Time");
   }
-  if (get_boolean(crl, "pass_debug_sample_count")) {
+  /* Per-pixel sample counts are needed to merge renders of sample ranges. */
+  if (get_boolean(crl, "pass_debug_sample_count") ||
+      (BlenderSession::sample_range_num_samples != 0 && !b_engine.is_preview())) {
     b_engine.add_pass("Debug Sample Count", 1, "X", b_view_layer.name().c_str());
     pass_add(scene, PASS_SAMPLE_COUNT, "Debug Sample Count");
   }
@@ -772,6 +775,16 @@ SceneParams BlenderSync::get_scene_params(BL::Scene &b_scene, bool background)
     params.texture_limit = 0;
   }
 
+  params.texture_cache_size = get_boolean(cscene, "use_texture_cache") ?
+                                  get_int(cscene, "texture_cache_size") :
+                                  0;
+
+  /* Only worth it when the scene is kept between updates, and the camera is likely to move a
+   * little between them. */
+  params.use_subd_cache = !background || b_scene.render().use_persistent_data();
+
+  params.use_quantized_attributes = get_boolean(cscene, "use_quantized_attributes");
+
   params.bvh_layout = DebugFlags().cpu.bvh_layout;
 
   params.background = background;
@@ -822,6 +835,13 @@ SessionParams BlenderSync::get_session_params(BL::RenderEngine &b_engine,
   /* Clamp samples. */
   params.samples = min(params.samples, Integrator::MAX_SAMPLES);
 
+  /* Sample range from the command line. */
+  if (background && BlenderSession::sample_range_num_samples != 0) {
+    params.start_sample = BlenderSession::sample_range_start;
+    params.samples = min(BlenderSession::sample_range_num_samples,
+                         max(params.samples - params.start_sample, 0));
+  }
+
   /* Viewport Performance */
   params.pixel_size = b_engine.get_preview_pixel_size(b_scene);
 
@@ -150,7 +150,10 @@ class BlenderSync {
   void sync_volume(BObjectInfo &b_ob_info, Volume *volume);
 
   /* Mesh */
-  void sync_mesh(BL::Depsgraph b_depsgraph, BObjectInfo &b_ob_info, Mesh *mesh);
+  void sync_mesh(BL::Depsgraph b_depsgraph,
+                 BObjectInfo &b_ob_info,
+                 Mesh *mesh,
+                 const bool geometry_modified);
   void sync_mesh_motion(BL::Depsgraph b_depsgraph,
                         BObjectInfo &b_ob_info,
                         Mesh *mesh,
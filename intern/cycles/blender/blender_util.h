@@ -36,6 +36,7 @@ void BKE_image_user_frame_calc(void *ima, void *iuser, int cfra);
 void BKE_image_user_file_path(void *iuser, void *ima, char *path);
 unsigned char *BKE_image_get_pixels_for_frame(void *image, int frame, int tile);
 float *BKE_image_get_float_pixels_for_frame(void *image, int frame, int tile);
+void *CustomData_get_layer(const struct CustomData *data, int type);
 }
 
 CCL_NAMESPACE_BEGIN
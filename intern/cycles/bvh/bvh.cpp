@@ -78,10 +78,15 @@ BVHLayout BVHParams::best_bvh_layout(BVHLayout requested_layout, BVHLayoutMask s
 BVH::BVH(const BVHParams &params_,
          const vector<Geometry *> &geometry_,
          const vector<Object *> &objects_)
-    : params(params_), geometry(geometry_), objects(objects_)
+    : params(params_), geometry(geometry_), objects(objects_), build_cost(0.0f), refit_cost(0.0f)
 {
 }
 
+bool BVH::refit_degraded() const
+{
+  return refit_cost > build_cost * BVH_REFIT_MAX_COST_RATIO;
+}
+
 BVH *BVH::create(const BVHParams &params,
                  const vector<Geometry *> &geometry,
                  const vector<Object *> &objects,
@@ -75,6 +75,9 @@ struct PackedBVH {
   }
 };
 
+/* Rebuild the BVH when refitting increased its estimated cost by more than this factor. */
+#define BVH_REFIT_MAX_COST_RATIO 1.5f
+
 /* BVH */
 
 class BVH {
@@ -83,6 +86,12 @@ class BVH {
   vector<Geometry *> geometry;
   vector<Object *> objects;
 
+  /* Estimated traversal cost of the tree right after it was built and after the last refit.
+   * Refitting keeps the tree topology, so its quality degrades as primitives move away from
+   * where they were when building. Zero when the BVH layout does not estimate it. */
+  float build_cost;
+  float refit_cost;
+
   static BVH *create(const BVHParams &params,
                      const vector<Geometry *> &geometry,
                      const vector<Object *> &objects,
@@ -91,6 +100,9 @@ class BVH {
   {
   }
 
+  /* Whether the last refit degraded the tree enough for a full build to be worth it. */
+  bool refit_degraded() const;
+
  protected:
   BVH(const BVHParams &params,
       const vector<Geometry *> &geometry,
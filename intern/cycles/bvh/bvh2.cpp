@@ -42,7 +42,10 @@ int BVHStackEntry::encodeIdx() const
 BVH2::BVH2(const BVHParams &params_,
            const vector<Geometry *> &geometry_,
            const vector<Object *> &objects_)
-    : BVH(params_, geometry_, objects_)
+    : BVH(params_, geometry_, objects_),
+      top_level_num_prims(0),
+      top_level_nodes_size(0),
+      top_level_leaf_nodes_size(0)
 {
 }
 
@@ -94,18 +97,30 @@ void BVH2::build(Progress &progress, Stats *)
   progress.set_substatus("Packing BVH nodes");
   pack_nodes(root);
 
+  build_cost = root->computeSubtreeSAHCost(params);
+  refit_cost = build_cost;
+
   /* free build nodes */
   root->deleteSubtree();
 }
 
 void BVH2::refit(Progress &progress)
 {
+  if (params.top_level) {
+    unpack_instances();
+  }
+
   progress.set_substatus("Packing BVH primitives");
   pack_primitives();
 
   if (progress.get_cancel())
     return;
 
+  if (params.top_level) {
+    /* Instance BVH's may have been refit or rebuilt, merge them again. */
+    pack_instances(top_level_nodes_size, top_level_leaf_nodes_size);
+  }
+
   progress.set_substatus("Refitting BVH nodes");
   refit_nodes();
 }
@@ -315,14 +330,18 @@ void BVH2::pack_nodes(const BVHNode *root)
 
 void BVH2::refit_nodes()
 {
-  assert(!params.top_level);
-
   BoundBox bbox = BoundBox::empty;
   uint visibility = 0;
-  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility);
+  float sah_area = 0.0f;
+  refit_node(0, (pack.root_index == -1) ? true : false, bbox, visibility, sah_area);
+
+  /* Same cost as BVHNode::computeSubtreeSAHCost(), with the node probabilities written as the
+   * ratio of node and root surface area. */
+  const float root_area = bbox.safe_area();
+  refit_cost = (root_area > 0.0f) ? sah_area / root_area : 0.0f;
 }
 
-void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
+void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &sah_area)
 {
   if (leaf) {
     /* refit leaf node */
@@ -331,7 +350,15 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     const int c0 = data[0].x;
     const int c1 = data[0].y;
 
-    refit_primitives(c0, c1, bbox, visibility);
+    if (c0 < 0) {
+      /* Object instance in the top level BVH. */
+      refit_primitives(~c0, ~c0 + 1, bbox, visibility);
+      sah_area += bbox.safe_area() * params.primitive_cost(1);
+    }
+    else {
+      refit_primitives(c0, c1, bbox, visibility);
+      sah_area += bbox.safe_area() * params.primitive_cost(c1 - c0);
+    }
 
     /* TODO(sergey): De-duplicate with pack_leaf(). */
     float4 leaf_data[BVH_NODE_LEAF_SIZE];
@@ -352,8 +379,8 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     BoundBox bbox0 = BoundBox::empty, bbox1 = BoundBox::empty;
     uint visibility0 = 0, visibility1 = 0;
 
-    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0);
-    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1);
+    refit_node((c0 < 0) ? -c0 - 1 : c0, (c0 < 0), bbox0, visibility0, sah_area);
+    refit_node((c1 < 0) ? -c1 - 1 : c1, (c1 < 0), bbox1, visibility1, sah_area);
 
     if (is_unaligned) {
       Transform aligned_space = transform_identity();
@@ -367,6 +394,7 @@ void BVH2::refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility)
     bbox.grow(bbox0);
     bbox.grow(bbox1);
     visibility = visibility0 | visibility1;
+    sah_area += bbox.safe_area() * params.node_cost(2);
   }
 }
 
@@ -503,6 +531,10 @@ void BVH2::pack_primitives()
 
 void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
 {
+  top_level_num_prims = pack.prim_index.size();
+  top_level_nodes_size = nodes_size;
+  top_level_leaf_nodes_size = leaf_nodes_size;
+
   /* Adjust primitive index to point to the triangle in the global array, for
    * geometry with transform applied and already in the top level BVH.
    */
@@ -699,4 +731,24 @@ void BVH2::pack_instances(size_t nodes_size, size_t leaf_nodes_size)
   }
 }
 
+void BVH2::unpack_instances()
+{
+  /* Shrinking keeps the top level part of the arrays, which is stored first. */
+  pack.prim_index.resize(top_level_num_prims);
+  pack.prim_type.resize(top_level_num_prims);
+  pack.prim_object.resize(top_level_num_prims);
+  if (pack.prim_time.size()) {
+    pack.prim_time.resize(top_level_num_prims);
+  }
+  pack.nodes.resize(top_level_nodes_size);
+  pack.leaf_nodes.resize(top_level_leaf_nodes_size);
+
+  /* Primitive indices are local to their geometry again, as after building. */
+  for (size_t i = 0; i < pack.prim_index.size(); i++) {
+    if (pack.prim_index[i] != -1) {
+      pack.prim_index[i] -= objects[pack.prim_object[i]]->get_geometry()->prim_offset;
+    }
+  }
+}
+
 CCL_NAMESPACE_END
@@ -92,7 +92,7 @@ class BVH2 : public BVH {
 
   /* refit */
   void refit_nodes();
-  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility);
+  void refit_node(int idx, bool leaf, BoundBox &bbox, uint &visibility, float &sah_area);
 
   /* Refit range of primitives. */
   void refit_primitives(int start, int end, BoundBox &bbox, uint &visibility);
@@ -103,6 +103,13 @@ class BVH2 : public BVH {
 
   /* merge instance BVH's */
   void pack_instances(size_t nodes_size, size_t leaf_nodes_size);
+  /* Undo merging of instance BVH's, so the top level can be refit and merged again. */
+  void unpack_instances();
+
+  /* Size of the top level part of the packed arrays, before instance BVH's are merged. */
+  size_t top_level_num_prims;
+  size_t top_level_nodes_size;
+  size_t top_level_leaf_nodes_size;
 };
 
 CCL_NAMESPACE_END
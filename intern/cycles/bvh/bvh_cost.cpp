@@ -0,0 +1,110 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "bvh/bvh_cost.h"
+
+#include "bvh/bvh_params.h"
+
+#include "util/util_algorithm.h"
+
+CCL_NAMESPACE_BEGIN
+
+BVHCostEstimate::BVHCostEstimate(int leaf_size) : leaf_size(max(leaf_size, 1))
+{
+}
+
+float BVHCostEstimate::build(const BVHParams &params, const vector<BoundBox> &prim_bounds)
+{
+  prim_order.resize(prim_bounds.size());
+  for (size_t i = 0; i < prim_order.size(); i++) {
+    prim_order[i] = (int)i;
+  }
+
+  build_range(prim_bounds, 0, (int)prim_order.size());
+
+  return refit(params, prim_bounds);
+}
+
+void BVHCostEstimate::build_range(const vector<BoundBox> &prim_bounds, int start, int end)
+{
+  if (end - start <= leaf_size) {
+    return;
+  }
+
+  /* Split at the median of the primitive centers along the largest axis. */
+  BoundBox centroid_bounds = BoundBox::empty;
+  for (int i = start; i < end; i++) {
+    centroid_bounds.grow(prim_bounds[prim_order[i]].center());
+  }
+
+  const float3 size = centroid_bounds.size();
+  const int dim = (size.x >= size.y && size.x >= size.z) ? 0 : (size.y >= size.z) ? 1 : 2;
+
+  const int mid = (start + end) / 2;
+  std::nth_element(prim_order.begin() + start,
+                   prim_order.begin() + mid,
+                   prim_order.begin() + end,
+                   [&](const int a, const int b) {
+                     return prim_bounds[a].center()[dim] < prim_bounds[b].center()[dim];
+                   });
+
+  build_range(prim_bounds, start, mid);
+  build_range(prim_bounds, mid, end);
+}
+
+float BVHCostEstimate::refit(const BVHParams &params, const vector<BoundBox> &prim_bounds) const
+{
+  if (prim_bounds.size() != prim_order.size()) {
+    return FLT_MAX;
+  }
+  if (prim_order.empty()) {
+    return 0.0f;
+  }
+
+  float sah_area = 0.0f;
+  const BoundBox bounds = refit_range(params, prim_bounds, 0, (int)prim_order.size(), sah_area);
+
+  /* Same cost as BVHNode::computeSubtreeSAHCost(), with the node probabilities written as the
+   * ratio of node and root surface area. */
+  const float root_area = bounds.safe_area();
+  return (root_area > 0.0f) ? sah_area / root_area : 0.0f;
+}
+
+BoundBox BVHCostEstimate::refit_range(const BVHParams &params,
+                                      const vector<BoundBox> &prim_bounds,
+                                      int start,
+                                      int end,
+                                      float &sah_area) const
+{
+  BoundBox bounds = BoundBox::empty;
+
+  if (end - start <= leaf_size) {
+    for (int i = start; i < end; i++) {
+      bounds.grow(prim_bounds[prim_order[i]]);
+    }
+    sah_area += bounds.safe_area() * params.primitive_cost(end - start);
+  }
+  else {
+    const int mid = (start + end) / 2;
+    bounds.grow(refit_range(params, prim_bounds, start, mid, sah_area));
+    bounds.grow(refit_range(params, prim_bounds, mid, end, sah_area));
+    sah_area += bounds.safe_area() * params.node_cost(2);
+  }
+
+  return bounds;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BVH_COST_H__
+#define __BVH_COST_H__
+
+#include "util/util_boundbox.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+class BVHParams;
+
+/* SAH cost estimate for BVHs which do not give access to their nodes, like Embree.
+ *
+ * A binary tree is built over the primitive bounds with object median splits, and refit with the
+ * same topology when the primitives move. Its summed node surface area grows the same way as the
+ * one of the actual BVH after refitting, so comparing the build and refit costs tells when
+ * building again is worth it. */
+class BVHCostEstimate {
+ public:
+  explicit BVHCostEstimate(int leaf_size = 4);
+
+  /* Build the tree topology over the primitive bounds, and return its SAH cost. */
+  float build(const BVHParams &params, const vector<BoundBox> &prim_bounds);
+  /* SAH cost of the tree topology of the last build, for the new bounds of the same primitives.
+   * Returns FLT_MAX when the number of primitives changed. */
+  float refit(const BVHParams &params, const vector<BoundBox> &prim_bounds) const;
+
+ protected:
+  void build_range(const vector<BoundBox> &prim_bounds, int start, int end);
+  BoundBox refit_range(const BVHParams &params,
+                       const vector<BoundBox> &prim_bounds,
+                       int start,
+                       int end,
+                       float &sah_area) const;
+
+  int leaf_size;
+  /* Primitive indices in the order of the tree leaves. */
+  vector<int> prim_order;
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __BVH_COST_H__ */
@@ -363,10 +363,14 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
                                                         RTC_BUILD_QUALITY_MEDIUM);
   rtcSetSceneBuildQuality(scene, build_quality);
 
+  traceable_objects.clear();
+  traceable_objects.resize(objects.size(), true);
+
   int i = 0;
   foreach (Object *ob, objects) {
     if (params.top_level) {
       if (!ob->is_traceable()) {
+        traceable_objects[i] = false;
         ++i;
         continue;
       }
@@ -391,6 +395,50 @@ void BVHEmbree::build(Progress &progress, Stats *stats, RTCDevice rtc_device_)
 
   rtcSetSceneProgressMonitorFunction(scene, rtc_progress_func, &progress);
   rtcCommitScene(scene);
+
+  vector<BoundBox> prim_bounds;
+  get_primitive_bounds(prim_bounds);
+  build_cost = cost_estimate.build(params, prim_bounds);
+  refit_cost = build_cost;
+}
+
+void BVHEmbree::get_primitive_bounds(vector<BoundBox> &prim_bounds) const
+{
+  prim_bounds.clear();
+
+  foreach (Object *ob, objects) {
+    Geometry *geom = ob->get_geometry();
+
+    if (params.top_level && !ob->is_traceable()) {
+      continue;
+    }
+
+    if (params.top_level && geom->is_instanced()) {
+      prim_bounds.push_back(ob->bounds);
+    }
+    else if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
+      const Mesh *mesh = static_cast<const Mesh *>(geom);
+      const float3 *verts = mesh->get_verts().data();
+      for (size_t i = 0; i < mesh->num_triangles(); i++) {
+        BoundBox bounds = BoundBox::empty;
+        mesh->get_triangle(i).bounds_grow(verts, bounds);
+        prim_bounds.push_back(bounds);
+      }
+    }
+    else if (geom->geometry_type == Geometry::HAIR) {
+      const Hair *hair = static_cast<const Hair *>(geom);
+      const float3 *keys = hair->get_curve_keys().data();
+      const float *radius = hair->get_curve_radius().data();
+      for (size_t i = 0; i < hair->num_curves(); i++) {
+        const Hair::Curve curve = hair->get_curve(i);
+        for (int k = 0; k < curve.num_segments(); k++) {
+          BoundBox bounds = BoundBox::empty;
+          curve.bounds_grow(k, keys, radius, bounds);
+          prim_bounds.push_back(bounds);
+        }
+      }
+    }
+  }
 }
 
 void BVHEmbree::add_object(Object *ob, int i)
@@ -416,12 +464,24 @@ void BVHEmbree::add_instance(Object *ob, int i)
   BVHEmbree *instance_bvh = (BVHEmbree *)(ob->get_geometry()->bvh);
   assert(instance_bvh != NULL);
 
+  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
+  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
+  set_instance_transform(geom_id, ob);
+
+  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
+  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
+
+  rtcCommitGeometry(geom_id);
+  rtcAttachGeometryByID(scene, geom_id, i * 2);
+  rtcReleaseGeometry(geom_id);
+}
+
+void BVHEmbree::set_instance_transform(RTCGeometry geom_id, const Object *ob)
+{
   const size_t num_object_motion_steps = ob->use_motion() ? ob->get_motion().size() : 1;
   const size_t num_motion_steps = min(num_object_motion_steps, RTC_MAX_TIME_STEP_COUNT);
   assert(num_object_motion_steps <= RTC_MAX_TIME_STEP_COUNT);
 
-  RTCGeometry geom_id = rtcNewGeometry(rtc_device, RTC_GEOMETRY_TYPE_INSTANCE);
-  rtcSetGeometryInstancedScene(geom_id, instance_bvh->scene);
   rtcSetGeometryTimeStepCount(geom_id, num_motion_steps);
 
   if (ob->use_motion()) {
@@ -445,13 +505,6 @@ void BVHEmbree::add_instance(Object *ob, int i)
     rtcSetGeometryTransform(
         geom_id, 0, RTC_FORMAT_FLOAT3X4_ROW_MAJOR, (const float *)&ob->get_tfm());
   }
-
-  rtcSetGeometryUserData(geom_id, (void *)instance_bvh->scene);
-  rtcSetGeometryMask(geom_id, ob->visibility_for_tracing());
-
-  rtcCommitGeometry(geom_id);
-  rtcAttachGeometryByID(scene, geom_id, i * 2);
-  rtcReleaseGeometry(geom_id);
 }
 
 void BVHEmbree::add_triangles(const Object *ob, const Mesh *mesh, int i)
@@ -691,35 +744,66 @@ void BVHEmbree::refit(Progress &progress)
 {
   progress.set_substatus("Refitting BVH nodes");
 
-  /* Update all vertex buffers, then tell Embree to rebuild/-fit the BVHs. */
+  /* Update all vertex buffers and instance transforms, then tell Embree to refit the BVHs. */
+  bool is_valid = true;
   unsigned geom_id = 0;
   foreach (Object *ob, objects) {
-    if (!params.top_level || (ob->is_traceable() && !ob->get_geometry()->is_instanced())) {
-      Geometry *geom = ob->get_geometry();
-
-      if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
-        Mesh *mesh = static_cast<Mesh *>(geom);
-        if (mesh->num_triangles() > 0) {
-          RTCGeometry geom = rtcGetGeometry(scene, geom_id);
-          set_tri_vertex_buffer(geom, mesh, true);
-          rtcSetGeometryUserData(geom, (void *)mesh->optix_prim_offset);
-          rtcCommitGeometry(geom);
-        }
+    Geometry *geom = ob->get_geometry();
+
+    if (params.top_level && !ob->is_traceable()) {
+      /* Objects which stopped being traceable would stay in the scene. */
+      is_valid &= !traceable_objects[geom_id / 2];
+    }
+    else if (params.top_level && !traceable_objects[geom_id / 2]) {
+      /* Objects which became traceable are missing from the scene. */
+      is_valid = false;
+    }
+    else if (params.top_level && geom->is_instanced()) {
+      /* Instanced BVH may have been rebuilt instead of refit. */
+      BVHEmbree *instance_bvh = static_cast<BVHEmbree *>(geom->bvh);
+      RTCGeometry rtc_geom = rtcGetGeometry(scene, geom_id);
+      rtcSetGeometryInstancedScene(rtc_geom, instance_bvh->scene);
+      set_instance_transform(rtc_geom, ob);
+      rtcSetGeometryUserData(rtc_geom, (void *)instance_bvh->scene);
+      rtcSetGeometryMask(rtc_geom, ob->visibility_for_tracing());
+      rtcCommitGeometry(rtc_geom);
+    }
+    else if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
+      Mesh *mesh = static_cast<Mesh *>(geom);
+      if (mesh->num_triangles() > 0) {
+        RTCGeometry rtc_geom = rtcGetGeometry(scene, geom_id);
+        set_tri_vertex_buffer(rtc_geom, mesh, true);
+        rtcSetGeometryUserData(rtc_geom, (void *)mesh->optix_prim_offset);
+        rtcSetGeometryMask(rtc_geom, ob->visibility_for_tracing());
+        rtcSetGeometryBuildQuality(rtc_geom, RTC_BUILD_QUALITY_REFIT);
+        rtcCommitGeometry(rtc_geom);
       }
-      else if (geom->geometry_type == Geometry::HAIR) {
-        Hair *hair = static_cast<Hair *>(geom);
-        if (hair->num_curves() > 0) {
-          RTCGeometry geom = rtcGetGeometry(scene, geom_id + 1);
-          set_curve_vertex_buffer(geom, hair, true);
-          rtcSetGeometryUserData(geom, (void *)hair->optix_prim_offset);
-          rtcCommitGeometry(geom);
-        }
+    }
+    else if (geom->geometry_type == Geometry::HAIR) {
+      Hair *hair = static_cast<Hair *>(geom);
+      if (hair->num_curves() > 0) {
+        RTCGeometry rtc_geom = rtcGetGeometry(scene, geom_id + 1);
+        set_curve_vertex_buffer(rtc_geom, hair, true);
+        rtcSetGeometryUserData(rtc_geom, (void *)hair->optix_prim_offset);
+        rtcSetGeometryMask(rtc_geom, ob->visibility_for_tracing());
+        rtcSetGeometryBuildQuality(rtc_geom, RTC_BUILD_QUALITY_REFIT);
+        rtcCommitGeometry(rtc_geom);
       }
     }
     geom_id += 2;
   }
 
+  if (!is_valid) {
+    /* Leave it to the caller to build the scene again. */
+    refit_cost = FLT_MAX;
+    return;
+  }
+
   rtcCommitScene(scene);
+
+  vector<BoundBox> prim_bounds;
+  get_primitive_bounds(prim_bounds);
+  refit_cost = cost_estimate.refit(params, prim_bounds);
 }
 
 CCL_NAMESPACE_END
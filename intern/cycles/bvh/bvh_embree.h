@@ -23,6 +23,7 @@
 #  include <embree3/rtcore_scene.h>
 
 #  include "bvh/bvh.h"
+#  include "bvh/bvh_cost.h"
 #  include "bvh/bvh_params.h"
 
 #  include "util/util_thread.h"
@@ -50,6 +51,7 @@ class BVHEmbree : public BVH {
 
   void add_object(Object *ob, int i);
   void add_instance(Object *ob, int i);
+  void set_instance_transform(RTCGeometry geom_id, const Object *ob);
   void add_curves(const Object *ob, const Hair *hair, int i);
   void add_triangles(const Object *ob, const Mesh *mesh, int i);
 
@@ -57,8 +59,15 @@ class BVHEmbree : public BVH {
   void set_tri_vertex_buffer(RTCGeometry geom_id, const Mesh *mesh, const bool update);
   void set_curve_vertex_buffer(RTCGeometry geom_id, const Hair *hair, const bool update);
 
+  /* Bounds of the primitives in the scene, in the order they were added to it. */
+  void get_primitive_bounds(vector<BoundBox> &prim_bounds) const;
+
   RTCDevice rtc_device;
   enum RTCBuildQuality build_quality;
+  /* Objects which were attached to the scene when building. */
+  vector<bool> traceable_objects;
+  /* Embree does not give access to its nodes, estimate the SAH cost of refitting with this. */
+  BVHCostEstimate cost_estimate;
 };
 
 CCL_NAMESPACE_END
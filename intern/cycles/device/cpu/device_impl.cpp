@@ -168,6 +168,11 @@ void CPUDevice::mem_copy_to(device_memory &mem)
   }
 }
 
+void CPUDevice::mem_copy_to(device_memory & /*mem*/, size_t /*size*/, size_t /*offset*/)
+{
+  /* Device memory is the host memory, copy is no-op. */
+}
+
 void CPUDevice::mem_copy_from(
     device_memory & /*mem*/, size_t /*y*/, size_t /*w*/, size_t /*h*/, size_t /*elem*/)
 {
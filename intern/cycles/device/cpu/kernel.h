@@ -48,13 +48,17 @@ class CPUKernels {
   IntegratorShadeFunction integrator_shade_light;
   IntegratorShadeFunction integrator_shade_shadow;
   IntegratorShadeFunction integrator_shade_surface;
+  IntegratorShadeFunction integrator_shade_surface_raytrace;
   IntegratorShadeFunction integrator_shade_volume;
   IntegratorShadeFunction integrator_megakernel;
 
   /* Shader evaluation. */
 
-  using ShaderEvalFunction = CPUKernelFunction<void (*)(
-      const KernelGlobals *kg, const KernelShaderEvalInput *, float4 *, const int)>;
+  using ShaderEvalFunction = CPUKernelFunction<void (*)(const KernelGlobals *kg,
+                                                        const KernelShaderEvalInput *,
+                                                        float4 *,
+                                                        const int64_t,
+                                                        const int64_t)>;
 
   ShaderEvalFunction shader_eval_displace;
   ShaderEvalFunction shader_eval_background;
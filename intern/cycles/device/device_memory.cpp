@@ -136,6 +136,21 @@ void device_memory::device_copy_to()
   }
 }
 
+void device_memory::device_copy_to(size_t size, size_t offset)
+{
+  if (!host_pointer) {
+    return;
+  }
+
+  /* Partial copies are only possible into existing memory of the same size. */
+  if (!device_pointer || device_size != memory_size()) {
+    device->mem_copy_to(*this);
+  }
+  else {
+    device->mem_copy_to(*this, size, offset);
+  }
+}
+
 void device_memory::device_copy_from(size_t y, size_t w, size_t h, size_t elem)
 {
   assert(type != MEM_TEXTURE && type != MEM_READ_ONLY && type != MEM_GLOBAL);
@@ -217,6 +232,7 @@ device_texture::device_texture(Device *device,
     case IMAGE_DATA_TYPE_BYTE:
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT:
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
       data_type = TYPE_UCHAR;
       data_elements = 1;
       break;
@@ -21,8 +21,10 @@
  *
  * Data types for allocating, copying and freeing device memory. */
 
+#include "util/util_algorithm.h"
 #include "util/util_array.h"
 #include "util/util_half.h"
+#include "util/util_map.h"
 #include "util/util_string.h"
 #include "util/util_texture.h"
 #include "util/util_types.h"
@@ -243,7 +245,7 @@ class device_memory {
   {
     return data_size * data_elements * datatype_size(data_type);
   }
-  size_t memory_elements_size(int elements)
+  size_t memory_elements_size(size_t elements)
   {
     return elements * data_elements * datatype_size(data_type);
   }
@@ -297,6 +299,7 @@ class device_memory {
   void device_alloc();
   void device_free();
   void device_copy_to();
+  void device_copy_to(size_t size, size_t offset);
   void device_copy_from(size_t y, size_t w, size_t h, size_t elem);
   void device_zero();
 
@@ -487,6 +490,7 @@ template<typename T> class device_vector : public device_memory {
     host_pointer = 0;
     modified = true;
     need_realloc_ = true;
+    modified_ranges.clear();
     assert(device_pointer == 0);
   }
 
@@ -499,7 +503,7 @@ template<typename T> class device_vector : public device_memory {
 
   bool is_modified() const
   {
-    return modified;
+    return modified || !modified_ranges.empty();
   }
 
   bool need_realloc()
@@ -512,6 +516,15 @@ template<typename T> class device_vector : public device_memory {
     modified = true;
   }
 
+  /* Tag a range of elements as modified. When the rest of the array did not change, only the
+   * modified ranges are copied by copy_to_device_if_modified(). */
+  void tag_modified(size_t offset, size_t size)
+  {
+    if (!modified && size != 0) {
+      modified_ranges.push_back({offset, size});
+    }
+  }
+
   void tag_realloc()
   {
     need_realloc_ = true;
@@ -546,19 +559,30 @@ template<typename T> class device_vector : public device_memory {
     }
   }
 
-  void copy_to_device_if_modified()
+  /* Copy a range of elements, the device memory must already be allocated with the same size. */
+  void copy_to_device(size_t size, size_t offset)
   {
-    if (!modified) {
-      return;
+    if (size != 0) {
+      assert(offset + size <= data_size);
+      device_copy_to(size, offset);
     }
+  }
 
-    copy_to_device();
+  void copy_to_device_if_modified()
+  {
+    if (modified) {
+      copy_to_device();
+    }
+    else if (!modified_ranges.empty()) {
+      copy_modified_ranges_to_device();
+    }
   }
 
   void clear_modified()
   {
     modified = false;
     need_realloc_ = false;
+    modified_ranges.clear();
   }
 
   void copy_from_device()
@@ -589,6 +613,47 @@ template<typename T> class device_vector : public device_memory {
   {
     return width * ((height == 0) ? 1 : height) * ((depth == 0) ? 1 : depth);
   }
+
+  void copy_modified_ranges_to_device()
+  {
+    /* Merge overlapping and adjacent ranges, packed arrays of neighboring geometry are often
+     * modified together. */
+    sort(modified_ranges.begin(), modified_ranges.end());
+
+    vector<pair<size_t, size_t>> ranges;
+    size_t total_size = 0;
+    for (const pair<size_t, size_t> &range : modified_ranges) {
+      const size_t range_end = min(range.first + range.second, data_size);
+      if (range.first >= range_end) {
+        continue;
+      }
+      if (!ranges.empty() && range.first <= ranges.back().first + ranges.back().second) {
+        pair<size_t, size_t> &last = ranges.back();
+        const size_t last_end = last.first + last.second;
+        if (range_end > last_end) {
+          total_size += range_end - last_end;
+          last.second = range_end - last.first;
+        }
+      }
+      else {
+        ranges.push_back({range.first, range_end - range.first});
+        total_size += range_end - range.first;
+      }
+    }
+
+    /* Many copies of small ranges are slower than one copy of the whole array. */
+    if (total_size > data_size / 2) {
+      copy_to_device();
+      return;
+    }
+
+    for (const pair<size_t, size_t> &range : ranges) {
+      copy_to_device(range.second, range.first);
+    }
+  }
+
+  /* Element ranges as (offset, size), modified since the last copy to the device. */
+  vector<pair<size_t, size_t>> modified_ranges;
 };
 
 /* Device Sub Memory
@@ -48,6 +48,10 @@ class DummyDevice : public Device {
   {
   }
 
+  virtual void mem_copy_to(device_memory &, size_t, size_t) override
+  {
+  }
+
   virtual void mem_copy_from(device_memory &, size_t, size_t, size_t, size_t) override
   {
   }
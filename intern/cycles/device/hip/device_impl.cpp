@@ -808,6 +808,24 @@ void HIPDevice::mem_copy_to(device_memory &mem)
   }
 }
 
+void HIPDevice::mem_copy_to(device_memory &mem, size_t size, size_t offset)
+{
+  if (mem.type == MEM_TEXTURE) {
+    /* Texture objects are created along with the copy, update the whole texture. */
+    mem_copy_to(mem);
+    return;
+  }
+
+  thread_scoped_lock lock(hip_mem_map_mutex);
+  if (!hip_mem_map[&mem].use_mapped_host || mem.host_pointer != mem.shared_pointer) {
+    const HIPContextScope scope(this);
+    const size_t offset_bytes = mem.memory_elements_size(offset);
+    hip_assert(hipMemcpyHtoD((hipDeviceptr_t)((char *)mem.device_pointer + offset_bytes),
+                             (char *)mem.host_pointer + offset_bytes,
+                             mem.memory_elements_size(size)));
+  }
+}
+
 void HIPDevice::mem_copy_from(device_memory &mem, size_t y, size_t w, size_t h, size_t elem)
 {
   if (mem.type == MEM_TEXTURE || mem.type == MEM_GLOBAL) {
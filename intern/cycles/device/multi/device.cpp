@@ -315,6 +315,31 @@ class MultiDevice : public Device {
     stats.mem_alloc(mem.device_size - existing_size);
   }
 
+  void mem_copy_to(device_memory &mem, size_t size, size_t offset) override
+  {
+    if (mem.type == MEM_TEXTURE) {
+      mem_copy_to(mem);
+      return;
+    }
+
+    device_ptr key = mem.device_pointer;
+    size_t existing_size = mem.device_size;
+
+    /* Memory is already allocated, so pointers in kernel globals and texture objects of the
+     * other devices of the island stay valid, only the owner needs the data. */
+    foreach (const vector<SubDevice *> &island, peer_islands) {
+      SubDevice *owner_sub = find_suitable_mem_device(key, island);
+      mem.device = owner_sub->device;
+      mem.device_pointer = owner_sub->ptr_map[key];
+      mem.device_size = existing_size;
+
+      owner_sub->device->mem_copy_to(mem, size, offset);
+    }
+
+    mem.device = this;
+    mem.device_pointer = key;
+  }
+
   void mem_copy_from(device_memory &mem, size_t y, size_t w, size_t h, size_t elem) override
   {
     device_ptr key = mem.device_pointer;
@@ -0,0 +1,547 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "graph/node_binary.h"
+
+#include "util/util_foreach.h"
+#include "util/util_logging.h"
+#include "util/util_path.h"
+#include "util/util_transform.h"
+
+#ifndef _WIN32
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+CCL_NAMESPACE_BEGIN
+
+static bool binary_socket_is_serialized(const SocketType &socket)
+{
+  if (socket.type == SocketType::CLOSURE || socket.type == SocketType::UNDEFINED) {
+    return false;
+  }
+  if (socket.flags & SocketType::INTERNAL) {
+    return false;
+  }
+  return true;
+}
+
+/* Writer */
+
+BinaryWriter::BinaryWriter() : file(NULL), offset(0), failed(false)
+{
+}
+
+BinaryWriter::~BinaryWriter()
+{
+  close();
+}
+
+bool BinaryWriter::open(const string &filepath)
+{
+  close();
+
+  file = path_fopen(filepath, "wb");
+  offset = 0;
+  failed = (file == NULL);
+  node_ids.clear();
+
+  return !failed;
+}
+
+bool BinaryWriter::close()
+{
+  if (file) {
+    if (fclose(file) != 0) {
+      failed = true;
+    }
+    file = NULL;
+  }
+
+  return !failed;
+}
+
+void BinaryWriter::write_data(const void *data, size_t size)
+{
+  if (failed || size == 0) {
+    return;
+  }
+
+  if (fwrite(data, 1, size, file) != size) {
+    failed = true;
+    return;
+  }
+
+  offset += size;
+}
+
+void BinaryWriter::write_string(const string &value)
+{
+  write<uint32_t>(value.size());
+  write_data(value.data(), value.size());
+}
+
+void BinaryWriter::write_array(const void *data, size_t num_elements, size_t element_size)
+{
+  write<uint64_t>(num_elements);
+
+  static const uint8_t zeros[BINARY_ARRAY_ALIGNMENT] = {0};
+  write_data(zeros, align_up(offset, BINARY_ARRAY_ALIGNMENT) - offset);
+  write_data(data, num_elements * element_size);
+}
+
+void BinaryWriter::add_node(const Node *node)
+{
+  const int id = node_ids.size();
+  node_ids[node] = id;
+}
+
+void BinaryWriter::write_node_ref(const Node *node)
+{
+  int id = -1;
+
+  if (node) {
+    map<const Node *, int>::iterator it = node_ids.find(node);
+    if (it != node_ids.end()) {
+      id = it->second;
+    }
+    else {
+      LOG(WARNING) << "Reference to node " << node->name.c_str() << " of type "
+                   << node->type->name.c_str() << " which is not written, skipping.";
+    }
+  }
+
+  write<int32_t>(id);
+}
+
+void BinaryWriter::write_node(const Node *node)
+{
+  write_string(node->name.string());
+
+  uint32_t num_sockets = 0;
+  foreach (const SocketType &socket, node->type->inputs) {
+    if (binary_socket_is_serialized(socket) && !node->has_default_value(socket)) {
+      num_sockets++;
+    }
+  }
+  write<uint32_t>(num_sockets);
+
+  foreach (const SocketType &socket, node->type->inputs) {
+    if (!binary_socket_is_serialized(socket) || node->has_default_value(socket)) {
+      continue;
+    }
+
+    write_string(socket.name.string());
+    write<uint8_t>(socket.type);
+
+    switch (socket.type) {
+      case SocketType::BOOLEAN: {
+        write<uint8_t>(node->get_bool(socket));
+        break;
+      }
+      case SocketType::BOOLEAN_ARRAY: {
+        const array<bool> &value = node->get_bool_array(socket);
+        write_array(value.data(), value.size(), sizeof(bool));
+        break;
+      }
+      case SocketType::FLOAT: {
+        write(node->get_float(socket));
+        break;
+      }
+      case SocketType::FLOAT_ARRAY: {
+        const array<float> &value = node->get_float_array(socket);
+        write_array(value.data(), value.size(), sizeof(float));
+        break;
+      }
+      case SocketType::INT: {
+        write<int32_t>(node->get_int(socket));
+        break;
+      }
+      case SocketType::UINT: {
+        write<uint32_t>(node->get_uint(socket));
+        break;
+      }
+      case SocketType::INT_ARRAY: {
+        const array<int> &value = node->get_int_array(socket);
+        write_array(value.data(), value.size(), sizeof(int));
+        break;
+      }
+      case SocketType::COLOR:
+      case SocketType::VECTOR:
+      case SocketType::POINT:
+      case SocketType::NORMAL: {
+        write(node->get_float3(socket));
+        break;
+      }
+      case SocketType::COLOR_ARRAY:
+      case SocketType::VECTOR_ARRAY:
+      case SocketType::POINT_ARRAY:
+      case SocketType::NORMAL_ARRAY: {
+        const array<float3> &value = node->get_float3_array(socket);
+        write_array(value.data(), value.size(), sizeof(float3));
+        break;
+      }
+      case SocketType::POINT2: {
+        write(node->get_float2(socket));
+        break;
+      }
+      case SocketType::POINT2_ARRAY: {
+        const array<float2> &value = node->get_float2_array(socket);
+        write_array(value.data(), value.size(), sizeof(float2));
+        break;
+      }
+      case SocketType::STRING:
+      case SocketType::ENUM: {
+        /* Enums are stored by name, so changes to the enum values do not break old files. */
+        write_string(node->get_string(socket).string());
+        break;
+      }
+      case SocketType::STRING_ARRAY: {
+        const array<ustring> &value = node->get_string_array(socket);
+        write<uint64_t>(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+          write_string(value[i].string());
+        }
+        break;
+      }
+      case SocketType::TRANSFORM: {
+        write(node->get_transform(socket));
+        break;
+      }
+      case SocketType::TRANSFORM_ARRAY: {
+        const array<Transform> &value = node->get_transform_array(socket);
+        write_array(value.data(), value.size(), sizeof(Transform));
+        break;
+      }
+      case SocketType::NODE: {
+        write_node_ref(node->get_node(socket));
+        break;
+      }
+      case SocketType::NODE_ARRAY: {
+        const array<Node *> &value = node->get_node_array(socket);
+        write<uint64_t>(value.size());
+        for (size_t i = 0; i < value.size(); i++) {
+          write_node_ref(value[i]);
+        }
+        break;
+      }
+      case SocketType::CLOSURE:
+      case SocketType::UNDEFINED:
+        break;
+    }
+  }
+}
+
+/* Reader */
+
+BinaryReader::BinaryReader() : data(NULL), size(0), offset(0), failed(false), mapped(false)
+{
+}
+
+BinaryReader::~BinaryReader()
+{
+  close();
+}
+
+bool BinaryReader::open(const string &filepath)
+{
+  close();
+
+#ifndef _WIN32
+  /* Map the file, pages are only read from disk when arrays are copied into the nodes. */
+  int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd != -1) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      void *mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapping != MAP_FAILED) {
+        data = (const uint8_t *)mapping;
+        size = st.st_size;
+        mapped = true;
+      }
+    }
+    ::close(fd);
+  }
+#endif
+
+  if (!mapped) {
+    if (!path_read_binary(filepath, buffer)) {
+      failed = true;
+      return false;
+    }
+    data = buffer.data();
+    size = buffer.size();
+  }
+
+  return true;
+}
+
+void BinaryReader::close()
+{
+#ifndef _WIN32
+  if (mapped) {
+    munmap((void *)data, size);
+  }
+#endif
+
+  buffer.clear();
+  nodes.clear();
+  data = NULL;
+  size = 0;
+  offset = 0;
+  failed = false;
+  mapped = false;
+}
+
+bool BinaryReader::read_data(void *value, size_t value_size)
+{
+  if (failed || value_size > size - offset) {
+    failed = true;
+    return false;
+  }
+
+  memcpy(value, data + offset, value_size);
+  offset += value_size;
+  return true;
+}
+
+string BinaryReader::read_string()
+{
+  const uint32_t length = read<uint32_t>();
+  if (failed || length > size - offset) {
+    failed = true;
+    return string();
+  }
+
+  string value((const char *)data + offset, length);
+  offset += length;
+  return value;
+}
+
+const void *BinaryReader::read_array(size_t *num_elements, size_t element_size)
+{
+  const uint64_t count = read<uint64_t>();
+  const size_t begin = align_up(offset, BINARY_ARRAY_ALIGNMENT);
+
+  if (failed || begin > size || count > (size - begin) / element_size) {
+    failed = true;
+    *num_elements = 0;
+    return NULL;
+  }
+
+  offset = begin + count * element_size;
+  *num_elements = count;
+  return data + begin;
+}
+
+void BinaryReader::add_node(Node *node)
+{
+  nodes.push_back(node);
+}
+
+Node *BinaryReader::read_node_ref()
+{
+  const int32_t id = read<int32_t>();
+  if (id < 0 || id >= (int)nodes.size()) {
+    return NULL;
+  }
+  return nodes[id];
+}
+
+template<typename T> static bool binary_read_array(BinaryReader &reader, array<T> &value)
+{
+  size_t num_elements;
+  const void *elements = reader.read_array(&num_elements, sizeof(T));
+  if (elements == NULL) {
+    return false;
+  }
+
+  value.resize(num_elements);
+  if (num_elements) {
+    memcpy(value.data(), elements, num_elements * sizeof(T));
+  }
+  return true;
+}
+
+void BinaryReader::read_node(Node *node)
+{
+  node->name = ustring(read_string());
+
+  const uint32_t num_sockets = read<uint32_t>();
+
+  for (uint32_t i = 0; i < num_sockets && !failed; i++) {
+    const ustring name(read_string());
+    const SocketType::Type type = (SocketType::Type)read<uint8_t>();
+
+    /* Values are always read to advance in the file, but only set when the socket still exists
+     * with the same type. */
+    const SocketType *socket = node->type->find_input(name);
+    if (socket && (socket->type != type || !binary_socket_is_serialized(*socket))) {
+      socket = NULL;
+    }
+    if (socket == NULL) {
+      VLOG(1) << "Skipping unknown socket " << name.c_str() << " of node type "
+              << node->type->name.c_str() << ".";
+    }
+
+    switch (type) {
+      case SocketType::BOOLEAN: {
+        const bool value = read<uint8_t>() != 0;
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::BOOLEAN_ARRAY: {
+        array<bool> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::FLOAT: {
+        const float value = read<float>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::FLOAT_ARRAY: {
+        array<float> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::INT: {
+        const int value = read<int32_t>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::UINT: {
+        const uint value = read<uint32_t>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::INT_ARRAY: {
+        array<int> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::COLOR:
+      case SocketType::VECTOR:
+      case SocketType::POINT:
+      case SocketType::NORMAL: {
+        const float3 value = read<float3>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::COLOR_ARRAY:
+      case SocketType::VECTOR_ARRAY:
+      case SocketType::POINT_ARRAY:
+      case SocketType::NORMAL_ARRAY: {
+        array<float3> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::POINT2: {
+        const float2 value = read<float2>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::POINT2_ARRAY: {
+        array<float2> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::STRING:
+      case SocketType::ENUM: {
+        const ustring value(read_string());
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::STRING_ARRAY: {
+        const uint64_t num_elements = read<uint64_t>();
+        array<ustring> value;
+        for (uint64_t j = 0; j < num_elements && !failed; j++) {
+          value.push_back_slow(ustring(read_string()));
+        }
+        if (socket && !failed) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::TRANSFORM: {
+        const Transform value = read<Transform>();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::TRANSFORM_ARRAY: {
+        array<Transform> value;
+        if (binary_read_array(*this, value) && socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::NODE: {
+        Node *value = read_node_ref();
+        if (socket) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::NODE_ARRAY: {
+        const uint64_t num_elements = read<uint64_t>();
+        array<Node *> value;
+        for (uint64_t j = 0; j < num_elements && !failed; j++) {
+          value.push_back_slow(read_node_ref());
+        }
+        if (socket && !failed) {
+          node->set(*socket, value);
+        }
+        break;
+      }
+      case SocketType::CLOSURE:
+      case SocketType::UNDEFINED:
+      default:
+        /* Nothing is written for these, anything else means the file is corrupted. */
+        failed = true;
+        break;
+    }
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "graph/node.h"
+
+#include "util/util_map.h"
+#include "util/util_string.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Binary serialization of node sockets.
+ *
+ * Values are stored in native byte order and layout, so files are only meant to be read by a
+ * build for the same architecture. Array data is aligned to BINARY_ARRAY_ALIGNMENT bytes from
+ * the start of the file, so that arrays of a memory mapped file can be copied into node storage
+ * without any conversion.
+ *
+ * Nodes are referenced by the order in which they were added to the writer and reader, which
+ * is up to the caller to keep the same. */
+
+#define BINARY_ARRAY_ALIGNMENT 16
+
+class BinaryWriter {
+ public:
+  BinaryWriter();
+  ~BinaryWriter();
+
+  bool open(const string &filepath);
+  bool close();
+
+  void write_data(const void *data, size_t size);
+  template<typename T> void write(const T &value)
+  {
+    write_data(&value, sizeof(T));
+  }
+  void write_string(const string &value);
+  /* Write element count followed by the aligned element data. */
+  void write_array(const void *data, size_t num_elements, size_t element_size);
+
+  void add_node(const Node *node);
+  void write_node_ref(const Node *node);
+  void write_node(const Node *node);
+
+ protected:
+  FILE *file;
+  size_t offset;
+  bool failed;
+  map<const Node *, int> node_ids;
+};
+
+class BinaryReader {
+ public:
+  BinaryReader();
+  ~BinaryReader();
+
+  bool open(const string &filepath);
+  void close();
+
+  bool read_data(void *data, size_t size);
+  template<typename T> T read()
+  {
+    T value = T();
+    read_data(&value, sizeof(T));
+    return value;
+  }
+  string read_string();
+  /* Returns pointer to the aligned element data inside of the file, NULL on error. */
+  const void *read_array(size_t *num_elements, size_t element_size);
+
+  void add_node(Node *node);
+  Node *read_node_ref();
+  /* Read sockets written by BinaryWriter::write_node. Sockets which do not exist in the node
+   * type are skipped, so files stay readable when sockets are added or removed. */
+  void read_node(Node *node);
+
+  /* Whether reading went past the end of the file or found inconsistent data. */
+  bool has_error() const
+  {
+    return failed;
+  }
+
+ protected:
+  const uint8_t *data;
+  size_t size;
+  size_t offset;
+  bool failed;
+  bool mapped;
+  vector<uint8_t> buffer;
+  vector<Node *> nodes;
+};
+
+CCL_NAMESPACE_END
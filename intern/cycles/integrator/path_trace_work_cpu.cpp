@@ -23,13 +23,17 @@
 
 #include "integrator/pass_accessor_cpu.h"
 #include "integrator/path_trace_display.h"
+#include "integrator/tile.h"
 
 #include "render/buffers.h"
 #include "render/scene.h"
 
+#include "util/util_algorithm.h"
 #include "util/util_atomic.h"
+#include "util/util_debug.h"
 #include "util/util_logging.h"
 #include "util/util_tbb.h"
+#include "util/util_time.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -53,6 +57,18 @@ static inline CPUKernelThreadGlobals *kernel_thread_globals_get(
   return &kernel_thread_globals[thread_index];
 }
 
+/* Add time spent on the pixel of the work tile to the render time pass. Every pixel is only
+ * rendered by one thread at a time, so no atomics are needed. */
+static inline void render_time_pass_add(float *render_buffer,
+                                        const KernelWorkTile &work_tile,
+                                        const int pass_stride,
+                                        const int pass_offset,
+                                        const double time)
+{
+  const int64_t pixel_index = work_tile.offset + work_tile.x + work_tile.y * work_tile.stride;
+  render_buffer[pixel_index * pass_stride + pass_offset] += (float)(time * 1000.0);
+}
+
 PathTraceWorkCPU::PathTraceWorkCPU(Device *device,
                                    Film *film,
                                    DeviceScene *device_scene,
@@ -67,15 +83,30 @@ void PathTraceWorkCPU::init_execution()
 {
   /* Cache per-thread kernel globals. */
   device_->get_cpu_kernel_thread_globals(kernel_thread_globals_);
+
+  /* Path states of the wavefront integrator are allocated on demand by the threads using them. */
+  wavefront_thread_states_.clear();
+  wavefront_thread_states_.resize(kernel_thread_globals_.size());
 }
 
 void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
                                       int start_sample,
                                       int samples_num)
 {
-  const int64_t image_width = effective_buffer_params_.width;
-  const int64_t image_height = effective_buffer_params_.height;
-  const int64_t total_pixels_num = image_width * image_height;
+  const int image_width = effective_buffer_params_.width;
+  const int image_height = effective_buffer_params_.height;
+
+  /* Schedule small square tiles rather than individual pixels, so that rays of neighbor pixels
+   * are traced on the same thread, sharing BVH nodes and textures in its caches. */
+  const int tile_size = clamp(DebugFlags().cpu.work_tile_size, 1, kMaxWorkTileSize);
+  const int2 num_tiles = make_int2(divide_up(image_width, tile_size),
+                                   divide_up(image_height, tile_size));
+  if (num_tiles.x != work_tiles_num_.x || num_tiles.y != work_tiles_num_.y) {
+    work_tiles_order_ = tile_calculate_morton_order(num_tiles);
+    work_tiles_num_ = num_tiles;
+  }
+
+  const bool use_wavefront = DebugFlags().cpu.wavefront;
 
   for (CPUKernelThreadGlobals &kernel_globals : kernel_thread_globals_) {
     kernel_globals.start_profiling();
@@ -83,19 +114,20 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
 
   tbb::task_arena local_arena = local_tbb_arena_create(device_);
   local_arena.execute([&]() {
-    tbb::parallel_for(int64_t(0), total_pixels_num, [&](int64_t work_index) {
+    tbb::parallel_for(int64_t(0), int64_t(work_tiles_order_.size()), [&](int64_t work_index) {
       if (is_cancel_requested()) {
         return;
       }
 
-      const int y = work_index / image_width;
-      const int x = work_index - y * image_width;
+      const int2 tile = work_tiles_order_[work_index];
+      const int x = tile.x * tile_size;
+      const int y = tile.y * tile_size;
 
       KernelWorkTile work_tile;
       work_tile.x = effective_buffer_params_.full_x + x;
       work_tile.y = effective_buffer_params_.full_y + y;
-      work_tile.w = 1;
-      work_tile.h = 1;
+      work_tile.w = min(tile_size, image_width - x);
+      work_tile.h = min(tile_size, image_height - y);
       work_tile.start_sample = start_sample;
       work_tile.num_samples = 1;
       work_tile.offset = effective_buffer_params_.offset;
@@ -103,7 +135,12 @@ void PathTraceWorkCPU::render_samples(RenderStatistics &statistics,
 
       CPUKernelThreadGlobals *kernel_globals = kernel_thread_globals_get(kernel_thread_globals_);
 
-      render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      if (use_wavefront) {
+        render_samples_wavefront(kernel_globals, work_tile, samples_num);
+      }
+      else {
+        render_samples_full_pipeline(kernel_globals, work_tile, samples_num);
+      }
     });
   });
 
@@ -133,31 +170,263 @@ void PathTraceWorkCPU::render_samples_full_pipeline(KernelGlobals *kernel_global
   KernelWorkTile sample_work_tile = work_tile;
   float *render_buffer = buffers_->buffer.data();
 
-  for (int sample = 0; sample < samples_num; ++sample) {
+  const int pass_stride = effective_buffer_params_.pass_stride;
+  const int render_time_offset = effective_buffer_params_.get_pass_offset(PASS_RENDER_TIME);
+
+  /* Pixels which do not need more samples (converged, or have nothing to bake). */
+  const int num_pixels = work_tile.w * work_tile.h;
+  DCHECK_LE(num_pixels, kMaxWorkTileSize * kMaxWorkTileSize);
+  bool pixel_done[kMaxWorkTileSize * kMaxWorkTileSize] = {false};
+  int num_active_pixels = num_pixels;
+
+  /* Samples are interleaved within the tile: every pixel of the tile gets a sample before moving
+   * to the next one, so that consecutive paths start close to each other. */
+  for (int sample = 0; sample < samples_num && num_active_pixels; ++sample) {
     if (is_cancel_requested()) {
       break;
     }
 
-    if (has_bake) {
-      if (!kernels_.integrator_init_from_bake(
-              kernel_globals, state, &sample_work_tile, render_buffer)) {
-        break;
+    sample_work_tile.start_sample = work_tile.start_sample + sample;
+
+    for (int pixel_index = 0; pixel_index < num_pixels; ++pixel_index) {
+      if (pixel_done[pixel_index]) {
+        continue;
+      }
+
+      const int y = pixel_index / work_tile.w;
+      const int x = pixel_index - y * work_tile.w;
+      sample_work_tile.x = work_tile.x + x;
+      sample_work_tile.y = work_tile.y + y;
+
+      const double pixel_start_time = (render_time_offset != PASS_UNUSED) ? time_dt() : 0.0;
+
+      if (has_bake) {
+        if (!kernels_.integrator_init_from_bake(
+                kernel_globals, state, &sample_work_tile, render_buffer)) {
+          pixel_done[pixel_index] = true;
+          --num_active_pixels;
+          continue;
+        }
+      }
+      else {
+        if (!kernels_.integrator_init_from_camera(
+                kernel_globals, state, &sample_work_tile, render_buffer)) {
+          pixel_done[pixel_index] = true;
+          --num_active_pixels;
+          continue;
+        }
+      }
+
+      kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
+
+      if (shadow_catcher_state) {
+        kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+      }
+
+      if (render_time_offset != PASS_UNUSED) {
+        render_time_pass_add(render_buffer,
+                             sample_work_tile,
+                             pass_stride,
+                             render_time_offset,
+                             time_dt() - pixel_start_time);
       }
     }
-    else {
-      if (!kernels_.integrator_init_from_camera(
-              kernel_globals, state, &sample_work_tile, render_buffer)) {
-        break;
+  }
+}
+
+void PathTraceWorkCPU::render_samples_wavefront(KernelGlobals *kernel_globals,
+                                                const KernelWorkTile &work_tile,
+                                                const int samples_num)
+{
+  const bool has_bake = device_scene_->data.bake.use;
+  const bool has_shadow_catcher = device_scene_->data.integrator.has_shadow_catcher;
+
+  /* Shadow catcher split writes to the state which follows the main path state, so every main
+   * path state is followed by its shadow catcher state. */
+  const int num_pixels = work_tile.w * work_tile.h;
+  const int num_states_per_pixel = has_shadow_catcher ? 2 : 1;
+  const int num_states = num_pixels * num_states_per_pixel;
+  DCHECK_LE(num_pixels, kMaxWorkTileSize * kMaxWorkTileSize);
+
+  const int thread_index = tbb::this_task_arena::current_thread_index();
+  vector<IntegratorStateCPU> &states = wavefront_thread_states_[thread_index];
+  if (states.size() < num_states) {
+    states.resize(num_states);
+  }
+
+  KernelWorkTile sample_work_tile = work_tile;
+  float *render_buffer = buffers_->buffer.data();
+
+  /* Pixels which do not need more samples (converged, or have nothing to bake). */
+  bool pixel_done[kMaxWorkTileSize * kMaxWorkTileSize] = {false};
+  int num_active_pixels = num_pixels;
+
+  /* Indices of states queued for a shading kernel. */
+  int shade_queue[kMaxWorkTileSize * kMaxWorkTileSize * 2];
+
+  /* Paths of the tile are advanced together, so the time of a sample is distributed evenly
+   * between the pixels which were sampled. */
+  const int pass_stride = effective_buffer_params_.pass_stride;
+  const int render_time_offset = effective_buffer_params_.get_pass_offset(PASS_RENDER_TIME);
+
+  for (int sample = 0; sample < samples_num && num_active_pixels; ++sample) {
+    if (is_cancel_requested()) {
+      break;
+    }
+
+    sample_work_tile.start_sample = work_tile.start_sample + sample;
+
+    const double sample_start_time = (render_time_offset != PASS_UNUSED) ? time_dt() : 0.0;
+
+    /* Initialize paths of all pixels of the tile for this sample. */
+    for (int pixel_index = 0; pixel_index < num_pixels; ++pixel_index) {
+      IntegratorStateCPU *state = &states[pixel_index * num_states_per_pixel];
+
+      /* Paths of pixels which are not sampled are to stay terminated. */
+      path_state_init_queues(kernel_globals, state);
+      if (has_shadow_catcher) {
+        path_state_init_queues(kernel_globals, state + 1);
+      }
+
+      if (pixel_done[pixel_index]) {
+        continue;
+      }
+
+      const int y = pixel_index / work_tile.w;
+      const int x = pixel_index - y * work_tile.w;
+      sample_work_tile.x = work_tile.x + x;
+      sample_work_tile.y = work_tile.y + y;
+
+      bool is_initialized;
+      if (has_bake) {
+        is_initialized = kernels_.integrator_init_from_bake(
+            kernel_globals, state, &sample_work_tile, render_buffer);
+      }
+      else {
+        is_initialized = kernels_.integrator_init_from_camera(
+            kernel_globals, state, &sample_work_tile, render_buffer);
+      }
+      if (!is_initialized) {
+        pixel_done[pixel_index] = true;
+        --num_active_pixels;
       }
     }
 
-    kernels_.integrator_megakernel(kernel_globals, state, render_buffer);
+    /* Advance all paths of the tile one kernel at a time, until all of them are terminated. */
+    while (true) {
+      bool has_queued_kernels = false;
+
+      /* First handle all shadow paths, before shading kernels potentially create more. */
+      bool has_queued_shadow_kernels = true;
+      while (has_queued_shadow_kernels) {
+        has_queued_shadow_kernels = false;
+        for (int i = 0; i < num_states; ++i) {
+          IntegratorStateCPU *state = &states[i];
+          if (state->shadow_path.queued_kernel == DEVICE_KERNEL_INTEGRATOR_INTERSECT_SHADOW) {
+            kernels_.integrator_intersect_shadow(kernel_globals, state);
+          }
+        }
+        for (int i = 0; i < num_states; ++i) {
+          IntegratorStateCPU *state = &states[i];
+          if (state->shadow_path.queued_kernel == DEVICE_KERNEL_INTEGRATOR_SHADE_SHADOW) {
+            kernels_.integrator_shade_shadow(kernel_globals, state, render_buffer);
+          }
+          has_queued_shadow_kernels |= (state->shadow_path.queued_kernel != 0);
+        }
+      }
+
+      /* Intersect rays of all paths, and gather paths which are to be shaded. */
+      int num_shade_queued = 0;
+      for (int i = 0; i < num_states; ++i) {
+        IntegratorStateCPU *state = &states[i];
+        switch (state->path.queued_kernel) {
+          case 0:
+            continue;
+          case DEVICE_KERNEL_INTEGRATOR_INTERSECT_CLOSEST:
+            kernels_.integrator_intersect_closest(kernel_globals, state);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_INTERSECT_SUBSURFACE:
+            kernels_.integrator_intersect_subsurface(kernel_globals, state);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_INTERSECT_VOLUME_STACK:
+            kernels_.integrator_intersect_volume_stack(kernel_globals, state);
+            break;
+          default:
+            /* Shading kernel was queued by the previous iteration. */
+            break;
+        }
+        has_queued_kernels = true;
+      }
+      for (int i = 0; i < num_states; ++i) {
+        switch (states[i].path.queued_kernel) {
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+            shade_queue[num_shade_queued++] = i;
+            break;
+        }
+      }
+
+      if (!has_queued_kernels) {
+        break;
+      }
 
-    if (shadow_catcher_state) {
-      kernels_.integrator_megakernel(kernel_globals, shadow_catcher_state, render_buffer);
+      /* Execute shading kernels grouped by kernel and shader, so that consecutive invocations run
+       * the same code and access the same SVM program and textures. */
+      sort(shade_queue, shade_queue + num_shade_queued, [&](const int a, const int b) {
+        const IntegratorStateCPU &state_a = states[a];
+        const IntegratorStateCPU &state_b = states[b];
+        if (state_a.path.queued_kernel != state_b.path.queued_kernel) {
+          return state_a.path.queued_kernel < state_b.path.queued_kernel;
+        }
+        if (state_a.path.shader_sort_key != state_b.path.shader_sort_key) {
+          return state_a.path.shader_sort_key < state_b.path.shader_sort_key;
+        }
+        return a < b;
+      });
+
+      for (int i = 0; i < num_shade_queued; ++i) {
+        IntegratorStateCPU *state = &states[shade_queue[i]];
+        switch (state->path.queued_kernel) {
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_BACKGROUND:
+            kernels_.integrator_shade_background(kernel_globals, state, render_buffer);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_LIGHT:
+            kernels_.integrator_shade_light(kernel_globals, state, render_buffer);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE:
+            kernels_.integrator_shade_surface(kernel_globals, state, render_buffer);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_SURFACE_RAYTRACE:
+            kernels_.integrator_shade_surface_raytrace(kernel_globals, state, render_buffer);
+            break;
+          case DEVICE_KERNEL_INTEGRATOR_SHADE_VOLUME:
+            kernels_.integrator_shade_volume(kernel_globals, state, render_buffer);
+            break;
+          default:
+            LOG(DFATAL) << "Unhandled kernel " << state->path.queued_kernel
+                        << " in the shading queue, should never happen.";
+            break;
+        }
+      }
     }
 
-    ++sample_work_tile.start_sample;
+    if (render_time_offset != PASS_UNUSED && num_active_pixels) {
+      const double pixel_time = (time_dt() - sample_start_time) / num_active_pixels;
+      for (int pixel_index = 0; pixel_index < num_pixels; ++pixel_index) {
+        if (pixel_done[pixel_index]) {
+          continue;
+        }
+        const int y = pixel_index / work_tile.w;
+        const int x = pixel_index - y * work_tile.w;
+        sample_work_tile.x = work_tile.x + x;
+        sample_work_tile.y = work_tile.y + y;
+        render_time_pass_add(
+            render_buffer, sample_work_tile, pass_stride, render_time_offset, pixel_time);
+      }
+    }
   }
 }
 
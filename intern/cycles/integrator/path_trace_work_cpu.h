@@ -32,7 +32,7 @@ struct KernelGlobals;
 
 class CPUKernels;
 
-/* Implementation of PathTraceWork which schedules work on to queues pixel-by-pixel,
+/* Implementation of PathTraceWork which schedules work on to queues in small tiles of pixels,
  * for CPU devices.
  *
  * NOTE: For the CPU rendering there are assumptions about TBB arena size and number of concurrent
@@ -63,11 +63,21 @@ class PathTraceWorkCPU : public PathTraceWork {
   virtual void cryptomatte_postproces() override;
 
  protected:
+  /* Maximum size of a square tile of pixels which is rendered as a single work item. */
+  static constexpr int kMaxWorkTileSize = 16;
+
   /* Core path tracing routine. Renders given work time on the given queue. */
   void render_samples_full_pipeline(KernelGlobals *kernel_globals,
                                     const KernelWorkTile &work_tile,
                                     const int samples_num);
 
+  /* Wavefront path tracing routine: all paths of the work tile are advanced together one kernel
+   * at a time, with the shading kernels sorted by shader. Gives the same result as the full
+   * pipeline. */
+  void render_samples_wavefront(KernelGlobals *kernel_globals,
+                                const KernelWorkTile &work_tile,
+                                const int samples_num);
+
   /* CPU kernels. */
   const CPUKernels &kernels_;
 
@@ -77,6 +87,13 @@ class PathTraceWorkCPU : public PathTraceWork {
    * accessing it, but some "localization" is required to decouple from kernel globals stored
    * on the device level. */
   vector<CPUKernelThreadGlobals> kernel_thread_globals_;
+
+  /* Per-thread path states of the wavefront integrator, indexed by the TBB thread index. */
+  vector<vector<IntegratorStateCPU>> wavefront_thread_states_;
+
+  /* Order in which tiles are scheduled, cached for the number of tiles it was calculated for. */
+  vector<int2> work_tiles_order_;
+  int2 work_tiles_num_ = make_int2(0, 0);
 };
 
 CCL_NAMESPACE_END
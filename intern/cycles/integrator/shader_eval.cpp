@@ -95,33 +95,40 @@ bool ShaderEval::eval_cpu(Device *device,
   /* Find required kernel function. */
   const CPUKernels &kernels = *(device->get_cpu_kernels());
 
-  /* Simple parallel_for over all work items. */
+  /* Evaluate points in batches, so the kernel dispatch and the cancel check, which may call back
+   * into the host application, are done once for many points. */
   const int64_t work_size = output.size();
+  const int64_t batch_size = 256;
   KernelShaderEvalInput *input_data = input.data();
   float4 *output_data = output.data();
   bool success = true;
 
   tbb::task_arena local_arena(device->info.cpu_threads);
   local_arena.execute([&]() {
-    tbb::parallel_for(int64_t(0), work_size, [&](int64_t work_index) {
-      /* TODO: is this fast enough? */
-      if (progress_.get_cancel()) {
-        success = false;
-        return;
-      }
-
-      const int thread_index = tbb::this_task_arena::current_thread_index();
-      KernelGlobals *kg = &kernel_thread_globals[thread_index];
-
-      switch (type) {
-        case SHADER_EVAL_DISPLACE:
-          kernels.shader_eval_displace(kg, input_data, output_data, work_index);
-          break;
-        case SHADER_EVAL_BACKGROUND:
-          kernels.shader_eval_background(kg, input_data, output_data, work_index);
-          break;
-      }
-    });
+    parallel_for(blocked_range<int64_t>(0, work_size, batch_size),
+                 [&](const blocked_range<int64_t> &range) {
+                   if (progress_.get_cancel()) {
+                     success = false;
+                     return;
+                   }
+
+                   const int thread_index = tbb::this_task_arena::current_thread_index();
+                   KernelGlobals *kg = &kernel_thread_globals[thread_index];
+
+                   const int64_t offset = range.begin();
+                   const int64_t num_points = range.size();
+
+                   switch (type) {
+                     case SHADER_EVAL_DISPLACE:
+                       kernels.shader_eval_displace(
+                           kg, input_data, output_data, offset, num_points);
+                       break;
+                     case SHADER_EVAL_BACKGROUND:
+                       kernels.shader_eval_background(
+                           kg, input_data, output_data, offset, num_points);
+                       break;
+                   }
+                 });
   });
 
   return success;
@@ -16,6 +16,8 @@
 
 #include "integrator/tile.h"
 
+#include <algorithm>
+
 #include "util/util_logging.h"
 #include "util/util_math.h"
 
@@ -105,4 +107,51 @@ TileSize tile_calculate_best_size(const int2 &image_size,
   return tile_size;
 }
 
+/* Interleave the bits of x with zeros, so that bit i ends up at bit 2 * i. */
+ccl_device_inline uint64_t morton_spread_bits(uint32_t x)
+{
+  uint64_t v = x;
+  v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+  v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+  v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  v = (v | (v << 2)) & 0x3333333333333333ULL;
+  v = (v | (v << 1)) & 0x5555555555555555ULL;
+  return v;
+}
+
+vector<int2> tile_calculate_morton_order(const int2 &num_tiles)
+{
+  vector<int2> order;
+
+  if (num_tiles.x <= 0 || num_tiles.y <= 0) {
+    return order;
+  }
+
+  const size_t num_tiles_total = size_t(num_tiles.x) * num_tiles.y;
+
+  /* Sort the tiles by their 64-bit Morton code. This covers the full range of both axes, and
+   * unlike walking the curve of the covering power-of-two square it does not degrade for grids
+   * which are much wider than they are tall. */
+  vector<std::pair<uint64_t, int2>> codes;
+  codes.reserve(num_tiles_total);
+  for (int y = 0; y < num_tiles.y; ++y) {
+    for (int x = 0; x < num_tiles.x; ++x) {
+      const uint64_t code = morton_spread_bits(uint32_t(x)) |
+                            (morton_spread_bits(uint32_t(y)) << 1);
+      codes.emplace_back(code, make_int2(x, y));
+    }
+  }
+
+  std::sort(codes.begin(), codes.end(), [](const auto &a, const auto &b) {
+    return a.first < b.first;
+  });
+
+  order.reserve(num_tiles_total);
+  for (const auto &code : codes) {
+    order.push_back(code.second);
+  }
+
+  return order;
+}
+
 CCL_NAMESPACE_END
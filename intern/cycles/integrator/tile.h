@@ -19,6 +19,7 @@
 #include <ostream>
 
 #include "util/util_types.h"
+#include "util/util_vector.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -53,4 +54,11 @@ TileSize tile_calculate_best_size(const int2 &image_size,
                                   const int num_samples,
                                   const int max_num_path_states);
 
+/* Calculate order in which tiles of a grid with the given number of tiles are to be rendered.
+ * The tiles are visited along a Morton (Z-order) curve, so that tiles which are close in the
+ * schedule are also close in the image, and threads which pick up neighbor work items trace rays
+ * hitting the same BVH nodes and textures.
+ * The result contains tile coordinates in the grid (not in pixels). */
+vector<int2> tile_calculate_morton_order(const int2 &num_tiles);
+
 CCL_NAMESPACE_END
@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include <OpenImageIO/texture.h>
+
 #ifdef WITH_NANOVDB
 #  define NANOVDB_USE_INTRINSICS
 #  include <nanovdb/NanoVDB.h>
@@ -583,6 +585,102 @@ template<typename T> struct NanoVDBInterpolator {
 
 #undef SET_CUBIC_SPLINE_WEIGHTS
 
+/* Lookup of an image which is read on demand through the OpenImageIO texture cache. The mipmap
+ * level is chosen from the derivatives of the texture coordinates, zero derivatives sample the
+ * full resolution image. */
+ccl_device float4 kernel_tex_image_texture_cache(const TextureInfo &info,
+                                                 float x,
+                                                 float y,
+                                                 const float2 duv_dx,
+                                                 const float2 duv_dy)
+{
+  const TextureCacheImage *cache_image = (const TextureCacheImage *)info.data;
+  OIIO::TextureSystem *texture_system = (OIIO::TextureSystem *)cache_image->texture_system;
+  OIIO::TextureSystem::TextureHandle *texture_handle =
+      (OIIO::TextureSystem::TextureHandle *)cache_image->texture_handle;
+
+  OIIO::TextureOpt options;
+  switch (info.interpolation) {
+    case INTERPOLATION_CLOSEST:
+      /* Keep pixels sharp, as with images stored in device memory. */
+      options.interpmode = OIIO::TextureOpt::InterpClosest;
+      options.mipmode = OIIO::TextureOpt::MipModeNoMIP;
+      break;
+    case INTERPOLATION_LINEAR:
+      options.interpmode = OIIO::TextureOpt::InterpBilinear;
+      options.mipmode = OIIO::TextureOpt::MipModeTrilinear;
+      break;
+    default:
+      options.interpmode = OIIO::TextureOpt::InterpBicubic;
+      options.mipmode = OIIO::TextureOpt::MipModeTrilinear;
+      break;
+  }
+  if (cache_image->min_filter_width > 0.0f) {
+    /* Texture size limit, read from the mipmap level which matches it. */
+    options.sblur = cache_image->min_filter_width;
+    options.tblur = cache_image->min_filter_width;
+    if (options.mipmode == OIIO::TextureOpt::MipModeNoMIP) {
+      options.mipmode = OIIO::TextureOpt::MipModeOneLevel;
+    }
+  }
+  switch (info.extension) {
+    case EXTENSION_REPEAT:
+      options.swrap = OIIO::TextureOpt::WrapPeriodic;
+      options.twrap = OIIO::TextureOpt::WrapPeriodic;
+      break;
+    case EXTENSION_EXTEND:
+      options.swrap = OIIO::TextureOpt::WrapClamp;
+      options.twrap = OIIO::TextureOpt::WrapClamp;
+      break;
+    default:
+      options.swrap = OIIO::TextureOpt::WrapBlack;
+      options.twrap = OIIO::TextureOpt::WrapBlack;
+      break;
+  }
+
+  /* Images in device memory are stored bottom to top, the texture cache uses the file order. */
+  const int num_channels = cache_image->num_channels;
+  float result[4];
+  if (!texture_system->texture(texture_handle,
+                               NULL,
+                               options,
+                               x,
+                               1.0f - y,
+                               duv_dx.x,
+                               -duv_dx.y,
+                               duv_dy.x,
+                               -duv_dy.y,
+                               num_channels,
+                               result)) {
+    return make_float4(
+        TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
+  }
+
+  /* Expand to RGBA and avoid buggy values the same way as images in device memory do, where all
+   * channels are set to 0 if either of them is not finite. */
+  float4 color;
+  switch (num_channels) {
+    case 1: {
+      const float value = ensure_finite(result[0]);
+      return make_float4(value, value, value, 1.0f);
+    }
+    case 2:
+      color = make_float4(result[0], result[0], result[0], result[1]);
+      break;
+    case 3:
+      color = make_float4(result[0], result[1], result[2], 1.0f);
+      break;
+    default:
+      color = make_float4(result[0], result[1], result[2], result[3]);
+      break;
+  }
+  if (!isfinite_safe(color.x) || !isfinite_safe(color.y) || !isfinite_safe(color.z) ||
+      !isfinite_safe(color.w)) {
+    return zero_float4();
+  }
+  return color;
+}
+
 ccl_device float4 kernel_tex_image_interp(const KernelGlobals *kg, int id, float x, float y)
 {
   const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
@@ -604,6 +702,8 @@ ccl_device float4 kernel_tex_image_interp(const KernelGlobals *kg, int id, float
       return TextureInterpolator<ushort4>::interp(info, x, y);
     case IMAGE_DATA_TYPE_FLOAT4:
       return TextureInterpolator<float4>::interp(info, x, y);
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return kernel_tex_image_texture_cache(info, x, y, zero_float2(), zero_float2());
     default:
       assert(0);
       return make_float4(
@@ -611,6 +711,20 @@ ccl_device float4 kernel_tex_image_interp(const KernelGlobals *kg, int id, float
   }
 }
 
+/* Same as kernel_tex_image_interp, with derivatives of the texture coordinates for filtering.
+ * Only images in the texture cache are filtered. */
+ccl_device float4 kernel_tex_image_interp_filtered(
+    const KernelGlobals *kg, int id, float x, float y, const float2 duv_dx, const float2 duv_dy)
+{
+  const TextureInfo &info = kernel_tex_fetch(__texture_info, id);
+
+  if (info.data_type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    return kernel_tex_image_texture_cache(info, x, y, duv_dx, duv_dy);
+  }
+
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(const KernelGlobals *kg,
                                              int id,
                                              float3 P,
@@ -45,6 +45,7 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_background);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_light);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_shadow);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface);
+KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_surface_raytrace);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(shade_volume);
 KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
 
@@ -56,14 +57,17 @@ KERNEL_INTEGRATOR_SHADE_FUNCTION(megakernel);
  * Shader evaluation.
  */
 
+/* Evaluate work_size points starting at offset. */
 void KERNEL_FUNCTION_FULL_NAME(shader_eval_background)(const KernelGlobals *kg,
                                                        const KernelShaderEvalInput *input,
                                                        float4 *output,
-                                                       const int offset);
+                                                       const int64_t offset,
+                                                       const int64_t work_size);
 void KERNEL_FUNCTION_FULL_NAME(shader_eval_displace)(const KernelGlobals *kg,
                                                      const KernelShaderEvalInput *input,
                                                      float4 *output,
-                                                     const int offset);
+                                                     const int64_t offset,
+                                                     const int64_t work_size);
 
 /* --------------------------------------------------------------------
  * Adaptive sampling.
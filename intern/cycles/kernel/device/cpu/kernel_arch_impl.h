@@ -105,6 +105,7 @@ DEFINE_INTEGRATOR_SHADE_KERNEL(shade_background)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_light)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_shadow)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface)
+DEFINE_INTEGRATOR_SHADE_KERNEL(shade_surface_raytrace)
 DEFINE_INTEGRATOR_SHADE_KERNEL(shade_volume)
 DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 
@@ -115,24 +116,36 @@ DEFINE_INTEGRATOR_SHADE_KERNEL(megakernel)
 void KERNEL_FUNCTION_FULL_NAME(shader_eval_displace)(const KernelGlobals *kg,
                                                      const KernelShaderEvalInput *input,
                                                      float4 *output,
-                                                     const int offset)
+                                                     const int64_t offset,
+                                                     const int64_t work_size)
 {
 #ifdef KERNEL_STUB
   STUB_ASSERT(KERNEL_ARCH, shader_eval_displace);
 #else
-  kernel_displace_evaluate(kg, input, output, offset);
+  /* Offset the arrays rather than the point index, which is an int in the kernel. */
+  input += offset;
+  output += offset;
+  for (int64_t i = 0; i < work_size; i++) {
+    kernel_displace_evaluate(kg, input, output, (int)i);
+  }
 #endif
 }
 
 void KERNEL_FUNCTION_FULL_NAME(shader_eval_background)(const KernelGlobals *kg,
                                                        const KernelShaderEvalInput *input,
                                                        float4 *output,
-                                                       const int offset)
+                                                       const int64_t offset,
+                                                       const int64_t work_size)
 {
 #ifdef KERNEL_STUB
   STUB_ASSERT(KERNEL_ARCH, shader_eval_background);
 #else
-  kernel_background_evaluate(kg, input, output, offset);
+  /* Offset the arrays rather than the point index, which is an int in the kernel. */
+  input += offset;
+  output += offset;
+  for (int64_t i = 0; i < work_size; i++) {
+    kernel_background_evaluate(kg, input, output, (int)i);
+  }
 #endif
 }
 
@@ -221,6 +221,13 @@ ccl_device float4 kernel_tex_image_interp(const KernelGlobals *kg, int id, float
   }
 }
 
+/* The texture cache is not available on the GPU, so there is nothing to filter. */
+ccl_device float4 kernel_tex_image_interp_filtered(
+    const KernelGlobals *kg, int id, float x, float y, const float2 duv_dx, const float2 duv_dy)
+{
+  return kernel_tex_image_interp(kg, id, x, y);
+}
+
 ccl_device float4 kernel_tex_image_interp_3d(const KernelGlobals *kg,
                                              int id,
                                              float3 P,
@@ -17,8 +17,8 @@
 #pragma once
 
 // clang-format off
-#include "kernel/geom/geom_attribute.h"
 #include "kernel/geom/geom_object.h"
+#include "kernel/geom/geom_attribute.h"
 #ifdef __PATCH_EVAL__
 #  include "kernel/geom/geom_patch.h"
 #endif
@@ -50,7 +50,7 @@ ccl_device_inline AttributeDescriptor attribute_not_found()
 
 ccl_device_inline uint object_attribute_map_offset(const KernelGlobals *kg, int object)
 {
-  return kernel_tex_fetch(__objects, object).attribute_map_offset;
+  return object_fetch_data(kg, object)->attribute_map_offset;
 }
 
 ccl_device_inline AttributeDescriptor find_attribute(const KernelGlobals *kg,
@@ -98,6 +98,50 @@ ccl_device_inline AttributeDescriptor find_attribute(const KernelGlobals *kg,
   return desc;
 }
 
+/* Fetch attribute data of a triangle mesh, which may be quantized when the scene uses
+ * quantized attributes. Quantized data is stored bitwise in the float arrays. */
+
+ccl_device_inline float2 attribute_data_float2(const KernelGlobals *kg,
+                                               const AttributeDescriptor desc,
+                                               int offset)
+{
+  if (desc.flags & ATTR_QUANTIZED_HALF) {
+    const uint h = __float_as_uint(kernel_tex_fetch(__attributes_float, offset));
+    return make_float2(half_bits_to_float(h & 0xffff), half_bits_to_float(h >> 16));
+  }
+  return kernel_tex_fetch(__attributes_float2, offset);
+}
+
+ccl_device_inline float4 attribute_data_float4(const KernelGlobals *kg,
+                                               const AttributeDescriptor desc,
+                                               int offset)
+{
+  if (desc.flags & ATTR_QUANTIZED_HALF) {
+    const float2 f = kernel_tex_fetch(__attributes_float2, offset);
+    const uint h0 = __float_as_uint(f.x), h1 = __float_as_uint(f.y);
+    return make_float4(half_bits_to_float(h0 & 0xffff),
+                       half_bits_to_float(h0 >> 16),
+                       half_bits_to_float(h1 & 0xffff),
+                       half_bits_to_float(h1 >> 16));
+  }
+  else if (desc.flags & ATTR_QUANTIZED_OCTAHEDRAL) {
+    const float3 n = octahedral_to_float3(
+        __float_as_uint(kernel_tex_fetch(__attributes_float, offset)));
+    return make_float4(n.x, n.y, n.z, 0.0f);
+  }
+  return kernel_tex_fetch(__attributes_float3, offset);
+}
+
+ccl_device_inline float3 attribute_data_float3(const KernelGlobals *kg,
+                                               const AttributeDescriptor desc,
+                                               int offset)
+{
+  if (desc.flags & ATTR_QUANTIZED_OCTAHEDRAL) {
+    return octahedral_to_float3(__float_as_uint(kernel_tex_fetch(__attributes_float, offset)));
+  }
+  return float4_to_float3(attribute_data_float4(kg, desc, offset));
+}
+
 /* Transform matrix attribute on meshes */
 
 ccl_device Transform primitive_attribute_matrix(const KernelGlobals *kg,
@@ -35,12 +35,28 @@ enum ObjectTransform {
 
 enum ObjectVectorTransform { OBJECT_PASS_MOTION_PRE = 0, OBJECT_PASS_MOTION_POST = 1 };
 
+/* Object data, shared with other instances of the same prototype in compact instancing mode. */
+
+ccl_device_inline const ccl_global KernelObject *object_fetch_data(const KernelGlobals *kg,
+                                                                  int object)
+{
+  if (kernel_data.bvh.use_compact_instances) {
+    object = kernel_tex_fetch(__object_instances, object).prototype;
+  }
+  return &kernel_tex_fetch(__objects, object);
+}
+
 /* Object to world space transformation */
 
 ccl_device_inline Transform object_fetch_transform(const KernelGlobals *kg,
                                                    int object,
                                                    enum ObjectTransform type)
 {
+  if (kernel_data.bvh.use_compact_instances) {
+    const Transform tfm = kernel_tex_fetch(__object_instances, object).tfm;
+    return (type == OBJECT_INVERSE_TRANSFORM) ? transform_quick_inverse(tfm) : tfm;
+  }
+
   if (type == OBJECT_INVERSE_TRANSFORM) {
     return kernel_tex_fetch(__objects, object).itfm;
   }
@@ -78,9 +94,10 @@ ccl_device_inline Transform object_fetch_transform_motion(const KernelGlobals *k
                                                           int object,
                                                           float time)
 {
-  const uint motion_offset = kernel_tex_fetch(__objects, object).motion_offset;
+  const ccl_global KernelObject *kobject = object_fetch_data(kg, object);
+  const uint motion_offset = kobject->motion_offset;
   const ccl_global DecomposedTransform *motion = &kernel_tex_fetch(__object_motion, motion_offset);
-  const uint num_steps = kernel_tex_fetch(__objects, object).numsteps * 2 + 1;
+  const uint num_steps = kobject->numsteps * 2 + 1;
 
   Transform tfm;
   transform_motion_array_interpolate(&tfm, motion, num_steps, time);
@@ -271,7 +288,7 @@ ccl_device_inline float3 object_color(const KernelGlobals *kg, int object)
   if (object == OBJECT_NONE)
     return make_float3(0.0f, 0.0f, 0.0f);
 
-  const ccl_global KernelObject *kobject = &kernel_tex_fetch(__objects, object);
+  const ccl_global KernelObject *kobject = object_fetch_data(kg, object);
   return make_float3(kobject->color[0], kobject->color[1], kobject->color[2]);
 }
 
@@ -282,7 +299,7 @@ ccl_device_inline float object_pass_id(const KernelGlobals *kg, int object)
   if (object == OBJECT_NONE)
     return 0.0f;
 
-  return kernel_tex_fetch(__objects, object).pass_id;
+  return object_fetch_data(kg, object)->pass_id;
 }
 
 /* Per lamp random number for shader variation */
@@ -302,6 +319,10 @@ ccl_device_inline float object_random_number(const KernelGlobals *kg, int object
   if (object == OBJECT_NONE)
     return 0.0f;
 
+  if (kernel_data.bvh.use_compact_instances) {
+    return kernel_tex_fetch(__object_instances, object).random_number;
+  }
+
   return kernel_tex_fetch(__objects, object).random_number;
 }
 
@@ -312,7 +333,7 @@ ccl_device_inline int object_particle_id(const KernelGlobals *kg, int object)
   if (object == OBJECT_NONE)
     return 0;
 
-  return kernel_tex_fetch(__objects, object).particle_index;
+  return object_fetch_data(kg, object)->particle_index;
 }
 
 /* Generated texture coordinate on surface from where object was instanced */
@@ -322,7 +343,7 @@ ccl_device_inline float3 object_dupli_generated(const KernelGlobals *kg, int obj
   if (object == OBJECT_NONE)
     return make_float3(0.0f, 0.0f, 0.0f);
 
-  const ccl_global KernelObject *kobject = &kernel_tex_fetch(__objects, object);
+  const ccl_global KernelObject *kobject = object_fetch_data(kg, object);
   return make_float3(
       kobject->dupli_generated[0], kobject->dupli_generated[1], kobject->dupli_generated[2]);
 }
@@ -334,7 +355,7 @@ ccl_device_inline float3 object_dupli_uv(const KernelGlobals *kg, int object)
   if (object == OBJECT_NONE)
     return make_float3(0.0f, 0.0f, 0.0f);
 
-  const ccl_global KernelObject *kobject = &kernel_tex_fetch(__objects, object);
+  const ccl_global KernelObject *kobject = object_fetch_data(kg, object);
   return make_float3(kobject->dupli_uv[0], kobject->dupli_uv[1], 0.0f);
 }
 
@@ -343,14 +364,16 @@ ccl_device_inline float3 object_dupli_uv(const KernelGlobals *kg, int object)
 ccl_device_inline void object_motion_info(
     const KernelGlobals *kg, int object, int *numsteps, int *numverts, int *numkeys)
 {
+  const ccl_global KernelObject *kobject = object_fetch_data(kg, object);
+
   if (numkeys) {
-    *numkeys = kernel_tex_fetch(__objects, object).numkeys;
+    *numkeys = kobject->numkeys;
   }
 
   if (numsteps)
-    *numsteps = kernel_tex_fetch(__objects, object).numsteps;
+    *numsteps = kobject->numsteps;
   if (numverts)
-    *numverts = kernel_tex_fetch(__objects, object).numverts;
+    *numverts = kobject->numverts;
 }
 
 /* Offset to an objects patch map */
@@ -360,7 +383,7 @@ ccl_device_inline uint object_patch_map_offset(const KernelGlobals *kg, int obje
   if (object == OBJECT_NONE)
     return 0;
 
-  return kernel_tex_fetch(__objects, object).patch_map_offset;
+  return object_fetch_data(kg, object)->patch_map_offset;
 }
 
 /* Volume step size */
@@ -371,7 +394,7 @@ ccl_device_inline float object_volume_density(const KernelGlobals *kg, int objec
     return 1.0f;
   }
 
-  return kernel_tex_fetch(__objects, object).volume_density;
+  return object_fetch_data(kg, object)->volume_density;
 }
 
 ccl_device_inline float object_volume_step_size(const KernelGlobals *kg, int object)
@@ -397,7 +420,7 @@ ccl_device_inline float object_cryptomatte_id(const KernelGlobals *kg, int objec
   if (object == OBJECT_NONE)
     return 0.0f;
 
-  return kernel_tex_fetch(__objects, object).cryptomatte_object;
+  return object_fetch_data(kg, object)->cryptomatte_object;
 }
 
 ccl_device_inline float object_cryptomatte_asset_id(const KernelGlobals *kg, int object)
@@ -405,7 +428,7 @@ ccl_device_inline float object_cryptomatte_asset_id(const KernelGlobals *kg, int
   if (object == OBJECT_NONE)
     return 0;
 
-  return kernel_tex_fetch(__objects, object).cryptomatte_asset;
+  return object_fetch_data(kg, object)->cryptomatte_asset;
 }
 
 /* Particle data from which object was instanced */
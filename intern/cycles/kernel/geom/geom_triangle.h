@@ -73,6 +73,16 @@ ccl_device_inline void triangle_point_normal(const KernelGlobals *kg,
   *shader = kernel_tex_fetch(__tri_shader, prim);
 }
 
+/* Vertex normal, stored quantized when the scene uses quantized attributes. */
+
+ccl_device_inline float3 triangle_vertex_normal(const KernelGlobals *kg, uint vert)
+{
+  if (kernel_data.bvh.use_quantized_normals) {
+    return octahedral_to_float3(kernel_tex_fetch(__tri_vnormal_quantized, vert));
+  }
+  return float4_to_float3(kernel_tex_fetch(__tri_vnormal, vert));
+}
+
 /* Triangle vertex locations */
 
 ccl_device_inline void triangle_vertices(const KernelGlobals *kg, int prim, float3 P[3])
@@ -94,9 +104,9 @@ ccl_device_inline void triangle_vertices_and_normals(const KernelGlobals *kg,
   P[0] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 0));
   P[1] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 1));
   P[2] = float4_to_float3(kernel_tex_fetch(__prim_tri_verts, tri_vindex.w + 2));
-  N[0] = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.x));
-  N[1] = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.y));
-  N[2] = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.z));
+  N[0] = triangle_vertex_normal(kg, tri_vindex.x);
+  N[1] = triangle_vertex_normal(kg, tri_vindex.y);
+  N[2] = triangle_vertex_normal(kg, tri_vindex.z);
 }
 
 /* Interpolate smooth vertex normal from vertices */
@@ -106,9 +116,9 @@ triangle_smooth_normal(const KernelGlobals *kg, float3 Ng, int prim, float u, fl
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 n0 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.x));
-  float3 n1 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.y));
-  float3 n2 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.z));
+  float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   float3 N = safe_normalize((1.0f - u - v) * n2 + u * n0 + v * n1);
 
@@ -120,9 +130,9 @@ ccl_device_inline float3 triangle_smooth_normal_unnormalized(
 {
   /* load triangle vertices */
   const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, prim);
-  float3 n0 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.x));
-  float3 n1 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.y));
-  float3 n2 = float4_to_float3(kernel_tex_fetch(__tri_vnormal, tri_vindex.z));
+  float3 n0 = triangle_vertex_normal(kg, tri_vindex.x);
+  float3 n1 = triangle_vertex_normal(kg, tri_vindex.y);
+  float3 n2 = triangle_vertex_normal(kg, tri_vindex.z);
 
   /* ensure that the normals are in object space */
   if (sd->object_flag & SD_OBJECT_TRANSFORM_APPLIED) {
@@ -217,15 +227,15 @@ ccl_device float2 triangle_attribute_float2(const KernelGlobals *kg,
 
     if (desc.element & (ATTR_ELEMENT_VERTEX | ATTR_ELEMENT_VERTEX_MOTION)) {
       const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-      f0 = kernel_tex_fetch(__attributes_float2, desc.offset + tri_vindex.x);
-      f1 = kernel_tex_fetch(__attributes_float2, desc.offset + tri_vindex.y);
-      f2 = kernel_tex_fetch(__attributes_float2, desc.offset + tri_vindex.z);
+      f0 = attribute_data_float2(kg, desc, desc.offset + tri_vindex.x);
+      f1 = attribute_data_float2(kg, desc, desc.offset + tri_vindex.y);
+      f2 = attribute_data_float2(kg, desc, desc.offset + tri_vindex.z);
     }
     else {
       const int tri = desc.offset + sd->prim * 3;
-      f0 = kernel_tex_fetch(__attributes_float2, tri + 0);
-      f1 = kernel_tex_fetch(__attributes_float2, tri + 1);
-      f2 = kernel_tex_fetch(__attributes_float2, tri + 2);
+      f0 = attribute_data_float2(kg, desc, tri + 0);
+      f1 = attribute_data_float2(kg, desc, tri + 1);
+      f2 = attribute_data_float2(kg, desc, tri + 2);
     }
 
 #ifdef __RAY_DIFFERENTIALS__
@@ -248,7 +258,7 @@ ccl_device float2 triangle_attribute_float2(const KernelGlobals *kg,
     if (desc.element & (ATTR_ELEMENT_FACE | ATTR_ELEMENT_OBJECT | ATTR_ELEMENT_MESH)) {
       const int offset = (desc.element == ATTR_ELEMENT_FACE) ? desc.offset + sd->prim :
                                                                desc.offset;
-      return kernel_tex_fetch(__attributes_float2, offset);
+      return attribute_data_float2(kg, desc, offset);
     }
     else {
       return make_float2(0.0f, 0.0f);
@@ -267,15 +277,15 @@ ccl_device float3 triangle_attribute_float3(const KernelGlobals *kg,
 
     if (desc.element & (ATTR_ELEMENT_VERTEX | ATTR_ELEMENT_VERTEX_MOTION)) {
       const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-      f0 = float4_to_float3(kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.x));
-      f1 = float4_to_float3(kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.y));
-      f2 = float4_to_float3(kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.z));
+      f0 = attribute_data_float3(kg, desc, desc.offset + tri_vindex.x);
+      f1 = attribute_data_float3(kg, desc, desc.offset + tri_vindex.y);
+      f2 = attribute_data_float3(kg, desc, desc.offset + tri_vindex.z);
     }
     else {
       const int tri = desc.offset + sd->prim * 3;
-      f0 = float4_to_float3(kernel_tex_fetch(__attributes_float3, tri + 0));
-      f1 = float4_to_float3(kernel_tex_fetch(__attributes_float3, tri + 1));
-      f2 = float4_to_float3(kernel_tex_fetch(__attributes_float3, tri + 2));
+      f0 = attribute_data_float3(kg, desc, tri + 0);
+      f1 = attribute_data_float3(kg, desc, tri + 1);
+      f2 = attribute_data_float3(kg, desc, tri + 2);
     }
 
 #ifdef __RAY_DIFFERENTIALS__
@@ -298,7 +308,7 @@ ccl_device float3 triangle_attribute_float3(const KernelGlobals *kg,
     if (desc.element & (ATTR_ELEMENT_FACE | ATTR_ELEMENT_OBJECT | ATTR_ELEMENT_MESH)) {
       const int offset = (desc.element == ATTR_ELEMENT_FACE) ? desc.offset + sd->prim :
                                                                desc.offset;
-      return float4_to_float3(kernel_tex_fetch(__attributes_float3, offset));
+      return attribute_data_float3(kg, desc, offset);
     }
     else {
       return make_float3(0.0f, 0.0f, 0.0f);
@@ -318,16 +328,16 @@ ccl_device float4 triangle_attribute_float4(const KernelGlobals *kg,
 
     if (desc.element & (ATTR_ELEMENT_VERTEX | ATTR_ELEMENT_VERTEX_MOTION)) {
       const uint4 tri_vindex = kernel_tex_fetch(__tri_vindex, sd->prim);
-      f0 = kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.x);
-      f1 = kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.y);
-      f2 = kernel_tex_fetch(__attributes_float3, desc.offset + tri_vindex.z);
+      f0 = attribute_data_float4(kg, desc, desc.offset + tri_vindex.x);
+      f1 = attribute_data_float4(kg, desc, desc.offset + tri_vindex.y);
+      f2 = attribute_data_float4(kg, desc, desc.offset + tri_vindex.z);
     }
     else {
       const int tri = desc.offset + sd->prim * 3;
       if (desc.element == ATTR_ELEMENT_CORNER) {
-        f0 = kernel_tex_fetch(__attributes_float3, tri + 0);
-        f1 = kernel_tex_fetch(__attributes_float3, tri + 1);
-        f2 = kernel_tex_fetch(__attributes_float3, tri + 2);
+        f0 = attribute_data_float4(kg, desc, tri + 0);
+        f1 = attribute_data_float4(kg, desc, tri + 1);
+        f2 = attribute_data_float4(kg, desc, tri + 2);
       }
       else {
         f0 = color_srgb_to_linear_v4(
@@ -359,7 +369,7 @@ ccl_device float4 triangle_attribute_float4(const KernelGlobals *kg,
     if (desc.element & (ATTR_ELEMENT_FACE | ATTR_ELEMENT_OBJECT | ATTR_ELEMENT_MESH)) {
       const int offset = (desc.element == ATTR_ELEMENT_FACE) ? desc.offset + sd->prim :
                                                                desc.offset;
-      return kernel_tex_fetch(__attributes_float3, offset);
+      return attribute_data_float4(kg, desc, offset);
     }
     else {
       return make_float4(0.0f, 0.0f, 0.0f, 0.0f);
@@ -163,7 +163,7 @@ ccl_device void integrator_intersect_closest(INTEGRATOR_STATE_ARGS)
     const int last_object = last_isect_object != OBJECT_NONE ?
                                 last_isect_object :
                                 kernel_tex_fetch(__prim_object, last_isect_prim);
-    const float object_ao_distance = kernel_tex_fetch(__objects, last_object).ao_distance;
+    const float object_ao_distance = object_fetch_data(kg, last_object)->ao_distance;
     if (object_ao_distance != 0.0f) {
       ray.t = object_ao_distance;
     }
@@ -89,6 +89,9 @@ ccl_device_forceinline void integrate_surface_emission(INTEGRATOR_STATE_CONST_AR
     /* Multiple importance sampling, get triangle light pdf,
      * and compute weight with respect to BSDF pdf. */
     float pdf = triangle_light_pdf(kg, sd, t);
+    if (kernel_data.integrator.use_light_tree) {
+      pdf *= light_tree_triangle_pdf_scale(kg, sd->P + sd->I * t, sd->object, sd->prim);
+    }
     float mis_weight = power_heuristic(bsdf_pdf, pdf);
 
     L *= mis_weight;
@@ -107,7 +107,7 @@ CCL_NAMESPACE_BEGIN
 #  define INTEGRATOR_PATH_INIT_SORTED(next_kernel, key) \
     { \
       INTEGRATOR_STATE_WRITE(path, queued_kernel) = next_kernel; \
-      (void)key; \
+      INTEGRATOR_STATE_WRITE(path, shader_sort_key) = key; \
     }
 #  define INTEGRATOR_PATH_NEXT(current_kernel, next_kernel) \
     { \
@@ -122,7 +122,7 @@ CCL_NAMESPACE_BEGIN
 #  define INTEGRATOR_PATH_NEXT_SORTED(current_kernel, next_kernel, key) \
     { \
       INTEGRATOR_STATE_WRITE(path, queued_kernel) = next_kernel; \
-      (void)key; \
+      INTEGRATOR_STATE_WRITE(path, shader_sort_key) = key; \
       (void)current_kernel; \
     }
 
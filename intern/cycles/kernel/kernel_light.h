@@ -19,6 +19,7 @@
 #include "geom/geom.h"
 
 #include "kernel_light_background.h"
+#include "kernel_light_tree.h"
 #include "kernel_montecarlo.h"
 #include "kernel_projection.h"
 #include "kernel_types.h"
@@ -456,6 +457,9 @@ ccl_device bool light_sample_from_intersection(const KernelGlobals *ccl_restrict
   }
 
   ls->pdf *= kernel_data.integrator.pdf_lights;
+  if (kernel_data.integrator.use_light_tree) {
+    ls->pdf *= light_tree_lamp_pdf_scale(kg, ray_P, lamp);
+  }
 
   return true;
 }
@@ -802,8 +806,21 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
                                                    const int path_flag,
                                                    LightSample *ls)
 {
-  /* Sample light index from distribution. */
-  const int index = light_distribution_sample(kg, &randu);
+  /* Sample light index from distribution.
+   *
+   * The light tree is not used for volume segments: the sample only guides equiangular sampling
+   * and the light is sampled again from the scatter position. */
+  int index;
+  float pdf_scale = 1.0f;
+  if (!in_volume_segment && kernel_data.integrator.use_light_tree) {
+    index = light_tree_sample(kg, P, &randu, &pdf_scale);
+    if (index == -1) {
+      return false;
+    }
+  }
+  else {
+    index = light_distribution_sample(kg, &randu);
+  }
   const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(__light_distribution,
                                                                               index);
   const int prim = kdistribution->prim;
@@ -821,6 +838,7 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
     const int shader_flag = kdistribution->mesh_light.shader_flag;
     triangle_light_sample<in_volume_segment>(kg, prim, object, randu, randv, time, ls, P);
     ls->shader |= shader_flag;
+    ls->pdf *= pdf_scale;
     return (ls->pdf > 0.0f);
   }
 
@@ -830,7 +848,11 @@ ccl_device_noinline bool light_distribution_sample(const KernelGlobals *kg,
     return false;
   }
 
-  return light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls);
+  if (!light_sample<in_volume_segment>(kg, lamp, randu, randv, P, path_flag, ls)) {
+    return false;
+  }
+  ls->pdf *= pdf_scale;
+  return true;
 }
 
 ccl_device_inline bool light_distribution_sample_from_volume_segment(const KernelGlobals *kg,
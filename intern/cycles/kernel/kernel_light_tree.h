@@ -0,0 +1,227 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "kernel_types.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree
+ *
+ * Alternative to picking an emitter from the flat light distribution: emitters are organized in
+ * a binary tree built on the host, which is traversed stochastically, descending into a child
+ * with probability proportional to its estimated contribution to the shading point.
+ *
+ * Based on:
+ *
+ * Alejandro Conty Estevez, Christopher Kulla.
+ * Importance Sampling of Many Lights With Adaptive Tree Splitting.
+ *
+ * The tree only changes the probability of picking an emitter, sampling of a point on the emitter
+ * is shared with the light distribution. So instead of computing the pdf from scratch, the pdf of
+ * the light distribution is scaled by the ratio of both selection probabilities. */
+
+/* Estimated contribution of the emitters of the node to the shading point. Bounds are
+ * conservative: zero is only returned when none of the emitters can illuminate the point. */
+ccl_device float light_tree_node_importance(const ccl_global KernelLightTreeNode *knode,
+                                            const float3 P)
+{
+  if (knode->energy == 0.0f) {
+    return 0.0f;
+  }
+
+  const float3 bbox_min = make_float3(knode->bbox_min[0], knode->bbox_min[1], knode->bbox_min[2]);
+  const float3 bbox_max = make_float3(knode->bbox_max[0], knode->bbox_max[1], knode->bbox_max[2]);
+  const float3 centroid = 0.5f * (bbox_min + bbox_max);
+  const float radius_squared = 0.25f * len_squared(bbox_max - bbox_min);
+  const float3 to_P = P - centroid;
+  const float distance_squared = len_squared(to_P);
+
+  /* Clamp the distance to the radius of the bounding sphere, so the importance does not go to
+   * infinity when the shading point is close to or inside of the cluster. */
+  float importance = knode->energy / max(max(distance_squared, radius_squared), 1e-8f);
+
+  /* Emission cone, only applies when the shading point is outside of the bounding sphere. */
+  if (knode->theta_o + knode->theta_e < M_PI_F && distance_squared > radius_squared) {
+    const float3 axis = make_float3(knode->axis[0], knode->axis[1], knode->axis[2]);
+    const float distance = sqrtf(distance_squared);
+    const float theta = safe_acosf(dot(axis, to_P) / distance);
+    const float theta_u = safe_asinf(sqrtf(radius_squared / distance_squared));
+    const float theta_prime = max(theta - knode->theta_o - theta_u, 0.0f);
+    if (theta_prime >= knode->theta_e) {
+      return 0.0f;
+    }
+    importance *= cosf(theta_prime);
+  }
+
+  return importance;
+}
+
+ccl_device_inline void light_tree_children_importance(const KernelGlobals *kg,
+                                                      const int child_index,
+                                                      const float3 P,
+                                                      float *importance0,
+                                                      float *importance1)
+{
+  const ccl_global KernelLightTreeNode *kchild0 = &kernel_tex_fetch(__light_tree_nodes,
+                                                                    child_index);
+  const ccl_global KernelLightTreeNode *kchild1 = &kernel_tex_fetch(__light_tree_nodes,
+                                                                    child_index + 1);
+
+  if ((kchild0->flags | kchild1->flags) & LIGHT_TREE_NODE_INFINITE) {
+    /* There is no position to estimate contribution of distant and background lights from, so
+     * they are picked with the same probability as in the light distribution. */
+    *importance0 = kchild0->distribution_pdf;
+    *importance1 = kchild1->distribution_pdf;
+    return;
+  }
+
+  *importance0 = light_tree_node_importance(kchild0, P);
+  *importance1 = light_tree_node_importance(kchild1, P);
+}
+
+/* Pick an emitter for the shading point. Returns its index in the light distribution, or -1 if
+ * none of the emitters can illuminate the point. The random number is rescaled to be reused for
+ * sampling a point on the emitter, and the ratio of the tree and light distribution pdfs is
+ * returned in pdf_scale. */
+ccl_device int light_tree_sample(const KernelGlobals *kg,
+                                 const float3 P,
+                                 float *randu,
+                                 float *pdf_scale)
+{
+  float r = *randu;
+  float pdf = 1.0f;
+  int node_index = 0;
+
+  while (true) {
+    const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes,
+                                                                   node_index);
+    if (knode->child_index < 0) {
+      if (knode->distribution_pdf == 0.0f) {
+        return -1;
+      }
+      *randu = r;
+      *pdf_scale = pdf / knode->distribution_pdf;
+      return ~knode->child_index;
+    }
+
+    float importance0, importance1;
+    light_tree_children_importance(kg, knode->child_index, P, &importance0, &importance1);
+    const float total_importance = importance0 + importance1;
+    if (!(total_importance > 0.0f)) {
+      return -1;
+    }
+
+    const float p0 = importance0 / total_importance;
+    if (r < p0) {
+      r = r / p0;
+      pdf *= p0;
+      node_index = knode->child_index;
+    }
+    else {
+      r = (r - p0) / (1.0f - p0);
+      pdf *= 1.0f - p0;
+      node_index = knode->child_index + 1;
+    }
+    r = min(r, 1.0f - FLT_EPSILON);
+  }
+}
+
+/* Ratio of the tree and light distribution pdfs of picking the emitter for the shading point. */
+ccl_device float light_tree_pdf_scale(const KernelGlobals *kg,
+                                      const float3 P,
+                                      const int distribution_index)
+{
+  int node_index = kernel_tex_fetch(__light_tree_emitter_nodes, distribution_index);
+  const ccl_global KernelLightTreeNode *knode = &kernel_tex_fetch(__light_tree_nodes, node_index);
+  const float distribution_pdf = knode->distribution_pdf;
+  if (distribution_pdf == 0.0f) {
+    return 0.0f;
+  }
+
+  float pdf = 1.0f;
+  int parent_index = knode->parent_index;
+  while (parent_index != -1) {
+    const ccl_global KernelLightTreeNode *kparent = &kernel_tex_fetch(__light_tree_nodes,
+                                                                     parent_index);
+    float importance0, importance1;
+    light_tree_children_importance(kg, kparent->child_index, P, &importance0, &importance1);
+    const float total_importance = importance0 + importance1;
+    if (!(total_importance > 0.0f)) {
+      return 0.0f;
+    }
+
+    pdf *= ((node_index == kparent->child_index) ? importance0 : importance1) /
+           total_importance;
+    node_index = parent_index;
+    parent_index = kparent->parent_index;
+  }
+
+  return pdf / distribution_pdf;
+}
+
+ccl_device float light_tree_lamp_pdf_scale(const KernelGlobals *kg,
+                                           const float3 P,
+                                           const int lamp)
+{
+  /* Lamps are stored after the mesh light triangles in the light distribution. */
+  const int distribution_index = kernel_data.integrator.num_distribution -
+                                 kernel_data.integrator.num_all_lights + lamp;
+  return light_tree_pdf_scale(kg, P, distribution_index);
+}
+
+ccl_device float light_tree_triangle_pdf_scale(const KernelGlobals *kg,
+                                               const float3 P,
+                                               const int object,
+                                               const int prim)
+{
+  /* Triangles are stored in the light distribution sorted by object and primitive index, find
+   * the one with a binary search. */
+  const int num_triangles = kernel_data.integrator.num_distribution -
+                            kernel_data.integrator.num_all_lights;
+  int first = 0;
+  int len = num_triangles;
+
+  while (len > 0) {
+    const int half_len = len >> 1;
+    const int middle = first + half_len;
+    const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(
+        __light_distribution, middle);
+    const int middle_object = kdistribution->mesh_light.object_id;
+
+    if (middle_object < object || (middle_object == object && kdistribution->prim < prim)) {
+      first = middle + 1;
+      len = len - half_len - 1;
+    }
+    else {
+      len = half_len;
+    }
+  }
+
+  if (first == num_triangles) {
+    return 0.0f;
+  }
+  const ccl_global KernelLightDistribution *kdistribution = &kernel_tex_fetch(__light_distribution,
+                                                                              first);
+  if (kdistribution->mesh_light.object_id != object || kdistribution->prim != prim) {
+    return 0.0f;
+  }
+
+  return light_tree_pdf_scale(kg, P, first);
+}
+
+CCL_NAMESPACE_END
@@ -592,6 +592,11 @@ typedef enum AttributeStandard {
 typedef enum AttributeFlag {
   ATTR_FINAL_SIZE = (1 << 0),
   ATTR_SUBDIVIDED = (1 << 1),
+  /* Unit vector stored as octahedral encoding in __attributes_float. */
+  ATTR_QUANTIZED_OCTAHEDRAL = (1 << 2),
+  /* Half floats, float2 stored as half2 in __attributes_float and float3 and float4 stored as
+   * half4 in __attributes_float2. */
+  ATTR_QUANTIZED_HALF = (1 << 3),
 } AttributeFlag;
 
 typedef struct AttributeDescriptor {
@@ -1162,8 +1167,11 @@ typedef struct KernelIntegrator {
 
   int has_shadow_catcher;
 
+  /* light tree */
+  int use_light_tree;
+
   /* padding */
-  int pad1, pad2;
+  int pad1;
 } KernelIntegrator;
 static_assert_align(KernelIntegrator, 16);
 
@@ -1190,6 +1198,12 @@ typedef struct KernelBVH {
   int use_bvh_steps;
   int curve_subdivisions;
 
+  /* Objects are stored as KernelObjectInstance, sharing KernelObject data with the prototype. */
+  int use_compact_instances;
+  /* Vertex normals are stored in __tri_vnormal_quantized instead of __tri_vnormal. */
+  int use_quantized_normals;
+  int pad3, pad4;
+
   /* Custom BVH */
 #ifdef __KERNEL_OPTIX__
   OptixTraversableHandle scene;
@@ -1271,6 +1285,18 @@ typedef struct KernelObject {
 } KernelObject;
 static_assert_align(KernelObject, 16);
 
+/* Per object data in compact instancing mode, everything else is read from the KernelObject of
+ * the prototype. The inverse transform is computed on the fly. */
+typedef struct KernelObjectInstance {
+  Transform tfm;
+
+  uint prototype;
+  float random_number;
+
+  float pad1, pad2;
+} KernelObjectInstance;
+static_assert_align(KernelObjectInstance, 16);
+
 typedef struct KernelSpotLight {
   float radius;
   float invarea;
@@ -1332,6 +1358,32 @@ typedef struct KernelLightDistribution {
 } KernelLightDistribution;
 static_assert_align(KernelLightDistribution, 16);
 
+typedef enum KernelLightTreeNodeFlag {
+  /* Distant and background lights, which have no position. */
+  LIGHT_TREE_NODE_INFINITE = (1 << 0),
+} KernelLightTreeNodeFlag;
+
+typedef struct KernelLightTreeNode {
+  /* Bounds of the emitters in the subtree. */
+  float bbox_min[3];
+  /* Estimated power of the emitters in the subtree. */
+  float energy;
+  float bbox_max[3];
+  /* Normals of the emitters are within theta_o of the axis, emission happens within theta_e
+   * around the normal. */
+  float theta_o;
+  float axis[3];
+  float theta_e;
+  /* Index of the first child for inner nodes, the second child immediately follows it.
+   * For leaf nodes it is ~index of the emitter in the light distribution. */
+  int child_index;
+  int parent_index;
+  /* Probability of the flat light distribution to pick an emitter from the subtree. */
+  float distribution_pdf;
+  int flags;
+} KernelLightTreeNode;
+static_assert_align(KernelLightTreeNode, 16);
+
 typedef struct KernelParticle {
   int index;
   float age;
@@ -16,14 +16,20 @@
 
 CCL_NAMESPACE_BEGIN
 
-ccl_device float4 svm_image_texture(const KernelGlobals *kg, int id, float x, float y, uint flags)
+ccl_device float4 svm_image_texture_filtered(const KernelGlobals *kg,
+                                             int id,
+                                             float x,
+                                             float y,
+                                             const float2 duv_dx,
+                                             const float2 duv_dy,
+                                             uint flags)
 {
   if (id == -1) {
     return make_float4(
         TEX_IMAGE_MISSING_R, TEX_IMAGE_MISSING_G, TEX_IMAGE_MISSING_B, TEX_IMAGE_MISSING_A);
   }
 
-  float4 r = kernel_tex_image_interp(kg, id, x, y);
+  float4 r = kernel_tex_image_interp_filtered(kg, id, x, y, duv_dx, duv_dy);
   const float alpha = r.w;
 
   if ((flags & NODE_IMAGE_ALPHA_UNASSOCIATE) && alpha != 1.0f && alpha != 0.0f) {
@@ -38,31 +44,54 @@ ccl_device float4 svm_image_texture(const KernelGlobals *kg, int id, float x, fl
   return r;
 }
 
+ccl_device float4 svm_image_texture(const KernelGlobals *kg, int id, float x, float y, uint flags)
+{
+  return svm_image_texture_filtered(kg, id, x, y, zero_float2(), zero_float2(), flags);
+}
+
 /* Remap coordinate from 0..1 box to -1..-1 */
 ccl_device_inline float3 texco_remap_square(float3 co)
 {
   return (co - make_float3(0.5f, 0.5f, 0.5f)) * 2.0f;
 }
 
+ccl_device_inline float2 svm_image_projection(float3 co, uint projection)
+{
+  if (projection == NODE_IMAGE_PROJ_SPHERE) {
+    return map_to_sphere(texco_remap_square(co));
+  }
+  else if (projection == NODE_IMAGE_PROJ_TUBE) {
+    return map_to_tube(texco_remap_square(co));
+  }
+  else {
+    return make_float2(co.x, co.y);
+  }
+}
+
 ccl_device_noinline int svm_node_tex_image(
     const KernelGlobals *kg, ShaderData *sd, float *stack, uint4 node, int offset)
 {
   uint co_offset, out_offset, alpha_offset, flags;
+  uint projection, co_dx_offset, co_dy_offset;
 
   svm_unpack_node_uchar4(node.z, &co_offset, &out_offset, &alpha_offset, &flags);
+  svm_unpack_node_uchar3(node.w, &projection, &co_dx_offset, &co_dy_offset);
 
   float3 co = stack_load_float3(stack, co_offset);
-  float2 tex_co;
-  if (node.w == NODE_IMAGE_PROJ_SPHERE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_sphere(co);
-  }
-  else if (node.w == NODE_IMAGE_PROJ_TUBE) {
-    co = texco_remap_square(co);
-    tex_co = map_to_tube(co);
-  }
-  else {
-    tex_co = make_float2(co.x, co.y);
+  float2 tex_co = svm_image_projection(co, projection);
+
+  /* Texture coordinates at the ray differential offsets are only available for images in the
+   * texture cache, to choose the mipmap level. */
+  float2 duv_dx = zero_float2();
+  float2 duv_dy = zero_float2();
+  if (stack_valid(co_dx_offset) && stack_valid(co_dy_offset)) {
+    duv_dx = svm_image_projection(stack_load_float3(stack, co_dx_offset), projection) - tex_co;
+    duv_dy = svm_image_projection(stack_load_float3(stack, co_dy_offset), projection) - tex_co;
+    if (projection != NODE_IMAGE_PROJ_FLAT) {
+      /* Sphere and tube mappings wrap around horizontally. */
+      duv_dx.x -= floorf(duv_dx.x + 0.5f);
+      duv_dy.x -= floorf(duv_dy.x + 0.5f);
+    }
   }
 
   /* TODO(lukas): Consider moving tile information out of the SVM node.
@@ -108,7 +137,7 @@ ccl_device_noinline int svm_node_tex_image(
     id = -num_nodes;
   }
 
-  float4 f = svm_image_texture(kg, id, tex_co.x, tex_co.y, flags);
+  float4 f = svm_image_texture_filtered(kg, id, tex_co.x, tex_co.y, duv_dx, duv_dy, flags);
 
   if (stack_valid(out_offset))
     stack_store_float3(stack, out_offset, make_float3(f.x, f.y, f.z));
@@ -38,6 +38,7 @@
 #include "kernel/osl/osl_globals.h"
 
 #include "util/util_foreach.h"
+#include "util/util_half.h"
 #include "util/util_logging.h"
 #include "util/util_progress.h"
 #include "util/util_task.h"
@@ -228,15 +229,24 @@ void Geometry::compute_bvh(
     vector<Object *> objects;
     objects.push_back(&object);
 
-    if (bvh && !need_update_rebuild) {
+    bool need_build = (bvh == NULL || need_update_rebuild);
+
+    if (!need_build) {
       progress->set_status(msg, "Refitting BVH");
 
       bvh->geometry = geometry;
       bvh->objects = objects;
 
       device->build_bvh(bvh, *progress, true);
+
+      if (bvh->refit_degraded()) {
+        VLOG(1) << "Refit BVH of " << name << " degraded from cost " << bvh->build_cost << " to "
+                << bvh->refit_cost << ", rebuilding.";
+        need_build = true;
+      }
     }
-    else {
+
+    if (need_build) {
       progress->set_status(msg, "Building BVH");
 
       BVHParams bparams;
@@ -552,9 +562,69 @@ void GeometryManager::update_svm_attributes(Device *,
   dscene->attributes_map.copy_to_device();
 }
 
+/* Quantization of triangle mesh attributes when the scene uses quantized attributes. Unit
+ * normals are stored in octahedral encoding and UVs as half2 in the float array, colors as
+ * half4 in the float2 array. Returns the ATTR_QUANTIZED_* flag, or zero for full precision. */
+static uint attribute_quantization(const Geometry *geom,
+                                   const Attribute *mattr,
+                                   AttributePrimitive prim,
+                                   bool use_quantized_attributes)
+{
+  if (!use_quantized_attributes || !geom->is_mesh() || prim != ATTR_PRIM_GEOMETRY ||
+      (mattr->flags & ATTR_SUBDIVIDED)) {
+    return 0;
+  }
+
+  if (!(mattr->element & (ATTR_ELEMENT_VERTEX | ATTR_ELEMENT_CORNER | ATTR_ELEMENT_FACE))) {
+    return 0;
+  }
+
+  if (mattr->type == TypeDesc::TypeNormal) {
+    return ATTR_QUANTIZED_OCTAHEDRAL;
+  }
+  else if (mattr->type == TypeFloat2 || mattr->type == TypeDesc::TypeColor ||
+           mattr->type == TypeRGBA) {
+    return ATTR_QUANTIZED_HALF;
+  }
+
+  return 0;
+}
+
+/* Whether the attribute is stored in the float array, quantized to 32 bits. */
+static bool attribute_quantized_to_float(const Attribute *mattr, uint quantization)
+{
+  return (quantization == ATTR_QUANTIZED_OCTAHEDRAL) ||
+         (quantization == ATTR_QUANTIZED_HALF && mattr->type == TypeFloat2);
+}
+
+/* Device array used for the attribute, taking quantization into account. */
+static AttrKernelDataType attribute_kernel_type(const Geometry *geom,
+                                                const Attribute *mattr,
+                                                AttributePrimitive prim,
+                                                bool use_quantized_attributes)
+{
+  const uint quantization = attribute_quantization(geom, mattr, prim, use_quantized_attributes);
+
+  if (attribute_quantized_to_float(mattr, quantization)) {
+    return AttrKernelDataType::FLOAT;
+  }
+  else if (quantization == ATTR_QUANTIZED_HALF) {
+    return AttrKernelDataType::FLOAT2;
+  }
+
+  return Attribute::kernel_type(*mattr);
+}
+
+static uint float2_to_half2(const float2 f)
+{
+  return (uint)(unsigned short)float_to_half(f.x) |
+         ((uint)(unsigned short)float_to_half(f.y) << 16);
+}
+
 static void update_attribute_element_size(Geometry *geom,
                                           Attribute *mattr,
                                           AttributePrimitive prim,
+                                          bool use_quantized_attributes,
                                           size_t *attr_float_size,
                                           size_t *attr_float2_size,
                                           size_t *attr_float3_size,
@@ -562,6 +632,8 @@ static void update_attribute_element_size(Geometry *geom,
 {
   if (mattr) {
     size_t size = mattr->element_size(geom, prim);
+    const uint quantization = attribute_quantization(
+        geom, mattr, prim, use_quantized_attributes);
 
     if (mattr->element == ATTR_ELEMENT_VOXEL) {
       /* pass */
@@ -569,6 +641,12 @@ static void update_attribute_element_size(Geometry *geom,
     else if (mattr->element == ATTR_ELEMENT_CORNER_BYTE) {
       *attr_uchar4_size += size;
     }
+    else if (attribute_quantized_to_float(mattr, quantization)) {
+      *attr_float_size += size;
+    }
+    else if (quantization == ATTR_QUANTIZED_HALF) {
+      *attr_float2_size += size;
+    }
     else if (mattr->type == TypeDesc::TypeFloat) {
       *attr_float_size += size;
     }
@@ -595,13 +673,17 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
                                                       size_t &attr_uchar4_offset,
                                                       Attribute *mattr,
                                                       AttributePrimitive prim,
+                                                      bool use_quantized_attributes,
                                                       TypeDesc &type,
                                                       AttributeDescriptor &desc)
 {
   if (mattr) {
+    const uint quantization = attribute_quantization(
+        geom, mattr, prim, use_quantized_attributes);
+
     /* store element and type */
     desc.element = mattr->element;
-    desc.flags = mattr->flags;
+    desc.flags = mattr->flags | quantization;
     type = mattr->type;
 
     /* store attribute data in arrays */
@@ -624,9 +706,54 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
         for (size_t k = 0; k < size; k++) {
           attr_uchar4[offset + k] = data[k];
         }
+        attr_uchar4.tag_modified(offset, size);
       }
       attr_uchar4_offset += size;
     }
+    else if (quantization == ATTR_QUANTIZED_OCTAHEDRAL) {
+      float3 *data = mattr->data_float3();
+      offset = attr_float_offset;
+
+      assert(attr_float.size() >= offset + size);
+      if (mattr->modified) {
+        uint *quantized = (uint *)attr_float.data();
+        for (size_t k = 0; k < size; k++) {
+          quantized[offset + k] = float3_to_octahedral(data[k]);
+        }
+        attr_float.tag_modified(offset, size);
+      }
+      attr_float_offset += size;
+    }
+    else if (quantization == ATTR_QUANTIZED_HALF && mattr->type == TypeFloat2) {
+      float2 *data = mattr->data_float2();
+      offset = attr_float_offset;
+
+      assert(attr_float.size() >= offset + size);
+      if (mattr->modified) {
+        uint *quantized = (uint *)attr_float.data();
+        for (size_t k = 0; k < size; k++) {
+          quantized[offset + k] = float2_to_half2(data[k]);
+        }
+        attr_float.tag_modified(offset, size);
+      }
+      attr_float_offset += size;
+    }
+    else if (quantization == ATTR_QUANTIZED_HALF) {
+      float4 *data = mattr->data_float4();
+      offset = attr_float2_offset;
+
+      assert(attr_float2.size() >= offset + size);
+      if (mattr->modified) {
+        uint2 *quantized = (uint2 *)attr_float2.data();
+        for (size_t k = 0; k < size; k++) {
+          quantized[offset + k] = make_uint2(
+              float2_to_half2(make_float2(data[k].x, data[k].y)),
+              float2_to_half2(make_float2(data[k].z, data[k].w)));
+        }
+        attr_float2.tag_modified(offset, size);
+      }
+      attr_float2_offset += size;
+    }
     else if (mattr->type == TypeDesc::TypeFloat) {
       float *data = mattr->data_float();
       offset = attr_float_offset;
@@ -636,6 +763,7 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
         for (size_t k = 0; k < size; k++) {
           attr_float[offset + k] = data[k];
         }
+        attr_float.tag_modified(offset, size);
       }
       attr_float_offset += size;
     }
@@ -648,6 +776,7 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
         for (size_t k = 0; k < size; k++) {
           attr_float2[offset + k] = data[k];
         }
+        attr_float2.tag_modified(offset, size);
       }
       attr_float2_offset += size;
     }
@@ -660,6 +789,7 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
         for (size_t k = 0; k < size * 3; k++) {
           attr_float3[offset + k] = (&tfm->x)[k];
         }
+        attr_float3.tag_modified(offset, size * 3);
       }
       attr_float3_offset += size * 3;
     }
@@ -672,6 +802,7 @@ void GeometryManager::update_attribute_element_offset(Geometry *geom,
         for (size_t k = 0; k < size; k++) {
           attr_float3[offset + k] = data[k];
         }
+        attr_float3.tag_modified(offset, size);
       }
       attr_float3_offset += size;
     }
@@ -780,6 +911,8 @@ void GeometryManager::device_update_attributes(Device *device,
    * those arrays, and set the offset and element type to create attribute
    * maps next */
 
+  const bool use_quantized_attributes = scene->params.use_quantized_attributes;
+
   /* Pre-allocate attributes to avoid arrays re-allocation which would
    * take 2x of overall attribute memory usage.
    */
@@ -797,6 +930,7 @@ void GeometryManager::device_update_attributes(Device *device,
       update_attribute_element_size(geom,
                                     attr,
                                     ATTR_PRIM_GEOMETRY,
+                                    use_quantized_attributes,
                                     &attr_float_size,
                                     &attr_float2_size,
                                     &attr_float3_size,
@@ -809,6 +943,7 @@ void GeometryManager::device_update_attributes(Device *device,
         update_attribute_element_size(mesh,
                                       subd_attr,
                                       ATTR_PRIM_SUBD,
+                                      use_quantized_attributes,
                                       &attr_float_size,
                                       &attr_float2_size,
                                       &attr_float3_size,
@@ -824,6 +959,7 @@ void GeometryManager::device_update_attributes(Device *device,
       update_attribute_element_size(object->geometry,
                                     &attr,
                                     ATTR_PRIM_GEOMETRY,
+                                    use_quantized_attributes,
                                     &attr_float_size,
                                     &attr_float2_size,
                                     &attr_float3_size,
@@ -861,7 +997,8 @@ void GeometryManager::device_update_attributes(Device *device,
 
       if (attr) {
         /* force a copy if we need to reallocate all the data */
-        attr->modified |= attributes_need_realloc[Attribute::kernel_type(*attr)];
+        attr->modified |= attributes_need_realloc[attribute_kernel_type(
+            geom, attr, ATTR_PRIM_GEOMETRY, use_quantized_attributes)];
       }
 
       update_attribute_element_offset(geom,
@@ -875,6 +1012,7 @@ void GeometryManager::device_update_attributes(Device *device,
                                       attr_uchar4_offset,
                                       attr,
                                       ATTR_PRIM_GEOMETRY,
+                                      use_quantized_attributes,
                                       req.type,
                                       req.desc);
 
@@ -884,7 +1022,8 @@ void GeometryManager::device_update_attributes(Device *device,
 
         if (subd_attr) {
           /* force a copy if we need to reallocate all the data */
-          subd_attr->modified |= attributes_need_realloc[Attribute::kernel_type(*subd_attr)];
+          subd_attr->modified |= attributes_need_realloc[attribute_kernel_type(
+              mesh, subd_attr, ATTR_PRIM_SUBD, use_quantized_attributes)];
         }
 
         update_attribute_element_offset(mesh,
@@ -898,6 +1037,7 @@ void GeometryManager::device_update_attributes(Device *device,
                                         attr_uchar4_offset,
                                         subd_attr,
                                         ATTR_PRIM_SUBD,
+                                        use_quantized_attributes,
                                         req.subd_type,
                                         req.subd_desc);
       }
@@ -916,7 +1056,8 @@ void GeometryManager::device_update_attributes(Device *device,
       Attribute *attr = values.find(req);
 
       if (attr) {
-        attr->modified |= attributes_need_realloc[Attribute::kernel_type(*attr)];
+        attr->modified |= attributes_need_realloc[attribute_kernel_type(
+            object->geometry, attr, ATTR_PRIM_GEOMETRY, use_quantized_attributes)];
       }
 
       update_attribute_element_offset(object->geometry,
@@ -930,6 +1071,7 @@ void GeometryManager::device_update_attributes(Device *device,
                                       attr_uchar4_offset,
                                       attr,
                                       ATTR_PRIM_GEOMETRY,
+                                      use_quantized_attributes,
                                       req.type,
                                       req.desc);
 
@@ -1104,15 +1246,24 @@ void GeometryManager::device_update_mesh(
     /* normals */
     progress.set_status("Updating Mesh", "Computing normals");
 
+    /* Only one of the normal arrays is used, depending on quantization. */
+    const bool use_quantized_normals = scene->params.use_quantized_attributes;
+    dscene->data.bvh.use_quantized_normals = use_quantized_normals;
+    device_vector<float4> &tri_vnormal = dscene->tri_vnormal;
+    device_vector<uint> &tri_vnormal_quantized = dscene->tri_vnormal_quantized;
+
     uint *tri_shader = dscene->tri_shader.alloc(tri_size);
-    float4 *vnormal = dscene->tri_vnormal.alloc(vert_size);
+    float4 *vnormal = (use_quantized_normals) ? nullptr : tri_vnormal.alloc(vert_size);
+    uint *vnormal_quantized = (use_quantized_normals) ? tri_vnormal_quantized.alloc(vert_size) :
+                                                        nullptr;
     uint4 *tri_vindex = dscene->tri_vindex.alloc(tri_size);
     uint *tri_patch = dscene->tri_patch.alloc(tri_size);
     float2 *tri_patch_uv = dscene->tri_patch_uv.alloc(vert_size);
 
     const bool copy_all_data = dscene->tri_shader.need_realloc() ||
                                dscene->tri_vindex.need_realloc() ||
-                               dscene->tri_vnormal.need_realloc() ||
+                               tri_vnormal.need_realloc() ||
+                               tri_vnormal_quantized.need_realloc() ||
                                dscene->tri_patch.need_realloc() ||
                                dscene->tri_patch_uv.need_realloc();
 
@@ -1120,13 +1271,26 @@ void GeometryManager::device_update_mesh(
       if (geom->geometry_type == Geometry::MESH || geom->geometry_type == Geometry::VOLUME) {
         Mesh *mesh = static_cast<Mesh *>(geom);
 
+        /* Only the slices of modified meshes are copied to the device, unless the arrays were
+         * reallocated because the offsets changed. */
+        const size_t num_verts = mesh->verts.size();
+        const size_t num_triangles = mesh->num_triangles();
+
         if (mesh->shader_is_modified() || mesh->smooth_is_modified() ||
             mesh->triangles_is_modified() || copy_all_data) {
           mesh->pack_shaders(scene, &tri_shader[mesh->prim_offset]);
+          dscene->tri_shader.tag_modified(mesh->prim_offset, num_triangles);
         }
 
         if (mesh->verts_is_modified() || copy_all_data) {
-          mesh->pack_normals(&vnormal[mesh->vert_offset]);
+          if (use_quantized_normals) {
+            mesh->pack_normals_quantized(&vnormal_quantized[mesh->vert_offset]);
+            tri_vnormal_quantized.tag_modified(mesh->vert_offset, num_verts);
+          }
+          else {
+            mesh->pack_normals(&vnormal[mesh->vert_offset]);
+            tri_vnormal.tag_modified(mesh->vert_offset, num_verts);
+          }
         }
 
         if (mesh->triangles_is_modified() || mesh->vert_patch_uv_is_modified() || copy_all_data) {
@@ -1136,6 +1300,9 @@ void GeometryManager::device_update_mesh(
                            &tri_patch_uv[mesh->vert_offset],
                            mesh->vert_offset,
                            mesh->prim_offset);
+          dscene->tri_vindex.tag_modified(mesh->prim_offset, num_triangles);
+          dscene->tri_patch.tag_modified(mesh->prim_offset, num_triangles);
+          dscene->tri_patch_uv.tag_modified(mesh->vert_offset, num_verts);
         }
 
         if (progress.get_cancel())
@@ -1147,7 +1314,12 @@ void GeometryManager::device_update_mesh(
     progress.set_status("Updating Mesh", "Copying Mesh to device");
 
     dscene->tri_shader.copy_to_device_if_modified();
-    dscene->tri_vnormal.copy_to_device_if_modified();
+    if (use_quantized_normals) {
+      tri_vnormal_quantized.copy_to_device_if_modified();
+    }
+    else {
+      tri_vnormal.copy_to_device_if_modified();
+    }
     dscene->tri_vindex.copy_to_device_if_modified();
     dscene->tri_patch.copy_to_device_if_modified();
     dscene->tri_patch_uv.copy_to_device_if_modified();
@@ -1178,6 +1350,8 @@ void GeometryManager::device_update_mesh(
                           &curve_keys[hair->curvekey_offset],
                           &curves[hair->prim_offset],
                           hair->curvekey_offset);
+        dscene->curve_keys.tag_modified(hair->curvekey_offset, hair->get_curve_keys().size());
+        dscene->curves.tag_modified(hair->prim_offset, hair->num_curves());
         if (progress.get_cancel())
           return;
       }
@@ -1253,8 +1427,17 @@ void GeometryManager::device_update_bvh(Device *device,
 
   VLOG(1) << "Using " << bvh_layout_name(bparams.bvh_layout) << " layout.";
 
+  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
+
+  /* The scene BVH is freed when primitives are added or removed, so when it still exists for the
+   * same objects only vertices and transforms changed and refitting is enough. This is only done
+   * for final renders, viewport renders use dynamic BVHs which are fast to build. */
   const bool can_refit = scene->bvh != nullptr &&
-                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX);
+                         (bparams.bvh_layout == BVHLayout::BVH_LAYOUT_OPTIX ||
+                          (bparams.bvh_type == BVH_TYPE_STATIC &&
+                           (has_bvh2_layout || bparams.bvh_layout == BVH_LAYOUT_EMBREE) &&
+                           scene->bvh->objects == scene->objects &&
+                           scene->bvh->geometry == scene->geometry));
 
   PackFlags pack_flags = PackFlags::PACK_NONE;
 
@@ -1271,14 +1454,31 @@ void GeometryManager::device_update_bvh(Device *device,
     bvh = scene->bvh = BVH::create(bparams, scene->geometry, scene->objects, device);
   }
 
+  if (can_refit && has_bvh2_layout) {
+    /* Refit updates the packed BVH in place, take it back from the device arrays. */
+    BVH2 *bvh2 = static_cast<BVH2 *>(bvh);
+    dscene->bvh_nodes.give_data(bvh2->pack.nodes);
+    dscene->bvh_leaf_nodes.give_data(bvh2->pack.leaf_nodes);
+    dscene->object_node.give_data(bvh2->pack.object_node);
+    dscene->prim_type.give_data(bvh2->pack.prim_type);
+    dscene->prim_index.give_data(bvh2->pack.prim_index);
+    dscene->prim_object.give_data(bvh2->pack.prim_object);
+    dscene->prim_time.give_data(bvh2->pack.prim_time);
+    bvh2->pack.root_index = dscene->data.bvh.root;
+  }
+
   device->build_bvh(bvh, progress, can_refit);
 
+  if (can_refit && bvh->refit_degraded()) {
+    VLOG(1) << "Refit scene BVH degraded from cost " << bvh->build_cost << " to "
+            << bvh->refit_cost << ", rebuilding.";
+    device->build_bvh(bvh, progress, false);
+  }
+
   if (progress.get_cancel()) {
     return;
   }
 
-  const bool has_bvh2_layout = (bparams.bvh_layout == BVH_LAYOUT_BVH2);
-
   PackedBVH pack;
   if (has_bvh2_layout) {
     pack = std::move(static_cast<BVH2 *>(bvh)->pack);
@@ -1411,24 +1611,16 @@ void GeometryManager::device_update_bvh(Device *device,
   dscene->data.bvh.scene = 0;
 }
 
-/* Set of flags used to help determining what data has been modified or needs reallocation, so we
- * can decide which device data to free or update. */
+/* Set of flags used to help determining what data needs reallocation, so we can decide which
+ * device data to free. Modified data is tagged per geometry when it is packed. */
 enum {
-  DEVICE_CURVE_DATA_MODIFIED = (1 << 0),
-  DEVICE_MESH_DATA_MODIFIED = (1 << 1),
+  CURVE_DATA_NEED_REALLOC = (1 << 0),
+  MESH_DATA_NEED_REALLOC = (1 << 1),
 
-  ATTR_FLOAT_MODIFIED = (1 << 2),
-  ATTR_FLOAT2_MODIFIED = (1 << 3),
-  ATTR_FLOAT3_MODIFIED = (1 << 4),
-  ATTR_UCHAR4_MODIFIED = (1 << 5),
-
-  CURVE_DATA_NEED_REALLOC = (1 << 6),
-  MESH_DATA_NEED_REALLOC = (1 << 7),
-
-  ATTR_FLOAT_NEEDS_REALLOC = (1 << 8),
-  ATTR_FLOAT2_NEEDS_REALLOC = (1 << 9),
-  ATTR_FLOAT3_NEEDS_REALLOC = (1 << 10),
-  ATTR_UCHAR4_NEEDS_REALLOC = (1 << 11),
+  ATTR_FLOAT_NEEDS_REALLOC = (1 << 2),
+  ATTR_FLOAT2_NEEDS_REALLOC = (1 << 3),
+  ATTR_FLOAT3_NEEDS_REALLOC = (1 << 4),
+  ATTR_UCHAR4_NEEDS_REALLOC = (1 << 5),
 
   ATTRS_NEED_REALLOC = (ATTR_FLOAT_NEEDS_REALLOC | ATTR_FLOAT2_NEEDS_REALLOC |
                         ATTR_FLOAT3_NEEDS_REALLOC | ATTR_UCHAR4_NEEDS_REALLOC),
@@ -1436,37 +1628,6 @@ enum {
   DEVICE_CURVE_DATA_NEEDS_REALLOC = (CURVE_DATA_NEED_REALLOC | ATTRS_NEED_REALLOC),
 };
 
-static void update_device_flags_attribute(uint32_t &device_update_flags,
-                                          const AttributeSet &attributes)
-{
-  foreach (const Attribute &attr, attributes.attributes) {
-    if (!attr.modified) {
-      continue;
-    }
-
-    AttrKernelDataType kernel_type = Attribute::kernel_type(attr);
-
-    switch (kernel_type) {
-      case AttrKernelDataType::FLOAT: {
-        device_update_flags |= ATTR_FLOAT_MODIFIED;
-        break;
-      }
-      case AttrKernelDataType::FLOAT2: {
-        device_update_flags |= ATTR_FLOAT2_MODIFIED;
-        break;
-      }
-      case AttrKernelDataType::FLOAT3: {
-        device_update_flags |= ATTR_FLOAT3_MODIFIED;
-        break;
-      }
-      case AttrKernelDataType::UCHAR4: {
-        device_update_flags |= ATTR_UCHAR4_MODIFIED;
-        break;
-      }
-    }
-  }
-}
-
 static void update_attribute_realloc_flags(uint32_t &device_update_flags,
                                            const AttributeSet &attributes)
 {
@@ -1561,13 +1722,6 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
       }
     }
 
-    /* only check for modified attributes if we do not need to reallocate them already */
-    if ((device_update_flags & ATTRS_NEED_REALLOC) == 0) {
-      update_device_flags_attribute(device_update_flags, geom->attributes);
-      /* don't check for subd_attributes, as if they were modified, we would need to reallocate
-       * anyway */
-    }
-
     /* Re-create volume mesh if we will rebuild or refit the BVH. Note we
      * should only do it in that case, otherwise the BVH and mesh can go
      * out of sync. */
@@ -1594,9 +1748,6 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
       if (hair->need_update_rebuild) {
         device_update_flags |= DEVICE_CURVE_DATA_NEEDS_REALLOC;
       }
-      else if (hair->is_modified()) {
-        device_update_flags |= DEVICE_CURVE_DATA_MODIFIED;
-      }
     }
 
     if (geom->is_mesh()) {
@@ -1605,9 +1756,6 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
       if (mesh->need_update_rebuild) {
         device_update_flags |= DEVICE_MESH_DATA_NEEDS_REALLOC;
       }
-      else if (mesh->is_modified()) {
-        device_update_flags |= DEVICE_MESH_DATA_MODIFIED;
-      }
     }
   }
 
@@ -1619,6 +1767,17 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     device_update_flags |= DEVICE_CURVE_DATA_NEEDS_REALLOC;
   }
 
+  /* Quantized attributes are not stored in the array of their kernel type: UVs and normals are
+   * stored in the float array, colors in the float2 array. */
+  if (scene->params.use_quantized_attributes) {
+    if (device_update_flags & ATTR_FLOAT2_NEEDS_REALLOC) {
+      device_update_flags |= ATTR_FLOAT_NEEDS_REALLOC;
+    }
+    if (device_update_flags & ATTR_FLOAT3_NEEDS_REALLOC) {
+      device_update_flags |= ATTR_FLOAT_NEEDS_REALLOC | ATTR_FLOAT2_NEEDS_REALLOC;
+    }
+  }
+
   /* tag the device arrays for reallocation or modification */
   DeviceScene *dscene = &scene->dscene;
 
@@ -1639,6 +1798,7 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
 
     if (device_update_flags & DEVICE_MESH_DATA_NEEDS_REALLOC) {
       dscene->tri_vnormal.tag_realloc();
+      dscene->tri_vnormal_quantized.tag_realloc();
       dscene->tri_vindex.tag_realloc();
       dscene->tri_patch.tag_realloc();
       dscene->tri_patch_uv.tag_realloc();
@@ -1660,45 +1820,24 @@ void GeometryManager::device_update_preprocess(Device *device, Scene *scene, Pro
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT_MODIFIED) {
-    dscene->attributes_float.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT2_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float2.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT2_MODIFIED) {
-    dscene->attributes_float2.tag_modified();
-  }
 
   if (device_update_flags & ATTR_FLOAT3_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_float3.tag_realloc();
   }
-  else if (device_update_flags & ATTR_FLOAT3_MODIFIED) {
-    dscene->attributes_float3.tag_modified();
-  }
 
   if (device_update_flags & ATTR_UCHAR4_NEEDS_REALLOC) {
     dscene->attributes_map.tag_realloc();
     dscene->attributes_uchar4.tag_realloc();
   }
-  else if (device_update_flags & ATTR_UCHAR4_MODIFIED) {
-    dscene->attributes_uchar4.tag_modified();
-  }
 
-  if (device_update_flags & DEVICE_MESH_DATA_MODIFIED) {
-    /* if anything else than vertices or shaders are modified, we would need to reallocate, so
-     * these are the only arrays that can be updated */
-    dscene->tri_vnormal.tag_modified();
-    dscene->tri_shader.tag_modified();
-  }
-
-  if (device_update_flags & DEVICE_CURVE_DATA_MODIFIED) {
-    dscene->curve_keys.tag_modified();
-    dscene->curves.tag_modified();
-  }
+  /* Without reallocation, only the ranges of modified geometry and attributes are tagged when
+   * they are packed, see device_update_mesh() and update_attribute_element_offset(). */
 
   need_flags_update = false;
 }
@@ -1845,7 +1984,7 @@ void GeometryManager::device_update(Device *device,
                                    dicing_camera->get_full_height());
     dicing_camera->update(scene);
 
-    size_t i = 0;
+    vector<Mesh *> tess_meshes;
     foreach (Geometry *geom, scene->geometry) {
       if (!(geom->is_modified() && geom->is_mesh())) {
         continue;
@@ -1853,26 +1992,36 @@ void GeometryManager::device_update(Device *device,
 
       Mesh *mesh = static_cast<Mesh *>(geom);
       if (mesh->need_tesselation()) {
-        string msg = "Tessellating ";
-        if (mesh->name == "")
-          msg += string_printf("%u/%u", (uint)(i + 1), (uint)total_tess_needed);
-        else
-          msg += string_printf(
-              "%s %u/%u", mesh->name.c_str(), (uint)(i + 1), (uint)total_tess_needed);
+        tess_meshes.push_back(mesh);
+      }
+    }
 
-        progress.set_status("Updating Mesh", msg);
+    /* Meshes are independent of each other, so they are tessellated in parallel. */
+    const bool use_subd_cache = scene->params.use_subd_cache;
+    parallel_for(blocked_range<size_t>(0, tess_meshes.size(), 1),
+                 [&](const blocked_range<size_t> &r) {
+                   for (size_t i = r.begin(); i != r.end(); i++) {
+                     if (progress.get_cancel()) {
+                       return;
+                     }
 
-        mesh->subd_params->camera = dicing_camera;
-        DiagSplit dsplit(*mesh->subd_params);
-        mesh->tessellate(&dsplit);
+                     Mesh *mesh = tess_meshes[i];
+                     string msg = "Tessellating ";
+                     if (mesh->name == "")
+                       msg += string_printf("%u/%u", (uint)(i + 1), (uint)tess_meshes.size());
+                     else
+                       msg += string_printf("%s %u/%u",
+                                            mesh->name.c_str(),
+                                            (uint)(i + 1),
+                                            (uint)tess_meshes.size());
 
-        i++;
+                     progress.set_status("Updating Mesh", msg);
 
-        if (progress.get_cancel()) {
-          return;
-        }
-      }
-    }
+                     mesh->subd_params->camera = dicing_camera;
+                     DiagSplit dsplit(*mesh->subd_params);
+                     mesh->tessellate(&dsplit, use_subd_cache);
+                   }
+                 });
 
     if (progress.get_cancel()) {
       return;
@@ -1961,6 +2110,22 @@ void GeometryManager::device_update(Device *device,
     return;
   }
 
+  /* Keep the final geometry of adaptively subdivided meshes for the next update, and drop it for
+   * meshes which are no longer subdivided. */
+  foreach (Geometry *geom, scene->geometry) {
+    if (!geom->is_mesh()) {
+      continue;
+    }
+    Mesh *mesh = static_cast<Mesh *>(geom);
+    if (!scene->params.use_subd_cache ||
+        mesh->get_subdivision_type() == Mesh::SUBDIVISION_NONE) {
+      mesh->subd_cache_free();
+    }
+    else if (mesh->is_modified()) {
+      mesh->subd_cache_store();
+    }
+  }
+
   /* Device re-update after displacement. */
   if (displacement_done) {
     scoped_callback_timer timer([scene](double time) {
@@ -2102,6 +2267,7 @@ void GeometryManager::device_update(Device *device,
   dscene->tri_vindex.clear_modified();
   dscene->tri_patch.clear_modified();
   dscene->tri_vnormal.clear_modified();
+  dscene->tri_vnormal_quantized.clear_modified();
   dscene->tri_patch_uv.clear_modified();
   dscene->curves.clear_modified();
   dscene->curve_keys.clear_modified();
@@ -2127,6 +2293,7 @@ void GeometryManager::device_free(Device *device, DeviceScene *dscene, bool forc
   dscene->prim_time.free_if_need_realloc(force_free);
   dscene->tri_shader.free_if_need_realloc(force_free);
   dscene->tri_vnormal.free_if_need_realloc(force_free);
+  dscene->tri_vnormal_quantized.free_if_need_realloc(force_free);
   dscene->tri_vindex.free_if_need_realloc(force_free);
   dscene->tri_patch.free_if_need_realloc(force_free);
   dscene->tri_patch_uv.free_if_need_realloc(force_free);
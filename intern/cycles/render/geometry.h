@@ -289,6 +289,7 @@ class GeometryManager {
                                               size_t &attr_uchar4_offset,
                                               Attribute *mattr,
                                               AttributePrimitive prim,
+                                              bool use_quantized_attributes,
                                               TypeDesc &type,
                                               AttributeDescriptor &desc);
 };
@@ -17,6 +17,7 @@
 #include "render/graph.h"
 #include "render/attribute.h"
 #include "render/constant_fold.h"
+#include "render/image.h"
 #include "render/nodes.h"
 #include "render/scene.h"
 #include "render/shader.h"
@@ -366,6 +367,10 @@ void ShaderGraph::simplify(Scene *scene)
     clean(scene);
     refine_bump_nodes();
 
+    if (scene->image_manager->use_texture_cache() && !scene->shader_manager->use_osl()) {
+      refine_texture_derivatives();
+    }
+
     simplified = true;
   }
 }
@@ -954,6 +959,47 @@ void ShaderGraph::refine_bump_nodes()
   }
 }
 
+void ShaderGraph::refine_texture_derivatives()
+{
+  /* Images read through the texture cache choose the mipmap level from the derivatives of the
+   * texture coordinates. Like for bump nodes, we copy the sub-graph defined by the vector input
+   * to the "Vector DX" and "Vector DY" inputs, with texture coordinates shifted by dx/dy. */
+
+  foreach (ShaderNode *node, nodes) {
+    ShaderInput *vector_in = node->input("Vector");
+    ShaderInput *vector_dx_in = node->input("Vector DX");
+    ShaderInput *vector_dy_in = node->input("Vector DY");
+
+    /* Copies of nodes in the sub-graphs are already connected. */
+    if (!(vector_dx_in && vector_dy_in && vector_in->link) || vector_dx_in->link) {
+      continue;
+    }
+
+    ShaderNodeSet nodes_vector;
+    ShaderNodeMap nodes_dx;
+    ShaderNodeMap nodes_dy;
+
+    find_dependencies(nodes_vector, vector_in);
+
+    copy_nodes(nodes_vector, nodes_dx);
+    copy_nodes(nodes_vector, nodes_dy);
+
+    foreach (NodePair &pair, nodes_dx)
+      pair.second->bump = SHADER_BUMP_DX;
+    foreach (NodePair &pair, nodes_dy)
+      pair.second->bump = SHADER_BUMP_DY;
+
+    ShaderOutput *out = vector_in->link;
+    connect(nodes_dx[out->parent]->output(out->name()), vector_dx_in);
+    connect(nodes_dy[out->parent]->output(out->name()), vector_dy_in);
+
+    foreach (NodePair &pair, nodes_dx)
+      add(pair.second);
+    foreach (NodePair &pair, nodes_dy)
+      add(pair.second);
+  }
+}
+
 void ShaderGraph::bump_from_displacement(bool use_object_space)
 {
   /* generate bump mapping automatically from displacement. bump mapping is
@@ -32,6 +32,8 @@
 #include "util/util_texture.h"
 #include "util/util_unique_ptr.h"
 
+#include <OpenImageIO/texture.h>
+
 #ifdef WITH_OSL
 #  include <OSL/oslexec.h>
 #endif
@@ -77,6 +79,8 @@ const char *name_from_type(ImageDataType type)
       return "nanovdb_float";
     case IMAGE_DATA_TYPE_NANOVDB_FLOAT3:
       return "nanovdb_float3";
+    case IMAGE_DATA_TYPE_TEXTURE_CACHE:
+      return "texture_cache";
     case IMAGE_DATA_NUM_TYPES:
       assert(!"System enumerator type, should never be used");
       return "";
@@ -302,6 +306,11 @@ ImageManager::ImageManager(const DeviceInfo &info)
   osl_texture_system = NULL;
   animation_frame = 0;
 
+  /* Only the CPU kernels can read from the texture cache. */
+  has_texture_cache = (info.type == DEVICE_CPU);
+  texture_cache_size = 0;
+  texture_cache_system = NULL;
+
   /* Set image limits */
   features.has_half_float = info.has_half_images;
   features.has_nanovdb = info.has_nanovdb;
@@ -311,6 +320,8 @@ ImageManager::~ImageManager()
 {
   for (size_t slot = 0; slot < images.size(); slot++)
     assert(!images[slot]);
+
+  texture_cache_free();
 }
 
 void ImageManager::set_osl_texture_system(void *texture_system)
@@ -318,6 +329,16 @@ void ImageManager::set_osl_texture_system(void *texture_system)
   osl_texture_system = texture_system;
 }
 
+void ImageManager::set_texture_cache_size(int size)
+{
+  texture_cache_size = (has_texture_cache) ? size : 0;
+}
+
+bool ImageManager::use_texture_cache() const
+{
+  return texture_cache_size > 0;
+}
+
 bool ImageManager::set_animation_frame_update(int frame)
 {
   if (frame != animation_frame) {
@@ -642,6 +663,120 @@ bool ImageManager::file_load_image(Image *img, int texture_limit)
   return true;
 }
 
+/* Prefer a tiled and mipmapped .tx file next to the image as created by maketx, otherwise the
+ * texture cache generates tiles and mipmaps itself. */
+static ustring texture_cache_filepath(const ustring &filepath)
+{
+  const string filename = path_filename(filepath.string());
+  const size_t extension_start = filename.rfind('.');
+  if (extension_start != string::npos) {
+    const string tx_filepath = path_join(path_dirname(filepath.string()),
+                                         filename.substr(0, extension_start) + ".tx");
+    if (path_exists(tx_filepath)) {
+      return ustring(tx_filepath);
+    }
+  }
+  return filepath;
+}
+
+bool ImageManager::texture_cache_supports(const ImageMetaData &metadata,
+                                          const ImageParams &params)
+{
+  /* The texture cache reads pixels from the file as they are, so only images which need no
+   * conversion on load can use it. Volumes are always loaded into device memory. */
+  if (metadata.depth > 1 || !(metadata.channels > 0)) {
+    return false;
+  }
+  if (metadata.colorspace != u_colorspace_raw && metadata.colorspace != u_colorspace_srgb) {
+    return false;
+  }
+
+  /* The texture cache associates alpha of grayscale + alpha and RGBA files, and can not ignore
+   * or keep it channel packed. */
+  const bool has_alpha = (metadata.channels == 2 || metadata.channels >= 4);
+  if (has_alpha && (ColorSpaceManager::colorspace_is_data(params.colorspace) ||
+                    params.alpha_type == IMAGE_ALPHA_IGNORE ||
+                    params.alpha_type == IMAGE_ALPHA_CHANNEL_PACKED)) {
+    return false;
+  }
+
+  return true;
+}
+
+void *ImageManager::texture_cache_handle(Image *img)
+{
+  if (!use_texture_cache()) {
+    return NULL;
+  }
+
+  /* Packed and generated images are always loaded into device memory. */
+  const ustring filepath = img->loader->osl_filepath();
+  if (filepath.empty() || !texture_cache_supports(img->metadata, img->params)) {
+    return NULL;
+  }
+
+  thread_scoped_lock device_lock(device_mutex);
+
+  if (texture_cache_system == NULL) {
+    OIIO::TextureSystem *texture_system = OIIO::TextureSystem::create(false);
+    texture_system->attribute("max_memory_MB", (float)texture_cache_size);
+    texture_system->attribute("autotile", 64);
+    texture_system->attribute("automip", 1);
+    texture_system->attribute("accept_untiled", 1);
+    texture_system->attribute("accept_unmipped", 1);
+    texture_cache_system = texture_system;
+  }
+
+  OIIO::TextureSystem *texture_system = (OIIO::TextureSystem *)texture_cache_system;
+  OIIO::TextureSystem::TextureHandle *texture_handle = texture_system->get_texture_handle(
+      texture_cache_filepath(filepath));
+  if (texture_handle == NULL || !texture_system->good(texture_handle)) {
+    VLOG(1) << "Texture cache failed to open " << img->loader->name()
+            << ", loading into device memory instead.";
+    return NULL;
+  }
+
+  return texture_handle;
+}
+
+void ImageManager::texture_cache_load_image(Image *img, void *texture_handle, int texture_limit)
+{
+  /* Instead of scaling the image down, limit the resolution by never filtering over less than
+   * the pixels of the scaled down image. The mipmap level is chosen accordingly. */
+  float min_filter_width = 0.0f;
+  const size_t max_size = max(img->metadata.width, img->metadata.height);
+  if (texture_limit > 0 && max_size > texture_limit) {
+    float scale_factor = 1.0f;
+    while (max_size * scale_factor > texture_limit) {
+      scale_factor *= 0.5f;
+    }
+    min_filter_width = 1.0f / (max_size * scale_factor);
+    VLOG(1) << "Limiting texture cache resolution of " << img->loader->name()
+            << " by a factor of " << scale_factor << ".";
+  }
+
+  thread_scoped_lock device_lock(device_mutex);
+  TextureCacheImage *cache_image = (TextureCacheImage *)img->mem->alloc(
+      sizeof(TextureCacheImage), 0);
+
+  cache_image->texture_system = texture_cache_system;
+  cache_image->texture_handle = texture_handle;
+  cache_image->num_channels = min(img->metadata.channels, 4);
+  cache_image->min_filter_width = min_filter_width;
+}
+
+void ImageManager::texture_cache_free()
+{
+  if (texture_cache_system == NULL) {
+    return;
+  }
+
+  OIIO::TextureSystem *texture_system = (OIIO::TextureSystem *)texture_cache_system;
+  VLOG(1) << "Texture cache statistics:\n" << texture_system->getstats();
+  OIIO::TextureSystem::destroy(texture_system);
+  texture_cache_system = NULL;
+}
+
 void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Progress *progress)
 {
   if (progress->get_cancel()) {
@@ -657,6 +792,11 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   load_image_metadata(img);
   ImageDataType type = img->metadata.type;
 
+  void *texture_handle = texture_cache_handle(img);
+  if (texture_handle) {
+    type = IMAGE_DATA_TYPE_TEXTURE_CACHE;
+  }
+
   /* Name for debugging. */
   img->mem_name = string_printf("__tex_image_%s_%03d", name_from_type(type), slot);
 
@@ -673,7 +813,10 @@ void ImageManager::device_load_image(Device *device, Scene *scene, int slot, Pro
   img->mem->info.transform_3d = img->metadata.transform_3d;
 
   /* Create new texture. */
-  if (type == IMAGE_DATA_TYPE_FLOAT4) {
+  if (type == IMAGE_DATA_TYPE_TEXTURE_CACHE) {
+    texture_cache_load_image(img, texture_handle, texture_limit);
+  }
+  else if (type == IMAGE_DATA_TYPE_FLOAT4) {
     if (!file_load_image<TypeDesc::FLOAT, float>(img, texture_limit)) {
       /* on failure to load, we set a 1x1 pixels pink image */
       thread_scoped_lock device_lock(device_mutex);
@@ -794,6 +937,13 @@ void ImageManager::device_free_image(Device *, int slot)
 #endif
   }
 
+  if (texture_cache_system) {
+    ustring filepath = img->loader->osl_filepath();
+    if (!filepath.empty()) {
+      ((OIIO::TextureSystem *)texture_cache_system)->invalidate(texture_cache_filepath(filepath));
+    }
+  }
+
   if (img->mem) {
     thread_scoped_lock device_lock(device_mutex);
     delete img->mem;
@@ -882,6 +1032,8 @@ void ImageManager::device_free(Device *device)
     device_free_image(device, slot);
   }
   images.clear();
+
+  texture_cache_free();
 }
 
 void ImageManager::collect_statistics(RenderStats *stats)
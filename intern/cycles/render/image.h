@@ -194,6 +194,14 @@ class ImageManager {
   void set_osl_texture_system(void *texture_system);
   bool set_animation_frame_update(int frame);
 
+  /* Read image files on demand through a texture cache with the given memory budget in
+   * megabytes, instead of loading them fully into device memory. Zero disables the cache. */
+  void set_texture_cache_size(int size);
+  bool use_texture_cache() const;
+
+  /* Whether pixels read through the texture cache match those loaded into device memory. */
+  static bool texture_cache_supports(const ImageMetaData &metadata, const ImageParams &params);
+
   void collect_statistics(RenderStats *stats);
 
   void tag_update();
@@ -229,6 +237,10 @@ class ImageManager {
   vector<Image *> images;
   void *osl_texture_system;
 
+  bool has_texture_cache;
+  int texture_cache_size;
+  void *texture_cache_system;
+
   int add_image_slot(ImageLoader *loader, const ImageParams &params, const bool builtin);
   void add_image_user(int slot);
   void remove_image_user(int slot);
@@ -238,6 +250,10 @@ class ImageManager {
   template<TypeDesc::BASETYPE FileFormat, typename StorageType>
   bool file_load_image(Image *img, int texture_limit);
 
+  void *texture_cache_handle(Image *img);
+  void texture_cache_load_image(Image *img, void *texture_handle, int texture_limit);
+  void texture_cache_free();
+
   void device_load_image(Device *device, Scene *scene, int slot, Progress *progress);
   void device_free_image(Device *device, int slot);
 
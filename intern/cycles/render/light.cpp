@@ -21,6 +21,7 @@
 #include "render/graph.h"
 #include "render/integrator.h"
 #include "render/light.h"
+#include "render/light_tree.h"
 #include "render/mesh.h"
 #include "render/nodes.h"
 #include "render/object.h"
@@ -30,6 +31,7 @@
 
 #include "integrator/shader_eval.h"
 
+#include "util/util_algorithm.h"
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_logging.h"
@@ -269,6 +271,53 @@ bool LightManager::object_usable_as_light(Object *object)
   return false;
 }
 
+/* Estimated strength of the emission shader, used to weight mesh lights in the light tree. */
+static float light_tree_shader_strength(Shader *shader)
+{
+  float3 emission;
+  if (shader->is_constant_emission(&emission)) {
+    return average(fabs(emission));
+  }
+  return 1.0f;
+}
+
+static LightTreeEmitter light_tree_emitter_from_light(const Light *light)
+{
+  LightTreeEmitter emitter;
+  const float strength = average(fabs(light->get_strength()));
+
+  if (light->get_light_type() == LIGHT_DISTANT || light->get_light_type() == LIGHT_BACKGROUND) {
+    emitter.is_infinite = true;
+    emitter.energy = strength;
+  }
+  else if (light->get_light_type() == LIGHT_AREA) {
+    const float3 axisu = light->get_axisu() * (light->get_sizeu() * light->get_size());
+    const float3 axisv = light->get_axisv() * (light->get_sizev() * light->get_size());
+    const float3 co = light->get_co();
+    emitter.bbox.grow(co - 0.5f * axisu - 0.5f * axisv);
+    emitter.bbox.grow(co - 0.5f * axisu + 0.5f * axisv);
+    emitter.bbox.grow(co + 0.5f * axisu - 0.5f * axisv);
+    emitter.bbox.grow(co + 0.5f * axisu + 0.5f * axisv);
+    /* Area lights only emit to the front side. */
+    emitter.orientation.axis = safe_normalize(light->get_dir());
+    emitter.orientation.theta_o = 0.0f;
+    emitter.orientation.theta_e = M_PI_2_F;
+    emitter.energy = 0.25f * strength;
+  }
+  else {
+    const float radius = light->get_size();
+    emitter.bbox.grow(light->get_co(), radius);
+    if (light->get_light_type() == LIGHT_SPOT) {
+      emitter.orientation.axis = safe_normalize(light->get_dir());
+      emitter.orientation.theta_o = 0.0f;
+      emitter.orientation.theta_e = min(0.5f * light->get_spot_angle(), M_PI_2_F);
+    }
+    emitter.energy = 0.25f * M_1_PI_F * strength;
+  }
+
+  return emitter;
+}
+
 void LightManager::device_update_distribution(Device *,
                                               DeviceScene *dscene,
                                               Scene *scene,
@@ -323,6 +372,13 @@ void LightManager::device_update_distribution(Device *,
   KernelLightDistribution *distribution = dscene->light_distribution.alloc(num_distribution + 1);
   float totarea = 0.0f;
 
+  /* Emitters of the light tree, in the same order as in the distribution. */
+  const bool use_light_tree = scene->integrator->get_use_light_tree();
+  vector<LightTreeEmitter> tree_emitters;
+  if (use_light_tree) {
+    tree_emitters.reserve(num_distribution);
+  }
+
   /* triangles */
   size_t offset = 0;
   int j = 0;
@@ -361,6 +417,13 @@ void LightManager::device_update_distribution(Device *,
       shader_flag |= SHADER_EXCLUDE_SHADOW_CATCHER;
     }
 
+    vector<float> shader_strengths;
+    if (use_light_tree) {
+      for (Node *node : mesh->get_used_shaders()) {
+        shader_strengths.push_back(light_tree_shader_strength(static_cast<Shader *>(node)));
+      }
+    }
+
     size_t mesh_num_triangles = mesh->num_triangles();
     for (size_t i = 0; i < mesh_num_triangles; i++) {
       int shader_index = mesh->get_shader()[i];
@@ -375,6 +438,10 @@ void LightManager::device_update_distribution(Device *,
         distribution[offset].mesh_light.object_id = object_id;
         offset++;
 
+        if (use_light_tree) {
+          tree_emitters.push_back(LightTreeEmitter());
+        }
+
         Mesh::Triangle t = mesh->get_triangle(i);
         if (!t.valid(&mesh->get_verts()[0])) {
           continue;
@@ -389,7 +456,21 @@ void LightManager::device_update_distribution(Device *,
           p3 = transform_point(&tfm, p3);
         }
 
-        totarea += triangle_area(p1, p2, p3);
+        const float area = triangle_area(p1, p2, p3);
+        totarea += area;
+
+        if (use_light_tree) {
+          /* Mesh lights emit from both sides. Area is stored in place of the pdf until the
+           * distribution is normalized. */
+          LightTreeEmitter &emitter = tree_emitters.back();
+          emitter.bbox.grow(p1);
+          emitter.bbox.grow(p2);
+          emitter.bbox.grow(p3);
+          emitter.energy = area * ((shader_index < shader_strengths.size()) ?
+                                       shader_strengths[shader_index] :
+                                       1.0f);
+          emitter.distribution_pdf = area;
+        }
       }
     }
 
@@ -413,6 +494,10 @@ void LightManager::device_update_distribution(Device *,
       distribution[offset].lamp.size = light->size;
       totarea += lightarea;
 
+      if (use_light_tree) {
+        tree_emitters.push_back(light_tree_emitter_from_light(light));
+      }
+
       if (light->light_type == LIGHT_DISTANT) {
         use_lamp_mis |= (light->angle > 0.0f && light->use_mis);
       }
@@ -478,6 +563,33 @@ void LightManager::device_update_distribution(Device *,
 
     kintegrator->use_lamp_mis = use_lamp_mis;
 
+    /* Light tree. */
+    kintegrator->use_light_tree = use_light_tree;
+    if (use_light_tree) {
+      for (size_t i = 0; i < num_distribution; i++) {
+        tree_emitters[i].distribution_pdf = (i < num_triangles) ?
+                                                tree_emitters[i].distribution_pdf *
+                                                    kintegrator->pdf_triangles :
+                                                kintegrator->pdf_lights;
+      }
+
+      LightTree light_tree(tree_emitters);
+      VLOG(1) << "Light tree built with " << light_tree.nodes.size() << " nodes.";
+
+      KernelLightTreeNode *tree_nodes = dscene->light_tree_nodes.alloc(light_tree.nodes.size());
+      std::copy(light_tree.nodes.begin(), light_tree.nodes.end(), tree_nodes);
+      uint *tree_emitter_nodes = dscene->light_tree_emitter_nodes.alloc(num_distribution);
+      std::copy(
+          light_tree.emitter_nodes.begin(), light_tree.emitter_nodes.end(), tree_emitter_nodes);
+
+      dscene->light_tree_nodes.copy_to_device();
+      dscene->light_tree_emitter_nodes.copy_to_device();
+    }
+    else {
+      dscene->light_tree_nodes.free();
+      dscene->light_tree_emitter_nodes.free();
+    }
+
     /* bit of an ugly hack to compensate for emitting triangles influencing
      * amount of samples we get for this pass */
     kfilm->pass_shadow_scale = 1.0f;
@@ -508,12 +620,15 @@ void LightManager::device_update_distribution(Device *,
   }
   else {
     dscene->light_distribution.free();
+    dscene->light_tree_nodes.free();
+    dscene->light_tree_emitter_nodes.free();
 
     kintegrator->num_distribution = 0;
     kintegrator->num_all_lights = 0;
     kintegrator->pdf_triangles = 0.0f;
     kintegrator->pdf_lights = 0.0f;
     kintegrator->use_lamp_mis = false;
+    kintegrator->use_light_tree = false;
 
     kbackground->num_portals = 0;
     kbackground->portal_offset = 0;
@@ -1007,6 +1122,8 @@ void LightManager::device_update(Device *device,
 void LightManager::device_free(Device *, DeviceScene *dscene, const bool free_background)
 {
   dscene->light_distribution.free();
+  dscene->light_tree_nodes.free();
+  dscene->light_tree_emitter_nodes.free();
   dscene->lights.free();
   if (free_background) {
     dscene->light_background_marginal_cdf.free();
@@ -0,0 +1,307 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "render/light_tree.h"
+
+#include "util/util_algorithm.h"
+#include "util/util_math.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Light Tree Orientation */
+
+LightTreeOrientation LightTreeOrientation::merge(const LightTreeOrientation &cone_a,
+                                                 const LightTreeOrientation &cone_b)
+{
+  /* Algorithm from the paper, with a being the wider cone. */
+  const bool is_b_wider = cone_b.theta_o > cone_a.theta_o;
+  const LightTreeOrientation &a = (is_b_wider) ? cone_b : cone_a;
+  const LightTreeOrientation &b = (is_b_wider) ? cone_a : cone_b;
+
+  LightTreeOrientation result;
+  result.theta_e = max(a.theta_e, b.theta_e);
+
+  const float cos_theta_d = dot(a.axis, b.axis);
+  const float theta_d = safe_acosf(cos_theta_d);
+  if (min(theta_d + b.theta_o, M_PI_F) <= a.theta_o) {
+    /* Cone b is inside of cone a. */
+    result.axis = a.axis;
+    result.theta_o = a.theta_o;
+    return result;
+  }
+
+  const float theta_o = 0.5f * (a.theta_o + theta_d + b.theta_o);
+  const float3 ortho = b.axis - a.axis * cos_theta_d;
+  const float ortho_len = len(ortho);
+  if (theta_o >= M_PI_F || ortho_len < 1e-6f) {
+    result.axis = a.axis;
+    result.theta_o = M_PI_F;
+    return result;
+  }
+
+  /* Rotate axis of cone a towards the axis of cone b. */
+  const float theta_r = theta_o - a.theta_o;
+  result.axis = normalize(a.axis * cosf(theta_r) + ortho * (sinf(theta_r) / ortho_len));
+  result.theta_o = theta_o;
+  return result;
+}
+
+float LightTreeOrientation::measure() const
+{
+  const float theta_w = min(theta_o + theta_e, M_PI_F);
+  const float sin_theta_o = sinf(theta_o);
+  const float cos_theta_o = cosf(theta_o);
+  return M_2PI_F * (1.0f - cos_theta_o) +
+         M_PI_2_F * (2.0f * theta_w * sin_theta_o - cosf(theta_o - 2.0f * theta_w) -
+                     2.0f * theta_o * sin_theta_o + cos_theta_o);
+}
+
+/* Light Tree */
+
+LightTree::LightTree(const vector<LightTreeEmitter> &emitters)
+{
+  build(emitters);
+}
+
+void LightTree::build(const vector<LightTreeEmitter> &emitters)
+{
+  const int num_emitters = emitters.size();
+  emitter_nodes.resize(num_emitters);
+  if (num_emitters == 0) {
+    return;
+  }
+
+  /* Order of the emitters in the leaves. Emitters with a position go first, so that splitting
+   * separates them from the infinite ones before anything else. */
+  vector<int> order(num_emitters);
+  for (int i = 0; i < num_emitters; i++) {
+    order[i] = i;
+  }
+  std::stable_partition(
+      order.begin(), order.end(), [&](const int i) { return !emitters[i].is_infinite; });
+
+  /* The stack avoids recursion, the tree is not guaranteed to be balanced. */
+  nodes.reserve(2 * num_emitters - 1);
+  nodes.resize(1);
+  vector<BuildRange> stack;
+  stack.push_back({0, -1, 0, num_emitters});
+  while (!stack.empty()) {
+    const BuildRange range = stack.back();
+    stack.pop_back();
+    build_range(emitters, range, order, stack);
+  }
+}
+
+void LightTree::build_range(const vector<LightTreeEmitter> &emitters,
+                            const BuildRange &range,
+                            vector<int> &order,
+                            vector<BuildRange> &stack)
+{
+  BoundBox bbox = BoundBox::empty;
+  LightTreeOrientation orientation = emitters[order[range.begin]].orientation;
+  float energy = 0.0f;
+  float distribution_pdf = 0.0f;
+
+  for (int i = range.begin; i < range.end; i++) {
+    const LightTreeEmitter &emitter = emitters[order[i]];
+    if (emitter.bbox.valid()) {
+      bbox.grow(emitter.bbox);
+    }
+    if (i != range.begin) {
+      orientation = LightTreeOrientation::merge(orientation, emitter.orientation);
+    }
+    energy += emitter.energy;
+    distribution_pdf += emitter.distribution_pdf;
+  }
+
+  KernelLightTreeNode knode;
+  const float3 bbox_min = (bbox.valid()) ? bbox.min : zero_float3();
+  const float3 bbox_max = (bbox.valid()) ? bbox.max : zero_float3();
+  knode.bbox_min[0] = bbox_min.x;
+  knode.bbox_min[1] = bbox_min.y;
+  knode.bbox_min[2] = bbox_min.z;
+  knode.energy = energy;
+  knode.bbox_max[0] = bbox_max.x;
+  knode.bbox_max[1] = bbox_max.y;
+  knode.bbox_max[2] = bbox_max.z;
+  knode.theta_o = orientation.theta_o;
+  knode.axis[0] = orientation.axis.x;
+  knode.axis[1] = orientation.axis.y;
+  knode.axis[2] = orientation.axis.z;
+  knode.theta_e = orientation.theta_e;
+  knode.parent_index = range.parent_index;
+  knode.distribution_pdf = distribution_pdf;
+  /* Only the root can have both kinds of emitters, its flags are never used. */
+  knode.flags = (emitters[order[range.begin]].is_infinite &&
+                 emitters[order[range.end - 1]].is_infinite) ?
+                    LIGHT_TREE_NODE_INFINITE :
+                    0;
+
+  if (range.end - range.begin == 1) {
+    const int emitter_index = order[range.begin];
+    knode.child_index = ~emitter_index;
+    emitter_nodes[emitter_index] = range.node_index;
+  }
+  else {
+    const int middle = split_range(emitters, range, order);
+    const int child_index = nodes.size();
+    nodes.resize(child_index + 2);
+    knode.child_index = child_index;
+    stack.push_back({child_index, range.node_index, range.begin, middle});
+    stack.push_back({child_index + 1, range.node_index, middle, range.end});
+  }
+
+  nodes[range.node_index] = knode;
+}
+
+/* Split the range with the surface area orientation heuristic from the paper, evaluated at a
+ * fixed number of bins along every axis. Returns the first index of the second child. */
+int LightTree::split_range(const vector<LightTreeEmitter> &emitters,
+                           const BuildRange &range,
+                           vector<int> &order)
+{
+  static constexpr int kNumBins = 12;
+
+  const int middle = (range.begin + range.end) / 2;
+  const bool is_begin_infinite = emitters[order[range.begin]].is_infinite;
+  const bool is_end_infinite = emitters[order[range.end - 1]].is_infinite;
+
+  if (is_begin_infinite != is_end_infinite) {
+    return std::partition_point(order.begin() + range.begin,
+                                order.begin() + range.end,
+                                [&](const int i) { return !emitters[i].is_infinite; }) -
+           order.begin();
+  }
+  if (is_begin_infinite) {
+    /* Infinite emitters are picked proportionally to the light distribution, there is nothing to
+     * optimize for. */
+    return middle;
+  }
+
+  BoundBox centroid_bbox = BoundBox::empty;
+  for (int i = range.begin; i < range.end; i++) {
+    const LightTreeEmitter &emitter = emitters[order[i]];
+    if (emitter.bbox.valid()) {
+      centroid_bbox.grow(emitter.bbox.center());
+    }
+  }
+  if (!centroid_bbox.valid()) {
+    return middle;
+  }
+
+  const float3 extent = centroid_bbox.size();
+  const float max_extent = max3(extent);
+  if (max_extent == 0.0f) {
+    return middle;
+  }
+
+  auto emitter_bin = [&](const LightTreeEmitter &emitter, const int axis) {
+    if (!emitter.bbox.valid()) {
+      return 0;
+    }
+    const float offset = emitter.bbox.center()[axis] - centroid_bbox.min[axis];
+    return clamp((int)(kNumBins * offset / extent[axis]), 0, kNumBins - 1);
+  };
+
+  struct Bin {
+    BoundBox bbox = BoundBox(BoundBox::empty);
+    LightTreeOrientation orientation;
+    float energy = 0.0f;
+    int num_emitters = 0;
+
+    void add(const Bin &other)
+    {
+      if (other.num_emitters == 0) {
+        return;
+      }
+      bbox.grow(other.bbox);
+      orientation = (num_emitters == 0) ?
+                        other.orientation :
+                        LightTreeOrientation::merge(orientation, other.orientation);
+      energy += other.energy;
+      num_emitters += other.num_emitters;
+    }
+
+    float cost() const
+    {
+      return energy * ((bbox.valid()) ? bbox.area() : 0.0f) * orientation.measure();
+    }
+  };
+
+  float best_cost = FLT_MAX;
+  int best_axis = -1;
+  int best_bin = -1;
+
+  for (int axis = 0; axis < 3; axis++) {
+    if (extent[axis] == 0.0f) {
+      continue;
+    }
+
+    Bin bins[kNumBins];
+    for (int i = range.begin; i < range.end; i++) {
+      const LightTreeEmitter &emitter = emitters[order[i]];
+      Bin emitter_bin_data;
+      if (emitter.bbox.valid()) {
+        emitter_bin_data.bbox = emitter.bbox;
+      }
+      emitter_bin_data.orientation = emitter.orientation;
+      emitter_bin_data.energy = emitter.energy;
+      emitter_bin_data.num_emitters = 1;
+      bins[emitter_bin(emitter, axis)].add(emitter_bin_data);
+    }
+
+    /* Costs of everything to the right of the split, accumulated from the end. */
+    float right_costs[kNumBins];
+    Bin right;
+    for (int bin = kNumBins - 1; bin > 0; bin--) {
+      right.add(bins[bin]);
+      right_costs[bin] = (right.num_emitters) ? right.cost() : -1.0f;
+    }
+
+    /* Elongated clusters are preferred to be split along the longest axis. */
+    const float regularization = max_extent / extent[axis];
+    Bin left;
+    for (int bin = 0; bin < kNumBins - 1; bin++) {
+      left.add(bins[bin]);
+      if (left.num_emitters == 0 || right_costs[bin + 1] < 0.0f) {
+        continue;
+      }
+      const float cost = regularization * (left.cost() + right_costs[bin + 1]);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best_axis = axis;
+        best_bin = bin;
+      }
+    }
+  }
+
+  if (best_axis == -1) {
+    return middle;
+  }
+
+  const int split = std::partition(order.begin() + range.begin,
+                                   order.begin() + range.end,
+                                   [&](const int i) {
+                                     return emitter_bin(emitters[i], best_axis) <= best_bin;
+                                   }) -
+                    order.begin();
+  if (split == range.begin || split == range.end) {
+    return middle;
+  }
+  return split;
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,92 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __LIGHT_TREE_H__
+#define __LIGHT_TREE_H__
+
+#include "kernel/kernel_types.h"
+
+#include "util/util_boundbox.h"
+#include "util/util_types.h"
+#include "util/util_vector.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Bounds of the emission directions: normals are within theta_o of the axis, and emission
+ * happens within theta_e around the normal. */
+struct LightTreeOrientation {
+  float3 axis = make_float3(0.0f, 0.0f, 1.0f);
+  float theta_o = M_PI_F;
+  float theta_e = M_PI_2_F;
+
+  /* Orientation of an emitter which emits in all directions. */
+  static LightTreeOrientation omnidirectional()
+  {
+    return LightTreeOrientation();
+  }
+
+  /* Smallest cone which contains both of the cones. */
+  static LightTreeOrientation merge(const LightTreeOrientation &a, const LightTreeOrientation &b);
+
+  /* Measure of the cone from the paper, used by the build cost. */
+  float measure() const;
+};
+
+struct LightTreeEmitter {
+  /* Bounds of the emitter, unused for infinite emitters. */
+  BoundBox bbox = BoundBox(BoundBox::empty);
+  LightTreeOrientation orientation;
+  /* Estimated power of the emitter. */
+  float energy = 0.0f;
+  /* Probability of the flat light distribution to pick the emitter. */
+  float distribution_pdf = 0.0f;
+  /* Distant and background lights, which have no position. */
+  bool is_infinite = false;
+};
+
+/* Binary tree over the emitters of the light distribution, used for importance sampling of
+ * many lights in the kernel. Emitters are given in the light distribution order, and every leaf
+ * holds a single emitter. */
+class LightTree {
+ public:
+  explicit LightTree(const vector<LightTreeEmitter> &emitters);
+
+  /* Nodes of the tree, root is the first node. */
+  vector<KernelLightTreeNode> nodes;
+  /* Index of the leaf node of every emitter. */
+  vector<uint> emitter_nodes;
+
+ protected:
+  struct BuildRange {
+    int node_index;
+    int parent_index;
+    int begin;
+    int end;
+  };
+
+  void build(const vector<LightTreeEmitter> &emitters);
+  void build_range(const vector<LightTreeEmitter> &emitters,
+                   const BuildRange &range,
+                   vector<int> &order,
+                   vector<BuildRange> &stack);
+  int split_range(const vector<LightTreeEmitter> &emitters,
+                  const BuildRange &range,
+                  vector<int> &order);
+};
+
+CCL_NAMESPACE_END
+
+#endif /* __LIGHT_TREE_H__ */
@@ -16,8 +16,10 @@
 
 #include "render/merge.h"
 
+#include "util/util_algorithm.h"
 #include "util/util_array.h"
 #include "util/util_map.h"
+#include "util/util_math.h"
 #include "util/util_system.h"
 #include "util/util_time.h"
 #include "util/util_unique_ptr.h"
@@ -35,7 +37,8 @@ enum MergeChannelOp {
   MERGE_CHANNEL_NOP,
   MERGE_CHANNEL_COPY,
   MERGE_CHANNEL_SUM,
-  MERGE_CHANNEL_AVERAGE
+  MERGE_CHANNEL_AVERAGE,
+  MERGE_CHANNEL_SAMPLE_COUNT
 };
 
 struct MergeImagePass {
@@ -58,6 +61,10 @@ struct MergeImageLayer {
   vector<MergeImagePass> passes;
   /* Sample amount that was used for rendering this layer. */
   int samples;
+  /* First sample of the range that was rendered, -1 if the whole range was rendered. */
+  int start_sample;
+  /* Offset of the per-pixel sample count channel in the input image, -1 if there is none. */
+  int sample_count_offset;
 };
 
 /* Merge Image */
@@ -69,6 +76,27 @@ struct MergeImage {
   string filepath;
   /* Render layers. */
   vector<MergeImageLayer> layers;
+
+  /* First rendered sample of all layers, used to merge images in a fixed order. */
+  int start_sample() const
+  {
+    int start_sample = std::numeric_limits<int>::max();
+    for (const MergeImageLayer &layer : layers) {
+      if (layer.name != "") {
+        start_sample = min(start_sample, max(layer.start_sample, 0));
+      }
+    }
+    return start_sample;
+  }
+};
+
+/* Merge Channel */
+
+struct MergeChannel {
+  /* Type of operation to perform when merging, of the first image that has the channel. */
+  MergeChannelOp op;
+  /* Index of the render layer in the merged image. */
+  int layer;
 };
 
 /* Channel Parsing */
@@ -79,6 +107,9 @@ static MergeChannelOp parse_channel_operation(const string &pass_name)
       string_startswith(pass_name, "Crypto")) {
     return MERGE_CHANNEL_COPY;
   }
+  else if (pass_name == "Debug Sample Count") {
+    return MERGE_CHANNEL_SAMPLE_COUNT;
+  }
   else if (string_startswith(pass_name, "Debug BVH") ||
            string_startswith(pass_name, "Debug Ray") ||
            string_startswith(pass_name, "Debug Render Time")) {
@@ -171,6 +202,8 @@ static bool parse_channels(const ImageSpec &in_spec,
 
     layer.name = name;
     layer.samples = 0;
+    layer.start_sample = -1;
+    layer.sample_count_offset = -1;
 
     /* Determine number of samples from metadata. */
     if (layer.name == "") {
@@ -193,6 +226,22 @@ static bool parse_channels(const ImageSpec &in_spec,
       return false;
     }
 
+    /* Sample range of partial renders. */
+    if (layer.name != "") {
+      string start_string = in_spec.get_string_attribute(
+          "cycles." + name + ".range_start_sample", "");
+      if (start_string != "" && !sscanf(start_string.c_str(), "%d", &layer.start_sample)) {
+        error = "Failed to parse sample range metadata: " + start_string;
+        return false;
+      }
+    }
+
+    for (const MergeImagePass &pass : layer.passes) {
+      if (pass.op == MERGE_CHANNEL_SAMPLE_COUNT) {
+        layer.sample_count_offset = pass.offset;
+      }
+    }
+
     layers.push_back(layer);
   }
 
@@ -240,6 +289,40 @@ static bool open_images(const vector<string> &filepaths, vector<MergeImage> &ima
     images.push_back(std::move(image));
   }
 
+  /* Merge in order of the sample ranges rather than the order of the inputs, so the floating
+   * point accumulation and the image which wins for copied channels are always the same. */
+  stable_sort(images.begin(), images.end(), [](const MergeImage &a, const MergeImage &b) {
+    const int a_start = a.start_sample(), b_start = b.start_sample();
+    return (a_start != b_start) ? a_start < b_start : a.filepath < b.filepath;
+  });
+
+  /* Overlapping sample ranges would count the same samples multiple times. */
+  map<string, vector<pair<int, int>>> layer_ranges;
+  for (const MergeImage &image : images) {
+    for (const MergeImageLayer &layer : image.layers) {
+      if (layer.start_sample >= 0) {
+        layer_ranges[layer.name].push_back(
+            {layer.start_sample, layer.start_sample + layer.samples});
+      }
+    }
+  }
+
+  for (auto &i : layer_ranges) {
+    vector<pair<int, int>> &ranges = i.second;
+    sort(ranges.begin(), ranges.end());
+    for (size_t j = 1; j < ranges.size(); j++) {
+      if (ranges[j].first < ranges[j - 1].second) {
+        error = string_printf("Sample ranges %d-%d and %d-%d of layer %s overlap",
+                              ranges[j - 1].first,
+                              ranges[j - 1].second - 1,
+                              ranges[j].first,
+                              ranges[j].second - 1,
+                              i.first.c_str());
+        return false;
+      }
+    }
+  }
+
   return true;
 }
 
@@ -285,7 +368,9 @@ static void merge_layer_render_time(ImageSpec &spec,
 
 static void merge_channels_metadata(vector<MergeImage> &images,
                                     ImageSpec &out_spec,
-                                    vector<int> &channel_total_samples)
+                                    vector<MergeChannel> &channels,
+                                    vector<string> &layer_names,
+                                    vector<int> &layer_total_samples)
 {
   /* Based on first image. */
   out_spec = images[0].in->spec();
@@ -297,6 +382,15 @@ static void merge_channels_metadata(vector<MergeImage> &images,
 
   for (MergeImage &image : images) {
     for (MergeImageLayer &layer : image.layers) {
+      /* Layers of the same name are merged, find or add it. */
+      const size_t layer_index = std::find(layer_names.begin(), layer_names.end(), layer.name) -
+                                 layer_names.begin();
+      if (layer_index == layer_names.size()) {
+        layer_names.push_back(layer.name);
+        layer_total_samples.push_back(0);
+      }
+      layer_total_samples[layer_index] += layer.samples;
+
       for (MergeImagePass &pass : layer.passes) {
         /* Test if matching channel already exists in merged image. */
         bool found = false;
@@ -304,7 +398,6 @@ static void merge_channels_metadata(vector<MergeImage> &images,
         for (size_t i = 0; i < out_spec.nchannels; i++) {
           if (pass.channel_name == out_spec.channelnames[i]) {
             pass.merge_offset = i;
-            channel_total_samples[i] += layer.samples;
             /* First image wins for channels that can't be averaged or summed. */
             if (pass.op == MERGE_CHANNEL_COPY) {
               pass.op = MERGE_CHANNEL_NOP;
@@ -317,7 +410,7 @@ static void merge_channels_metadata(vector<MergeImage> &images,
         if (!found) {
           /* Add new channel. */
           pass.merge_offset = out_spec.nchannels;
-          channel_total_samples.push_back(layer.samples);
+          channels.push_back({pass.op, (int)layer_index});
 
           out_spec.channelnames.push_back(pass.channel_name);
           out_spec.channelformats.push_back(pass.format);
@@ -330,22 +423,22 @@ static void merge_channels_metadata(vector<MergeImage> &images,
   /* Merge metadata. */
   merge_render_time(out_spec, images, "RenderTime", false);
 
-  map<string, int> layer_num_samples;
-  for (MergeImage &image : images) {
-    for (MergeImageLayer &layer : image.layers) {
-      if (layer.name != "") {
-        layer_num_samples[layer.name] += layer.samples;
-      }
+  for (size_t i = 0; i < layer_names.size(); i++) {
+    const string &layer_name = layer_names[i];
+    if (layer_name == "") {
+      continue;
     }
-  }
 
-  for (const auto &i : layer_num_samples) {
-    string name = "cycles." + i.first + ".samples";
-    out_spec.attribute(name, TypeDesc::STRING, string_printf("%d", i.second));
+    string name = "cycles." + layer_name + ".samples";
+    out_spec.attribute(name, TypeDesc::STRING, string_printf("%d", layer_total_samples[i]));
+
+    /* The merged image is not a partial render anymore. */
+    out_spec.erase_attribute("cycles." + layer_name + ".range_start_sample");
+    out_spec.erase_attribute("cycles." + layer_name + ".range_num_samples");
 
-    merge_layer_render_time(out_spec, images, i.first, "total_time", false);
-    merge_layer_render_time(out_spec, images, i.first, "render_time", false);
-    merge_layer_render_time(out_spec, images, i.first, "synchronization_time", true);
+    merge_layer_render_time(out_spec, images, layer_name, "total_time", false);
+    merge_layer_render_time(out_spec, images, layer_name, "render_time", false);
+    merge_layer_render_time(out_spec, images, layer_name, "synchronization_time", true);
   }
 }
 
@@ -359,14 +452,40 @@ static void alloc_pixels(const ImageSpec &spec, array<float> &pixels)
   pixels.resize(num_pixels * num_channels);
 }
 
+/* Number of samples the pixel was rendered with. Layers with a sample count pass store the
+ * fraction of the layer samples, rounding removes the error of the division. */
+static double merge_pixel_samples(const MergeImageLayer &layer,
+                                  const array<float> &pixels,
+                                  const size_t pixel_offset)
+{
+  if (layer.sample_count_offset == -1) {
+    return layer.samples;
+  }
+  const double fraction = pixels[pixel_offset + layer.sample_count_offset];
+  return std::floor(fraction * layer.samples + 0.5);
+}
+
 static bool merge_pixels(const vector<MergeImage> &images,
                          const ImageSpec &out_spec,
-                         const vector<int> &channel_total_samples,
+                         const vector<MergeChannel> &channels,
+                         const vector<string> &layer_names,
+                         const vector<int> &layer_total_samples,
                          array<float> &out_pixels,
                          string &error)
 {
   alloc_pixels(out_spec, out_pixels);
-  memset(out_pixels.data(), 0, out_pixels.size() * sizeof(float));
+
+  const size_t num_pixels = (size_t)out_spec.width * (size_t)out_spec.height;
+  const size_t out_stride = out_spec.nchannels;
+
+  /* Accumulate in double precision, with images sorted by their sample range. The weights of
+   * averaged channels are the number of samples of every pixel, which differs between pixels
+   * with adaptive sampling. */
+  array<double> out_sums(out_pixels.size());
+  memset(out_sums.data(), 0, out_sums.size() * sizeof(double));
+
+  array<double> out_weights(num_pixels * layer_names.size());
+  memset(out_weights.data(), 0, out_weights.size() * sizeof(double));
 
   for (const MergeImage &image : images) {
     /* Read all channels into buffer. Reading all channels at once is
@@ -379,42 +498,63 @@ static bool merge_pixels(const vector<MergeImage> &images,
       return false;
     }
 
+    const size_t stride = image.in->spec().nchannels;
+
     for (size_t li = 0; li < image.layers.size(); li++) {
       const MergeImageLayer &layer = image.layers[li];
+      const size_t layer_index = std::find(layer_names.begin(), layer_names.end(), layer.name) -
+                                 layer_names.begin();
+      double *weights = out_weights.data() + layer_index * num_pixels;
+
+      for (size_t pixel = 0; pixel < num_pixels; pixel++) {
+        const size_t offset = pixel * stride;
+        const size_t out_offset = pixel * out_stride;
+        const double pixel_samples = merge_pixel_samples(layer, pixels, offset);
+
+        weights[pixel] += pixel_samples;
+
+        for (const MergeImagePass &pass : layer.passes) {
+          const double value = pixels[offset + pass.offset];
+          double &out_value = out_sums[out_offset + pass.merge_offset];
+
+          switch (pass.op) {
+            case MERGE_CHANNEL_NOP:
+              break;
+            case MERGE_CHANNEL_COPY:
+              out_value = value;
+              break;
+            case MERGE_CHANNEL_SUM:
+              out_value += value;
+              break;
+            case MERGE_CHANNEL_AVERAGE:
+              out_value += pixel_samples * value;
+              break;
+            case MERGE_CHANNEL_SAMPLE_COUNT:
+              out_value += pixel_samples;
+              break;
+          }
+        }
+      }
+    }
+  }
 
-      const size_t stride = image.in->spec().nchannels;
-      const size_t out_stride = out_spec.nchannels;
-      const size_t num_pixels = pixels.size();
-
-      for (const MergeImagePass &pass : layer.passes) {
-        size_t offset = pass.offset;
-        size_t out_offset = pass.merge_offset;
+  /* Normalize. */
+  for (size_t pixel = 0; pixel < num_pixels; pixel++) {
+    for (size_t channel = 0; channel < out_stride; channel++) {
+      const MergeChannel &merge_channel = channels[channel];
+      const size_t out_offset = pixel * out_stride + channel;
+      double value = out_sums[out_offset];
 
-        switch (pass.op) {
-          case MERGE_CHANNEL_NOP:
-            break;
-          case MERGE_CHANNEL_COPY:
-            for (; offset < num_pixels; offset += stride, out_offset += out_stride) {
-              out_pixels[out_offset] = pixels[offset];
-            }
-            break;
-          case MERGE_CHANNEL_SUM:
-            for (; offset < num_pixels; offset += stride, out_offset += out_stride) {
-              out_pixels[out_offset] += pixels[offset];
-            }
-            break;
-          case MERGE_CHANNEL_AVERAGE:
-            /* Weights based on sample metadata. Per channel since not
-             * all files are guaranteed to have the same channels. */
-            const int total_samples = channel_total_samples[out_offset];
-            const float t = (float)layer.samples / (float)total_samples;
-
-            for (; offset < num_pixels; offset += stride, out_offset += out_stride) {
-              out_pixels[out_offset] += t * pixels[offset];
-            }
-            break;
-        }
+      if (merge_channel.op == MERGE_CHANNEL_AVERAGE) {
+        const double weight = out_weights[merge_channel.layer * num_pixels + pixel];
+        value = (weight > 0.0) ? value / weight : 0.0;
+      }
+      else if (merge_channel.op == MERGE_CHANNEL_SAMPLE_COUNT) {
+        /* Keep the convention of storing the fraction of the layer samples. */
+        value /= layer_total_samples[merge_channel.layer];
       }
+
+      out_pixels[out_offset] = (float)value;
     }
   }
 
@@ -496,12 +636,15 @@ bool ImageMerger::run()
 
   /* Merge metadata and setup channels and offsets. */
   ImageSpec out_spec;
-  vector<int> channel_total_samples;
-  merge_channels_metadata(images, out_spec, channel_total_samples);
+  vector<MergeChannel> channels;
+  vector<string> layer_names;
+  vector<int> layer_total_samples;
+  merge_channels_metadata(images, out_spec, channels, layer_names, layer_total_samples);
 
   /* Merge pixels. */
   array<float> out_pixels;
-  if (!merge_pixels(images, out_spec, channel_total_samples, out_pixels, error)) {
+  if (!merge_pixels(
+          images, out_spec, channels, layer_names, layer_total_samples, out_pixels, error)) {
     return false;
   }
 
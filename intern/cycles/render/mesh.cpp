@@ -200,6 +200,8 @@ Mesh::Mesh(const NodeType *node_type, Type geom_type_)
   subd_params = NULL;
 
   patch_table = NULL;
+
+  displacement_applied = false;
 }
 
 Mesh::Mesh() : Mesh(get_node_type(), Geometry::MESH)
@@ -210,6 +212,7 @@ Mesh::~Mesh()
 {
   delete patch_table;
   delete subd_params;
+  subd_cache_free();
 }
 
 void Mesh::resize_mesh(int numverts, int numtris)
@@ -289,6 +292,8 @@ void Mesh::clear_non_sockets()
 
   delete patch_table;
   patch_table = NULL;
+
+  displacement_applied = false;
 }
 
 void Mesh::clear(bool preserve_shaders, bool preserve_voxel_data)
@@ -729,6 +734,30 @@ void Mesh::pack_normals(float4 *vnormal)
   }
 }
 
+void Mesh::pack_normals_quantized(uint *vnormal)
+{
+  Attribute *attr_vN = attributes.find(ATTR_STD_VERTEX_NORMAL);
+  if (attr_vN == NULL) {
+    /* Happens on objects with just hair. */
+    return;
+  }
+
+  bool do_transform = transform_applied;
+  Transform ntfm = transform_normal;
+
+  float3 *vN = attr_vN->data_float3();
+  size_t verts_size = verts.size();
+
+  for (size_t i = 0; i < verts_size; i++) {
+    float3 vNi = vN[i];
+
+    if (do_transform)
+      vNi = safe_normalize(transform_direction(&ntfm, vNi));
+
+    vnormal[i] = float3_to_octahedral(vNi);
+  }
+}
+
 void Mesh::pack_verts(const vector<uint> &tri_prim_index,
                       uint4 *tri_vindex,
                       uint *tri_patch,
@@ -167,6 +167,9 @@ class Mesh : public Geometry {
 
   AttributeSet subd_attributes;
 
+  /* Vertex positions were moved by true displacement since the mesh was last synced. */
+  bool displacement_applied;
+
  private:
   PackedPatchTable *patch_table;
   /* BVH */
@@ -184,6 +187,36 @@ class Mesh : public Geometry {
   unordered_multimap<int, int>
       vert_stitching_map; /* stitching index -> multiple real vert indices */
 
+  /* Diced and displaced geometry of the last adaptive subdivision, reused as long as the control
+   * mesh, displacement shaders and bucketed edge factors stay the same. */
+  struct SubdCache {
+    uint mesh_hash = 0;
+    uint edge_factors_hash = 0;
+
+    /* Geometry is stored once displacement is done. */
+    bool valid = false;
+    /* Geometry was restored from the cache in the current update, no need to displace it. */
+    bool restored = false;
+
+    array<float3> verts;
+    array<int> triangles;
+    array<int> shader;
+    array<bool> smooth;
+    array<int> triangle_patch;
+    array<float2> vert_patch_uv;
+    size_t num_subd_verts = 0;
+
+    struct CachedAttribute {
+      ustring name;
+      AttributeStandard std;
+      TypeDesc type;
+      AttributeElement element;
+      vector<char> buffer;
+    };
+    vector<CachedAttribute> attributes;
+  };
+  SubdCache *subd_cache = nullptr;
+
   friend class BVH2;
   friend class BVHBuild;
   friend class BVHSpatialSplit;
@@ -224,6 +257,7 @@ class Mesh : public Geometry {
 
   void pack_shaders(Scene *scene, uint *shader);
   void pack_normals(float4 *vnormal);
+  void pack_normals_quantized(uint *vnormal);
   void pack_verts(const vector<uint> &tri_prim_index,
                   uint4 *tri_vindex,
                   uint *tri_patch,
@@ -237,7 +271,7 @@ class Mesh : public Geometry {
                        uint visibility,
                        PackFlags pack_flags) override;
 
-  void tessellate(DiagSplit *split);
+  void tessellate(DiagSplit *split, bool use_cache = false);
 
   SubdFace get_subd_face(size_t index) const;
 
@@ -260,6 +294,11 @@ class Mesh : public Geometry {
 
  protected:
   void clear(bool preserve_shaders, bool preserve_voxel_data);
+
+  uint subd_cache_mesh_hash() const;
+  void subd_dice(DiagSplit *split, bool use_cache, uint mesh_hash);
+  void subd_cache_store();
+  void subd_cache_free();
 };
 
 CCL_NAMESPACE_END
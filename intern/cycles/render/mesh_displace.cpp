@@ -167,6 +167,11 @@ bool GeometryManager::displace(
     return false;
   }
 
+  /* Geometry restored from the subdivision cache is already displaced. */
+  if (mesh->subd_cache && mesh->subd_cache->restored) {
+    return false;
+  }
+
   const size_t num_verts = mesh->verts.size();
   const size_t num_triangles = mesh->num_triangles();
 
@@ -199,6 +204,8 @@ bool GeometryManager::displace(
     return false;
   }
 
+  mesh->displacement_applied = true;
+
   /* stitch */
   unordered_set<int> stitch_keys;
   for (pair<int, int> i : mesh->vert_to_stitching_key_map) {
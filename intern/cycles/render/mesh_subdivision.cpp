@@ -16,6 +16,7 @@
 
 #include "render/attribute.h"
 #include "render/camera.h"
+#include "render/graph.h"
 #include "render/mesh.h"
 
 #include "subd/subd_patch.h"
@@ -25,6 +26,8 @@
 #include "util/util_algorithm.h"
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
+#include "util/util_logging.h"
+#include "util/util_murmurhash.h"
 
 CCL_NAMESPACE_BEGIN
 
@@ -369,12 +372,155 @@ struct OsdPatch : Patch {
 
 #endif
 
-void Mesh::tessellate(DiagSplit *split)
+/* Subdivision Cache */
+
+template<typename T> static uint hash_array(const array<T> &data, uint seed)
+{
+  return util_murmur_hash3(data.data(), data.size() * sizeof(T), seed);
+}
+
+uint Mesh::subd_cache_mesh_hash() const
+{
+  uint hash = hash_uint2(subdivision_type, num_ngons);
+  hash = hash_array(verts, hash);
+  hash = hash_array(subd_start_corner, hash);
+  hash = hash_array(subd_num_corners, hash);
+  hash = hash_array(subd_shader, hash);
+  hash = hash_array(subd_smooth, hash);
+  hash = hash_array(subd_ptex_offset, hash);
+  hash = hash_array(subd_face_corners, hash);
+  hash = hash_array(subd_creases_edge, hash);
+  hash = hash_array(subd_creases_weight, hash);
+
+  foreach (const Attribute &attr, subd_attributes.attributes) {
+    hash = util_murmur_hash3(attr.name.c_str(), attr.name.length(), hash);
+    hash = util_murmur_hash3(attr.buffer.data(), attr.buffer.size(), hash);
+  }
+
+  /* Only shaders which move vertices affect the cached geometry. */
+  foreach (const Node *node, used_shaders) {
+    const Shader *shader = static_cast<const Shader *>(node);
+    hash = hash_uint2(hash, shader->has_displacement);
+    if (shader->has_displacement && shader->get_displacement_method() != DISPLACE_BUMP) {
+      const string &displacement_hash = shader->graph->displacement_hash;
+      hash = util_murmur_hash3(displacement_hash.c_str(), displacement_hash.size(), hash);
+    }
+  }
+
+  return hash;
+}
+
+/* Dice the split patches, or restore the result from the cache. */
+void Mesh::subd_dice(DiagSplit *split, bool use_cache, uint mesh_hash)
+{
+  if (!use_cache) {
+    split->post_split();
+    return;
+  }
+
+  if (!subd_cache) {
+    subd_cache = new SubdCache();
+  }
+
+  const uint edge_factors_hash = split->edge_factors_hash();
+  subd_cache->restored = false;
+
+  if (subd_cache->valid && subd_cache->mesh_hash == mesh_hash &&
+      subd_cache->edge_factors_hash == edge_factors_hash &&
+      subd_cache->verts.size() >= verts.size()) {
+    VLOG(1) << "Using cached adaptive subdivision for mesh " << name.c_str() << ".";
+
+    verts = subd_cache->verts;
+    triangles = subd_cache->triangles;
+    shader = subd_cache->shader;
+    smooth = subd_cache->smooth;
+    triangle_patch = subd_cache->triangle_patch;
+    vert_patch_uv = subd_cache->vert_patch_uv;
+    num_subd_verts = subd_cache->num_subd_verts;
+
+    tag_verts_modified();
+    tag_triangles_modified();
+    tag_shader_modified();
+    tag_smooth_modified();
+    tag_triangle_patch_modified();
+    tag_vert_patch_uv_modified();
+
+    attributes.resize();
+    for (const SubdCache::CachedAttribute &cached : subd_cache->attributes) {
+      Attribute *attr = (cached.std != ATTR_STD_NONE) ?
+                            attributes.add(cached.std, cached.name) :
+                            attributes.add(cached.name, cached.type, cached.element);
+      attr->buffer = cached.buffer;
+      attr->modified = true;
+    }
+
+    subd_cache->restored = true;
+    return;
+  }
+
+  /* Geometry is stored in the cache after displacement, see subd_cache_store(). */
+  subd_cache->valid = false;
+  subd_cache->mesh_hash = mesh_hash;
+  subd_cache->edge_factors_hash = edge_factors_hash;
+
+  split->post_split();
+}
+
+void Mesh::subd_cache_store()
+{
+  if (subd_cache == nullptr) {
+    return;
+  }
+
+  /* Displacement is done, restored geometry must be displaced again once it is diced anew. */
+  subd_cache->restored = false;
+
+  if (subd_cache->valid) {
+    return;
+  }
+
+  subd_cache->verts = verts;
+  subd_cache->triangles = triangles;
+  subd_cache->shader = shader;
+  subd_cache->smooth = smooth;
+  subd_cache->triangle_patch = triangle_patch;
+  subd_cache->vert_patch_uv = vert_patch_uv;
+  subd_cache->num_subd_verts = num_subd_verts;
+
+  subd_cache->attributes.clear();
+  foreach (const Attribute &attr, attributes.attributes) {
+    SubdCache::CachedAttribute cached;
+    cached.name = attr.name;
+    cached.std = attr.std;
+    cached.type = attr.type;
+    cached.element = attr.element;
+    cached.buffer = attr.buffer;
+    subd_cache->attributes.push_back(std::move(cached));
+  }
+
+  subd_cache->valid = true;
+}
+
+void Mesh::subd_cache_free()
+{
+  delete subd_cache;
+  subd_cache = nullptr;
+}
+
+void Mesh::tessellate(DiagSplit *split, bool use_cache)
 {
   /* reset the number of subdivision vertices, in case the Mesh was not cleared
    * between calls or data updates */
   num_subd_verts = 0;
 
+  uint mesh_hash = 0;
+  if (use_cache) {
+    mesh_hash = subd_cache_mesh_hash();
+  }
+  else {
+    subd_cache_free();
+  }
+
 #ifdef WITH_OPENSUBDIV
   OsdData osd_data;
   bool need_packed_patch_table = false;
@@ -443,6 +589,7 @@ void Mesh::tessellate(DiagSplit *split)
 
     /* split patches */
     split->split_patches(osd_patches.data(), sizeof(OsdPatch));
+    subd_dice(split, use_cache, mesh_hash);
   }
   else
 #endif
@@ -539,6 +686,7 @@ void Mesh::tessellate(DiagSplit *split)
 
     /* split patches */
     split->split_patches(linear_patches.data(), sizeof(LinearQuadPatch));
+    subd_dice(split, use_cache, mesh_hash);
   }
 
   /* interpolate center points for attributes */
@@ -251,6 +251,9 @@ NODE_DEFINE(ImageTextureNode)
   SOCKET_BOOLEAN(animated, "Animated", false);
 
   SOCKET_IN_POINT(vector, "Vector", zero_float3(), SocketType::LINK_TEXTURE_UV);
+  /* Vector at the ray differential offsets, for filtering of images in the texture cache. */
+  SOCKET_IN_POINT(vector_dx, "Vector DX", zero_float3(), SocketType::SVM_INTERNAL);
+  SOCKET_IN_POINT(vector_dy, "Vector DY", zero_float3(), SocketType::SVM_INTERNAL);
 
   SOCKET_OUT_COLOR(color, "Color");
   SOCKET_OUT_FLOAT(alpha, "Alpha");
@@ -394,6 +397,17 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
   }
 
   if (projection != NODE_IMAGE_PROJ_BOX) {
+    /* Derivative inputs are only linked when images are read through the texture cache. */
+    ShaderInput *vector_dx_in = input("Vector DX");
+    ShaderInput *vector_dy_in = input("Vector DY");
+    const bool use_derivatives = vector_dx_in->link && vector_dy_in->link;
+    int vector_dx_offset = SVM_STACK_INVALID;
+    int vector_dy_offset = SVM_STACK_INVALID;
+    if (use_derivatives) {
+      vector_dx_offset = tex_mapping.compile_begin(compiler, vector_dx_in);
+      vector_dy_offset = tex_mapping.compile_begin(compiler, vector_dy_in);
+    }
+
     /* If there only is one image (a very common case), we encode it as a negative value. */
     int num_nodes;
     if (handle.num_tiles() == 1) {
@@ -409,7 +423,7 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
                                              compiler.stack_assign_if_linked(color_out),
                                              compiler.stack_assign_if_linked(alpha_out),
                                              flags),
-                      projection);
+                      compiler.encode_uchar4(projection, vector_dx_offset, vector_dy_offset));
 
     if (num_nodes > 0) {
       for (int i = 0; i < num_nodes; i++) {
@@ -427,6 +441,11 @@ void ImageTextureNode::compile(SVMCompiler &compiler)
         compiler.add_node(node.x, node.y, node.z, node.w);
       }
     }
+
+    if (use_derivatives) {
+      tex_mapping.compile_end(compiler, vector_dx_in, vector_dx_offset);
+      tex_mapping.compile_end(compiler, vector_dy_in, vector_dy_offset);
+    }
   }
   else {
     assert(handle.num_tiles() == 1);
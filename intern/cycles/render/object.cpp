@@ -61,10 +61,18 @@ struct UpdateObjectTransformState {
   /* Packed object arrays. Those will be filled in. */
   uint *object_flag;
   KernelObject *objects;
+  KernelObjectInstance *object_instances;
   Transform *object_motion_pass;
   DecomposedTransform *object_motion;
   float *object_volume_step;
 
+  /* Compact instancing, objects only store their transform and share the rest of the object
+   * data with other instances of the same prototype. */
+  bool use_compact_instances;
+
+  /* Index of the object which fills in the KernelObject of every prototype. */
+  vector<int> prototype_object;
+
   /* Flags which will be synchronized to Integrator. */
   bool have_motion;
   bool have_curves;
@@ -111,6 +119,7 @@ Object::Object() : Node(get_node_type())
 {
   particle_system = NULL;
   particle_index = 0;
+  prototype_index = 0;
   attr_map_offset = 0;
   bounds = BoundBox::empty;
 }
@@ -377,6 +386,8 @@ ObjectManager::ObjectManager()
 {
   update_flags = UPDATE_ALL;
   need_flags_update = true;
+  last_use_compact_instances = false;
+  last_num_objects = 0;
 }
 
 ObjectManager::~ObjectManager()
@@ -396,11 +407,124 @@ static float object_volume_density(const Transform &tfm, Geometry *geom)
   return 1.0f;
 }
 
+/* Object properties which end up in the KernelObject, apart from the transform and random number.
+ * Objects with equal keys share a prototype in compact instancing mode. */
+struct ObjectPrototypeKey {
+  const Geometry *geometry;
+  const ParticleSystem *particle_system;
+  const char *name;
+  const char *asset_name;
+  float color[3];
+  int pass_id;
+  int particle_index;
+  float dupli_generated[3];
+  float dupli_uv[2];
+  float shadow_terminator_shading_offset;
+  float shadow_terminator_geometry_offset;
+  float ao_distance;
+
+  bool operator==(const ObjectPrototypeKey &other) const
+  {
+    return memcmp(this, &other, sizeof(ObjectPrototypeKey)) == 0;
+  }
+};
+
+struct ObjectPrototypeKeyHash {
+  size_t operator()(const ObjectPrototypeKey &key) const
+  {
+    return util_murmur_hash3(&key, sizeof(ObjectPrototypeKey), 0);
+  }
+};
+
+static ObjectPrototypeKey object_prototype_key(const Object *ob)
+{
+  /* Keys are hashed and compared as raw memory, so padding must be cleared. */
+  ObjectPrototypeKey key;
+  memset(&key, 0, sizeof(key));
+
+  key.geometry = ob->get_geometry();
+  key.particle_system = ob->get_particle_system();
+  key.name = ob->name.c_str();
+  key.asset_name = ob->get_asset_name().c_str();
+  key.color[0] = ob->get_color().x;
+  key.color[1] = ob->get_color().y;
+  key.color[2] = ob->get_color().z;
+  key.pass_id = ob->get_pass_id();
+  key.particle_index = ob->get_particle_index();
+  key.dupli_generated[0] = ob->get_dupli_generated().x;
+  key.dupli_generated[1] = ob->get_dupli_generated().y;
+  key.dupli_generated[2] = ob->get_dupli_generated().z;
+  key.dupli_uv[0] = ob->get_dupli_uv().x;
+  key.dupli_uv[1] = ob->get_dupli_uv().y;
+  key.shadow_terminator_shading_offset = ob->get_shadow_terminator_shading_offset();
+  key.shadow_terminator_geometry_offset = ob->get_shadow_terminator_geometry_offset();
+  key.ao_distance = ob->get_ao_distance();
+
+  return key;
+}
+
+static bool object_can_share_prototype(const Object *ob, const Scene::MotionType need_motion)
+{
+  /* Motion blur transforms and object attributes are stored per object, and the volume density
+   * depends on the object transform. */
+  return !(need_motion == Scene::MOTION_BLUR && ob->use_motion()) && ob->attributes.empty() &&
+         ob->get_geometry()->geometry_type != Geometry::VOLUME;
+}
+
+/* Find objects which can share KernelObject data, and decide whether it is worth to use compact
+ * instancing for the scene. Returns true when compact instancing is used. */
+bool ObjectManager::assign_object_prototypes(Scene *scene, UpdateObjectTransformState *state)
+{
+  /* The lookup in the kernel is only worth it when it saves a lot of memory. */
+  static const size_t COMPACT_INSTANCES_MIN_OBJECTS = 1024;
+
+  const size_t num_objects = scene->objects.size();
+  vector<int> &prototype_object = state->prototype_object;
+  prototype_object.clear();
+
+  if (num_objects >= COMPACT_INSTANCES_MIN_OBJECTS) {
+    unordered_map<ObjectPrototypeKey, int, ObjectPrototypeKeyHash> prototypes;
+
+    foreach (Object *ob, scene->objects) {
+      if (!object_can_share_prototype(ob, state->need_motion)) {
+        ob->prototype_index = prototype_object.size();
+        prototype_object.push_back(ob->index);
+        continue;
+      }
+
+      auto it = prototypes.emplace(object_prototype_key(ob), prototype_object.size());
+      if (it.second) {
+        prototype_object.push_back(ob->index);
+      }
+      ob->prototype_index = it.first->second;
+    }
+
+    if (prototype_object.size() * 2 <= num_objects) {
+      VLOG(1) << "Using compact instancing, " << num_objects << " objects share "
+              << prototype_object.size() << " prototypes.";
+      return true;
+    }
+  }
+
+  /* Every object has its own KernelObject. */
+  prototype_object.resize(num_objects);
+  foreach (Object *ob, scene->objects) {
+    ob->prototype_index = ob->index;
+    prototype_object[ob->index] = ob->index;
+  }
+
+  return false;
+}
+
 void ObjectManager::device_update_object_transform(UpdateObjectTransformState *state,
                                                    Object *ob,
                                                    bool update_all)
 {
-  KernelObject &kobject = state->objects[ob->index];
+  /* Instances of the same prototype share the KernelObject, which is only filled in once. */
+  KernelObject kobject_shared;
+  KernelObject &kobject = (state->prototype_object[ob->prototype_index] == ob->index) ?
+                              state->objects[ob->prototype_index] :
+                              kobject_shared;
   Transform *object_motion_pass = state->object_motion_pass;
 
   Geometry *geom = ob->geometry;
@@ -512,6 +636,15 @@ void ObjectManager::device_update_object_transform(UpdateObjectTransformState *s
                                              (1.0f - 0.5f * ob->shadow_terminator_shading_offset);
   kobject.shadow_terminator_geometry_offset = ob->shadow_terminator_geometry_offset;
 
+  if (state->use_compact_instances) {
+    KernelObjectInstance &kinstance = state->object_instances[ob->index];
+    kinstance.tfm = tfm;
+    kinstance.prototype = ob->prototype_index;
+    kinstance.random_number = random_number;
+    kinstance.pad1 = 0.0f;
+    kinstance.pad2 = 0.0f;
+  }
+
   /* Object flag. */
   if (ob->use_holdout) {
     flag |= SD_OBJECT_HOLDOUT_MASK;
@@ -534,7 +667,6 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   state.scene = scene;
   state.queue_start_object = 0;
 
-  state.objects = dscene->objects.alloc(scene->objects.size());
   state.object_flag = dscene->object_flag.alloc(scene->objects.size());
   state.object_volume_step = dscene->object_volume_step.alloc(scene->objects.size());
   state.object_motion = NULL;
@@ -561,6 +693,20 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     state.object_motion = dscene->object_motion.alloc(motion_offset);
   }
 
+  state.use_compact_instances = assign_object_prototypes(scene, &state);
+  state.objects = dscene->objects.alloc(state.prototype_object.size());
+  state.object_instances = NULL;
+
+  if (state.use_compact_instances) {
+    state.object_instances = dscene->object_instances.alloc(scene->objects.size());
+    /* Objects may be assigned to different prototypes than before. */
+    dscene->objects.tag_modified();
+    dscene->object_instances.tag_modified();
+  }
+  else {
+    dscene->object_instances.free();
+  }
+
   /* Particle system device offsets
    * 0 is dummy particle, index starts at 1.
    */
@@ -570,8 +716,13 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
     numparticles += psys->particles.size();
   }
 
-  /* as all the arrays are the same size, checking only dscene.objects is sufficient */
-  const bool update_all = dscene->objects.need_realloc();
+  /* as all the arrays are the same size, checking only dscene.objects is sufficient. Objects
+   * map to other KernelObjects when the instancing mode or the number of objects changes. */
+  const bool update_all = dscene->objects.need_realloc() || state.use_compact_instances ||
+                          state.use_compact_instances != last_use_compact_instances ||
+                          scene->objects.size() != last_num_objects;
+  last_use_compact_instances = state.use_compact_instances;
+  last_num_objects = scene->objects.size();
 
   /* Parallel object update, with grain size to avoid too much threading overhead
    * for individual objects. */
@@ -589,6 +740,9 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
   }
 
   dscene->objects.copy_to_device_if_modified();
+  if (state.use_compact_instances) {
+    dscene->object_instances.copy_to_device();
+  }
   if (state.need_motion == Scene::MOTION_PASS) {
     dscene->object_motion_pass.copy_to_device();
   }
@@ -598,8 +752,10 @@ void ObjectManager::device_update_transforms(DeviceScene *dscene, Scene *scene,
 
   dscene->data.bvh.have_motion = state.have_motion;
   dscene->data.bvh.have_curves = state.have_curves;
+  dscene->data.bvh.use_compact_instances = state.use_compact_instances;
 
   dscene->objects.clear_modified();
+  dscene->object_instances.clear_modified();
   dscene->object_motion_pass.clear_modified();
   dscene->object_motion.clear_modified();
 }
@@ -614,6 +770,7 @@ void ObjectManager::device_update(Device *device,
 
   if (update_flags & (OBJECT_ADDED | OBJECT_REMOVED)) {
     dscene->objects.tag_realloc();
+    dscene->object_instances.tag_realloc();
     dscene->object_motion_pass.tag_realloc();
     dscene->object_motion.tag_realloc();
     dscene->object_flag.tag_realloc();
@@ -801,8 +958,8 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
                                      mesh->patch_table->num_nodes * PATCH_NODE_SIZE) -
                                 mesh->patch_offset;
 
-        if (kobjects[object->index].patch_map_offset != patch_map_offset) {
-          kobjects[object->index].patch_map_offset = patch_map_offset;
+        if (kobjects[object->prototype_index].patch_map_offset != patch_map_offset) {
+          kobjects[object->prototype_index].patch_map_offset = patch_map_offset;
           update = true;
         }
       }
@@ -815,8 +972,8 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
       attr_map_offset = geom->attr_map_offset;
     }
 
-    if (kobjects[object->index].attribute_map_offset != attr_map_offset) {
-      kobjects[object->index].attribute_map_offset = attr_map_offset;
+    if (kobjects[object->prototype_index].attribute_map_offset != attr_map_offset) {
+      kobjects[object->prototype_index].attribute_map_offset = attr_map_offset;
       update = true;
     }
   }
@@ -829,6 +986,7 @@ void ObjectManager::device_update_mesh_offsets(Device *, DeviceScene *dscene, Sc
 void ObjectManager::device_free(Device *, DeviceScene *dscene, bool force_free)
 {
   dscene->objects.free_if_need_realloc(force_free);
+  dscene->object_instances.free_if_need_realloc(force_free);
   dscene->object_motion_pass.free_if_need_realloc(force_free);
   dscene->object_motion.free_if_need_realloc(force_free);
   dscene->object_flag.free_if_need_realloc(force_free);
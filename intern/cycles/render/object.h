@@ -114,6 +114,10 @@ class Object : public Node {
    * in the device vectors. Gets set in device_update. */
   int index;
 
+  /* Index of the KernelObject data in the device vectors. Objects share it with other instances
+   * of the same prototype in compact instancing mode, otherwise it matches the index. */
+  int prototype_index;
+
   /* Reference to the attribute map with object attributes,
    * or 0 if none. Set in update_svm_attributes. */
   size_t attr_map_offset;
@@ -172,6 +176,12 @@ class ObjectManager {
   string get_cryptomatte_assets(Scene *scene);
 
  protected:
+  /* Instancing mode and number of objects of the last transform update. The KernelObject
+   * layout changes with them, even when the number of KernelObjects stays the same. */
+  bool last_use_compact_instances;
+  size_t last_num_objects;
+
+  bool assign_object_prototypes(Scene *scene, UpdateObjectTransformState *state);
   void device_update_object_transform(UpdateObjectTransformState *state,
                                       Object *ob,
                                       bool update_all);
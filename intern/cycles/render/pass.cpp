@@ -218,8 +218,10 @@ PassInfo Pass::get_info(const PassType type, const bool include_albedo)
       pass_info.use_exposure = false;
       break;
     case PASS_RENDER_TIME:
-      /* This pass is handled entirely on the host side. */
-      pass_info.num_components = 0;
+      /* This pass is written on the host side by the CPU path tracing, it accumulates the time
+       * spent on the pixel in milliseconds. */
+      pass_info.num_components = 1;
+      pass_info.use_filter = false;
       break;
 
     case PASS_DIFFUSE_COLOR:
@@ -85,6 +85,7 @@ class DeviceScene {
   /* mesh */
   device_vector<uint> tri_shader;
   device_vector<float4> tri_vnormal;
+  device_vector<uint> tri_vnormal_quantized;
   device_vector<uint4> tri_vindex;
   device_vector<uint> tri_patch;
   device_vector<float2> tri_patch_uv;
@@ -96,6 +97,7 @@ class DeviceScene {
 
   /* objects */
   device_vector<KernelObject> objects;
+  device_vector<KernelObjectInstance> object_instances;
   device_vector<Transform> object_motion_pass;
   device_vector<DecomposedTransform> object_motion;
   device_vector<uint> object_flag;
@@ -116,6 +118,8 @@ class DeviceScene {
   device_vector<KernelLight> lights;
   device_vector<float2> light_background_marginal_cdf;
   device_vector<float2> light_background_conditional_cdf;
+  device_vector<KernelLightTreeNode> light_tree_nodes;
+  device_vector<uint> light_tree_emitter_nodes;
 
   /* particles */
   device_vector<KernelParticle> particles;
@@ -158,6 +162,13 @@ class SceneParams {
   int hair_subdivisions;
   CurveShapeType hair_shape;
   int texture_limit;
+  /* Memory budget of the texture cache in megabytes, zero to load images into device memory. */
+  int texture_cache_size;
+  /* Keep diced and displaced geometry of adaptively subdivided meshes between updates. */
+  bool use_subd_cache;
+  /* Store vertex normals, UVs and colors of triangle meshes with reduced precision, to reduce
+   * memory usage of large meshes. */
+  bool use_quantized_attributes;
 
   bool background;
 
@@ -172,6 +183,9 @@ class SceneParams {
     hair_subdivisions = 3;
     hair_shape = CURVE_RIBBON;
     texture_limit = 0;
+    texture_cache_size = 0;
+    use_subd_cache = false;
+    use_quantized_attributes = false;
     background = true;
   }
 
@@ -183,7 +197,10 @@ class SceneParams {
              use_bvh_unaligned_nodes == params.use_bvh_unaligned_nodes &&
              num_bvh_time_steps == params.num_bvh_time_steps &&
              hair_subdivisions == params.hair_subdivisions && hair_shape == params.hair_shape &&
-             texture_limit == params.texture_limit);
+             texture_limit == params.texture_limit &&
+             texture_cache_size == params.texture_cache_size &&
+             use_subd_cache == params.use_subd_cache &&
+             use_quantized_attributes == params.use_quantized_attributes);
   }
 
   int curve_subdivisions()
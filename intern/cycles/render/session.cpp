@@ -255,6 +255,7 @@ RenderWork Session::run_update_for_next_iteration()
     path_trace_->set_adaptive_sampling(adaptive_sampling);
   }
 
+  render_scheduler_.set_start_sample(params.start_sample);
   render_scheduler_.set_num_samples(params.samples);
   render_scheduler_.set_time_limit(params.time_limit);
 
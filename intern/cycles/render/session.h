@@ -54,6 +54,9 @@ class SessionParams {
 
   bool experimental;
   int samples;
+  /* Index of the first sample to render, for splitting the samples of a frame across multiple
+   * renders which are merged afterwards. */
+  int start_sample;
   int pixel_size;
   int threads;
 
@@ -75,6 +78,7 @@ class SessionParams {
 
     experimental = false;
     samples = 1024;
+    start_sample = 0;
     pixel_size = 1;
     threads = 0;
     time_limit = 0.0;
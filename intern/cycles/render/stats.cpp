@@ -48,7 +48,7 @@ bool namedTimeSampleEntryComparator(const NamedNestedSampleStats &a,
 
 bool namedSampleCountPairComparator(const NamedSampleCountPair &a, const NamedSampleCountPair &b)
 {
-  return a.samples > b.samples;
+  return a.time > b.time;
 }
 
 }  // namespace
@@ -172,8 +172,11 @@ string NamedNestedSampleStats::full_report(int indent_level, uint64_t total_samp
 
 /* Named sample count pairs. */
 
-NamedSampleCountPair::NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits)
-    : name(name), samples(samples), hits(hits)
+NamedSampleCountPair::NamedSampleCountPair(const ustring &name,
+                                           uint64_t samples,
+                                           uint64_t hits,
+                                           uint64_t time)
+    : name(name), samples(samples), hits(hits), time(time)
 {
 }
 
@@ -181,15 +184,19 @@ NamedSampleCountStats::NamedSampleCountStats()
 {
 }
 
-void NamedSampleCountStats::add(const ustring &name, uint64_t samples, uint64_t hits)
+void NamedSampleCountStats::add(const ustring &name,
+                                uint64_t samples,
+                                uint64_t hits,
+                                uint64_t time)
 {
   entry_map::iterator entry = entries.find(name);
   if (entry != entries.end()) {
     entry->second.samples += samples;
     entry->second.hits += hits;
+    entry->second.time += time;
     return;
   }
-  entries.emplace(name, NamedSampleCountPair(name, samples, hits));
+  entries.emplace(name, NamedSampleCountPair(name, samples, hits, time));
 }
 
 string NamedSampleCountStats::full_report(int indent_level)
@@ -199,27 +206,33 @@ string NamedSampleCountStats::full_report(int indent_level)
   vector<NamedSampleCountPair> sorted_entries;
   sorted_entries.reserve(entries.size());
 
-  uint64_t total_hits = 0, total_samples = 0;
+  uint64_t total_hits = 0, total_time = 0;
   foreach (entry_map::const_reference entry, entries) {
     const NamedSampleCountPair &pair = entry.second;
 
     total_hits += pair.hits;
-    total_samples += pair.samples;
+    total_time += pair.time;
 
     sorted_entries.push_back(pair);
   }
-  const double avg_samples_per_hit = ((double)total_samples) / total_hits;
+  const double avg_time_per_hit = (total_hits) ? ((double)total_time) / total_hits : 0.0;
 
   sort(sorted_entries.begin(), sorted_entries.end(), namedSampleCountPairComparator);
 
   string result = "";
   foreach (const NamedSampleCountPair &entry, sorted_entries) {
-    const double seconds = entry.samples * 0.001;
-    const double relative = ((double)entry.samples) / (entry.hits * avg_samples_per_hit);
-
-    result += indent +
-              string_printf(
-                  "%-32s: %.2fs (Relative cost: %.2f)\n", entry.name.c_str(), seconds, relative);
+    const double seconds = entry.time * 1e-9;
+    const double sampled_seconds = entry.samples * 0.001;
+    const double time_per_hit = (entry.hits) ? ((double)entry.time) / entry.hits : 0.0;
+    const double relative = (avg_time_per_hit > 0.0) ? time_per_hit / avg_time_per_hit : 0.0;
+
+    result += indent + string_printf("%-32s: %.2fs (Sampled: %.2fs, Per hit: %.2fus, Relative "
+                                     "cost: %.2f)\n",
+                                     entry.name.c_str(),
+                                     seconds,
+                                     sampled_seconds,
+                                     time_per_hit * 1e-3,
+                                     relative);
   }
   return result;
 }
@@ -295,17 +308,17 @@ void RenderStats::collect_profiling(Scene *scene, Profiler &prof)
 
   shaders.entries.clear();
   foreach (Shader *shader, scene->shaders) {
-    uint64_t samples, hits;
-    if (prof.get_shader(shader->id, samples, hits)) {
-      shaders.add(shader->name, samples, hits);
+    uint64_t samples, hits, time;
+    if (prof.get_shader(shader->id, samples, hits, time)) {
+      shaders.add(shader->name, samples, hits, time);
     }
   }
 
   objects.entries.clear();
   foreach (Object *object, scene->objects) {
-    uint64_t samples, hits;
-    if (prof.get_object(object->get_device_index(), samples, hits)) {
-      objects.add(object->name, samples, hits);
+    uint64_t samples, hits, time;
+    if (prof.get_object(object->get_device_index(), samples, hits, time)) {
+      objects.add(object->name, samples, hits, time);
     }
   }
 }
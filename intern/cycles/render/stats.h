@@ -124,15 +124,16 @@ class NamedNestedSampleStats {
 };
 
 /* Named entry containing both a time-sample count for objects of a type and a
- * total count of processed items.
+ * total count of processed items, along with the measured time in nanoseconds.
  * This allows to estimate the time spent per item. */
 class NamedSampleCountPair {
  public:
-  NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits);
+  NamedSampleCountPair(const ustring &name, uint64_t samples, uint64_t hits, uint64_t time);
 
   ustring name;
   uint64_t samples;
   uint64_t hits;
+  uint64_t time;
 };
 
 /* Contains statistics about pairs of samples and counts as described above. */
@@ -141,7 +142,7 @@ class NamedSampleCountStats {
   NamedSampleCountStats();
 
   string full_report(int indent_level = 0);
-  void add(const ustring &name, uint64_t samples, uint64_t hits);
+  void add(const ustring &name, uint64_t samples, uint64_t hits, uint64_t time);
 
   typedef unordered_map<ustring, NamedSampleCountPair, ustringHash> entry_map;
   entry_map entries;
@@ -88,13 +88,20 @@ class QuadDice : public EdgeDice {
   float2 map_uv(Subpatch &sub, float u, float v);
   void set_vert(Subpatch &sub, int index, float u, float v);
 
-  void add_grid(Subpatch &sub, int Mu, int Mv, int offset);
+  void set_grid_verts(Subpatch &sub, int Mu, int Mv, int offset);
+  void add_grid_triangles(Subpatch &sub, int Mu, int Mv, int offset);
 
   void set_side(Subpatch &sub, int edge);
 
   float quad_area(const float3 &a, const float3 &b, const float3 &c, const float3 &d);
   float scale_factor(Subpatch &sub, int Mu, int Mv);
 
+  void grid_size(Subpatch &sub, int *Mu, int *Mv);
+
+  /* Evaluate the vertices of the inner grid. Inner grids of subpatches do not share vertices, so
+   * this can run for multiple subpatches in parallel. */
+  void dice_grid(Subpatch &sub);
+  /* Evaluate the vertices on the sides and add all triangles, after dice_grid(). */
   void dice(Subpatch &sub);
 };
 
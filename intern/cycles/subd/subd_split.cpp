@@ -25,6 +25,7 @@
 #include "util/util_foreach.h"
 #include "util/util_hash.h"
 #include "util/util_math.h"
+#include "util/util_tbb.h"
 #include "util/util_types.h"
 
 CCL_NAMESPACE_BEGIN
@@ -360,8 +361,27 @@ void DiagSplit::split_patches(Patch *patches, size_t patches_byte_stride)
 
   params.mesh->vert_to_stitching_key_map.clear();
   params.mesh->vert_stitching_map.clear();
+}
 
-  post_split();
+/* Edge factors are quantized for the hash, so small changes in the dicing camera still give the
+ * same hash. Buckets of larger factors start after the exact ones, 8 and 9 are distinct. */
+uint DiagSplit::edge_factor_bucket(int T)
+{
+  if (T <= 8) {
+    return max(T, 0);
+  }
+  return 9 + (uint)(4.0f * log2f(T / 8.0f));
+}
+
+uint DiagSplit::edge_factors_hash() const
+{
+  uint hash = hash_uint2(edges.size(), subpatches.size());
+
+  foreach (const Edge &edge, edges) {
+    hash = hash_uint2(hash, edge_factor_bucket(edge.T));
+  }
+
+  return hash;
 }
 
 static Edge *create_edge_from_corner(DiagSplit *split,
@@ -729,15 +749,25 @@ void DiagSplit::post_split()
 
   dice.reserve(num_verts, num_triangles);
 
-  for (size_t i = 0; i < subpatches.size(); i++) {
-    Subpatch &sub = subpatches[i];
+  /* Patch evaluation for the inner grids is where most of the time is spent. Inner grids do not
+   * share vertices, so they are evaluated in parallel, while the triangles are added in order. */
+  static const size_t SUBPATCHES_PER_TASK = 16;
+  parallel_for(blocked_range<size_t>(0, subpatches.size(), SUBPATCHES_PER_TASK),
+               [&](const blocked_range<size_t> &r) {
+                 for (size_t i = r.begin(); i != r.end(); i++) {
+                   Subpatch &sub = subpatches[i];
+
+                   sub.edge_u0.T = max(sub.edge_u0.T, 1);
+                   sub.edge_u1.T = max(sub.edge_u1.T, 1);
+                   sub.edge_v0.T = max(sub.edge_v0.T, 1);
+                   sub.edge_v1.T = max(sub.edge_v1.T, 1);
 
-    sub.edge_u0.T = max(sub.edge_u0.T, 1);
-    sub.edge_u1.T = max(sub.edge_u1.T, 1);
-    sub.edge_v0.T = max(sub.edge_v0.T, 1);
-    sub.edge_v1.T = max(sub.edge_v1.T, 1);
+                   dice.dice_grid(sub);
+                 }
+               });
 
-    dice.dice(sub);
+  for (size_t i = 0; i < subpatches.size(); i++) {
+    dice.dice(subpatches[i]);
   }
 
   /* Cleanup */
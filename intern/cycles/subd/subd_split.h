@@ -62,12 +62,19 @@ class DiagSplit {
 
   explicit DiagSplit(const SubdParams &params);
 
+  /* Split patches and compute edge factors, post_split() does the actual dicing. */
   void split_patches(Patch *patches, size_t patches_byte_stride);
 
   void split_quad(const Mesh::SubdFace &face, Patch *patch);
   void split_ngon(const Mesh::SubdFace &face, Patch *patches, size_t patches_byte_stride);
 
   void post_split();
+
+  /* Hash of the bucketed edge factors of all edges, available after splitting. */
+  uint edge_factors_hash() const;
+
+  /* Bucket of an edge factor, small ones exactly and larger ones in steps of a quarter octave. */
+  static uint edge_factor_bucket(int T);
 };
 
 CCL_NAMESPACE_END
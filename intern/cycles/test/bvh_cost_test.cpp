@@ -0,0 +1,103 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "bvh/bvh.h"
+#include "bvh/bvh_cost.h"
+#include "bvh/bvh_params.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Unit boxes in a row along the X axis, in the order of their index. */
+static vector<BoundBox> bvh_cost_test_row(int num)
+{
+  vector<BoundBox> bounds;
+  for (int i = 0; i < num; i++) {
+    bounds.push_back(BoundBox(make_float3(i, 0.0f, 0.0f), make_float3(i + 1, 1.0f, 1.0f)));
+  }
+  return bounds;
+}
+
+TEST(BVHCostEstimate, refit_unchanged)
+{
+  const BVHParams params;
+  const vector<BoundBox> bounds = bvh_cost_test_row(64);
+
+  BVHCostEstimate estimate;
+  const float build_cost = estimate.build(params, bounds);
+  EXPECT_GT(build_cost, 0.0f);
+  EXPECT_EQ(estimate.refit(params, bounds), build_cost);
+}
+
+TEST(BVHCostEstimate, refit_rigid_motion)
+{
+  const BVHParams params;
+  vector<BoundBox> bounds = bvh_cost_test_row(64);
+
+  BVHCostEstimate estimate;
+  const float build_cost = estimate.build(params, bounds);
+
+  /* Moving and scaling everything the same way does not make the tree worse. */
+  for (BoundBox &b : bounds) {
+    b = BoundBox(b.min * 2.0f + make_float3(5.0f, -3.0f, 1.0f),
+                 b.max * 2.0f + make_float3(5.0f, -3.0f, 1.0f));
+  }
+  EXPECT_NEAR(estimate.refit(params, bounds), build_cost, build_cost * 1e-5f);
+}
+
+TEST(BVHCostEstimate, refit_degraded)
+{
+  const BVHParams params;
+  vector<BoundBox> bounds = bvh_cost_test_row(64);
+
+  BVHCostEstimate estimate;
+  const float build_cost = estimate.build(params, bounds);
+
+  /* Swap the first and second half, interleaved, so every node of the tree built for the old
+   * positions spans most of the row. */
+  vector<BoundBox> shuffled(bounds.size());
+  for (size_t i = 0; i < bounds.size(); i++) {
+    shuffled[i] = bounds[(i % 2) ? i / 2 : bounds.size() - 1 - i / 2];
+  }
+
+  const float refit_cost = estimate.refit(params, shuffled);
+  EXPECT_GT(refit_cost, build_cost * BVH_REFIT_MAX_COST_RATIO);
+
+  /* Building again for the new positions gives a tree as good as the original one. */
+  BVHCostEstimate rebuilt;
+  EXPECT_NEAR(rebuilt.build(params, shuffled), build_cost, build_cost * 1e-5f);
+}
+
+TEST(BVHCostEstimate, refit_different_primitives)
+{
+  const BVHParams params;
+
+  BVHCostEstimate estimate;
+  estimate.build(params, bvh_cost_test_row(64));
+  EXPECT_EQ(estimate.refit(params, bvh_cost_test_row(63)), FLT_MAX);
+}
+
+TEST(BVHCostEstimate, empty)
+{
+  const BVHParams params;
+
+  BVHCostEstimate estimate;
+  EXPECT_EQ(estimate.build(params, vector<BoundBox>()), 0.0f);
+  EXPECT_EQ(estimate.refit(params, vector<BoundBox>()), 0.0f);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,202 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+#include "device/device_memory.h"
+
+#include "util/util_profiling.h"
+#include "util/util_stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Device with memory separate from the host, which records the copies made to it. */
+class CopyRecordingDevice : public Device {
+ public:
+  CopyRecordingDevice(const DeviceInfo &info_, Stats &stats_, Profiler &profiler_)
+      : Device(info_, stats_, profiler_)
+  {
+  }
+
+  virtual BVHLayoutMask get_bvh_layout_mask() const override
+  {
+    return 0;
+  }
+
+  virtual void mem_alloc(device_memory &mem) override
+  {
+    mem.device_pointer = (device_ptr) new char[mem.memory_size()];
+    mem.device_size = mem.memory_size();
+  }
+
+  virtual void mem_copy_to(device_memory &mem) override
+  {
+    if (mem.device_pointer && mem.device_size != mem.memory_size()) {
+      mem_free(mem);
+    }
+    if (!mem.device_pointer) {
+      mem_alloc(mem);
+    }
+    memcpy((void *)mem.device_pointer, mem.host_pointer, mem.memory_size());
+    num_full_copies++;
+  }
+
+  virtual void mem_copy_to(device_memory &mem, size_t size, size_t offset) override
+  {
+    const size_t offset_bytes = mem.memory_elements_size(offset);
+    memcpy((char *)mem.device_pointer + offset_bytes,
+           (char *)mem.host_pointer + offset_bytes,
+           mem.memory_elements_size(size));
+    ranged_copies.push_back({offset, size});
+  }
+
+  virtual void mem_copy_from(device_memory &, size_t, size_t, size_t, size_t) override
+  {
+  }
+
+  virtual void mem_zero(device_memory &) override
+  {
+  }
+
+  virtual void mem_free(device_memory &mem) override
+  {
+    delete[](char *) mem.device_pointer;
+    mem.device_pointer = 0;
+    mem.device_size = 0;
+  }
+
+  virtual void const_copy_to(const char *, void *, size_t) override
+  {
+  }
+
+  int num_full_copies = 0;
+  vector<pair<size_t, size_t>> ranged_copies;
+};
+
+class DeviceMemory : public testing::Test {
+ protected:
+  static constexpr size_t num_elements = 1000;
+
+  void SetUp() override
+  {
+    device = new CopyRecordingDevice(DeviceInfo(), stats, profiler);
+    vec = new device_vector<int>(device, "test_vector", MEM_READ_ONLY);
+
+    int *data = vec->alloc(num_elements);
+    for (size_t i = 0; i < num_elements; i++) {
+      data[i] = i;
+    }
+    vec->copy_to_device();
+    vec->clear_modified();
+
+    device->num_full_copies = 0;
+  }
+
+  void TearDown() override
+  {
+    delete vec;
+    delete device;
+  }
+
+  const int *device_data() const
+  {
+    return (const int *)vec->device_pointer;
+  }
+
+  Stats stats;
+  Profiler profiler;
+  CopyRecordingDevice *device;
+  device_vector<int> *vec;
+};
+
+TEST_F(DeviceMemory, copy_modified_range)
+{
+  /* Host changes outside of the tagged range must not reach the device. */
+  for (size_t i = 100; i < 150; i++) {
+    (*vec)[i] = -1;
+  }
+  for (size_t i = 500; i < 510; i++) {
+    (*vec)[i] = -2;
+  }
+  vec->tag_modified(100, 50);
+  EXPECT_TRUE(vec->is_modified());
+
+  vec->copy_to_device_if_modified();
+  vec->clear_modified();
+
+  EXPECT_EQ(device->num_full_copies, 0);
+  ASSERT_EQ(device->ranged_copies.size(), 1);
+  EXPECT_EQ(device->ranged_copies[0], std::make_pair(size_t(100), size_t(50)));
+
+  for (size_t i = 0; i < num_elements; i++) {
+    if (i >= 100 && i < 150) {
+      EXPECT_EQ(device_data()[i], -1);
+    }
+    else {
+      EXPECT_EQ(device_data()[i], i);
+    }
+  }
+  EXPECT_FALSE(vec->is_modified());
+}
+
+TEST_F(DeviceMemory, merge_adjacent_ranges)
+{
+  vec->tag_modified(15, 5);
+  vec->tag_modified(10, 5);
+  vec->tag_modified(12, 2);
+  vec->tag_modified(300, 10);
+
+  vec->copy_to_device_if_modified();
+
+  EXPECT_EQ(device->num_full_copies, 0);
+  ASSERT_EQ(device->ranged_copies.size(), 2);
+  EXPECT_EQ(device->ranged_copies[0], std::make_pair(size_t(10), size_t(10)));
+  EXPECT_EQ(device->ranged_copies[1], std::make_pair(size_t(300), size_t(10)));
+}
+
+TEST_F(DeviceMemory, clamp_range_to_size)
+{
+  vec->tag_modified(num_elements - 10, 100);
+  vec->tag_modified(num_elements + 10, 10);
+
+  vec->copy_to_device_if_modified();
+
+  EXPECT_EQ(device->num_full_copies, 0);
+  ASSERT_EQ(device->ranged_copies.size(), 1);
+  EXPECT_EQ(device->ranged_copies[0], std::make_pair(num_elements - 10, size_t(10)));
+}
+
+TEST_F(DeviceMemory, copy_whole_array)
+{
+  /* Ranges covering most of the array are copied at once. */
+  vec->tag_modified(0, num_elements / 2 + 1);
+  vec->copy_to_device_if_modified();
+  vec->clear_modified();
+
+  EXPECT_EQ(device->num_full_copies, 1);
+  EXPECT_TRUE(device->ranged_copies.empty());
+
+  /* So is an array which is modified as a whole. */
+  vec->tag_modified();
+  vec->tag_modified(100, 10);
+  vec->copy_to_device_if_modified();
+
+  EXPECT_EQ(device->num_full_copies, 2);
+  EXPECT_TRUE(device->ranged_copies.empty());
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,250 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "graph/node.h"
+#include "graph/node_binary.h"
+#include "graph/node_type.h"
+
+#include "util/util_foreach.h"
+#include "util/util_path.h"
+#include "util/util_transform.h"
+
+CCL_NAMESPACE_BEGIN
+
+/* Node with a socket of every type which is written to binary files. */
+class BinaryTestNode : public Node {
+ public:
+  NODE_DECLARE
+
+  BinaryTestNode() : Node(get_node_type())
+  {
+  }
+
+  bool boolean_value;
+  int int_value;
+  uint uint_value;
+  float float_value;
+  float3 color_value;
+  float3 vector_value;
+  float3 point_value;
+  float3 normal_value;
+  float2 point2_value;
+  ustring string_value;
+  int enum_value;
+  Transform transform_value;
+  Node *node_value;
+
+  array<bool> boolean_array;
+  array<int> int_array;
+  array<float> float_array;
+  array<float3> color_array;
+  array<float3> vector_array;
+  array<float3> point_array;
+  array<float3> normal_array;
+  array<float2> point2_array;
+  array<ustring> string_array;
+  array<Transform> transform_array;
+  array<Node *> node_array;
+};
+
+NODE_DEFINE(BinaryTestNode)
+{
+  NodeType *type = NodeType::add("binary_test_node", create);
+
+  static NodeEnum enum_values;
+  enum_values.insert("first", 0);
+  enum_values.insert("second", 1);
+  enum_values.insert("third", 2);
+
+  SOCKET_BOOLEAN(boolean_value, "Boolean", false);
+  SOCKET_INT(int_value, "Int", 0);
+  SOCKET_UINT(uint_value, "UInt", 0);
+  SOCKET_FLOAT(float_value, "Float", 0.0f);
+  SOCKET_COLOR(color_value, "Color", zero_float3());
+  SOCKET_VECTOR(vector_value, "Vector", zero_float3());
+  SOCKET_POINT(point_value, "Point", zero_float3());
+  SOCKET_NORMAL(normal_value, "Normal", zero_float3());
+  SOCKET_POINT2(point2_value, "Point2", zero_float2());
+  SOCKET_STRING(string_value, "String", ustring());
+  SOCKET_ENUM(enum_value, "Enum", enum_values, 0);
+  SOCKET_TRANSFORM(transform_value, "Transform", transform_identity());
+  SOCKET_NODE(node_value, "Node", NULL);
+
+  SOCKET_BOOLEAN_ARRAY(boolean_array, "Boolean Array", array<bool>());
+  SOCKET_INT_ARRAY(int_array, "Int Array", array<int>());
+  SOCKET_FLOAT_ARRAY(float_array, "Float Array", array<float>());
+  SOCKET_COLOR_ARRAY(color_array, "Color Array", array<float3>());
+  SOCKET_VECTOR_ARRAY(vector_array, "Vector Array", array<float3>());
+  SOCKET_POINT_ARRAY(point_array, "Point Array", array<float3>());
+  SOCKET_NORMAL_ARRAY(normal_array, "Normal Array", array<float3>());
+  SOCKET_POINT2_ARRAY(point2_array, "Point2 Array", array<float2>());
+  SOCKET_STRING_ARRAY(string_array, "String Array", array<ustring>());
+  SOCKET_TRANSFORM_ARRAY(transform_array, "Transform Array", array<Transform>());
+  SOCKET_NODE_ARRAY(node_array, "Node Array", NULL);
+
+  return type;
+}
+
+template<typename T> static array<T> binary_test_array(const vector<T> &values)
+{
+  array<T> result;
+  foreach (const T &value, values) {
+    result.push_back_slow(value);
+  }
+  return result;
+}
+
+/* Give every socket a value which differs from its default. */
+static void binary_test_fill_node(BinaryTestNode &node, Node *other)
+{
+  const Transform tfm = transform_translate(1.0f, 2.0f, 3.0f) * transform_scale(4.0f, 5.0f, 6.0f);
+
+  node.name = ustring("filled");
+  node.boolean_value = true;
+  node.int_value = -42;
+  node.uint_value = 0xdeadbeef;
+  node.float_value = 1.5f;
+  node.color_value = make_float3(0.1f, 0.2f, 0.3f);
+  node.vector_value = make_float3(-1.0f, 0.0f, 1.0f);
+  node.point_value = make_float3(10.0f, 20.0f, 30.0f);
+  node.normal_value = make_float3(0.0f, 0.0f, 1.0f);
+  node.point2_value = make_float2(0.25f, 0.75f);
+  node.string_value = ustring("some string");
+  node.enum_value = 2;
+  node.transform_value = tfm;
+  node.node_value = other;
+
+  node.boolean_array = binary_test_array<bool>({true, false, true});
+  node.int_array = binary_test_array<int>({1, -2, 3, -4, 5});
+  node.float_array = binary_test_array<float>({0.5f, -0.25f});
+  node.color_array = binary_test_array<float3>({one_float3(), zero_float3()});
+  node.vector_array = binary_test_array<float3>({make_float3(1.0f, 2.0f, 3.0f)});
+  node.point_array = binary_test_array<float3>({make_float3(4.0f, 5.0f, 6.0f), one_float3()});
+  node.normal_array = binary_test_array<float3>({make_float3(0.0f, 1.0f, 0.0f)});
+  node.point2_array = binary_test_array<float2>({make_float2(1.0f, 2.0f), zero_float2()});
+  node.string_array = binary_test_array<ustring>({ustring("a"), ustring(), ustring("bc")});
+  node.transform_array = binary_test_array<Transform>({tfm, transform_identity()});
+  node.node_array = binary_test_array<Node *>({other, NULL, other});
+}
+
+static string binary_test_filepath(const char *name)
+{
+  return path_join(testing::TempDir(), name);
+}
+
+TEST(BinaryNode, round_trip_all_socket_types)
+{
+  const string filepath = binary_test_filepath("cycles_binary_round_trip.bin");
+
+  BinaryTestNode other;
+  other.name = ustring("other");
+  BinaryTestNode node;
+  binary_test_fill_node(node, &other);
+
+  /* Every socket has a non-default value, so all of them are written. */
+  foreach (const SocketType &socket, node.type->inputs) {
+    ASSERT_FALSE(node.has_default_value(socket)) << socket.name.c_str();
+  }
+
+  BinaryWriter writer;
+  ASSERT_TRUE(writer.open(filepath));
+  writer.add_node(&other);
+  writer.write_node(&other);
+  writer.add_node(&node);
+  writer.write_node(&node);
+  ASSERT_TRUE(writer.close());
+
+  BinaryTestNode read_other;
+  BinaryTestNode read_node;
+  BinaryReader reader;
+  ASSERT_TRUE(reader.open(filepath));
+  reader.add_node(&read_other);
+  reader.read_node(&read_other);
+  reader.add_node(&read_node);
+  reader.read_node(&read_node);
+  EXPECT_FALSE(reader.has_error());
+  reader.close();
+
+  EXPECT_EQ(read_other.name, ustring("other"));
+  EXPECT_EQ(read_node.name, ustring("filled"));
+
+  foreach (const SocketType &socket, node.type->inputs) {
+    if (socket.type == SocketType::NODE || socket.type == SocketType::NODE_ARRAY) {
+      continue;
+    }
+    EXPECT_TRUE(read_node.equals_value(node, socket)) << socket.name.c_str();
+  }
+
+  /* Node references point to the nodes on the reading side. */
+  EXPECT_EQ(read_node.node_value, &read_other);
+  ASSERT_EQ(read_node.node_array.size(), 3);
+  EXPECT_EQ(read_node.node_array[0], &read_other);
+  EXPECT_EQ(read_node.node_array[1], (Node *)NULL);
+  EXPECT_EQ(read_node.node_array[2], &read_other);
+
+  path_remove(filepath);
+}
+
+TEST(BinaryNode, default_values)
+{
+  const string filepath = binary_test_filepath("cycles_binary_default_values.bin");
+
+  BinaryTestNode node;
+  BinaryWriter writer;
+  ASSERT_TRUE(writer.open(filepath));
+  writer.write_node(&node);
+  ASSERT_TRUE(writer.close());
+
+  /* Sockets with default values are not written, and keep the value of the node read into. */
+  BinaryTestNode read_node;
+  read_node.int_value = 7;
+  BinaryReader reader;
+  ASSERT_TRUE(reader.open(filepath));
+  reader.read_node(&read_node);
+  EXPECT_FALSE(reader.has_error());
+  EXPECT_EQ(read_node.int_value, 7);
+
+  path_remove(filepath);
+}
+
+TEST(BinaryNode, truncated_file)
+{
+  const string filepath = binary_test_filepath("cycles_binary_truncated.bin");
+
+  BinaryTestNode node;
+  binary_test_fill_node(node, NULL);
+  BinaryWriter writer;
+  ASSERT_TRUE(writer.open(filepath));
+  writer.write_node(&node);
+  ASSERT_TRUE(writer.close());
+
+  vector<uint8_t> data;
+  ASSERT_TRUE(path_read_binary(filepath, data));
+  data.resize(data.size() / 2);
+  ASSERT_TRUE(path_write_binary(filepath, data));
+
+  BinaryTestNode read_node;
+  BinaryReader reader;
+  ASSERT_TRUE(reader.open(filepath));
+  reader.read_node(&read_node);
+  EXPECT_TRUE(reader.has_error());
+
+  path_remove(filepath);
+}
+
+CCL_NAMESPACE_END
@@ -44,4 +44,69 @@ TEST(tile_calculate_best_size, Extreme)
             TileSize(1, 1, 1024));
 }
 
+TEST(tile_calculate_morton_order, Square)
+{
+  const vector<int2> order = tile_calculate_morton_order(make_int2(4, 4));
+  ASSERT_EQ(order.size(), 16);
+
+  /* First quadrant is fully visited before moving to the next one. */
+  EXPECT_EQ(order[0], make_int2(0, 0));
+  EXPECT_EQ(order[1], make_int2(1, 0));
+  EXPECT_EQ(order[2], make_int2(0, 1));
+  EXPECT_EQ(order[3], make_int2(1, 1));
+  EXPECT_EQ(order[4], make_int2(2, 0));
+  EXPECT_EQ(order[15], make_int2(3, 3));
+}
+
+TEST(tile_calculate_morton_order, NonPowerOfTwo)
+{
+  const int2 num_tiles = make_int2(5, 3);
+  const vector<int2> order = tile_calculate_morton_order(num_tiles);
+  ASSERT_EQ(order.size(), num_tiles.x * num_tiles.y);
+
+  /* Every tile is visited exactly once. */
+  vector<int> num_visits(num_tiles.x * num_tiles.y, 0);
+  for (const int2 &tile : order) {
+    ASSERT_GE(tile.x, 0);
+    ASSERT_LT(tile.x, num_tiles.x);
+    ASSERT_GE(tile.y, 0);
+    ASSERT_LT(tile.y, num_tiles.y);
+    ++num_visits[tile.y * num_tiles.x + tile.x];
+  }
+  for (const int count : num_visits) {
+    EXPECT_EQ(count, 1);
+  }
+}
+
+TEST(tile_calculate_morton_order, Wide)
+{
+  /* More tiles along one axis than fit into 16 bits of a 32-bit Morton code. */
+  const int2 num_tiles = make_int2(70000, 2);
+  const vector<int2> order = tile_calculate_morton_order(num_tiles);
+  ASSERT_EQ(order.size(), size_t(num_tiles.x) * num_tiles.y);
+
+  vector<int> num_visits(num_tiles.x * num_tiles.y, 0);
+  for (const int2 &tile : order) {
+    ASSERT_GE(tile.x, 0);
+    ASSERT_LT(tile.x, num_tiles.x);
+    ASSERT_GE(tile.y, 0);
+    ASSERT_LT(tile.y, num_tiles.y);
+    ++num_visits[tile.y * num_tiles.x + tile.x];
+  }
+  for (const int count : num_visits) {
+    EXPECT_EQ(count, 1);
+  }
+
+  /* Tiles past the 16-bit boundary are still visited in curve order. */
+  EXPECT_EQ(order[65536 * 2], make_int2(65536, 0));
+  EXPECT_EQ(order[65536 * 2 + 1], make_int2(65537, 0));
+  EXPECT_EQ(order.back(), make_int2(num_tiles.x - 1, num_tiles.y - 1));
+}
+
+TEST(tile_calculate_morton_order, Empty)
+{
+  EXPECT_TRUE(tile_calculate_morton_order(make_int2(0, 0)).empty());
+  EXPECT_TRUE(tile_calculate_morton_order(make_int2(10, 0)).empty());
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "render/graph.h"
+#include "render/mesh.h"
+#include "render/nodes.h"
+#include "render/object.h"
+#include "render/scene.h"
+#include "render/shader.h"
+
+#include "util/util_half.h"
+#include "util/util_progress.h"
+#include "util/util_stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+class RenderGeometry : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  Progress progress;
+
+  virtual void SetUp()
+  {
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene_params.use_quantized_attributes = true;
+    scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+
+  /* Diffuse shader mixing two color attributes, so that both are stored for the kernel. */
+  Shader *create_color_attributes_shader(const char *name1, const char *name2)
+  {
+    ShaderGraph *graph = new ShaderGraph();
+    AttributeNode *attr1 = graph->create_node<AttributeNode>();
+    attr1->set_attribute(ustring(name1));
+    AttributeNode *attr2 = graph->create_node<AttributeNode>();
+    attr2->set_attribute(ustring(name2));
+    MixNode *mix = graph->create_node<MixNode>();
+    DiffuseBsdfNode *diffuse = graph->create_node<DiffuseBsdfNode>();
+    graph->add(attr1);
+    graph->add(attr2);
+    graph->add(mix);
+    graph->add(diffuse);
+    graph->connect(attr1->output("Color"), mix->input("Color1"));
+    graph->connect(attr2->output("Color"), mix->input("Color2"));
+    graph->connect(mix->output("Color"), diffuse->input("Color"));
+    graph->connect(diffuse->output("BSDF"), graph->output()->input("Surface"));
+
+    Shader *shader = scene->create_node<Shader>();
+    shader->set_graph(graph);
+    shader->tag_update(scene);
+    return shader;
+  }
+
+  static void add_color_attribute(Mesh *mesh, const char *name, const float4 color)
+  {
+    Attribute *attr = mesh->attributes.add(ustring(name), TypeRGBA, ATTR_ELEMENT_VERTEX);
+    float4 *data = attr->data_float4();
+    for (size_t i = 0; i < mesh->get_verts().size(); i++) {
+      data[i] = color;
+    }
+  }
+
+  /* Number of elements of the float2 attributes array storing given quantized color. */
+  int count_quantized_color(const float4 color)
+  {
+    const uint2 *data = (const uint2 *)scene->dscene.attributes_float2.data();
+    int count = 0;
+    for (size_t i = 0; i < scene->dscene.attributes_float2.size(); i++) {
+      const float4 decoded = make_float4(half_bits_to_float(data[i].x & 0xffff),
+                                         half_bits_to_float(data[i].x >> 16),
+                                         half_bits_to_float(data[i].y & 0xffff),
+                                         half_bits_to_float(data[i].y >> 16));
+      if (decoded == color) {
+        count++;
+      }
+    }
+    return count;
+  }
+};
+
+/*
+ * Tests:
+ *  - Quantized colors are stored in the float2 array, so adding one reallocates that array and
+ *    colors stored in previous updates are packed again.
+ */
+TEST_F(RenderGeometry, quantized_color_added)
+{
+  Shader *shader = create_color_attributes_shader("col1", "col2");
+
+  Mesh *mesh = scene->create_node<Mesh>();
+  array<Node *> used_shaders;
+  used_shaders.push_back_slow(shader);
+  mesh->set_used_shaders(used_shaders);
+  array<float3> verts;
+  verts.push_back_slow(make_float3(0.0f, 0.0f, 0.0f));
+  verts.push_back_slow(make_float3(1.0f, 0.0f, 0.0f));
+  verts.push_back_slow(make_float3(0.0f, 1.0f, 0.0f));
+  mesh->set_verts(verts);
+  mesh->reserve_mesh(verts.size(), 1);
+  mesh->add_triangle(0, 1, 2, 0, false);
+
+  Object *object = scene->create_node<Object>();
+  object->set_geometry(mesh);
+  object->set_tfm(transform_identity());
+
+  const float4 col1 = make_float4(0.25f, 0.5f, 0.75f, 1.0f);
+  const float4 col2 = make_float4(1.0f, 0.5f, 0.25f, 0.5f);
+  add_color_attribute(mesh, "col1", col1);
+  scene->update(progress);
+  ASSERT_EQ(scene->dscene.attributes_float2.size(), 3);
+  EXPECT_EQ(count_quantized_color(col1), 3);
+
+  add_color_attribute(mesh, "col2", col2);
+  mesh->tag_update(scene, false);
+  scene->update(progress);
+  ASSERT_EQ(scene->dscene.attributes_float2.size(), 6);
+  EXPECT_EQ(count_quantized_color(col1), 3);
+  EXPECT_EQ(count_quantized_color(col2), 3);
+}
+
+CCL_NAMESPACE_END
@@ -20,6 +20,7 @@
 #include "device/device.h"
 
 #include "render/graph.h"
+#include "render/image.h"
 #include "render/nodes.h"
 #include "render/scene.h"
 
@@ -1536,4 +1537,31 @@ TEST_F(RenderGraph, constant_fold_convert_color_float_color)
   graph.finalize(scene);
 }
 
+/*
+ * Tests:
+ *  - Texture coordinates at ray differential offsets for images read through the texture cache.
+ */
+TEST_F(RenderGraph, texture_cache_derivatives)
+{
+  EXPECT_ANY_MESSAGE(log);
+
+  scene->image_manager->set_texture_cache_size(256);
+
+  builder.add_node(ShaderNodeBuilder<TextureCoordinateNode>(graph, "TexCoord"))
+      .add_node(ShaderNodeBuilder<ImageTextureNode>(graph, "Image"))
+      .add_connection("TexCoord::UV", "Image::Vector")
+      .output_color("Image::Color");
+
+  graph.finalize(scene);
+
+  ShaderNode *image = builder.find_node("Image");
+  ShaderInput *vector_dx_in = image->input("Vector DX");
+  ShaderInput *vector_dy_in = image->input("Vector DY");
+  ASSERT_NE(vector_dx_in->link, (void *)NULL);
+  ASSERT_NE(vector_dy_in->link, (void *)NULL);
+  EXPECT_EQ(image->input("Vector")->link->parent->bump, SHADER_BUMP_NONE);
+  EXPECT_EQ(vector_dx_in->link->parent->bump, SHADER_BUMP_DX);
+  EXPECT_EQ(vector_dy_in->link->parent->bump, SHADER_BUMP_DY);
+}
+
 CCL_NAMESPACE_END
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "render/colorspace.h"
+#include "render/image.h"
+
+CCL_NAMESPACE_BEGIN
+
+static ImageMetaData texture_cache_test_metadata(int channels)
+{
+  ImageMetaData metadata;
+  metadata.channels = channels;
+  metadata.width = 64;
+  metadata.height = 64;
+  metadata.depth = 1;
+  metadata.colorspace = u_colorspace_srgb;
+  return metadata;
+}
+
+TEST(ImageManager, texture_cache_supports_channels)
+{
+  ImageParams params;
+  for (int channels = 1; channels <= 4; channels++) {
+    EXPECT_TRUE(
+        ImageManager::texture_cache_supports(texture_cache_test_metadata(channels), params));
+  }
+  EXPECT_FALSE(ImageManager::texture_cache_supports(texture_cache_test_metadata(0), params));
+
+  ImageMetaData volume = texture_cache_test_metadata(1);
+  volume.depth = 8;
+  EXPECT_FALSE(ImageManager::texture_cache_supports(volume, params));
+}
+
+TEST(ImageManager, texture_cache_supports_ignore_alpha)
+{
+  ImageParams params;
+  params.alpha_type = IMAGE_ALPHA_IGNORE;
+
+  /* The texture cache would associate alpha of grayscale + alpha images, instead of keeping
+   * the gray channel and ignoring alpha. */
+  EXPECT_FALSE(ImageManager::texture_cache_supports(texture_cache_test_metadata(2), params));
+  EXPECT_FALSE(ImageManager::texture_cache_supports(texture_cache_test_metadata(4), params));
+
+  /* Without alpha in the file there is nothing to ignore. */
+  EXPECT_TRUE(ImageManager::texture_cache_supports(texture_cache_test_metadata(1), params));
+  EXPECT_TRUE(ImageManager::texture_cache_supports(texture_cache_test_metadata(3), params));
+}
+
+TEST(ImageManager, texture_cache_supports_channel_packed)
+{
+  ImageParams params;
+  params.alpha_type = IMAGE_ALPHA_CHANNEL_PACKED;
+
+  EXPECT_FALSE(ImageManager::texture_cache_supports(texture_cache_test_metadata(2), params));
+  EXPECT_FALSE(ImageManager::texture_cache_supports(texture_cache_test_metadata(4), params));
+}
+
+CCL_NAMESPACE_END
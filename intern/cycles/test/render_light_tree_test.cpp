@@ -0,0 +1,181 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "render/light_tree.h"
+
+CCL_NAMESPACE_BEGIN
+
+namespace {
+
+LightTreeEmitter make_point_emitter(const float3 co, const float energy, const float pdf)
+{
+  LightTreeEmitter emitter;
+  emitter.bbox.grow(co);
+  emitter.energy = energy;
+  emitter.distribution_pdf = pdf;
+  return emitter;
+}
+
+LightTreeEmitter make_infinite_emitter(const float pdf)
+{
+  LightTreeEmitter emitter;
+  emitter.is_infinite = true;
+  emitter.energy = 1.0f;
+  emitter.distribution_pdf = pdf;
+  return emitter;
+}
+
+void expect_bbox_contains(const KernelLightTreeNode &knode, const KernelLightTreeNode &kchild)
+{
+  for (int axis = 0; axis < 3; axis++) {
+    EXPECT_LE(knode.bbox_min[axis], kchild.bbox_min[axis]);
+    EXPECT_GE(knode.bbox_max[axis], kchild.bbox_max[axis]);
+  }
+}
+
+/* Every emitter is in exactly one leaf, and inner nodes bound their children. */
+void expect_valid_tree(const LightTree &tree, const vector<LightTreeEmitter> &emitters)
+{
+  ASSERT_EQ(tree.emitter_nodes.size(), emitters.size());
+  ASSERT_EQ(tree.nodes.size(), 2 * emitters.size() - 1);
+  EXPECT_EQ(tree.nodes[0].parent_index, -1);
+
+  for (int i = 0; i < emitters.size(); i++) {
+    const KernelLightTreeNode &leaf = tree.nodes[tree.emitter_nodes[i]];
+    EXPECT_EQ(leaf.child_index, ~i);
+    EXPECT_FLOAT_EQ(leaf.distribution_pdf, emitters[i].distribution_pdf);
+  }
+
+  for (int node_index = 0; node_index < tree.nodes.size(); node_index++) {
+    const KernelLightTreeNode &knode = tree.nodes[node_index];
+    if (knode.child_index < 0) {
+      continue;
+    }
+    const KernelLightTreeNode &child0 = tree.nodes[knode.child_index];
+    const KernelLightTreeNode &child1 = tree.nodes[knode.child_index + 1];
+    EXPECT_EQ(child0.parent_index, node_index);
+    EXPECT_EQ(child1.parent_index, node_index);
+    EXPECT_FLOAT_EQ(knode.energy, child0.energy + child1.energy);
+    EXPECT_FLOAT_EQ(knode.distribution_pdf, child0.distribution_pdf + child1.distribution_pdf);
+
+    if (knode.flags & LIGHT_TREE_NODE_INFINITE) {
+      EXPECT_TRUE(child0.flags & LIGHT_TREE_NODE_INFINITE);
+      EXPECT_TRUE(child1.flags & LIGHT_TREE_NODE_INFINITE);
+      continue;
+    }
+    for (const KernelLightTreeNode *child : {&child0, &child1}) {
+      if (child->flags & LIGHT_TREE_NODE_INFINITE) {
+        continue;
+      }
+      expect_bbox_contains(knode, *child);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(LightTree, empty)
+{
+  vector<LightTreeEmitter> emitters;
+  LightTree tree(emitters);
+  EXPECT_TRUE(tree.nodes.empty());
+  EXPECT_TRUE(tree.emitter_nodes.empty());
+}
+
+TEST(LightTree, single_emitter)
+{
+  vector<LightTreeEmitter> emitters;
+  emitters.push_back(make_point_emitter(make_float3(1.0f, 2.0f, 3.0f), 2.0f, 1.0f));
+  LightTree tree(emitters);
+
+  ASSERT_EQ(tree.nodes.size(), 1);
+  EXPECT_EQ(tree.emitter_nodes[0], 0);
+  EXPECT_EQ(tree.nodes[0].child_index, ~0);
+  EXPECT_EQ(tree.nodes[0].parent_index, -1);
+  EXPECT_FLOAT_EQ(tree.nodes[0].energy, 2.0f);
+}
+
+TEST(LightTree, spatial_split)
+{
+  /* Two clusters of lights far away from each other end up in different subtrees. */
+  vector<LightTreeEmitter> emitters;
+  for (int i = 0; i < 8; i++) {
+    const float offset = (i % 2) ? 100.0f : -100.0f;
+    emitters.push_back(
+        make_point_emitter(make_float3(offset + i * 0.1f, 0.0f, 0.0f), 1.0f, 0.125f));
+  }
+  LightTree tree(emitters);
+  expect_valid_tree(tree, emitters);
+
+  const KernelLightTreeNode &root = tree.nodes[0];
+  const KernelLightTreeNode &child0 = tree.nodes[root.child_index];
+  const KernelLightTreeNode &child1 = tree.nodes[root.child_index + 1];
+  EXPECT_FLOAT_EQ(child0.energy, 4.0f);
+  EXPECT_FLOAT_EQ(child1.energy, 4.0f);
+  EXPECT_LT(child0.bbox_max[0] - child0.bbox_min[0], 1.0f);
+  EXPECT_LT(child1.bbox_max[0] - child1.bbox_min[0], 1.0f);
+}
+
+TEST(LightTree, infinite_emitters)
+{
+  /* Distant lights are separated from the local ones at the root. */
+  vector<LightTreeEmitter> emitters;
+  for (int i = 0; i < 5; i++) {
+    emitters.push_back(make_point_emitter(make_float3(i, i * i, 0.0f), 1.0f, 0.1f));
+  }
+  emitters.push_back(make_infinite_emitter(0.25f));
+  emitters.push_back(make_infinite_emitter(0.25f));
+  LightTree tree(emitters);
+  expect_valid_tree(tree, emitters);
+
+  const KernelLightTreeNode &root = tree.nodes[0];
+  const KernelLightTreeNode &child0 = tree.nodes[root.child_index];
+  const KernelLightTreeNode &child1 = tree.nodes[root.child_index + 1];
+  EXPECT_FALSE(child0.flags & LIGHT_TREE_NODE_INFINITE);
+  EXPECT_TRUE(child1.flags & LIGHT_TREE_NODE_INFINITE);
+  EXPECT_FLOAT_EQ(child0.distribution_pdf, 0.5f);
+  EXPECT_FLOAT_EQ(child1.distribution_pdf, 0.5f);
+}
+
+TEST(LightTree, orientation_merge)
+{
+  LightTreeOrientation a;
+  a.axis = make_float3(0.0f, 0.0f, 1.0f);
+  a.theta_o = 0.0f;
+  LightTreeOrientation b;
+  b.axis = make_float3(1.0f, 0.0f, 0.0f);
+  b.theta_o = 0.0f;
+
+  /* Cone which contains both axes. */
+  const LightTreeOrientation merged = LightTreeOrientation::merge(a, b);
+  EXPECT_NEAR(merged.theta_o, M_PI_4_F, 1e-5f);
+  EXPECT_NEAR(merged.axis.x, 0.70710678f, 1e-5f);
+  EXPECT_NEAR(merged.axis.y, 0.0f, 1e-5f);
+  EXPECT_NEAR(merged.axis.z, 0.70710678f, 1e-5f);
+
+  /* Merging with an omnidirectional emitter is omnidirectional. */
+  const LightTreeOrientation omni = LightTreeOrientation::merge(
+      a, LightTreeOrientation::omnidirectional());
+  EXPECT_FLOAT_EQ(omni.theta_o, M_PI_F);
+
+  /* Opposite directions cover the whole sphere. */
+  b.axis = make_float3(0.0f, 0.0f, -1.0f);
+  EXPECT_FLOAT_EQ(LightTreeOrientation::merge(a, b).theta_o, M_PI_F);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "render/merge.h"
+
+#include "util/util_path.h"
+#include "util/util_string.h"
+#include "util/util_unique_ptr.h"
+
+#include <OpenImageIO/imageio.h>
+
+OIIO_NAMESPACE_USING
+
+CCL_NAMESPACE_BEGIN
+
+static const int merge_test_width = 2;
+static const int merge_test_height = 2;
+static const int merge_test_channels = 4;
+
+/* Write a partial render of layer "View Layer" with the combined pass filled with a constant
+ * value, rendered with samples [start_sample, start_sample + num_samples). */
+static bool write_sample_range(const string &filepath,
+                               const int start_sample,
+                               const int num_samples,
+                               const float value)
+{
+  unique_ptr<ImageOutput> out(ImageOutput::create(filepath));
+  if (!out) {
+    return false;
+  }
+
+  ImageSpec spec(merge_test_width, merge_test_height, merge_test_channels, TypeDesc::FLOAT);
+  spec.channelnames = {"View Layer.Combined.R",
+                       "View Layer.Combined.G",
+                       "View Layer.Combined.B",
+                       "View Layer.Combined.A"};
+  spec.alpha_channel = 3;
+  spec.attribute("cycles.View Layer.samples", string_printf("%d", num_samples));
+  spec.attribute("cycles.View Layer.range_start_sample", string_printf("%d", start_sample));
+  spec.attribute("cycles.View Layer.range_num_samples", string_printf("%d", num_samples));
+
+  vector<float> pixels(merge_test_width * merge_test_height * merge_test_channels, value);
+
+  const bool ok = out->open(filepath, spec) && out->write_image(TypeDesc::FLOAT, pixels.data());
+  out->close();
+  return ok;
+}
+
+TEST(ImageMerger, sample_ranges)
+{
+  const string filepath_a = path_join(path_temp_get(), "cycles_merge_test_a.exr");
+  const string filepath_b = path_join(path_temp_get(), "cycles_merge_test_b.exr");
+  const string filepath_out = path_join(path_temp_get(), "cycles_merge_test_out.exr");
+
+  /* Samples 16..63 and 0..15, inputs deliberately not in sample range order. */
+  ASSERT_TRUE(write_sample_range(filepath_a, 16, 48, 1.0f));
+  ASSERT_TRUE(write_sample_range(filepath_b, 0, 16, 0.2f));
+
+  ImageMerger merger;
+  merger.input = {filepath_a, filepath_b};
+  merger.output = filepath_out;
+  ASSERT_TRUE(merger.run()) << merger.error;
+
+  unique_ptr<ImageInput> in(ImageInput::open(filepath_out));
+  ASSERT_TRUE(in);
+
+  const ImageSpec &spec = in->spec();
+  ASSERT_EQ(spec.nchannels, merge_test_channels);
+
+  /* Samples of the ranges add up, and the result is not a partial render anymore. */
+  EXPECT_EQ(spec.get_string_attribute("cycles.View Layer.samples"), "64");
+  EXPECT_EQ(spec.get_string_attribute("cycles.View Layer.range_start_sample"), "");
+  EXPECT_EQ(spec.get_string_attribute("cycles.View Layer.range_num_samples"), "");
+
+  /* Pixels are averaged weighted by the number of samples of every range. */
+  vector<float> pixels(merge_test_width * merge_test_height * merge_test_channels);
+  ASSERT_TRUE(in->read_image(TypeDesc::FLOAT, pixels.data()));
+  in->close();
+
+  const float expected = (48 * 1.0f + 16 * 0.2f) / 64;
+  for (const float value : pixels) {
+    EXPECT_NEAR(value, expected, 1e-6f);
+  }
+
+  path_remove(filepath_a);
+  path_remove(filepath_b);
+  path_remove(filepath_out);
+}
+
+TEST(ImageMerger, overlapping_sample_ranges)
+{
+  const string filepath_a = path_join(path_temp_get(), "cycles_merge_overlap_test_a.exr");
+  const string filepath_b = path_join(path_temp_get(), "cycles_merge_overlap_test_b.exr");
+  const string filepath_out = path_join(path_temp_get(), "cycles_merge_overlap_test_out.exr");
+
+  ASSERT_TRUE(write_sample_range(filepath_a, 0, 32, 1.0f));
+  ASSERT_TRUE(write_sample_range(filepath_b, 16, 32, 0.2f));
+
+  ImageMerger merger;
+  merger.input = {filepath_a, filepath_b};
+  merger.output = filepath_out;
+  EXPECT_FALSE(merger.run());
+  EXPECT_NE(merger.error, "");
+
+  path_remove(filepath_a);
+  path_remove(filepath_b);
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,114 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "device/device.h"
+
+#include "render/mesh.h"
+#include "render/object.h"
+#include "render/scene.h"
+
+#include "util/util_murmurhash.h"
+#include "util/util_progress.h"
+#include "util/util_stats.h"
+
+CCL_NAMESPACE_BEGIN
+
+class RenderObject : public testing::Test {
+ protected:
+  Stats stats;
+  Profiler profiler;
+  DeviceInfo device_info;
+  Device *device_cpu;
+  SceneParams scene_params;
+  Scene *scene;
+  Progress progress;
+
+  virtual void SetUp()
+  {
+    device_cpu = Device::create(device_info, stats, profiler);
+    scene = new Scene(scene_params, device_cpu);
+  }
+
+  virtual void TearDown()
+  {
+    delete scene;
+    delete device_cpu;
+  }
+
+  void update_objects()
+  {
+    scene->object_manager->device_update(device_cpu, &scene->dscene, scene, progress);
+    scene->object_manager->device_update_flags(
+        device_cpu, &scene->dscene, scene, progress, false);
+  }
+
+  float cryptomatte_object(int index)
+  {
+    return scene->dscene.objects[index].cryptomatte_object;
+  }
+};
+
+static float cryptomatte_hash(const char *name)
+{
+  return util_hash_to_float(util_murmur_hash3(name, strlen(name), 0));
+}
+
+/*
+ * Tests:
+ *  - Data which is only written for modified objects is filled in again when objects switch
+ *    from shared to their own KernelObjects.
+ */
+TEST_F(RenderObject, toggle_compact_instances)
+{
+  Mesh *mesh = scene->create_node<Mesh>();
+
+  /* 1023 unique objects and 1025 instances which can share their KernelObject, so that the
+   * number of prototypes is exactly half the number of objects. */
+  const int num_unique = 1023;
+  const int num_instances = 1025;
+  for (int i = 0; i < num_unique + num_instances; i++) {
+    Object *object = scene->create_node<Object>();
+    object->set_geometry(mesh);
+    object->set_tfm(transform_translate(make_float3(i, 0.0f, 0.0f)));
+    object->name = (i < num_unique) ? ustring(string_printf("unique_%d", i)) : ustring("instance");
+  }
+
+  update_objects();
+  ASSERT_TRUE(scene->dscene.data.bvh.use_compact_instances);
+  ASSERT_EQ(scene->dscene.objects.size(), num_unique + 1);
+
+  /* Object attributes can not be shared, one more prototype disables compact instancing without
+   * modifying any object socket. */
+  const float value = 1.0f;
+  scene->objects.back()->attributes.push_back(
+      ParamValue(ustring("attr"), TypeDesc::TypeFloat, 1, &value));
+  scene->object_manager->tag_update(scene, ObjectManager::OBJECT_MODIFIED);
+
+  update_objects();
+  ASSERT_FALSE(scene->dscene.data.bvh.use_compact_instances);
+  ASSERT_EQ(scene->dscene.objects.size(), num_unique + num_instances);
+
+  for (int i = 0; i < num_unique; i++) {
+    EXPECT_EQ(cryptomatte_object(i), cryptomatte_hash(string_printf("unique_%d", i).c_str()));
+  }
+  for (int i = num_unique; i < num_unique + num_instances; i++) {
+    EXPECT_EQ(cryptomatte_object(i), cryptomatte_hash("instance"));
+  }
+}
+
+CCL_NAMESPACE_END
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2011-2021 Blender Foundation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "testing/testing.h"
+
+#include "render/mesh.h"
+#include "subd/subd_split.h"
+
+CCL_NAMESPACE_BEGIN
+
+TEST(DiagSplit, edge_factor_bucket_exact)
+{
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(-1), 0u);
+  for (int T = 0; T <= 8; T++) {
+    EXPECT_EQ(DiagSplit::edge_factor_bucket(T), (uint)T);
+  }
+}
+
+TEST(DiagSplit, edge_factor_bucket_boundary)
+{
+  /* First quantized bucket follows the exact ones. */
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(9), 9u);
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(10), 10u);
+
+  /* Quarter octave steps. */
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(16), 13u);
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(17), 13u);
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(32), 17u);
+  EXPECT_EQ(DiagSplit::edge_factor_bucket(33), 17u);
+}
+
+TEST(DiagSplit, edge_factor_bucket_monotonic)
+{
+  for (int T = 1; T <= 100000; T++) {
+    const uint previous = DiagSplit::edge_factor_bucket(T - 1);
+    const uint current = DiagSplit::edge_factor_bucket(T);
+    ASSERT_GE(current, previous) << "T = " << T;
+    ASSERT_LE(current, previous + 1) << "T = " << T;
+  }
+}
+
+CCL_NAMESPACE_END
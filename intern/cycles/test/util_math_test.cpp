@@ -16,6 +16,7 @@
 
 #include "testing/testing.h"
 
+#include "util/util_half.h"
 #include "util/util_math.h"
 
 CCL_NAMESPACE_BEGIN
@@ -58,4 +59,37 @@ TEST(math, reverse_integer_bits)
   EXPECT_EQ(reverse_integer_bits(0xAAAAAAAA), 0x55555555);
 }
 
+TEST(math, octahedral)
+{
+  const float3 normals[] = {make_float3(0.0f, 0.0f, 1.0f),
+                            make_float3(0.0f, 0.0f, -1.0f),
+                            make_float3(1.0f, 0.0f, 0.0f),
+                            make_float3(0.0f, -1.0f, 0.0f),
+                            normalize(make_float3(1.0f, 2.0f, 3.0f)),
+                            normalize(make_float3(-0.3f, 0.2f, -0.9f)),
+                            normalize(make_float3(-1.0f, -1.0f, -1.0f))};
+
+  for (const float3 &n : normals) {
+    const float3 decoded = octahedral_to_float3(float3_to_octahedral(n));
+    EXPECT_NEAR(decoded.x, n.x, 1e-4f);
+    EXPECT_NEAR(decoded.y, n.y, 1e-4f);
+    EXPECT_NEAR(decoded.z, n.z, 1e-4f);
+    EXPECT_NEAR(len(decoded), 1.0f, 1e-6f);
+  }
+
+  /* Degenerate normals decode to a valid unit vector. */
+  const float3 zero = octahedral_to_float3(float3_to_octahedral(zero_float3()));
+  EXPECT_FLOAT_EQ(zero.z, 1.0f);
+}
+
+TEST(math, half_bits_to_float)
+{
+  EXPECT_EQ(half_bits_to_float(float_to_half(0.0f)), 0.0f);
+  EXPECT_EQ(half_bits_to_float(float_to_half(1.0f)), 1.0f);
+  EXPECT_EQ(half_bits_to_float(float_to_half(-2.5f)), -2.5f);
+  EXPECT_EQ(half_bits_to_float(float_to_half(0.125f)), 0.125f);
+  EXPECT_NEAR(half_bits_to_float(float_to_half(0.3f)), 0.3f, 1e-3f);
+  EXPECT_NEAR(half_bits_to_float(float_to_half(7.9f)), 7.9f, 4e-3f);
+}
+
 CCL_NAMESPACE_END
@@ -79,6 +79,16 @@ class DebugFlags {
      * CPUs and GPUs can be selected here instead.
      */
     BVHLayout bvh_layout;
+
+    /* Size in pixels of the square tiles which are scheduled as a single work item by the CPU
+     * path tracer. Samples are interleaved within a tile to keep neighbor rays on the same thread.
+     * Size of 1 gives pixel-by-pixel scheduling. */
+    int work_tile_size;
+
+    /* Render work tiles with the wavefront integrator: paths of a tile are advanced together one
+     * kernel at a time, with shading kernels sorted by shader, instead of using the megakernel
+     * for one path at a time. */
+    bool wavefront;
   };
 
   /* Descriptor of CUDA feature-set to be used. */
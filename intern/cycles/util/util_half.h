@@ -174,6 +174,17 @@ ccl_device_inline half float_to_half(float f)
 
 #endif
 
+/* Conversion of half float bits which, unlike half_to_float(), is exact for zero. Used for
+ * quantized geometry attributes, which are often exactly zero. Denormals are not supported,
+ * float_to_half() flushes them to zero. */
+ccl_device_inline float half_bits_to_float(uint h)
+{
+  const uint sign = (h & 0x8000) << 16;
+  const uint exponent_mantissa = h & 0x7fff;
+  const uint bits = (exponent_mantissa == 0) ? 0 : ((exponent_mantissa + 0x1C000) << 13);
+  return __uint_as_float(sign | bits);
+}
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_HALF_H__ */
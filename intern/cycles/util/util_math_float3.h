@@ -525,6 +525,46 @@ ccl_device_inline float3 ensure_finite3(float3 v)
   return v;
 }
 
+/* Octahedral encoding of a unit vector into two signed 16 bit integers packed in a uint. */
+
+ccl_device_inline int octahedral_snorm16(float f)
+{
+  f = clamp(f, -1.0f, 1.0f) * 32767.0f;
+  return (int)((f >= 0.0f) ? f + 0.5f : f - 0.5f);
+}
+
+ccl_device_inline uint float3_to_octahedral(float3 n)
+{
+  const float len = fabsf(n.x) + fabsf(n.y) + fabsf(n.z);
+  if (!(len > 0.0f)) {
+    /* Degenerate normal, encode as (0, 0, 1). */
+    return 0;
+  }
+
+  float u = n.x / len, v = n.y / len;
+  if (n.z < 0.0f) {
+    const float fold_u = (1.0f - fabsf(v)) * signf(u);
+    v = (1.0f - fabsf(u)) * signf(v);
+    u = fold_u;
+  }
+
+  return ((uint)octahedral_snorm16(u) & 0xffff) | ((uint)octahedral_snorm16(v) << 16);
+}
+
+ccl_device_inline float3 octahedral_to_float3(uint oct)
+{
+  const float u = (float)(short)(oct & 0xffff) * (1.0f / 32767.0f);
+  const float v = (float)(short)(oct >> 16) * (1.0f / 32767.0f);
+
+  float3 n = make_float3(u, v, 1.0f - fabsf(u) - fabsf(v));
+  if (n.z < 0.0f) {
+    n.x = (1.0f - fabsf(v)) * signf(u);
+    n.y = (1.0f - fabsf(u)) * signf(v);
+  }
+
+  return normalize(n);
+}
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_MATH_FLOAT3_H__ */
@@ -76,6 +76,8 @@ void Profiler::reset(int num_shaders, int num_objects)
   /* Resize and clear the accumulation vectors. */
   shader_hits.assign(num_shaders, 0);
   object_hits.assign(num_objects, 0);
+  shader_time.assign(num_shaders, 0);
+  object_time.assign(num_objects, 0);
 
   event_samples.assign(PROFILING_NUM_EVENTS, 0);
   shader_samples.assign(num_shaders, 0);
@@ -115,6 +117,8 @@ void Profiler::add_state(ProfilingState *state)
   /* Resize thread-local hit counters. */
   state->shader_hits.assign(shader_hits.size(), 0);
   state->object_hits.assign(object_hits.size(), 0);
+  state->shader_time.assign(shader_time.size(), 0);
+  state->object_time.assign(object_time.size(), 0);
 
   /* Initialize the state. */
   state->event = PROFILING_UNKNOWN;
@@ -131,15 +135,17 @@ void Profiler::remove_state(ProfilingState *state)
   states.erase(std::remove(states.begin(), states.end(), state), states.end());
   state->active = false;
 
-  /* Merge thread-local hit counters. */
+  /* Merge thread-local hit counters and times. */
   assert(shader_hits.size() == state->shader_hits.size());
   for (int i = 0; i < shader_hits.size(); i++) {
     shader_hits[i] += state->shader_hits[i];
+    shader_time[i] += state->shader_time[i];
   }
 
   assert(object_hits.size() == state->object_hits.size());
   for (int i = 0; i < object_hits.size(); i++) {
     object_hits[i] += state->object_hits[i];
+    object_time[i] += state->object_time[i];
   }
 }
 
@@ -149,25 +155,27 @@ uint64_t Profiler::get_event(ProfilingEvent event)
   return event_samples[event];
 }
 
-bool Profiler::get_shader(int shader, uint64_t &samples, uint64_t &hits)
+bool Profiler::get_shader(int shader, uint64_t &samples, uint64_t &hits, uint64_t &time)
 {
   assert(worker == NULL);
-  if (shader_samples[shader] == 0) {
+  if (shader_samples[shader] == 0 && shader_time[shader] == 0) {
     return false;
   }
   samples = shader_samples[shader];
   hits = shader_hits[shader];
+  time = shader_time[shader];
   return true;
 }
 
-bool Profiler::get_object(int object, uint64_t &samples, uint64_t &hits)
+bool Profiler::get_object(int object, uint64_t &samples, uint64_t &hits, uint64_t &time)
 {
   assert(worker == NULL);
-  if (object_samples[object] == 0) {
+  if (object_samples[object] == 0 && object_time[object] == 0) {
     return false;
   }
   samples = object_samples[object];
   hits = object_hits[object];
+  time = object_time[object];
   return true;
 }
 
@@ -18,6 +18,7 @@
 #define __UTIL_PROFILING_H__
 
 #include <atomic>
+#include <chrono>
 
 #include "util/util_map.h"
 #include "util/util_thread.h"
@@ -77,6 +78,10 @@ struct ProfilingState {
 
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
+
+  /* Time in nanoseconds spent with a shader or object being active, measured by the worker. */
+  vector<uint64_t> shader_time;
+  vector<uint64_t> object_time;
 };
 
 class Profiler {
@@ -93,8 +98,8 @@ class Profiler {
   void remove_state(ProfilingState *state);
 
   uint64_t get_event(ProfilingEvent event);
-  bool get_shader(int shader, uint64_t &samples, uint64_t &hits);
-  bool get_object(int object, uint64_t &samples, uint64_t &hits);
+  bool get_shader(int shader, uint64_t &samples, uint64_t &hits, uint64_t &time);
+  bool get_object(int object, uint64_t &samples, uint64_t &hits, uint64_t &time);
 
  protected:
   void run();
@@ -113,6 +118,11 @@ class Profiler {
   vector<uint64_t> shader_hits;
   vector<uint64_t> object_hits;
 
+  /* Measured time in nanoseconds every object/shader was active, written by the render
+   * thread. Unlike the samples this is exact, so cost of rarely hit shaders is still known. */
+  vector<uint64_t> shader_time;
+  vector<uint64_t> object_time;
+
   volatile bool do_stop_worker;
   thread *worker;
 
@@ -146,12 +156,14 @@ class ProfilingHelper {
 class ProfilingWithShaderHelper : public ProfilingHelper {
  public:
   ProfilingWithShaderHelper(ProfilingState *state, ProfilingEvent event)
-      : ProfilingHelper(state, event)
+      : ProfilingHelper(state, event), shader(-1), object(-1)
   {
   }
 
   ~ProfilingWithShaderHelper()
   {
+    accumulate_time();
+
     state->object = -1;
     state->shader = -1;
   }
@@ -159,6 +171,12 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
   inline void set_shader(int object, int shader)
   {
     if (state->active) {
+      accumulate_time();
+
+      this->shader = shader;
+      this->object = object;
+      start_time = std::chrono::steady_clock::now();
+
       state->shader = shader;
       state->object = object;
 
@@ -173,6 +191,32 @@ class ProfilingWithShaderHelper : public ProfilingHelper {
       }
     }
   }
+
+ protected:
+  /* Add time since the shader was set to the shader and object. */
+  inline void accumulate_time()
+  {
+    if (shader < 0 && object < 0) {
+      return;
+    }
+
+    const uint64_t time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - start_time)
+                              .count();
+    if (shader >= 0) {
+      state->shader_time[shader] += time;
+    }
+    if (object >= 0) {
+      state->object_time[object] += time;
+    }
+
+    shader = -1;
+    object = -1;
+  }
+
+  int shader;
+  int object;
+  std::chrono::steady_clock::time_point start_time;
 };
 
 CCL_NAMESPACE_END
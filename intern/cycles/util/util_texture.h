@@ -50,6 +50,7 @@ typedef enum ImageDataType {
   IMAGE_DATA_TYPE_USHORT = 7,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT = 8,
   IMAGE_DATA_TYPE_NANOVDB_FLOAT3 = 9,
+  IMAGE_DATA_TYPE_TEXTURE_CACHE = 10,
 
   IMAGE_DATA_NUM_TYPES
 } ImageDataType;
@@ -94,6 +95,18 @@ typedef struct TextureInfo {
   Transform transform_3d;
 } TextureInfo;
 
+/* Image which is not stored in device memory, but is read on demand through the OpenImageIO
+ * texture cache. The texture data of such images points to this struct. CPU only. */
+typedef struct TextureCacheImage {
+  /* OIIO::TextureSystem and its OIIO::TextureSystem::TextureHandle for the file. */
+  void *texture_system;
+  void *texture_handle;
+  /* Number of channels in the file, the kernel expands them to RGBA. */
+  int num_channels;
+  /* Smallest filter width in texture coordinates, to respect the texture size limit. */
+  float min_filter_width;
+} TextureCacheImage;
+
 CCL_NAMESPACE_END
 
 #endif /* __UTIL_TEXTURE_H__ */
@@ -160,8 +160,9 @@ size_t BLI_file_zstd_from_mem_at_pos(void *buf,
                                      size_t len,
                                      FILE *file,
                                      size_t file_offset,
-                                     int compression_level) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
-size_t BLI_file_unzstd_to_mem_at_pos(void *buf, size_t len, FILE *file, size_t file_offset)
+                                     int compression_level,
+                                     int num_threads) ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
+size_t BLI_file_unzstd_from_mem(void *buf, size_t len, const void *src, size_t src_len)
     ATTR_WARN_UNUSED_RESULT ATTR_NONNULL();
 bool BLI_file_magic_is_zstd(const char header[4]);
 
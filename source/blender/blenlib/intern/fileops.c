@@ -62,13 +62,24 @@
 #include "BLI_sys_types.h" /* for intptr_t support */
 #include "BLI_utildefines.h"
 
-size_t BLI_file_zstd_from_mem_at_pos(
-    void *buf, size_t len, FILE *file, size_t file_offset, int compression_level)
+/**
+ * Write a single Zstd frame storing its content size.
+ * Compression uses \a num_threads worker threads when Zstd was built with multi-threading
+ * support, 0 compresses on the calling thread.
+ */
+size_t BLI_file_zstd_from_mem_at_pos(void *buf,
+                                     size_t len,
+                                     FILE *file,
+                                     size_t file_offset,
+                                     int compression_level,
+                                     int num_threads)
 {
   fseek(file, file_offset, SEEK_SET);
 
   ZSTD_CCtx *ctx = ZSTD_createCCtx();
   ZSTD_CCtx_setParameter(ctx, ZSTD_c_compressionLevel, compression_level);
+  ZSTD_CCtx_setParameter(ctx, ZSTD_c_nbWorkers, num_threads);
+  ZSTD_CCtx_setPledgedSrcSize(ctx, len);
 
   ZSTD_inBuffer input = {buf, len, 0};
 
@@ -109,41 +120,14 @@ size_t BLI_file_zstd_from_mem_at_pos(
   return ZSTD_isError(ret) ? 0 : total_written;
 }
 
-size_t BLI_file_unzstd_to_mem_at_pos(void *buf, size_t len, FILE *file, size_t file_offset)
+/**
+ * Decompress Zstd frames of \a src_len bytes from memory, like a memory mapped file, directly
+ * into \a buf. Returns the number of decompressed bytes or 0 on error.
+ */
+size_t BLI_file_unzstd_from_mem(void *buf, size_t len, const void *src, size_t src_len)
 {
-  fseek(file, file_offset, SEEK_SET);
-
-  ZSTD_DCtx *ctx = ZSTD_createDCtx();
-
-  size_t in_len = ZSTD_DStreamInSize();
-  void *in_buf = MEM_mallocN(in_len, __func__);
-  ZSTD_inBuffer input = {in_buf, in_len, 0};
-
-  ZSTD_outBuffer output = {buf, len, 0};
-
-  size_t ret = 0;
-  /* Read and decompress chunks of input data until we have enough output. */
-  while (output.pos < output.size && !ZSTD_isError(ret)) {
-    input.size = fread(in_buf, 1, in_len, file);
-    if (input.size == 0) {
-      break;
-    }
-
-    /* Consume input data until we run out or have enough output. */
-    input.pos = 0;
-    while (input.pos < input.size && output.pos < output.size) {
-      ret = ZSTD_decompressStream(ctx, &output, &input);
-
-      if (ZSTD_isError(ret)) {
-        break;
-      }
-    }
-  }
-
-  MEM_freeN(in_buf);
-  ZSTD_freeDCtx(ctx);
-
-  return ZSTD_isError(ret) ? 0 : output.pos;
+  const size_t ret = ZSTD_decompress(buf, len, src, src_len);
+  return ZSTD_isError(ret) ? 0 : ret;
 }
 
 bool BLI_file_magic_is_gzip(const char header[4])
@@ -117,15 +117,18 @@ static void __cpuid(
     int data[4],
     int selector)
 {
+  /* Sub-leaf is 0, like MSVC's `__cpuid`. */
 #  if defined(__x86_64__)
-  asm("cpuid" : "=a"(data[0]), "=b"(data[1]), "=c"(data[2]), "=d"(data[3]) : "a"(selector));
+  asm("cpuid"
+      : "=a"(data[0]), "=b"(data[1]), "=c"(data[2]), "=d"(data[3])
+      : "a"(selector), "c"(0));
 #  elif defined(__i386__)
   asm("pushl %%ebx    \n\t"
       "cpuid          \n\t"
       "movl %%ebx, %1 \n\t"
       "popl %%ebx     \n\t"
       : "=a"(data[0]), "=r"(data[1]), "=c"(data[2]), "=d"(data[3])
-      : "a"(selector)
+      : "a"(selector), "c"(0)
       : "ebx");
 #  else
   (void)selector;
@@ -163,6 +166,42 @@ int BLI_cpu_support_sse41(void)
   return 0;
 }
 
+int BLI_cpu_support_avx2(void)
+{
+  int result[4], num;
+  __cpuid(result, 0);
+  num = result[0];
+
+  if (num < 7) {
+    return 0;
+  }
+
+  /* The OS has to save the AVX registers on context switches. */
+  __cpuid(result, 0x00000001);
+  const int os_uses_xsave = (result[2] & ((int)1 << 27)) != 0;
+  const int cpu_avx_support = (result[2] & ((int)1 << 28)) != 0;
+  if (!os_uses_xsave || !cpu_avx_support) {
+    return 0;
+  }
+
+  unsigned int xcr_feature_mask;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  unsigned int edx; /* Not used. */
+  /* Opcode of `xgetbv`. */
+  __asm__(".byte 0x0f, 0x01, 0xd0" : "=a"(xcr_feature_mask), "=d"(edx) : "c"(0));
+#elif defined(_MSC_VER) && defined(_XCR_XFEATURE_ENABLED_MASK)
+  xcr_feature_mask = (unsigned int)_xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+#else
+  xcr_feature_mask = 0;
+#endif
+  if ((xcr_feature_mask & 0x6) != 0x6) {
+    return 0;
+  }
+
+  __cpuid(result, 0x00000007);
+  return (result[1] & ((int)1 << 5)) != 0;
+}
+
 void BLI_hostname_get(char *buffer, size_t bufsize)
 {
 #ifndef WIN32
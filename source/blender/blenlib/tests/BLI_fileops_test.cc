@@ -0,0 +1,59 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "BLI_fileops.h"
+#include "BLI_mmap.h"
+
+/* Pixels of a 64x48 byte image, with compressible and random looking parts. */
+static std::vector<char> create_test_pixels()
+{
+  std::vector<char> pixels(64 * 48 * 4);
+  for (size_t i = 0; i < pixels.size(); i++) {
+    pixels[i] = (i < pixels.size() / 2) ? (char)(i / 64) : (char)((i * 2654435761u) >> 24);
+  }
+  return pixels;
+}
+
+/* Writes an entry after a header like the sequencer disk cache does, then reads it back from a
+ * memory mapping of the file. */
+TEST(fileops, ZstdMappedRoundTrip)
+{
+  const std::vector<char> pixels = create_test_pixels();
+  const size_t offset = 1024;
+
+  FILE *file = tmpfile();
+  ASSERT_NE(file, nullptr);
+  std::vector<char> data = pixels;
+  const size_t size_compressed = BLI_file_zstd_from_mem_at_pos(
+      data.data(), data.size(), file, offset, 1, 2);
+  ASSERT_GT(size_compressed, 0);
+  EXPECT_LT(size_compressed, pixels.size());
+  fflush(file);
+
+  BLI_mmap_file *mmap_file = BLI_mmap_open(fileno(file));
+  ASSERT_NE(mmap_file, nullptr);
+  EXPECT_EQ(BLI_mmap_get_length(mmap_file), offset + size_compressed);
+  char header[4];
+  EXPECT_TRUE(BLI_mmap_read(mmap_file, header, offset, sizeof(header)));
+  EXPECT_TRUE(BLI_file_magic_is_zstd(header));
+
+  std::vector<char> result(pixels.size());
+  const char *compressed_data = (const char *)BLI_mmap_get_pointer(mmap_file) + offset;
+  EXPECT_EQ(BLI_file_unzstd_from_mem(
+                result.data(), result.size(), compressed_data, size_compressed),
+            pixels.size());
+  EXPECT_FALSE(BLI_mmap_any_io_error(mmap_file));
+  EXPECT_EQ(result, pixels);
+
+  /* Truncated entries are not decompressed. */
+  EXPECT_EQ(BLI_file_unzstd_from_mem(
+                result.data(), result.size(), compressed_data, size_compressed - 1),
+            0);
+
+  BLI_mmap_free(mmap_file);
+  fclose(file);
+}
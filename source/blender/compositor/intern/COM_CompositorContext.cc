@@ -35,6 +35,7 @@ CompositorContext::CompositorContext()
   this->m_viewSettings = nullptr;
   this->m_displaySettings = nullptr;
   this->m_bnodetree = nullptr;
+  this->result_cache_ = nullptr;
 }
 
 int CompositorContext::getFramenumber() const
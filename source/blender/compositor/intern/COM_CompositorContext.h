@@ -31,6 +31,8 @@
 
 namespace blender::compositor {
 
+class ResultCache;
+
 /**
  * \brief Overall context of the compositor
  */
@@ -91,6 +93,11 @@ class CompositorContext {
    */
   const char *m_viewName;
 
+  /**
+   * Results of previous executions, nullptr when results are not cached.
+   */
+  ResultCache *result_cache_;
+
  public:
   /**
    * \brief constructor initializes the context with default values.
@@ -279,6 +286,22 @@ class CompositorContext {
     return (this->getbNodeTree()->flag & NTREE_COM_GROUPNODE_BUFFER) != 0;
   }
 
+  /**
+   * Whether color results can be stored as half float while waiting to be read.
+   */
+  bool is_half_buffers_enabled() const
+  {
+    return (this->getbNodeTree()->flag & NTREE_COM_HALF_BUFFERS) != 0;
+  }
+
+  /**
+   * Whether outputs are rendered in horizontal bands of chunk size rows.
+   */
+  bool is_streaming_enabled() const
+  {
+    return (this->getbNodeTree()->flag & NTREE_COM_STREAMING) != 0;
+  }
+
   /**
    * \brief Get the render percentage as a factor.
    * The compositor uses a factor i.o. a percentage.
@@ -290,6 +313,16 @@ class CompositorContext {
 
   Size2f get_render_size() const;
 
+  void set_result_cache(ResultCache *result_cache)
+  {
+    result_cache_ = result_cache;
+  }
+
+  ResultCache *get_result_cache() const
+  {
+    return result_cache_;
+  }
+
   /**
    * Get active execution model.
    */
@@ -41,7 +41,8 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
                                  bool fastcalculation,
                                  const ColorManagedViewSettings *viewSettings,
                                  const ColorManagedDisplaySettings *displaySettings,
-                                 const char *viewName)
+                                 const char *viewName,
+                                 ResultCache *result_cache)
 {
   num_work_threads_ = WorkScheduler::get_num_cpu_threads();
   this->m_context.setViewName(viewName);
@@ -63,6 +64,7 @@ ExecutionSystem::ExecutionSystem(RenderData *rd,
   this->m_context.setRenderData(rd);
   this->m_context.setViewSettings(viewSettings);
   this->m_context.setDisplaySettings(displaySettings);
+  this->m_context.set_result_cache(result_cache);
 
   BLI_mutex_init(&work_mutex_);
   BLI_condition_init(&work_finished_cond_);
@@ -119,6 +119,7 @@ namespace blender::compositor {
 
 /* Forward declarations. */
 class ExecutionModel;
+class ResultCache;
 
 /**
  * \brief the ExecutionSystem contains the whole compositor tree.
@@ -166,6 +167,7 @@ class ExecutionSystem {
    *
    * \param editingtree: [bNodeTree *]
    * \param rendering: [true false]
+   * \param result_cache: Results of previous executions to reuse, may be nullptr.
    */
   ExecutionSystem(RenderData *rd,
                   Scene *scene,
@@ -174,7 +176,8 @@ class ExecutionSystem {
                   bool fastcalculation,
                   const ColorManagedViewSettings *viewSettings,
                   const ColorManagedDisplaySettings *displaySettings,
-                  const char *viewName);
+                  const char *viewName,
+                  ResultCache *result_cache);
 
   /**
    * Destructor
@@ -0,0 +1,371 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+
+#include "COM_FFTConvolution.h"
+
+#include "BLI_array.hh"
+#include "BLI_task.hh"
+
+namespace blender::compositor {
+
+/*
+ * 2D Fast Hartley Transform, used for convolution.
+ */
+
+/** Minimum transform size, smaller ones have too much overhead per convolved pixel. */
+constexpr int FHT_MIN_SIZE = 256;
+
+/* Returns next highest power of 2 of x, as well its log2 in L2. */
+static unsigned int nextPow2(unsigned int x, unsigned int *L2)
+{
+  unsigned int pw, x_notpow2 = x & (x - 1);
+  *L2 = 0;
+  while (x >>= 1) {
+    ++(*L2);
+  }
+  pw = 1 << (*L2);
+  if (x_notpow2) {
+    (*L2)++;
+    pw <<= 1;
+  }
+  return pw;
+}
+
+/* From FXT library by Joerg Arndt, faster in order bit-reversal
+ * use: `r = revbin_upd(r, h)` where `h = N>>1`. */
+static unsigned int revbin_upd(unsigned int r, unsigned int h)
+{
+  while (!((r ^= h) & h)) {
+    h >>= 1;
+  }
+  return r;
+}
+
+static void FHT(float *data, unsigned int M, bool inverse)
+{
+  double tt, fc, dc, fs, ds, a = M_PI;
+  float t1, t2;
+  int n2, bd, bl, istep, k, len = 1 << M, n = 1;
+
+  int i, j = 0;
+  unsigned int Nh = len >> 1;
+  for (i = 1; i < (len - 1); i++) {
+    j = revbin_upd(j, Nh);
+    if (j > i) {
+      t1 = data[i];
+      data[i] = data[j];
+      data[j] = t1;
+    }
+  }
+
+  do {
+    float *data_n = &data[n];
+
+    istep = n << 1;
+    for (k = 0; k < len; k += istep) {
+      t1 = data_n[k];
+      data_n[k] = data[k] - t1;
+      data[k] += t1;
+    }
+
+    n2 = n >> 1;
+    if (n > 2) {
+      fc = dc = cos(a);
+      fs = ds = sqrt(1.0 - fc * fc); /* sin(a); */
+      bd = n - 2;
+      for (bl = 1; bl < n2; bl++) {
+        float *data_nbd = &data_n[bd];
+        float *data_bd = &data[bd];
+        for (k = bl; k < len; k += istep) {
+          t1 = fc * (double)data_n[k] + fs * (double)data_nbd[k];
+          t2 = fs * (double)data_n[k] - fc * (double)data_nbd[k];
+          data_n[k] = data[k] - t1;
+          data_nbd[k] = data_bd[k] - t2;
+          data[k] += t1;
+          data_bd[k] += t2;
+        }
+        tt = fc * dc - fs * ds;
+        fs = fs * dc + fc * ds;
+        fc = tt;
+        bd -= 2;
+      }
+    }
+
+    if (n > 1) {
+      for (k = n2; k < len; k += istep) {
+        t1 = data_n[k];
+        data_n[k] = data[k] - t1;
+        data[k] += t1;
+      }
+    }
+
+    n = istep;
+    a *= 0.5;
+  } while (n < len);
+
+  if (inverse) {
+    float sc = 1.0f / (float)len;
+    for (k = 0; k < len; k++) {
+      data[k] *= sc;
+    }
+  }
+}
+
+/**
+ * 2D Fast Hartley Transform of square data, M -> log2 of its size, nzp -> the row where zero pad
+ * data starts. Rows are transformed in parallel. Data is left transposed, transforming it again
+ * transposes it back.
+ */
+static void FHT2D(float *data, unsigned int M, unsigned int nzp, bool inverse)
+{
+  const unsigned int N = 1 << M;
+
+  /* Rows (forward transform skips 0 pad data). */
+  const unsigned int maxy = inverse ? N : nzp;
+  threading::parallel_for(IndexRange(maxy), 16, [&](const IndexRange rows) {
+    for (const int64_t j : rows) {
+      FHT(&data[N * j], M, inverse);
+    }
+  });
+
+  /* Transpose data, every row swaps elements after the diagonal. */
+  threading::parallel_for(IndexRange(N), 16, [&](const IndexRange rows) {
+    for (const int64_t j : rows) {
+      for (unsigned int i = j + 1; i < N; i++) {
+        SWAP(float, data[i + (j << M)], data[j + (i << M)]);
+      }
+    }
+  });
+
+  /* Now columns == transposed rows. */
+  threading::parallel_for(IndexRange(N), 16, [&](const IndexRange rows) {
+    for (const int64_t j : rows) {
+      FHT(&data[N * j], M, inverse);
+    }
+  });
+
+  /* Finalize. */
+  threading::parallel_for(IndexRange((N >> 1) + 1), 16, [&](const IndexRange rows) {
+    for (const int64_t j : rows) {
+      unsigned int jm = (N - j) & (N - 1);
+      unsigned int ji = j << M;
+      unsigned int jmi = jm << M;
+      for (unsigned int i = 0; i <= (N >> 1); i++) {
+        unsigned int im = (N - i) & (N - 1);
+        float A = data[ji + i];
+        float B = data[jmi + i];
+        float C = data[ji + im];
+        float D = data[jmi + im];
+        float E = 0.5f * ((A + D) - (B + C));
+        data[ji + i] = A - E;
+        data[jmi + i] = B + E;
+        data[ji + im] = C + E;
+        data[jmi + im] = D - E;
+      }
+    }
+  });
+}
+
+/* 2D convolution calc of square data, d1 *= d2, M -> log2 of its size. */
+static void fht_convolve(float *d1, const float *d2, unsigned int M)
+{
+  float a, b;
+  unsigned int i, j, k, L, mj, mL;
+  unsigned int m = 1 << M, n = 1 << M;
+  unsigned int m2 = 1 << (M - 1), n2 = 1 << (M - 1);
+  unsigned int mn2 = m << (M - 1);
+
+  d1[0] *= d2[0];
+  d1[mn2] *= d2[mn2];
+  d1[m2] *= d2[m2];
+  d1[m2 + mn2] *= d2[m2 + mn2];
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    a = d1[i] * d2[i] - d1[k] * d2[k];
+    b = d1[k] * d2[i] + d1[i] * d2[k];
+    d1[i] = (b + a) * 0.5f;
+    d1[k] = (b - a) * 0.5f;
+    a = d1[i + mn2] * d2[i + mn2] - d1[k + mn2] * d2[k + mn2];
+    b = d1[k + mn2] * d2[i + mn2] + d1[i + mn2] * d2[k + mn2];
+    d1[i + mn2] = (b + a) * 0.5f;
+    d1[k + mn2] = (b - a) * 0.5f;
+  }
+  for (j = 1; j < n2; j++) {
+    L = n - j;
+    mj = j << M;
+    mL = L << M;
+    a = d1[mj] * d2[mj] - d1[mL] * d2[mL];
+    b = d1[mL] * d2[mj] + d1[mj] * d2[mL];
+    d1[mj] = (b + a) * 0.5f;
+    d1[mL] = (b - a) * 0.5f;
+    a = d1[m2 + mj] * d2[m2 + mj] - d1[m2 + mL] * d2[m2 + mL];
+    b = d1[m2 + mL] * d2[m2 + mj] + d1[m2 + mj] * d2[m2 + mL];
+    d1[m2 + mj] = (b + a) * 0.5f;
+    d1[m2 + mL] = (b - a) * 0.5f;
+  }
+  for (i = 1; i < m2; i++) {
+    k = m - i;
+    for (j = 1; j < n2; j++) {
+      L = n - j;
+      mj = j << M;
+      mL = L << M;
+      a = d1[i + mj] * d2[i + mj] - d1[k + mL] * d2[k + mL];
+      b = d1[k + mL] * d2[i + mj] + d1[i + mj] * d2[k + mL];
+      d1[i + mj] = (b + a) * 0.5f;
+      d1[k + mL] = (b - a) * 0.5f;
+      a = d1[i + mL] * d2[i + mL] - d1[k + mj] * d2[k + mj];
+      b = d1[k + mj] * d2[i + mL] + d1[i + mL] * d2[k + mj];
+      d1[i + mL] = (b + a) * 0.5f;
+      d1[k + mj] = (b - a) * 0.5f;
+    }
+  }
+}
+
+static bool is_kernel_channel_zero(const MemoryBuffer &kernel, const int channel)
+{
+  for (const float *elem : kernel.as_range()) {
+    if (elem[channel] != 0.0f) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * Convolves image with given kernel writing the result into output area:
+ * `output(x, y) = sum(kernel(i, j) * image(x - i + kernel_center_x, y - j + kernel_center_y))`
+ * with kernel coordinates relative to its rect and image being zero outside of its rect.
+ *
+ * Image blocks are transformed with Fast Hartley Transforms and the block results are
+ * overlap-added into the output, so cost per pixel doesn't depend on kernel size. Each output
+ * channel uses the same image and kernel channel, or the first one when they are single channel.
+ */
+void convolve_fft(const MemoryBuffer &image,
+                  const MemoryBuffer &kernel,
+                  const int kernel_center_x,
+                  const int kernel_center_y,
+                  MemoryBuffer &output,
+                  const rcti &area)
+{
+  const int num_channels = output.get_num_channels();
+  BLI_assert(image.get_num_channels() == 1 || image.get_num_channels() == num_channels);
+  BLI_assert(kernel.get_num_channels() == 1 || kernel.get_num_channels() == num_channels);
+  const int kernel_width = kernel.getWidth();
+  const int kernel_height = kernel.getHeight();
+  const rcti &kernel_rect = kernel.get_rect();
+  const rcti &image_rect = image.get_rect();
+
+  output.fill(area, COM_COLOR_TRANSPARENT);
+
+  /* Image area contributing to output area. */
+  rcti input_area;
+  BLI_rcti_init(&input_area,
+                area.xmin - (kernel_width - 1 - kernel_center_x),
+                area.xmax + kernel_center_x,
+                area.ymin - (kernel_height - 1 - kernel_center_y),
+                area.ymax + kernel_center_y);
+  if (!BLI_rcti_isect(&input_area, &image_rect, &input_area)) {
+    return;
+  }
+
+  /* Transform size for blocks of at least kernel size, result of block convolution fits in it. */
+  unsigned int log2_size;
+  const int size = nextPow2(
+      MAX3(2 * kernel_width - 1, 2 * kernel_height - 1, FHT_MIN_SIZE), &log2_size);
+  const int block_width = size + 1 - kernel_width;
+  const int block_height = size + 1 - kernel_height;
+  const int64_t data_len = (int64_t)size * size;
+
+  /* Kernel transforms only need to be calculated once for every block. */
+  const int num_kernels = kernel.get_num_channels();
+  Array<float> kernels_data(data_len * num_kernels, 0.0f);
+  Array<bool> is_kernel_zero(num_kernels);
+  for (const int k : IndexRange(num_kernels)) {
+    is_kernel_zero[k] = is_kernel_channel_zero(kernel, k);
+    if (is_kernel_zero[k]) {
+      continue;
+    }
+    float *kernel_data = &kernels_data[data_len * k];
+    for (int y = 0; y < kernel_height; y++) {
+      for (int x = 0; x < kernel_width; x++) {
+        kernel_data[y * size + x] = kernel.get_elem(kernel_rect.xmin + x,
+                                                    kernel_rect.ymin + y)[k];
+      }
+    }
+    FHT2D(kernel_data, log2_size, kernel_height, false);
+  }
+
+  const int num_image_channels = image.get_num_channels();
+  Array<float> image_data(data_len);
+  Array<float> result_data(data_len);
+  for (int block_y = input_area.ymin; block_y < input_area.ymax; block_y += block_height) {
+    for (int block_x = input_area.xmin; block_x < input_area.xmax; block_x += block_width) {
+      const int block_xmax = MIN2(block_x + block_width, input_area.xmax);
+      const int block_ymax = MIN2(block_y + block_height, input_area.ymax);
+
+      for (const int image_channel : IndexRange(num_image_channels)) {
+        /* Block image channel -> image_data. */
+        image_data.fill(0.0f);
+        for (int y = block_y; y < block_ymax; y++) {
+          const float *elem = image.get_elem(block_x, y) + image_channel;
+          float *row = &image_data[(int64_t)(y - block_y) * size];
+          for (int x = block_x; x < block_xmax; x++, elem += image.elem_stride) {
+            row[x - block_x] = *elem;
+          }
+        }
+        FHT2D(image_data.data(), log2_size, block_ymax - block_y, false);
+
+        for (const int channel : IndexRange(num_channels)) {
+          const int kernel_channel = num_kernels == 1 ? 0 : channel;
+          const bool uses_image_channel = num_image_channels == 1 || image_channel == channel;
+          if (!uses_image_channel || is_kernel_zero[kernel_channel]) {
+            continue;
+          }
+
+          /* FHT2D transposed data, row/col now swapped, convolve & inverse FHT. */
+          result_data.as_mutable_span().copy_from(image_data);
+          fht_convolve(result_data.data(), &kernels_data[data_len * kernel_channel], log2_size);
+          FHT2D(result_data.data(), log2_size, 0, true);
+          /* Data again transposed, so in order again. */
+
+          /* Overlap-add result. */
+          const int offset_x = block_x - kernel_center_x;
+          const int offset_y = block_y - kernel_center_y;
+          const int ymin = MAX2(area.ymin, offset_y);
+          const int ymax = MIN2(area.ymax, offset_y + size);
+          const int xmin = MAX2(area.xmin, offset_x);
+          const int xmax = MIN2(area.xmax, offset_x + size);
+          threading::parallel_for(IndexRange(MAX2(ymax - ymin, 0)), 64, [&](IndexRange rows) {
+            for (const int64_t row : rows) {
+              const int y = ymin + row;
+              const float *result =
+                  &result_data[(int64_t)(y - offset_y) * size + (xmin - offset_x)];
+              float *out = output.get_elem(xmin, y) + channel;
+              for (int x = xmin; x < xmax; x++, out += output.elem_stride) {
+                *out += *result++;
+              }
+            }
+          });
+        }
+      }
+    }
+  }
+}
+
+}  // namespace blender::compositor
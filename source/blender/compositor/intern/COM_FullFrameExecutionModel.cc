@@ -17,26 +17,49 @@
  */
 
 #include "COM_FullFrameExecutionModel.h"
+#include "COM_ConstantOperation.h"
 #include "COM_Debug.h"
 #include "COM_ExecutionGroup.h"
 #include "COM_ReadBufferOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_ViewerOperation.h"
 #include "COM_WorkScheduler.h"
 
+#include "BKE_appdir.h"
+
 #include "BLT_translation.h"
 
+#include "PIL_time.h"
+
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
 #endif
 
 namespace blender::compositor {
 
+/**
+ * Minimum time in seconds an operation must take to render for its result to be cached. Results
+ * of faster operations are cheaper to render again than to keep in memory.
+ */
+constexpr double RESULT_CACHE_MIN_RENDER_TIME = 0.05;
+
+/**
+ * Memory in bytes that results kept between bands can use when streaming. Bigger results are
+ * stored in temporary files.
+ */
+constexpr size_t STREAMED_RESULTS_MEM_LIMIT = 256 * 1024 * 1024;
+
 FullFrameExecutionModel::FullFrameExecutionModel(CompositorContext &context,
                                                  SharedOperationBuffers &shared_buffers,
                                                  Span<NodeOperation *> operations)
     : ExecutionModel(context, operations),
       active_buffers_(shared_buffers),
-      num_operations_finished_(0)
+      num_operations_finished_(0),
+      result_cache_(context.get_result_cache()),
+      predicted_peak_mem_(0),
+      peak_mem_(0),
+      num_bands_(0),
+      num_bands_finished_(0)
 {
   priorities_.append(eCompositorPriority::High);
   if (!context.isFastCalculation()) {
@@ -52,8 +75,276 @@ void FullFrameExecutionModel::execute(ExecutionSystem &exec_system)
 
   DebugInfo::graphviz(&exec_system, "compositor_prior_rendering");
 
-  determine_areas_to_render_and_reads();
-  render_operations();
+  determine_cached_results();
+  determine_full_precision_results();
+  if (context_.is_streaming_enabled()) {
+    execute_streaming();
+  }
+  else {
+    determine_areas_to_render_and_reads();
+    determine_render_order();
+    predict_peak_mem();
+    render_operations();
+  }
+  report_peak_mem();
+}
+
+/**
+ * Renders outputs in horizontal bands of chunk size rows, so that operations buffers only hold
+ * the rows a band needs instead of whole frames. Results of operations depending on whole frames
+ * are rendered once and kept for next bands, in temporary files when they don't fit in memory.
+ */
+void FullFrameExecutionModel::execute_streaming()
+{
+  streamed_results_ = std::make_unique<StreamedResults>(BKE_tempdir_session(),
+                                                        STREAMED_RESULTS_MEM_LIMIT);
+  determine_full_frame_operations();
+
+  const bool is_rendering = context_.isRendering();
+  const bNodeTree *node_tree = context_.getbNodeTree();
+  const int band_height = MAX2(context_.getChunksize(), 1);
+  Vector<NodeOperation *> output_ops;
+  Vector<std::pair<NodeOperation *, rcti>> bands;
+  for (eCompositorPriority priority : priorities_) {
+    for (NodeOperation *op : operations_) {
+      op->setbNodeTree(node_tree);
+      const bool has_size = op->getWidth() > 0 && op->getHeight() > 0;
+      if (!op->isOutputOperation(is_rendering) || op->getRenderPriority() != priority ||
+          !has_size) {
+        continue;
+      }
+      rcti area;
+      get_output_render_area(op, area);
+      output_ops.append(op);
+      for (int y = area.ymin; y < area.ymax; y += band_height) {
+        rcti band = area;
+        band.ymin = y;
+        band.ymax = MIN2(y + band_height, area.ymax);
+        bands.append({op, band});
+      }
+    }
+  }
+  num_bands_ = bands.size();
+
+  WorkScheduler::start(this->context_);
+  /* Outputs write their result once all bands are rendered, so that each band only writes its
+   * rows into the same result. */
+  for (NodeOperation *op : output_ops) {
+    op->begin_partial_renders();
+  }
+  for (const std::pair<NodeOperation *, rcti> &band : bands) {
+    render_band(band.first, band.second);
+    num_bands_finished_++;
+  }
+  for (NodeOperation *op : output_ops) {
+    op->end_partial_renders();
+  }
+  clear_viewers_without_size();
+  WorkScheduler::stop();
+
+  active_buffers_.clear();
+  streamed_results_ = nullptr;
+}
+
+/**
+ * Find operations which output can't be rendered in bands because a single row of it reads all
+ * rows of an input (e.g. glare, normalize or inpaint). Inputs smaller than the operation, like
+ * bokeh images, don't make it depend on the whole frame.
+ */
+void FullFrameExecutionModel::determine_full_frame_operations()
+{
+  for (NodeOperation *op : operations_) {
+    if (op->getNumberOfOutputSockets() == 0 || op->get_flags().is_constant_operation ||
+        cached_results_.contains(op)) {
+      continue;
+    }
+
+    const rcti &canvas = op->get_canvas();
+    rcti first_row = canvas;
+    first_row.ymax = MIN2(canvas.ymin + 1, canvas.ymax);
+    rcti last_row = canvas;
+    last_row.ymin = MAX2(canvas.ymax - 1, canvas.ymin);
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      const rcti &input_canvas = input_op->get_canvas();
+      if (BLI_rcti_size_y(&input_canvas) < BLI_rcti_size_y(&canvas) ||
+          BLI_rcti_size_y(&input_canvas) <= 1) {
+        continue;
+      }
+
+      rcti first_row_input;
+      rcti last_row_input;
+      op->get_area_of_interest(input_op, first_row, first_row_input);
+      op->get_area_of_interest(input_op, last_row, last_row_input);
+      if (first_row_input.ymax >= input_canvas.ymax && last_row_input.ymin <= input_canvas.ymin) {
+        full_frame_ops_.add(op);
+        break;
+      }
+    }
+  }
+}
+
+/**
+ * Renders a band of an output operation. Results of full frame operations rendered for the band
+ * are moved to #streamed_results_.
+ */
+void FullFrameExecutionModel::render_band(NodeOperation *output_op, const rcti &band)
+{
+  active_buffers_.clear();
+  render_order_.clear();
+  num_operations_finished_ = 0;
+  determine_areas_to_render(output_op, band);
+  determine_reads(output_op);
+
+  /* An extra read keeps full frame results alive once the band is rendered. */
+  Vector<NodeOperation *> new_full_frame_ops;
+  for (NodeOperation *op : full_frame_ops_) {
+    if (active_buffers_.has_registered_reads(op) && !streamed_results_->contains(op->get_id())) {
+      active_buffers_.register_read(op);
+      new_full_frame_ops.append(op);
+    }
+  }
+
+  render_order_.append(output_op, [this](NodeOperation *op) { return is_result_available(op); });
+  predict_peak_mem();
+  for (NodeOperation *op : render_order_.get_operations()) {
+    render_operation(op);
+  }
+
+  for (NodeOperation *op : new_full_frame_ops) {
+    streamed_results_->add_result(op->get_id(), active_buffers_.take_rendered_buffer(op));
+  }
+}
+
+/**
+ * Whether operation result is taken from the results cache or from a previous band, without
+ * rendering its dependencies.
+ */
+bool FullFrameExecutionModel::is_result_available(NodeOperation *op)
+{
+  return cached_results_.contains(op) ||
+         (streamed_results_ && streamed_results_->contains(op->get_id()));
+}
+
+/**
+ * Hash identifying given operation result across executions, or none when any operation it
+ * depends on doesn't implement #NodeOperation::hash_output_params.
+ */
+static std::optional<size_t> get_result_hash(
+    NodeOperation *op, Map<NodeOperation *, std::optional<size_t>> &r_hashes)
+{
+  if (const std::optional<size_t> *hash = r_hashes.lookup_ptr(op)) {
+    return *hash;
+  }
+
+  std::optional<size_t> result_hash;
+  if (op->get_flags().is_constant_operation) {
+    const float *elem = static_cast<ConstantOperation *>(op)->get_constant_elem();
+    const int num_channels = COM_data_type_num_channels(op->getOutputSocket()->getDataType());
+    size_t hash = get_default_hash(num_channels);
+    for (const int i : IndexRange(num_channels)) {
+      hash = get_default_hash_2(hash, elem[i]);
+    }
+    result_hash = hash;
+  }
+  else if (std::optional<NodeOperationHash> op_hash = op->generate_hash(true)) {
+    size_t hash = get_default_hash_2(op_hash->get_type_hash(), op_hash->get_params_hash());
+    bool are_inputs_hashed = true;
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      const std::optional<size_t> input_hash = input_op ? get_result_hash(input_op, r_hashes) :
+                                                          std::nullopt;
+      if (!input_hash) {
+        are_inputs_hashed = false;
+        break;
+      }
+      hash = get_default_hash_2(hash, *input_hash);
+    }
+    if (are_inputs_hashed) {
+      result_hash = hash;
+    }
+  }
+
+  r_hashes.add_new(op, result_hash);
+  return result_hash;
+}
+
+/**
+ * Find operations results that can be taken from the cache. Their dependencies don't need to be
+ * rendered.
+ */
+void FullFrameExecutionModel::determine_cached_results()
+{
+  if (result_cache_ == nullptr) {
+    return;
+  }
+  result_cache_->begin_execution();
+
+  const bool is_rendering = context_.isRendering();
+  Map<NodeOperation *, std::optional<size_t>> hashes;
+  for (NodeOperation *op : operations_) {
+    const bool can_be_cached = op->getNumberOfOutputSockets() > 0 &&
+                               !op->get_flags().is_constant_operation &&
+                               !op->isOutputOperation(is_rendering);
+    if (!can_be_cached) {
+      continue;
+    }
+
+    const std::optional<size_t> result_hash = get_result_hash(op, hashes);
+    if (!result_hash) {
+      continue;
+    }
+    const std::optional<NodeOperationHash> op_hash = op->generate_hash(true);
+    BLI_assert(op_hash);
+    ResultCache::ResultKey key;
+    key.result_hash = *result_hash;
+    key.type_hash = op_hash->get_type_hash();
+    key.params_hash = op_hash->get_params_hash();
+    key.canvas = op->get_canvas();
+    result_keys_.add_new(op, key);
+
+    MemoryBuffer *cached_buf = result_cache_->get_result(key);
+    if (cached_buf && cached_buf->getWidth() == op->getWidth() &&
+        cached_buf->getHeight() == op->getHeight() &&
+        cached_buf->get_num_channels() ==
+            COM_data_type_num_channels(op->getOutputSocket()->getDataType())) {
+      cached_results_.add_new(op, cached_buf);
+    }
+  }
+}
+
+/**
+ * Find operations results that must not be stored as half float, because the operation or any
+ * of its readers needs full float precision.
+ */
+void FullFrameExecutionModel::determine_full_precision_results()
+{
+  if (!context_.is_half_buffers_enabled()) {
+    return;
+  }
+
+  for (NodeOperation *op : operations_) {
+    if (!op->get_flags().use_full_precision) {
+      continue;
+    }
+    full_precision_results_.add(op);
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      full_precision_results_.add(op->get_input_operation(i));
+    }
+  }
+}
+
+/**
+ * Whether an operation result can be stored as half float until all its readers are finished.
+ * Only color data is converted, values and vectors are usually non-color data needing precision.
+ */
+bool FullFrameExecutionModel::use_half_float_result(NodeOperation *op)
+{
+  return context_.is_half_buffers_enabled() && op->getNumberOfOutputSockets() > 0 &&
+         op->getOutputSocket()->getDataType() == DataType::Color &&
+         !op->get_flags().is_constant_operation && !cached_results_.contains(op) &&
+         !full_precision_results_.contains(op) && !full_frame_ops_.contains(op) &&
+         active_buffers_.has_registered_reads(op);
 }
 
 void FullFrameExecutionModel::determine_areas_to_render_and_reads()
@@ -92,21 +383,57 @@ Vector<MemoryBuffer *> FullFrameExecutionModel::get_input_buffers(NodeOperation
 
     rcti rect = buf->get_rect();
     BLI_rcti_translate(&rect, offset_x, offset_y);
+    if (buf->is_half_float()) {
+      /* Operations read full float buffers, convert them for the time the operation renders. */
+      inputs_buffers[i] = new MemoryBuffer(
+          COM_num_channels_data_type(buf->get_num_channels()), rect);
+      inputs_buffers[i]->copy_from(buf, buf->get_rect(), rect.xmin, rect.ymin);
+      continue;
+    }
     inputs_buffers[i] = new MemoryBuffer(
         buf->getBuffer(), buf->get_num_channels(), rect, buf->is_a_single_elem());
   }
   return inputs_buffers;
 }
 
+/**
+ * Bounds of the areas to render of an operation, relative to given output coordinates.
+ */
+rcti FullFrameExecutionModel::get_areas_to_render_bounds(NodeOperation *op,
+                                                         const int output_x,
+                                                         const int output_y)
+{
+  rcti bounds;
+  BLI_rcti_init(&bounds, output_x, output_x, output_y, output_y);
+  const int offset_x = output_x - op->get_canvas().xmin;
+  const int offset_y = output_y - op->get_canvas().ymin;
+  for (const rcti &area : active_buffers_.get_areas_to_render(op, offset_x, offset_y)) {
+    if (BLI_rcti_is_empty(&bounds)) {
+      bounds = area;
+    }
+    else {
+      BLI_rcti_union(&bounds, &area);
+    }
+  }
+  return bounds;
+}
+
 MemoryBuffer *FullFrameExecutionModel::create_operation_buffer(NodeOperation *op,
                                                                const int output_x,
                                                                const int output_y)
 {
+  const bool is_a_single_elem = op->get_flags().is_constant_operation;
   rcti rect;
-  BLI_rcti_init(&rect, output_x, output_x + op->getWidth(), output_y, output_y + op->getHeight());
+  if (streamed_results_ && !is_a_single_elem) {
+    /* When streaming, buffers only cover areas to render. */
+    rect = get_areas_to_render_bounds(op, output_x, output_y);
+  }
+  else {
+    BLI_rcti_init(
+        &rect, output_x, output_x + op->getWidth(), output_y, output_y + op->getHeight());
+  }
 
   const DataType data_type = op->getOutputSocket(0)->getDataType();
-  const bool is_a_single_elem = op->get_flags().is_constant_operation;
   return new MemoryBuffer(data_type, rect, is_a_single_elem);
 }
 
@@ -116,15 +443,43 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
   constexpr int output_x = 0;
   constexpr int output_y = 0;
 
+  if (MemoryBuffer *cached_buf = cached_results_.lookup_default(op, nullptr)) {
+    render_operation_from_cache(op, cached_buf);
+    return;
+  }
+  if (streamed_results_ && streamed_results_->contains(op->get_id())) {
+    /* Only the rows read by current band are needed. */
+    const rcti bounds = get_areas_to_render_bounds(op, output_x, output_y);
+    active_buffers_.set_rendered_buffer(
+        op, streamed_results_->get_result(op->get_id(), bounds.ymin, bounds.ymax));
+    operation_finished(op);
+    return;
+  }
+
   const bool has_outputs = op->getNumberOfOutputSockets() > 0;
   MemoryBuffer *op_buf = has_outputs ? create_operation_buffer(op, output_x, output_y) : nullptr;
   if (op->getWidth() > 0 && op->getHeight() > 0) {
     Vector<MemoryBuffer *> input_bufs = get_input_buffers(op, output_x, output_y);
+    size_t render_mem = active_buffers_.get_mem_used() + (op_buf ? op_buf->get_mem_size() : 0);
+    for (const int i : input_bufs.index_range()) {
+      /* Half float inputs are converted to temporary full float buffers. */
+      if (active_buffers_.get_rendered_buffer(op->get_input_operation(i))->is_half_float()) {
+        render_mem += input_bufs[i]->get_mem_size();
+      }
+    }
+    peak_mem_ = MAX2(peak_mem_, render_mem);
     const int op_offset_x = output_x - op->get_canvas().xmin;
     const int op_offset_y = output_y - op->get_canvas().ymin;
     Span<rcti> areas = active_buffers_.get_areas_to_render(op, op_offset_x, op_offset_y);
+    const double start_time = PIL_check_seconds_timer();
     op->render(op_buf, areas, input_bufs);
+    if (op_buf) {
+      cache_result(op, *op_buf, PIL_check_seconds_timer() - start_time);
+    }
     DebugInfo::operation_rendered(op, op_buf);
+    if (op_buf && use_half_float_result(op)) {
+      op_buf->convert_to_half_float();
+    }
 
     for (MemoryBuffer *buf : input_bufs) {
       delete buf;
@@ -138,68 +493,145 @@ void FullFrameExecutionModel::render_operation(NodeOperation *op)
 }
 
 /**
- * Render output operations in order of priority.
+ * Sets a cached result as operation rendered buffer. The cache keeps the buffer data during the
+ * whole execution.
  */
-void FullFrameExecutionModel::render_operations()
+void FullFrameExecutionModel::render_operation_from_cache(NodeOperation *op,
+                                                          MemoryBuffer *cached_buf)
 {
-  const bool is_rendering = context_.isRendering();
+  std::unique_ptr<MemoryBuffer> op_buf = std::make_unique<MemoryBuffer>(
+      cached_buf->getBuffer(),
+      cached_buf->get_num_channels(),
+      cached_buf->get_rect(),
+      cached_buf->is_a_single_elem());
+  active_buffers_.set_rendered_buffer(op, std::move(op_buf));
+  operation_finished(op);
+}
 
-  WorkScheduler::start(this->context_);
+/**
+ * Keeps operation result for next executions when it is expensive to render and the whole
+ * operation canvas has been rendered.
+ */
+void FullFrameExecutionModel::cache_result(NodeOperation *op,
+                                           const MemoryBuffer &buffer,
+                                           const double render_time)
+{
+  const ResultCache::ResultKey *result_key = result_keys_.lookup_ptr(op);
+  if (result_key == nullptr || render_time < RESULT_CACHE_MIN_RENDER_TIME ||
+      !active_buffers_.is_area_registered(op, op->get_canvas())) {
+    return;
+  }
+  result_cache_->add_result(*result_key, buffer);
+}
+
+/**
+ * Determines order to render output operations and their dependencies. Outputs are rendered in
+ * order of priority and their dependencies are ordered to reduce the number of results alive at
+ * the same time, instead of rendering all inputs of the tree first.
+ */
+void FullFrameExecutionModel::determine_render_order()
+{
+  const bool is_rendering = context_.isRendering();
+  auto is_result_available_fn = [this](NodeOperation *op) { return is_result_available(op); };
   for (eCompositorPriority priority : priorities_) {
     for (NodeOperation *op : operations_) {
       const bool has_size = op->getWidth() > 0 && op->getHeight() > 0;
-      const bool is_priority_output = op->isOutputOperation(is_rendering) &&
-                                      op->getRenderPriority() == priority;
-      if (is_priority_output && has_size) {
-        render_output_dependencies(op);
-        render_operation(op);
-      }
-      else if (is_priority_output && !has_size && op->isActiveViewerOutput()) {
-        static_cast<ViewerOperation *>(op)->clear_display_buffer();
+      if (op->isOutputOperation(is_rendering) && op->getRenderPriority() == priority &&
+          has_size) {
+        render_order_.append(op, is_result_available_fn);
       }
     }
   }
-  WorkScheduler::stop();
 }
 
 /**
- * Returns all dependencies from inputs to outputs. A dependency may be repeated when
- * several operations depend on it.
+ * Simulates rendering in #render_order_ to predict peak memory used by operations buffers.
  */
-static Vector<NodeOperation *> get_operation_dependencies(NodeOperation *operation)
+void FullFrameExecutionModel::predict_peak_mem()
 {
-  /* Get dependencies from outputs to inputs. */
-  Vector<NodeOperation *> dependencies;
-  Vector<NodeOperation *> next_outputs;
-  next_outputs.append(operation);
-  while (next_outputs.size() > 0) {
-    Vector<NodeOperation *> outputs(next_outputs);
-    next_outputs.clear();
-    for (NodeOperation *output : outputs) {
-      for (int i = 0; i < output->getNumberOfInputSockets(); i++) {
-        next_outputs.append(output->get_input_operation(i));
-      }
+  Map<NodeOperation *, int> reads_left;
+  for (NodeOperation *op : render_order_.get_operations()) {
+    if (is_result_available(op)) {
+      continue;
+    }
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      reads_left.lookup_or_add(op->get_input_operation(i), 0)++;
     }
-    dependencies.extend(next_outputs);
   }
 
-  /* Reverse to get dependencies from inputs to outputs. */
-  std::reverse(dependencies.begin(), dependencies.end());
+  auto get_stored_mem_size = [&](NodeOperation *op) {
+    const size_t mem_size = RenderOrder::get_result_mem_size(op);
+    return use_half_float_result(op) ? mem_size / 2 : mem_size;
+  };
+
+  size_t mem = 0;
+  for (NodeOperation *op : render_order_.get_operations()) {
+    if (is_result_available(op)) {
+      mem += get_stored_mem_size(op);
+      continue;
+    }
+
+    size_t render_mem = mem + RenderOrder::get_result_mem_size(op);
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      if (use_half_float_result(input_op)) {
+        render_mem += RenderOrder::get_result_mem_size(input_op);
+      }
+    }
+    predicted_peak_mem_ = MAX2(predicted_peak_mem_, render_mem);
+
+    mem += get_stored_mem_size(op);
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      if (--reads_left.lookup(input_op) == 0) {
+        mem -= get_stored_mem_size(input_op);
+      }
+    }
+  }
+}
 
-  return dependencies;
+/**
+ * Render operations in #render_order_.
+ */
+void FullFrameExecutionModel::render_operations()
+{
+  WorkScheduler::start(this->context_);
+  for (NodeOperation *op : render_order_.get_operations()) {
+    render_operation(op);
+  }
+  clear_viewers_without_size();
+  WorkScheduler::stop();
 }
 
-void FullFrameExecutionModel::render_output_dependencies(NodeOperation *output_op)
+void FullFrameExecutionModel::clear_viewers_without_size()
 {
-  BLI_assert(output_op->isOutputOperation(context_.isRendering()));
-  Vector<NodeOperation *> dependencies = get_operation_dependencies(output_op);
-  for (NodeOperation *op : dependencies) {
-    if (!active_buffers_.is_operation_rendered(op)) {
-      render_operation(op);
+  const bool is_rendering = context_.isRendering();
+  for (NodeOperation *op : operations_) {
+    const bool has_size = op->getWidth() > 0 && op->getHeight() > 0;
+    if (op->isOutputOperation(is_rendering) && !has_size && op->isActiveViewerOutput()) {
+      static_cast<ViewerOperation *>(op)->clear_display_buffer();
     }
   }
 }
 
+void FullFrameExecutionModel::report_peak_mem()
+{
+  const bNodeTree *tree = context_.getbNodeTree();
+  if (tree) {
+    char peak_str[15], predicted_peak_str[15];
+    BLI_str_format_byte_unit(peak_str, peak_mem_, false);
+    BLI_str_format_byte_unit(predicted_peak_str, predicted_peak_mem_, false);
+
+    char buf[128];
+    BLI_snprintf(buf,
+                 sizeof(buf),
+                 TIP_("Compositing | Peak memory %s (predicted %s)"),
+                 peak_str,
+                 predicted_peak_str);
+    tree->stats_draw(tree->sdh, buf);
+  }
+}
+
 /**
  * Determines all operations areas needed to render given output area.
  */
@@ -213,13 +645,22 @@ void FullFrameExecutionModel::determine_areas_to_render(NodeOperation *output_op
   while (stack.size() > 0) {
     std::pair<NodeOperation *, rcti> pair = stack.pop_last();
     NodeOperation *operation = pair.first;
-    const rcti &render_area = pair.second;
-    if (BLI_rcti_is_empty(&render_area) ||
-        active_buffers_.is_area_registered(operation, render_area)) {
+    if (BLI_rcti_is_empty(&pair.second)) {
+      continue;
+    }
+    /* When streaming, operations depending on whole frames are rendered entirely. Once
+     * streamed, only the area read by the band is taken from their result. */
+    const bool is_full_frame = streamed_results_ && full_frame_ops_.contains(operation) &&
+                               !streamed_results_->contains(operation->get_id());
+    const rcti &render_area = is_full_frame ? operation->get_canvas() : pair.second;
+    if (active_buffers_.is_area_registered(operation, render_area)) {
       continue;
     }
 
     active_buffers_.register_area(operation, render_area);
+    if (is_result_available(operation)) {
+      continue;
+    }
 
     const int num_inputs = operation->getNumberOfInputSockets();
     for (int i = 0; i < num_inputs; i++) {
@@ -247,6 +688,9 @@ void FullFrameExecutionModel::determine_reads(NodeOperation *output_op)
   stack.append(output_op);
   while (stack.size() > 0) {
     NodeOperation *operation = stack.pop_last();
+    if (is_result_available(operation)) {
+      continue;
+    }
     const int num_inputs = operation->getNumberOfInputSockets();
     for (int i = 0; i < num_inputs; i++) {
       NodeOperation *input_op = operation->get_input_operation(i);
@@ -290,10 +734,12 @@ void FullFrameExecutionModel::get_output_render_area(NodeOperation *output_op, r
 
 void FullFrameExecutionModel::operation_finished(NodeOperation *operation)
 {
-  /* Report inputs reads so that buffers may be freed/reused. */
-  const int num_inputs = operation->getNumberOfInputSockets();
-  for (int i = 0; i < num_inputs; i++) {
-    active_buffers_.read_finished(operation->get_input_operation(i));
+  /* Report inputs reads so that buffers may be freed/reused. Available results read no inputs. */
+  if (!is_result_available(operation)) {
+    const int num_inputs = operation->getNumberOfInputSockets();
+    for (int i = 0; i < num_inputs; i++) {
+      active_buffers_.read_finished(operation->get_input_operation(i));
+    }
   }
 
   num_operations_finished_++;
@@ -304,15 +750,26 @@ void FullFrameExecutionModel::update_progress_bar()
 {
   const bNodeTree *tree = context_.getbNodeTree();
   if (tree) {
-    const float progress = num_operations_finished_ / static_cast<float>(operations_.size());
-    tree->progress(tree->prh, progress);
-
     char buf[128];
-    BLI_snprintf(buf,
-                 sizeof(buf),
-                 TIP_("Compositing | Operation %i-%li"),
-                 num_operations_finished_ + 1,
-                 operations_.size());
+    if (streamed_results_) {
+      const float band_progress = num_operations_finished_ /
+                                  static_cast<float>(MAX2(render_order_.size(), 1));
+      tree->progress(tree->prh, (num_bands_finished_ + band_progress) / num_bands_);
+      BLI_snprintf(buf,
+                   sizeof(buf),
+                   TIP_("Compositing | Band %i-%i"),
+                   num_bands_finished_ + 1,
+                   num_bands_);
+    }
+    else {
+      const float progress = num_operations_finished_ / static_cast<float>(operations_.size());
+      tree->progress(tree->prh, progress);
+      BLI_snprintf(buf,
+                   sizeof(buf),
+                   TIP_("Compositing | Operation %i-%li"),
+                   num_operations_finished_ + 1,
+                   operations_.size());
+    }
     tree->stats_draw(tree->sdh, buf);
   }
 }
@@ -19,6 +19,11 @@
 #pragma once
 
 #include "COM_ExecutionModel.h"
+#include "COM_RenderOrder.h"
+#include "COM_ResultCache.h"
+#include "COM_StreamedResults.h"
+
+#include "BLI_set.hh"
 
 #ifdef WITH_CXX_GUARDEDALLOC
 #  include "MEM_guardedalloc.h"
@@ -50,6 +55,56 @@ class FullFrameExecutionModel : public ExecutionModel {
    */
   Vector<eCompositorPriority> priorities_;
 
+  /**
+   * Results of previous executions, nullptr when results are not cached.
+   */
+  ResultCache *result_cache_;
+
+  /**
+   * Keys identifying results of operations that can be cached.
+   */
+  Map<NodeOperation *, ResultCache::ResultKey> result_keys_;
+
+  /**
+   * Operations which result is reused from a previous execution instead of being rendered.
+   */
+  Map<NodeOperation *, MemoryBuffer *> cached_results_;
+
+  /**
+   * Operations which result must be kept in full float precision when half float buffers are
+   * enabled.
+   */
+  Set<NodeOperation *> full_precision_results_;
+
+  /**
+   * Order in which operations are rendered.
+   */
+  RenderOrder render_order_;
+
+  /**
+   * Peak memory used by operations buffers during execution, predicted from render order and
+   * measured while rendering.
+   */
+  size_t predicted_peak_mem_;
+  size_t peak_mem_;
+
+  /**
+   * Operations which output depends on the whole frame of an input. When streaming they are
+   * rendered entirely in the first band that needs them.
+   */
+  Set<NodeOperation *> full_frame_ops_;
+
+  /**
+   * Results of #full_frame_ops_ kept between bands when streaming, nullptr otherwise.
+   */
+  std::unique_ptr<StreamedResults> streamed_results_;
+
+  /**
+   * Number of output bands to render and rendered when streaming.
+   */
+  int num_bands_;
+  int num_bands_finished_;
+
  public:
   FullFrameExecutionModel(CompositorContext &context,
                           SharedOperationBuffers &shared_buffers,
@@ -58,14 +113,27 @@ class FullFrameExecutionModel : public ExecutionModel {
   void execute(ExecutionSystem &exec_system) override;
 
  private:
+  void determine_cached_results();
+  void determine_full_precision_results();
+  bool use_half_float_result(NodeOperation *op);
   void determine_areas_to_render_and_reads();
+  void determine_render_order();
+  void predict_peak_mem();
   void render_operations();
-  void render_output_dependencies(NodeOperation *output_op);
+  void report_peak_mem();
+  void clear_viewers_without_size();
+  void execute_streaming();
+  void determine_full_frame_operations();
+  void render_band(NodeOperation *output_op, const rcti &band);
+  bool is_result_available(NodeOperation *op);
   Vector<MemoryBuffer *> get_input_buffers(NodeOperation *op,
                                            const int output_x,
                                            const int output_y);
+  rcti get_areas_to_render_bounds(NodeOperation *op, int output_x, int output_y);
   MemoryBuffer *create_operation_buffer(NodeOperation *op, const int output_x, const int output_y);
   void render_operation(NodeOperation *op);
+  void render_operation_from_cache(NodeOperation *op, MemoryBuffer *cached_buf);
+  void cache_result(NodeOperation *op, const MemoryBuffer &buffer, double render_time);
 
   void operation_finished(NodeOperation *operation);
 
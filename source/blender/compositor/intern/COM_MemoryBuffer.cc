@@ -18,6 +18,8 @@
 
 #include "COM_MemoryBuffer.h"
 
+#include "BLI_task.hh"
+
 #include "IMB_colormanagement.h"
 #include "IMB_imbuf_types.h"
 #include "MEM_guardedalloc.h"
@@ -43,6 +45,68 @@ static rcti create_rect(const int width, const int height)
   return rect;
 }
 
+/* IEEE 754 binary16 conversion, rounding to nearest even. */
+static uint16_t float_to_half(const float f)
+{
+  uint32_t x;
+  memcpy(&x, &f, sizeof(x));
+  const uint16_t sign = (x >> 16) & 0x8000;
+  x &= 0x7fffffff;
+
+  /* Infinity and NaN. */
+  if (x >= 0x7f800000) {
+    return sign | 0x7c00 | (x > 0x7f800000 ? 0x200 : 0);
+  }
+  /* Overflow, rounds to infinity. */
+  if (x >= 0x477ff000) {
+    return sign | 0x7c00;
+  }
+  /* Denormal or zero. */
+  if (x < 0x38800000) {
+    if (x < 0x33000000) {
+      return sign;
+    }
+    const uint32_t shift = 126 - (x >> 23);
+    const uint32_t mantissa = (x & 0x7fffff) | 0x800000;
+    uint32_t result = mantissa >> shift;
+    const uint32_t remainder = mantissa & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (result & 1))) {
+      result++;
+    }
+    return sign | result;
+  }
+  /* Normal, rebias exponent. */
+  uint32_t result = (x - 0x38000000) >> 13;
+  const uint32_t remainder = x & 0x1fff;
+  if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1))) {
+    result++;
+  }
+  return sign | result;
+}
+
+static float half_to_float(const uint16_t h)
+{
+  const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+  const uint32_t exponent = (h >> 10) & 0x1f;
+  const uint32_t mantissa = h & 0x3ff;
+  uint32_t x;
+  if (exponent == 0) {
+    /* Zero or denormal. */
+    const float f = mantissa * (1.0f / 16777216.0f);
+    return sign ? -f : f;
+  }
+  if (exponent == 31) {
+    x = sign | 0x7f800000 | (mantissa << 13);
+  }
+  else {
+    x = sign | ((exponent + 112) << 23) | (mantissa << 13);
+  }
+  float f;
+  memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
 MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, const rcti &rect, MemoryBufferState state)
 {
   m_rect = rect;
@@ -51,6 +115,7 @@ MemoryBuffer::MemoryBuffer(MemoryProxy *memoryProxy, const rcti &rect, MemoryBuf
   this->m_num_channels = COM_data_type_num_channels(memoryProxy->getDataType());
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   this->m_state = state;
   this->m_datatype = memoryProxy->getDataType();
@@ -66,6 +131,7 @@ MemoryBuffer::MemoryBuffer(DataType dataType, const rcti &rect, bool is_a_single
   this->m_num_channels = COM_data_type_num_channels(dataType);
   this->m_buffer = (float *)MEM_mallocN_aligned(
       sizeof(float) * buffer_len() * this->m_num_channels, 16, "COM_MemoryBuffer");
+  half_buffer_ = nullptr;
   owns_data_ = true;
   this->m_state = MemoryBufferState::Temporary;
   this->m_datatype = dataType;
@@ -98,6 +164,7 @@ MemoryBuffer::MemoryBuffer(float *buffer,
   m_num_channels = num_channels;
   m_datatype = COM_num_channels_data_type(num_channels);
   m_buffer = buffer;
+  half_buffer_ = nullptr;
   owns_data_ = false;
   m_state = MemoryBufferState::Temporary;
 
@@ -126,6 +193,12 @@ void MemoryBuffer::set_strides()
   to_positive_y_stride_ = m_rect.ymin < 0 ? -m_rect.ymin + 1 : (m_rect.ymin == 0 ? 1 : 0);
 }
 
+void MemoryBuffer::move_to(const int xmin, const int ymin)
+{
+  BLI_rcti_translate(&m_rect, xmin - m_rect.xmin, ymin - m_rect.ymin);
+  set_strides();
+}
+
 void MemoryBuffer::clear()
 {
   memset(m_buffer, 0, buffer_len() * m_num_channels * sizeof(float));
@@ -192,12 +265,44 @@ float MemoryBuffer::get_max_value(const rcti &rect) const
   return 0.0f;
 }
 
+void MemoryBuffer::convert_to_half_float()
+{
+  BLI_assert(owns_data_ && !m_is_a_single_elem && !is_half_float());
+  const int64_t row_len = (int64_t)getWidth() * m_num_channels;
+  half_buffer_ = (uint16_t *)MEM_mallocN_aligned(
+      sizeof(uint16_t) * buffer_len() * m_num_channels, 16, "COM_MemoryBuffer half");
+  threading::parallel_for(IndexRange(getHeight()), 64, [&](const IndexRange rows) {
+    for (const int64_t y : rows) {
+      const float *from = m_buffer + y * row_len;
+      uint16_t *to = half_buffer_ + y * row_len;
+      for (int64_t i = 0; i < row_len; i++) {
+        to[i] = float_to_half(from[i]);
+      }
+    }
+  });
+  MEM_freeN(m_buffer);
+  m_buffer = nullptr;
+}
+
+void MemoryBuffer::read_half_elem(const int x, const int y, float *out) const
+{
+  BLI_assert(has_coords(x, y));
+  const uint16_t *elem = half_buffer_ + get_coords_offset(x, y);
+  for (int i = 0; i < m_num_channels; i++) {
+    out[i] = half_to_float(elem[i]);
+  }
+}
+
 MemoryBuffer::~MemoryBuffer()
 {
   if (this->m_buffer && owns_data_) {
     MEM_freeN(this->m_buffer);
     this->m_buffer = nullptr;
   }
+  if (half_buffer_) {
+    MEM_freeN(half_buffer_);
+    half_buffer_ = nullptr;
+  }
 }
 
 void MemoryBuffer::copy_from(const MemoryBuffer *src, const rcti &area)
@@ -231,7 +336,10 @@ void MemoryBuffer::copy_from(const MemoryBuffer *src,
                              const int to_y,
                              const int to_channel_offset)
 {
-  if (this->is_a_single_elem()) {
+  if (src->is_half_float()) {
+    copy_half_elems_from(src, area, channel_offset, elem_size, to_x, to_y, to_channel_offset);
+  }
+  else if (this->is_a_single_elem()) {
     copy_single_elem_from(src, channel_offset, elem_size, to_channel_offset);
   }
   else if (!src->is_a_single_elem() && elem_size == src->get_num_channels() &&
@@ -563,4 +671,38 @@ void MemoryBuffer::copy_elems_from(const MemoryBuffer *src,
   }
 }
 
+void MemoryBuffer::copy_half_elems_from(const MemoryBuffer *src,
+                                        const rcti &area,
+                                        const int channel_offset,
+                                        const int elem_size,
+                                        const int to_x,
+                                        const int to_y,
+                                        const int to_channel_offset)
+{
+  ASSERT_BUFFER_CONTAINS_AREA(src, area);
+  ASSERT_BUFFER_CONTAINS_AREA_AT_COORDS(this, area, to_x, to_y);
+  ASSERT_VALID_ELEM_SIZE(this, to_channel_offset, elem_size);
+  ASSERT_VALID_ELEM_SIZE(src, channel_offset, elem_size);
+  BLI_assert(src->is_half_float() && !this->is_half_float());
+
+  /* Single element buffers only need the first element. */
+  const int width = this->is_a_single_elem() ? 1 : BLI_rcti_size_x(&area);
+  const int height = this->is_a_single_elem() ? 1 : BLI_rcti_size_y(&area);
+  threading::parallel_for(IndexRange(height), 64, [&](const IndexRange rows) {
+    for (const int64_t y : rows) {
+      float *to_elem = &this->get_value(to_x, to_y + y, to_channel_offset);
+      const uint16_t *from_elem = src->half_buffer_ +
+                                  src->get_coords_offset(area.xmin, area.ymin + y) +
+                                  channel_offset;
+      for (int x = 0; x < width; x++) {
+        for (int i = 0; i < elem_size; i++) {
+          to_elem[i] = half_to_float(from_elem[i]);
+        }
+        to_elem += this->elem_stride;
+        from_elem += src->elem_stride;
+      }
+    }
+  });
+}
+
 }  // namespace blender::compositor
@@ -98,6 +98,11 @@ class MemoryBuffer {
    */
   float *m_buffer;
 
+  /**
+   * Half float data, used instead of #m_buffer once converted by #convert_to_half_float.
+   */
+  uint16_t *half_buffer_;
+
   /**
    * \brief the number of channels of a single value in the buffer.
    * For value buffers this is 1, vector 3 and color 4
@@ -155,6 +160,21 @@ class MemoryBuffer {
     return m_is_a_single_elem;
   }
 
+  /**
+   * Whether elements are stored as half floats. Such buffers can only be read with #read_elem,
+   * #read_elem_checked or copied into full float buffers.
+   */
+  bool is_half_float() const
+  {
+    return half_buffer_ != nullptr;
+  }
+
+  /**
+   * Stores buffer elements as half floats to halve its memory usage. Values out of half float
+   * range become infinite and precision is lost, so it must only be used for color data.
+   */
+  void convert_to_half_float();
+
   float &operator[](int index)
   {
     BLI_assert(m_is_a_single_elem ? index < m_num_channels :
@@ -182,7 +202,7 @@ class MemoryBuffer {
    */
   float *get_elem(int x, int y)
   {
-    BLI_assert(has_coords(x, y));
+    BLI_assert(has_coords(x, y) && !is_half_float());
     return m_buffer + get_coords_offset(x, y);
   }
 
@@ -191,12 +211,16 @@ class MemoryBuffer {
    */
   const float *get_elem(int x, int y) const
   {
-    BLI_assert(has_coords(x, y));
+    BLI_assert(has_coords(x, y) && !is_half_float());
     return m_buffer + get_coords_offset(x, y);
   }
 
   void read_elem(int x, int y, float *out) const
   {
+    if (is_half_float()) {
+      read_half_elem(x, y, out);
+      return;
+    }
     memcpy(out, get_elem(x, y), get_elem_bytes_len());
   }
 
@@ -337,6 +361,15 @@ class MemoryBuffer {
     return this->m_num_channels * sizeof(float);
   }
 
+  /**
+   * Get the number of bytes used by buffer elements data.
+   */
+  size_t get_mem_size() const
+  {
+    const size_t channel_size = is_half_float() ? sizeof(uint16_t) : sizeof(float);
+    return channel_size * m_num_channels * get_memory_width() * get_memory_height();
+  }
+
   /**
    * Get all buffer elements as a range with no offsets.
    */
@@ -634,6 +667,11 @@ class MemoryBuffer {
     return this->m_rect;
   }
 
+  /**
+   * Moves the rect of this MemoryBuffer to start at given coordinates, keeping its size and data.
+   */
+  void move_to(int xmin, int ymin);
+
   /**
    * \brief get the width of this MemoryBuffer
    */
@@ -708,6 +746,7 @@ class MemoryBuffer {
     return (int)(y + to_positive_y_stride_) - to_positive_y_stride_;
   }
 
+  void read_half_elem(int x, int y, float *out) const;
   void copy_single_elem_from(const MemoryBuffer *src,
                              int channel_offset,
                              int elem_size,
@@ -723,6 +762,13 @@ class MemoryBuffer {
                        const int to_x,
                        const int to_y,
                        const int to_channel_offset);
+  void copy_half_elems_from(const MemoryBuffer *src,
+                            const rcti &area,
+                            const int channel_offset,
+                            const int elem_size,
+                            const int to_x,
+                            const int to_y,
+                            const int to_channel_offset);
 
 #ifdef WITH_CXX_GUARDEDALLOC
   MEM_CXX_CLASS_ALLOC_FUNCS("COM:MemoryBuffer")
@@ -65,6 +65,9 @@ class MultiThreadedOperation : public NodeOperation {
   void update_memory_buffer(MemoryBuffer *output,
                             const rcti &area,
                             Span<MemoryBuffer *> inputs) override;
+
+  /* Renders fused operations partial areas directly. */
+  friend class FusedOperation;
 };
 
 }  // namespace blender::compositor
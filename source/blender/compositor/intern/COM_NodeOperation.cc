@@ -38,6 +38,7 @@ NodeOperation::NodeOperation()
   canvas_input_index_ = 0;
   canvas_ = COM_AREA_NONE;
   this->m_btree = nullptr;
+  keep_execution_initialized_ = false;
 }
 
 /** Get constant value when operation is constant, otherwise return default_value. */
@@ -62,8 +63,10 @@ const float *NodeOperation::get_constant_elem_default(const float *default_elem)
  * Generate a hash that identifies the operation result in the current execution.
  * Requires `hash_output_params` to be implemented, otherwise `std::nullopt` is returned.
  * If the operation parameters or its linked inputs change, the hash must be re-generated.
+ * \param hash_content: Whether to hash data read by the operation, to identify the result
+ * across executions.
  */
-std::optional<NodeOperationHash> NodeOperation::generate_hash()
+std::optional<NodeOperationHash> NodeOperation::generate_hash(const bool hash_content)
 {
   params_hash_ = get_default_hash_2(canvas_.xmin, canvas_.xmax);
 
@@ -73,6 +76,9 @@ std::optional<NodeOperationHash> NodeOperation::generate_hash()
   if (!is_hash_output_params_implemented_) {
     return std::nullopt;
   }
+  if (hash_content) {
+    hash_output_content();
+  }
 
   hash_params(canvas_.ymin, canvas_.ymax);
   if (m_outputs.size() > 0) {
@@ -336,6 +342,26 @@ void NodeOperation::render(MemoryBuffer *output_buf,
   }
 }
 
+/**
+ * Initializes execution for several renders of parts of the operation, which are done until
+ * #end_partial_renders is called. Needed by output operations that write their result on
+ * deinitialization (e.g. compositor result or output files) when rendered in parts.
+ */
+void NodeOperation::begin_partial_renders()
+{
+  BLI_assert(get_flags().is_fullframe_operation);
+  BLI_assert(!keep_execution_initialized_);
+  initExecution();
+  keep_execution_initialized_ = true;
+}
+
+void NodeOperation::end_partial_renders()
+{
+  BLI_assert(keep_execution_initialized_);
+  keep_execution_initialized_ = false;
+  deinitExecution();
+}
+
 /**
  * Renders given areas using operations full frame implementation.
  */
@@ -343,11 +369,15 @@ void NodeOperation::render_full_frame(MemoryBuffer *output_buf,
                                       Span<rcti> areas,
                                       Span<MemoryBuffer *> inputs_bufs)
 {
-  initExecution();
+  if (!keep_execution_initialized_) {
+    initExecution();
+  }
   for (const rcti &area : areas) {
     update_memory_buffer(output_buf, area, inputs_bufs);
   }
-  deinitExecution();
+  if (!keep_execution_initialized_) {
+    deinitExecution();
+  }
 }
 
 /**
@@ -546,6 +576,12 @@ std::ostream &operator<<(std::ostream &os, const NodeOperationFlags &node_operat
   if (node_operation_flags.can_be_constant) {
     os << "can_be_constant,";
   }
+  if (node_operation_flags.is_per_pixel_operation) {
+    os << "per_pixel,";
+  }
+  if (node_operation_flags.use_full_precision) {
+    os << "full_precision,";
+  }
 
   return os;
 }
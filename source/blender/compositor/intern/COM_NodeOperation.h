@@ -249,6 +249,18 @@ struct NodeOperationFlags {
    */
   bool can_be_constant : 1;
 
+  /**
+   * Whether each output pixel only depends on input pixels at the same coordinates and the
+   * operation renders in a single pass, so that it can be fused with other per-pixel operations.
+   */
+  bool is_per_pixel_operation : 1;
+
+  /**
+   * Whether operation input and output buffers must be kept in full float precision when half
+   * float buffers are enabled. E.g. operations storing non-color data in color buffers.
+   */
+  bool use_full_precision : 1;
+
   NodeOperationFlags()
   {
     complex = false;
@@ -267,6 +279,8 @@ struct NodeOperationFlags {
     is_fullframe_operation = false;
     is_constant_operation = false;
     can_be_constant = false;
+    is_per_pixel_operation = false;
+    use_full_precision = false;
   }
 };
 
@@ -286,6 +300,16 @@ struct NodeOperationHash {
     return operation_;
   }
 
+  size_t get_type_hash() const
+  {
+    return type_hash_;
+  }
+
+  size_t get_params_hash() const
+  {
+    return params_hash_;
+  }
+
   bool operator==(const NodeOperationHash &other) const
   {
     return type_hash_ == other.type_hash_ && parents_hash_ == other.parents_hash_ &&
@@ -345,6 +369,11 @@ class NodeOperation {
    */
   const bNodeTree *m_btree;
 
+  /**
+   * Whether execution is kept initialized between renders, see #begin_partial_renders.
+   */
+  bool keep_execution_initialized_;
+
  protected:
   /**
    * Compositor execution model.
@@ -393,7 +422,7 @@ class NodeOperation {
     return flags;
   }
 
-  std::optional<NodeOperationHash> generate_hash();
+  std::optional<NodeOperationHash> generate_hash(bool hash_content = false);
 
   unsigned int getNumberOfInputSockets() const
   {
@@ -624,6 +653,8 @@ class NodeOperation {
    * \{ */
 
   void render(MemoryBuffer *output_buf, Span<rcti> areas, Span<MemoryBuffer *> inputs_bufs);
+  void begin_partial_renders();
+  void end_partial_renders();
 
   /**
    * Executes operation updating output memory buffer. Single-threaded calls.
@@ -652,6 +683,12 @@ class NodeOperation {
     is_hash_output_params_implemented_ = false;
   }
 
+  /* Overridden by subclasses reading data that may change between executions with the same
+   * parameters (e.g. render passes). Only hashed to identify results across executions. */
+  virtual void hash_output_content()
+  {
+  }
+
   static void combine_hashes(size_t &combined, size_t other)
   {
     combined = BLI_ghashutil_combine_hash(combined, other);
@@ -38,6 +38,8 @@
 #include "COM_WriteBufferOperation.h"
 
 #include "COM_ConstantFolder.h"
+#include "COM_FusedOperation.h"
+#include "COM_OperationFuser.h"
 #include "COM_NodeOperationBuilder.h" /* own include */
 
 namespace blender::compositor {
@@ -112,6 +114,12 @@ void NodeOperationBuilder::convertToOperations(ExecutionSystem *system)
   save_graphviz("compositor_prior_merging");
   merge_equal_operations();
 
+  if (m_context->get_execution_model() == eExecutionModel::FullFrame) {
+    save_graphviz("compositor_prior_fusing");
+    OperationFuser fuser(*this);
+    fuser.fuse_operations();
+  }
+
   if (m_context->get_execution_model() == eExecutionModel::Tiled) {
     /* surround complex ops with read/write buffer */
     add_complex_operation_buffers();
@@ -154,6 +162,54 @@ void NodeOperationBuilder::replace_operation_with_constant(NodeOperation *operat
   addOperation(constant_operation);
 }
 
+/**
+ * Replace the fused operations by given #FusedOperation. Fused operations keep their input links
+ * as they still read their inputs when initializing execution, but are no longer part of the
+ * graph.
+ */
+void NodeOperationBuilder::replace_operations_with_fused(FusedOperation *fused_operation)
+{
+  Span<MultiThreadedOperation *> fused_ops = fused_operation->get_operations();
+
+  /* External outputs in the same order as the fused operation inputs were added. */
+  Vector<NodeOperationOutput *> external_outputs;
+  for (MultiThreadedOperation *op : fused_ops) {
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperationOutput *output = op->getInputSocket(i)->getLink();
+      if (!fused_ops.contains(static_cast<MultiThreadedOperation *>(&output->getOperation()))) {
+        external_outputs.append(output);
+      }
+    }
+  }
+  BLI_assert(external_outputs.size() == fused_operation->getNumberOfInputSockets());
+
+  NodeOperation *last_op = fused_ops.last();
+  int i = 0;
+  while (i < m_links.size()) {
+    Link &link = m_links[i];
+    NodeOperation *to_op = &link.to()->getOperation();
+    if (fused_ops.contains(static_cast<MultiThreadedOperation *>(to_op))) {
+      m_links.remove(i);
+      continue;
+    }
+
+    if (&link.from()->getOperation() == last_op) {
+      link.to()->setLink(fused_operation->getOutputSocket());
+      m_links[i] = Link(fused_operation->getOutputSocket(), link.to());
+    }
+    i++;
+  }
+
+  for (const int input_idx : external_outputs.index_range()) {
+    addLink(external_outputs[input_idx], fused_operation->getInputSocket(input_idx));
+  }
+
+  for (MultiThreadedOperation *op : fused_ops) {
+    m_operations.remove_first_occurrence_and_reorder(op);
+  }
+  addOperation(fused_operation);
+}
+
 void NodeOperationBuilder::unlink_inputs_and_relink_outputs(NodeOperation *unlinked_op,
                                                             NodeOperation *linked_op)
 {
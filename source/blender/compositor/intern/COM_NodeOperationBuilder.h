@@ -42,6 +42,7 @@ class PreviewOperation;
 class WriteBufferOperation;
 class ViewerOperation;
 class ConstantOperation;
+class FusedOperation;
 
 class NodeOperationBuilder {
  public:
@@ -102,6 +103,7 @@ class NodeOperationBuilder {
   void addOperation(NodeOperation *operation);
   void replace_operation_with_constant(NodeOperation *operation,
                                        ConstantOperation *constant_operation);
+  void replace_operations_with_fused(FusedOperation *fused_operation);
 
   /** Map input socket of the current node to an operation socket */
   void mapInputSocket(NodeInput *node_socket, NodeOperationInput *operation_socket);
@@ -0,0 +1,115 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "BLI_rect.h"
+
+#include "COM_FusedOperation.h"
+#include "COM_OperationFuser.h"
+
+namespace blender::compositor {
+
+using Link = NodeOperationBuilder::Link;
+
+OperationFuser::OperationFuser(NodeOperationBuilder &operations_builder)
+    : operations_builder_(operations_builder)
+{
+}
+
+static bool is_fusable(NodeOperation *operation)
+{
+  const NodeOperationFlags flags = operation->get_flags();
+  return flags.is_per_pixel_operation && flags.is_fullframe_operation &&
+         !flags.is_constant_operation && operation->getNumberOfOutputSockets() == 1;
+}
+
+/**
+ * An operation is fused into its reader when both are per-pixel operations with the same canvas
+ * and no other operation reads its result.
+ */
+void OperationFuser::find_fused_links()
+{
+  const Vector<Link> &links = operations_builder_.get_links();
+  const bool is_rendering = operations_builder_.context().isRendering();
+
+  Map<NodeOperation *, int> num_readers;
+  for (const Link &link : links) {
+    num_readers.add_or_modify(
+        &link.from()->getOperation(), [](int *value) { *value = 1; }, [](int *value) {
+          (*value)++;
+        });
+  }
+
+  fused_into_.clear();
+  for (const Link &link : links) {
+    NodeOperation *from = &link.from()->getOperation();
+    NodeOperation *to = &link.to()->getOperation();
+    if (is_fusable(from) && is_fusable(to) && num_readers.lookup(from) == 1 &&
+        !from->isOutputOperation(is_rendering) &&
+        BLI_rcti_compare(&from->get_canvas(), &to->get_canvas())) {
+      fused_into_.add_new(from, to);
+    }
+  }
+}
+
+/** Appends operations fused into given one in evaluation order, followed by itself. */
+void OperationFuser::get_fused_chain(NodeOperation *operation,
+                                     Vector<MultiThreadedOperation *> &r_chain)
+{
+  for (int i = 0; i < operation->getNumberOfInputSockets(); i++) {
+    NodeOperation *input_op = operation->get_input_operation(i);
+    if (fused_into_.lookup_default(input_op, nullptr) == operation) {
+      get_fused_chain(input_op, r_chain);
+    }
+  }
+  r_chain.append(static_cast<MultiThreadedOperation *>(operation));
+}
+
+/**
+ * Replace chains of per-pixel operations by fused operations. Returns number of fused operations
+ * created.
+ */
+int OperationFuser::fuse_operations()
+{
+  find_fused_links();
+  if (fused_into_.is_empty()) {
+    return 0;
+  }
+
+  /* Chains are fused from the operation at their end, which isn't fused into any other one. */
+  Vector<NodeOperation *> chain_ends;
+  for (NodeOperation *op : operations_builder_.get_operations()) {
+    if (is_fusable(op) && !fused_into_.contains(op)) {
+      chain_ends.append(op);
+    }
+  }
+
+  int fused_count = 0;
+  for (NodeOperation *op : chain_ends) {
+    Vector<MultiThreadedOperation *> chain;
+    get_fused_chain(op, chain);
+    if (chain.size() > 1) {
+      operations_builder_.replace_operations_with_fused(new FusedOperation(chain));
+      fused_count++;
+    }
+  }
+  fused_into_.clear();
+
+  return fused_count;
+}
+
+}  // namespace blender::compositor
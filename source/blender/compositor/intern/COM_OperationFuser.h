@@ -0,0 +1,51 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "BLI_vector.hh"
+
+#include "COM_NodeOperationBuilder.h"
+
+namespace blender::compositor {
+
+class NodeOperation;
+class MultiThreadedOperation;
+
+/**
+ * Replaces chains of per-pixel operations by #FusedOperation's, so that intermediate results of
+ * the chain don't need full frame buffers.
+ */
+class OperationFuser {
+ private:
+  NodeOperationBuilder &operations_builder_;
+
+  /** Operations fused into their only reader operation. */
+  Map<NodeOperation *, NodeOperation *> fused_into_;
+
+ public:
+  OperationFuser(NodeOperationBuilder &operations_builder);
+  int fuse_operations();
+
+ private:
+  void find_fused_links();
+  void get_fused_chain(NodeOperation *operation, Vector<MultiThreadedOperation *> &r_chain);
+};
+
+}  // namespace blender::compositor
@@ -0,0 +1,128 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_RenderOrder.h"
+#include "COM_NodeOperation.h"
+
+#include <algorithm>
+
+namespace blender::compositor {
+
+/**
+ * Get memory used by an operation result once rendered.
+ */
+size_t RenderOrder::get_result_mem_size(NodeOperation *op)
+{
+  if (op->getNumberOfOutputSockets() == 0) {
+    return 0;
+  }
+  const size_t num_elems = op->get_flags().is_constant_operation ?
+                               1 :
+                               (size_t)op->getWidth() * op->getHeight();
+  const size_t num_channels = COM_data_type_num_channels(op->getOutputSocket()->getDataType());
+  return num_elems * num_channels * sizeof(float);
+}
+
+/**
+ * Rendering inputs with higher peak relative to their result size first is optimal for trees
+ * (Sethi-Ullman ordering). Results of rendered inputs stay alive until their reader is rendered.
+ */
+void RenderOrder::sort_by_peak_mem(Vector<NodeOperation *> &operations)
+{
+  auto get_peak_excess = [&](NodeOperation *op) {
+    return (int64_t)subtree_peaks_.lookup(op) - (int64_t)get_result_mem_size(op);
+  };
+  std::stable_sort(operations.begin(), operations.end(), [&](NodeOperation *a, NodeOperation *b) {
+    return get_peak_excess(a) > get_peak_excess(b);
+  });
+}
+
+/**
+ * Estimates peak memory needed to render an operation and all its dependencies, assuming none
+ * of them is shared with other operations.
+ */
+size_t RenderOrder::get_subtree_peak_mem(NodeOperation *op,
+                                         IsResultAvailableFn is_result_available)
+{
+  if (const size_t *peak = subtree_peaks_.lookup_ptr(op)) {
+    return *peak;
+  }
+
+  Vector<NodeOperation *> inputs;
+  if (!is_result_available(op)) {
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      if (!inputs.contains(input_op)) {
+        get_subtree_peak_mem(input_op, is_result_available);
+        inputs.append(input_op);
+      }
+    }
+  }
+
+  sort_by_peak_mem(inputs);
+  size_t peak = 0;
+  size_t inputs_mem = 0;
+  for (NodeOperation *input_op : inputs) {
+    peak = MAX2(peak, inputs_mem + subtree_peaks_.lookup(input_op));
+    inputs_mem += get_result_mem_size(input_op);
+  }
+  peak = MAX2(peak, inputs_mem + get_result_mem_size(op));
+
+  subtree_peaks_.add_new(op, peak);
+  return peak;
+}
+
+/**
+ * Appends operation after its dependencies not ordered yet, ordering first the dependencies that
+ * need more memory.
+ */
+void RenderOrder::append(NodeOperation *op, IsResultAvailableFn is_result_available)
+{
+  if (ordered_ops_.contains(op)) {
+    return;
+  }
+
+  /* Available results don't need their dependencies. */
+  Vector<NodeOperation *> inputs;
+  if (!is_result_available(op)) {
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      if (!ordered_ops_.contains(input_op) && !inputs.contains(input_op)) {
+        get_subtree_peak_mem(input_op, is_result_available);
+        inputs.append(input_op);
+      }
+    }
+  }
+
+  sort_by_peak_mem(inputs);
+  for (NodeOperation *input_op : inputs) {
+    append(input_op, is_result_available);
+  }
+
+  ordered_ops_.add_new(op);
+  operations_.append(op);
+}
+
+void RenderOrder::clear()
+{
+  operations_.clear();
+  ordered_ops_.clear();
+  subtree_peaks_.clear();
+}
+
+}  // namespace blender::compositor
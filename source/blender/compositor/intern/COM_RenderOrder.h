@@ -0,0 +1,74 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_function_ref.hh"
+#include "BLI_map.hh"
+#include "BLI_set.hh"
+#include "BLI_vector.hh"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+namespace blender::compositor {
+
+class NodeOperation;
+
+/**
+ * Order in which operations are rendered. Dependencies of an operation are ordered before it,
+ * the ones needing more memory first, to reduce the number of results alive at the same time.
+ */
+class RenderOrder {
+ public:
+  /** Whether an operation result is available without rendering its dependencies. */
+  using IsResultAvailableFn = FunctionRef<bool(NodeOperation *op)>;
+
+ private:
+  Vector<NodeOperation *> operations_;
+  Set<NodeOperation *> ordered_ops_;
+  /** Estimated peak memory to render operations and their dependencies. */
+  Map<NodeOperation *, size_t> subtree_peaks_;
+
+ public:
+  void append(NodeOperation *op, IsResultAvailableFn is_result_available);
+  void clear();
+
+  Span<NodeOperation *> get_operations() const
+  {
+    return operations_;
+  }
+
+  int64_t size() const
+  {
+    return operations_.size();
+  }
+
+  static size_t get_result_mem_size(NodeOperation *op);
+
+ private:
+  size_t get_subtree_peak_mem(NodeOperation *op, IsResultAvailableFn is_result_available);
+  void sort_by_peak_mem(Vector<NodeOperation *> &operations);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:RenderOrder")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -0,0 +1,114 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_ResultCache.h"
+
+#include <optional>
+
+namespace blender::compositor {
+
+ResultCache::ResultCache(const size_t mem_limit)
+    : mem_limit_(mem_limit), mem_used_(0), execution_(0)
+{
+}
+
+void ResultCache::begin_execution()
+{
+  execution_++;
+  /* No result is in use yet, discard the ones exceeding the memory limit if it was lowered. */
+  free_results_not_in_use(0);
+}
+
+/**
+ * Get result with given key, nullptr when not cached. Returned buffer is owned by the cache.
+ */
+MemoryBuffer *ResultCache::get_result(const ResultKey &key)
+{
+  CachedResult *result = results_.lookup_ptr(key);
+  if (result == nullptr) {
+    return nullptr;
+  }
+  result->last_execution = execution_;
+  return result->buffer.get();
+}
+
+static size_t get_buffer_mem_size(const MemoryBuffer &buffer)
+{
+  return sizeof(float) * buffer.get_num_channels() * buffer.get_memory_width() *
+         buffer.get_memory_height();
+}
+
+/**
+ * Copy given buffer into the cache. Returns false when there is not enough memory for it
+ * without discarding results in use by current execution.
+ */
+bool ResultCache::add_result(const ResultKey &key, const MemoryBuffer &buffer)
+{
+  if (CachedResult *result = results_.lookup_ptr(key)) {
+    result->last_execution = execution_;
+    return true;
+  }
+
+  const size_t mem_size = get_buffer_mem_size(buffer);
+  if (!free_results_not_in_use(mem_size)) {
+    return false;
+  }
+
+  CachedResult result;
+  result.buffer = std::make_unique<MemoryBuffer>(buffer);
+  result.mem_size = mem_size;
+  result.last_execution = execution_;
+  results_.add_new(key, std::move(result));
+  mem_used_ += mem_size;
+  return true;
+}
+
+void ResultCache::clear()
+{
+  results_.clear();
+  mem_used_ = 0;
+}
+
+/**
+ * Discard least recently used results until there is enough memory for the required one.
+ */
+bool ResultCache::free_results_not_in_use(const size_t required_mem)
+{
+  if (required_mem > mem_limit_) {
+    return false;
+  }
+
+  while (mem_used_ + required_mem > mem_limit_) {
+    std::optional<ResultKey> lru_key;
+    int lru_execution = execution_;
+    for (Map<ResultKey, CachedResult>::Item item : results_.items()) {
+      if (item.value.last_execution < lru_execution) {
+        lru_execution = item.value.last_execution;
+        lru_key = item.key;
+      }
+    }
+
+    if (!lru_key) {
+      return false;
+    }
+    mem_used_ -= results_.pop(*lru_key).mem_size;
+  }
+  return true;
+}
+
+}  // namespace blender::compositor
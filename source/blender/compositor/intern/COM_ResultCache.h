@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+#include "BLI_rect.h"
+
+#include "COM_MemoryBuffer.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+#include <memory>
+
+namespace blender::compositor {
+
+/**
+ * Keeps operations results between executions so that unchanged parts of the tree don't need to
+ * be rendered again. Results are identified by a hash of the operation parameters and of all
+ * the operations it depends on. Least recently used results are discarded when exceeding the
+ * memory limit.
+ */
+class ResultCache {
+ public:
+  /**
+   * Identifies a cached result. Besides the hash of the operation and everything it depends on,
+   * the operation type, parameters and canvas are compared so that hash collisions of different
+   * operations don't return wrong results.
+   */
+  struct ResultKey {
+    /** Hash of the operation and all operations it depends on. */
+    size_t result_hash;
+    size_t type_hash;
+    size_t params_hash;
+    rcti canvas;
+
+    uint64_t hash() const
+    {
+      return result_hash;
+    }
+
+    bool operator==(const ResultKey &other) const
+    {
+      return result_hash == other.result_hash && type_hash == other.type_hash &&
+             params_hash == other.params_hash && BLI_rcti_compare(&canvas, &other.canvas);
+    }
+  };
+
+ private:
+  struct CachedResult {
+    std::unique_ptr<MemoryBuffer> buffer;
+    size_t mem_size;
+    /** Last execution the result was used in. */
+    int last_execution;
+  };
+
+  Map<ResultKey, CachedResult> results_;
+  size_t mem_limit_;
+  size_t mem_used_;
+  int execution_;
+
+ public:
+  ResultCache(size_t mem_limit);
+
+  /**
+   * Results used by an execution are kept until the next one begins, so that buffers returned by
+   * #get_result are valid during the whole execution.
+   */
+  void begin_execution();
+
+  MemoryBuffer *get_result(const ResultKey &key);
+  bool add_result(const ResultKey &key, const MemoryBuffer &buffer);
+  void clear();
+
+  /** Results exceeding a lowered limit are discarded when the next execution begins. */
+  void set_mem_limit(size_t mem_limit)
+  {
+    mem_limit_ = mem_limit;
+  }
+
+  size_t get_mem_used() const
+  {
+    return mem_used_;
+  }
+
+  int get_num_results() const
+  {
+    return results_.size();
+  }
+
+ private:
+  bool free_results_not_in_use(size_t required_mem);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:ResultCache")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -108,6 +108,9 @@ void SharedOperationBuffers::set_rendered_buffer(NodeOperation *op,
   BLI_assert(buf_data.buffer == nullptr);
   buf_data.buffer = std::move(buffer);
   buf_data.is_rendered = true;
+  if (buf_data.buffer) {
+    mem_used_ += buf_data.buffer->get_mem_size();
+  }
 }
 
 /**
@@ -119,6 +122,17 @@ MemoryBuffer *SharedOperationBuffers::get_rendered_buffer(NodeOperation *op)
   return get_buffer_data(op).buffer.get();
 }
 
+/** Releases ownership of a rendered buffer, it's not disposed when reads are finished. */
+std::unique_ptr<MemoryBuffer> SharedOperationBuffers::take_rendered_buffer(NodeOperation *op)
+{
+  BLI_assert(is_operation_rendered(op));
+  BufferData &buf_data = get_buffer_data(op);
+  if (buf_data.buffer) {
+    mem_used_ -= buf_data.buffer->get_mem_size();
+  }
+  return std::move(buf_data.buffer);
+}
+
 /**
  * Reports an operation has finished reading given operation. If all given operation dependencies
  * have finished its buffer will be disposed.
@@ -128,10 +142,17 @@ void SharedOperationBuffers::read_finished(NodeOperation *read_op)
   BufferData &buf_data = get_buffer_data(read_op);
   buf_data.received_reads++;
   BLI_assert(buf_data.received_reads > 0 && buf_data.received_reads <= buf_data.registered_reads);
-  if (buf_data.received_reads == buf_data.registered_reads) {
+  if (buf_data.received_reads == buf_data.registered_reads && buf_data.buffer) {
     /* Dispose buffer. */
+    mem_used_ -= buf_data.buffer->get_mem_size();
     buf_data.buffer = nullptr;
   }
 }
 
+void SharedOperationBuffers::clear()
+{
+  buffers_.clear();
+  mem_used_ = 0;
+}
+
 }  // namespace blender::compositor
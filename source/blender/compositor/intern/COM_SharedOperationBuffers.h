@@ -45,6 +45,8 @@ class SharedOperationBuffers {
     bool is_rendered;
   } BufferData;
   blender::Map<NodeOperation *, BufferData> buffers_;
+  /** Memory used by the buffers that are alive. */
+  size_t mem_used_ = 0;
 
  public:
   bool is_area_registered(NodeOperation *op, const rcti &area_to_render);
@@ -57,9 +59,18 @@ class SharedOperationBuffers {
   bool is_operation_rendered(NodeOperation *op);
   void set_rendered_buffer(NodeOperation *op, std::unique_ptr<MemoryBuffer> buffer);
   MemoryBuffer *get_rendered_buffer(NodeOperation *op);
+  std::unique_ptr<MemoryBuffer> take_rendered_buffer(NodeOperation *op);
 
   void read_finished(NodeOperation *read_op);
 
+  /** Removes all registered areas, reads and buffers. */
+  void clear();
+
+  size_t get_mem_used() const
+  {
+    return mem_used_;
+  }
+
  private:
   BufferData &get_buffer_data(NodeOperation *op);
 
@@ -0,0 +1,132 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_StreamedResults.h"
+
+#include "BLI_fileops.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+
+#include <cstdio>
+
+namespace blender::compositor {
+
+StreamedResults::StreamedResults(const char *dir, const size_t mem_limit)
+    : dir_(dir), mem_limit_(mem_limit), mem_used_(0), num_files_(0)
+{
+}
+
+StreamedResults::~StreamedResults()
+{
+  for (StreamedResult &result : results_.values()) {
+    if (!result.filepath.empty()) {
+      BLI_delete(result.filepath.c_str(), false, false);
+    }
+  }
+}
+
+/**
+ * Adds a full float result. It's kept in memory if it fits in the memory limit, otherwise it's
+ * written to a file. Results that can't be written are kept in memory.
+ */
+void StreamedResults::add_result(const int result_id, std::unique_ptr<MemoryBuffer> buffer)
+{
+  BLI_assert(!results_.contains(result_id));
+  BLI_assert(!buffer->is_half_float());
+
+  StreamedResult result;
+  result.data_type = COM_num_channels_data_type(buffer->get_num_channels());
+  result.rect = buffer->get_rect();
+  result.is_a_single_elem = buffer->is_a_single_elem();
+
+  const size_t mem_size = buffer->get_mem_size();
+  if (mem_used_ + mem_size > mem_limit_) {
+    char filename[64];
+    char filepath[FILE_MAX];
+    BLI_snprintf(filename, sizeof(filename), "compositor_%p_%d.tmp", this, result_id);
+    BLI_path_join(filepath, sizeof(filepath), dir_.c_str(), filename, nullptr);
+    if (write_file(*buffer, filepath)) {
+      result.filepath = filepath;
+      num_files_++;
+      results_.add_new(result_id, std::move(result));
+      return;
+    }
+    BLI_delete(filepath, false, false);
+  }
+
+  mem_used_ += mem_size;
+  result.buffer = std::move(buffer);
+  results_.add_new(result_id, std::move(result));
+}
+
+bool StreamedResults::contains(const int result_id) const
+{
+  return results_.contains(result_id);
+}
+
+std::unique_ptr<MemoryBuffer> StreamedResults::get_result(const int result_id,
+                                                          const int ymin,
+                                                          const int ymax)
+{
+  StreamedResult &result = results_.lookup(result_id);
+  if (result.buffer) {
+    return std::make_unique<MemoryBuffer>(result.buffer->getBuffer(),
+                                          result.buffer->get_num_channels(),
+                                          result.rect,
+                                          result.is_a_single_elem);
+  }
+
+  /* Rows are stored one after the other, skip the ones before requested rows. Single element
+   * results are read entirely. */
+  rcti rect = result.rect;
+  int64_t offset = 0;
+  if (!result.is_a_single_elem) {
+    rect.ymin = MAX2(ymin, result.rect.ymin);
+    rect.ymax = MAX2(MIN2(ymax, result.rect.ymax), rect.ymin);
+    const int64_t row_size = (int64_t)BLI_rcti_size_x(&rect) *
+                             COM_data_type_num_channels(result.data_type) * sizeof(float);
+    offset = (rect.ymin - result.rect.ymin) * row_size;
+  }
+  std::unique_ptr<MemoryBuffer> buffer = std::make_unique<MemoryBuffer>(
+      result.data_type, rect, result.is_a_single_elem);
+
+  const size_t mem_size = buffer->get_mem_size();
+  FILE *file = BLI_fopen(result.filepath.c_str(), "rb");
+  if (file == nullptr || BLI_fseek(file, offset, SEEK_SET) != 0 ||
+      fread(buffer->getBuffer(), 1, mem_size, file) != mem_size) {
+    /* File removed or truncated while rendering, continue with an empty result. */
+    buffer->clear();
+  }
+  if (file) {
+    fclose(file);
+  }
+  return buffer;
+}
+
+bool StreamedResults::write_file(MemoryBuffer &buffer, const std::string &filepath)
+{
+  FILE *file = BLI_fopen(filepath.c_str(), "wb");
+  if (file == nullptr) {
+    return false;
+  }
+  const size_t mem_size = buffer.get_mem_size();
+  const bool is_written = fwrite(buffer.getBuffer(), 1, mem_size, file) == mem_size;
+  return (fclose(file) == 0) && is_written;
+}
+
+}  // namespace blender::compositor
@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "BLI_map.hh"
+
+#include "COM_MemoryBuffer.h"
+
+#ifdef WITH_CXX_GUARDEDALLOC
+#  include "MEM_guardedalloc.h"
+#endif
+
+#include <memory>
+#include <string>
+
+namespace blender::compositor {
+
+/**
+ * Keeps results of operations depending on whole frames while outputs are rendered in bands, so
+ * that they are rendered once instead of once per band. Results are kept in memory up to the
+ * memory limit, the rest are stored in temporary files and read back when needed.
+ */
+class StreamedResults {
+ private:
+  struct StreamedResult {
+    /** Result buffer, nullptr when it's stored in a file. */
+    std::unique_ptr<MemoryBuffer> buffer;
+    std::string filepath;
+    DataType data_type;
+    rcti rect;
+    bool is_a_single_elem;
+  };
+
+  Map<int, StreamedResult> results_;
+  std::string dir_;
+  size_t mem_limit_;
+  size_t mem_used_;
+  int num_files_;
+
+ public:
+  StreamedResults(const char *dir, size_t mem_limit);
+  ~StreamedResults();
+
+  void add_result(int result_id, std::unique_ptr<MemoryBuffer> buffer);
+  bool contains(int result_id) const;
+
+  /**
+   * Returned buffer is either a view of a result kept in memory, valid until results are
+   * destructed, or a new buffer with only rows `ymin` to `ymax` read from file.
+   */
+  std::unique_ptr<MemoryBuffer> get_result(int result_id, int ymin, int ymax);
+
+  size_t get_mem_used() const
+  {
+    return mem_used_;
+  }
+
+  int get_num_files() const
+  {
+    return num_files_;
+  }
+
+ private:
+  bool write_file(MemoryBuffer &buffer, const std::string &filepath);
+
+#ifdef WITH_CXX_GUARDEDALLOC
+  MEM_CXX_CLASS_ALLOC_FUNCS("COM:StreamedResults")
+#endif
+};
+
+}  // namespace blender::compositor
@@ -20,18 +20,29 @@
 
 #include "BLT_translation.h"
 
+#include "DNA_userdef_types.h"
+
 #include "BKE_node.h"
 #include "BKE_scene.h"
 
 #include "COM_ExecutionSystem.h"
 #include "COM_MovieDistortionOperation.h"
+#include "COM_ResultCache.h"
 #include "COM_WorkScheduler.h"
 #include "COM_compositor.h"
 #include "clew.h"
 
+/* Memory limit for results kept between executions while editing the node tree, from the memory
+ * cache limit preference. */
+static size_t compositor_result_cache_mem_limit()
+{
+  return ((size_t)U.memcachelimit) * 1024 * 1024;
+}
+
 static struct {
   bool is_initialized = false;
   ThreadMutex mutex;
+  blender::compositor::ResultCache *result_cache = nullptr;
 } g_compositor;
 
 /* Make sure node tree has previews.
@@ -94,11 +105,31 @@ void COM_execute(RenderData *render_data,
   const bool use_opencl = (node_tree->flag & NTREE_COM_OPENCL) != 0;
   blender::compositor::WorkScheduler::initialize(use_opencl, BKE_render_num_threads(render_data));
 
+  /* Results are only cached while editing, final renders are executed once. */
+  blender::compositor::ResultCache *result_cache = nullptr;
+  if (!rendering) {
+    if (g_compositor.result_cache == nullptr) {
+      g_compositor.result_cache = new blender::compositor::ResultCache(
+          compositor_result_cache_mem_limit());
+    }
+    else {
+      g_compositor.result_cache->set_mem_limit(compositor_result_cache_mem_limit());
+    }
+    result_cache = g_compositor.result_cache;
+  }
+
   /* Execute. */
   const bool twopass = (node_tree->flag & NTREE_TWO_PASS) && !rendering;
   if (twopass) {
-    blender::compositor::ExecutionSystem fast_pass(
-        render_data, scene, node_tree, rendering, true, viewSettings, displaySettings, viewName);
+    blender::compositor::ExecutionSystem fast_pass(render_data,
+                                                   scene,
+                                                   node_tree,
+                                                   rendering,
+                                                   true,
+                                                   viewSettings,
+                                                   displaySettings,
+                                                   viewName,
+                                                   nullptr);
     fast_pass.execute();
 
     if (node_tree->test_break(node_tree->tbh)) {
@@ -107,8 +138,15 @@ void COM_execute(RenderData *render_data,
     }
   }
 
-  blender::compositor::ExecutionSystem system(
-      render_data, scene, node_tree, rendering, false, viewSettings, displaySettings, viewName);
+  blender::compositor::ExecutionSystem system(render_data,
+                                              scene,
+                                              node_tree,
+                                              rendering,
+                                              false,
+                                              viewSettings,
+                                              displaySettings,
+                                              viewName,
+                                              result_cache);
   system.execute();
 
   BLI_mutex_unlock(&g_compositor.mutex);
@@ -119,6 +157,8 @@ void COM_deinitialize()
   if (g_compositor.is_initialized) {
     BLI_mutex_lock(&g_compositor.mutex);
     blender::compositor::WorkScheduler::deinitialize();
+    delete g_compositor.result_cache;
+    g_compositor.result_cache = nullptr;
     g_compositor.is_initialized = false;
     BLI_mutex_unlock(&g_compositor.mutex);
     BLI_mutex_end(&g_compositor.mutex);
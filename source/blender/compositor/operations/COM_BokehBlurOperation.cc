@@ -18,6 +18,7 @@
 
 #include "COM_BokehBlurOperation.h"
 #include "COM_ConstantOperation.h"
+#include "COM_FFTConvolution.h"
 
 #include "BLI_math.h"
 #include "COM_OpenCLDevice.h"
@@ -324,17 +325,79 @@ void BokehBlurOperation::get_area_of_interest(const int input_idx,
   }
 }
 
+int BokehBlurOperation::get_pixel_size() const
+{
+  const float max_dim = MAX2(this->getWidth(), this->getHeight());
+  return m_size * max_dim / 100.0f;
+}
+
+bool BokehBlurOperation::use_fft_convolution(const int pixel_size) const
+{
+  /* FFT can't skip pixels, so lower quality steps are faster when done directly. */
+  return getStep() == 1 && pixel_size >= 2 &&
+         4 * pixel_size * pixel_size >= FFT_CONVOLUTION_MIN_KERNEL_AREA;
+}
+
+void BokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                      const rcti &area,
+                                                      Span<MemoryBuffer *> inputs)
+{
+  const int pixel_size = get_pixel_size();
+  if (!use_fft_convolution(pixel_size)) {
+    return;
+  }
+
+  /* Bokeh sampled at every offset of the blur window, flipped as it's convolved. */
+  const float m = m_bokehDimension / pixel_size;
+  const int kernel_size = 2 * pixel_size;
+  const int kernel_center = pixel_size - 1;
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, kernel_size, 0, kernel_size);
+  MemoryBuffer kernel(DataType::Color, kernel_rect);
+  const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
+  for (int y = 0; y < kernel_size; y++) {
+    const float v = m_bokehMidY + (y - kernel_center) * m;
+    for (int x = 0; x < kernel_size; x++) {
+      const float u = m_bokehMidX + (x - kernel_center) * m;
+      bokeh_input->read_elem_checked(u, v, kernel.get_elem(x, y));
+    }
+  }
+
+  /* Weighted colors sum is written to output, weights sum of the pixels inside the image is
+   * calculated by convolving an image mask. */
+  const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
+  convolve_fft(*image_input, kernel, kernel_center, kernel_center, *output, area);
+  MemoryBuffer image_mask(DataType::Value, image_input->get_rect(), true);
+  *image_mask.getBuffer() = 1.0f;
+  fft_weights_ = std::make_unique<MemoryBuffer>(DataType::Color, area);
+  convolve_fft(image_mask, kernel, kernel_center, kernel_center, *fft_weights_, area);
+}
+
 void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                       const rcti &area,
                                                       Span<MemoryBuffer *> inputs)
 {
-  const float max_dim = MAX2(this->getWidth(), this->getHeight());
-  const int pixel_size = m_size * max_dim / 100.0f;
+  const int pixel_size = get_pixel_size();
   const float m = m_bokehDimension / pixel_size;
 
   const MemoryBuffer *image_input = inputs[IMAGE_INPUT_INDEX];
   const MemoryBuffer *bokeh_input = inputs[BOKEH_INPUT_INDEX];
   MemoryBuffer *bounding_input = inputs[BOUNDING_BOX_INPUT_INDEX];
+  if (fft_weights_) {
+    for (BuffersIterator<float> it = output->iterate_with({bounding_input}, area); !it.is_end();
+         ++it) {
+      if (*it.in(0) <= 0.0f) {
+        image_input->read_elem(it.x, it.y, it.out);
+        continue;
+      }
+      const float *weights = fft_weights_->get_elem(it.x, it.y);
+      for (int ch = 0; ch < 4; ch++) {
+        it.out[ch] = weights[ch] > FLT_EPSILON ? it.out[ch] / weights[ch] : 0.0f;
+      }
+    }
+    return;
+  }
+
   BuffersIterator<float> it = output->iterate_with({bounding_input}, area);
   const rcti &image_rect = image_input->get_rect();
   for (; !it.is_end(); ++it) {
@@ -381,4 +444,11 @@ void BokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
   }
 }
 
+void BokehBlurOperation::update_memory_buffer_finished(MemoryBuffer *UNUSED(output),
+                                                       const rcti &UNUSED(area),
+                                                       Span<MemoryBuffer *> UNUSED(inputs))
+{
+  fft_weights_.reset();
+}
+
 }  // namespace blender::compositor
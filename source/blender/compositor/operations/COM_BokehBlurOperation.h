@@ -21,6 +21,8 @@
 #include "COM_MultiThreadedOperation.h"
 #include "COM_QualityStepHelper.h"
 
+#include <memory>
+
 namespace blender::compositor {
 
 class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelper {
@@ -37,6 +39,9 @@ class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelp
   float m_bokehDimension;
   bool m_extend_bounds;
 
+  /** Sum of bokeh weights of every pixel when blurring with #convolve_fft. */
+  std::unique_ptr<MemoryBuffer> fft_weights_;
+
  public:
   BokehBlurOperation();
 
@@ -83,9 +88,22 @@ class BokehBlurOperation : public MultiThreadedOperation, public QualityStepHelp
   void determine_canvas(const rcti &preferred_area, rcti &r_area) override;
 
   void get_area_of_interest(int input_idx, const rcti &output_area, rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_finished(MemoryBuffer *output,
+                                     const rcti &area,
+                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  /** Whether the blur is done with #convolve_fft rather than the direct loop. */
+  virtual bool use_fft_convolution(int pixel_size) const;
+
+ private:
+  int get_pixel_size() const;
 };
 
 }  // namespace blender::compositor
@@ -110,6 +110,12 @@ void BokehImageOperation::executePixelSampled(float output[4],
   output[3] = (insideBokehMax + insideBokehMed + insideBokehMin) / 3.0f;
 }
 
+void BokehImageOperation::hash_output_params()
+{
+  hash_params(m_data->angle, m_data->flaps, m_data->rounding);
+  hash_params(m_data->catadioptric, m_data->lensshift);
+}
+
 void BokehImageOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                        const rcti &area,
                                                        Span<MemoryBuffer *> UNUSED(inputs))
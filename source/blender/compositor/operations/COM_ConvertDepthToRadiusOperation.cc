@@ -116,6 +116,17 @@ void ConvertDepthToRadiusOperation::deinitExecution()
   this->m_inputOperation = nullptr;
 }
 
+void ConvertDepthToRadiusOperation::hash_output_params()
+{
+  hash_params(m_fStop, m_maxRadius);
+  if (this->m_cameraObject && this->m_cameraObject->type == OB_CAMERA) {
+    const Camera *camera = (const Camera *)this->m_cameraObject->data;
+    hash_params(camera->lens, (int)camera->sensor_fit);
+    hash_params(camera->sensor_x, camera->sensor_y);
+    hash_param(BKE_camera_object_dof_distance(this->m_cameraObject));
+  }
+}
+
 void ConvertDepthToRadiusOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                                  const rcti &area,
                                                                  Span<MemoryBuffer *> inputs)
@@ -28,6 +28,7 @@ ConvertBaseOperation::ConvertBaseOperation()
 {
   this->m_inputOperation = nullptr;
   this->flags.can_be_constant = true;
+  this->flags.is_per_pixel_operation = true;
 }
 
 void ConvertBaseOperation::initExecution()
@@ -58,6 +59,8 @@ ConvertValueToColorOperation::ConvertValueToColorOperation() : ConvertBaseOperat
 {
   this->addInputSocket(DataType::Value);
   this->addOutputSocket(DataType::Color);
+  /* Values are usually non-color data like depth. */
+  this->flags.use_full_precision = true;
 }
 
 void ConvertValueToColorOperation::executePixelSampled(float output[4],
@@ -186,6 +189,8 @@ ConvertVectorToColorOperation::ConvertVectorToColorOperation() : ConvertBaseOper
 {
   this->addInputSocket(DataType::Vector);
   this->addOutputSocket(DataType::Color);
+  /* Vectors are usually non-color data like normals or positions. */
+  this->flags.use_full_precision = true;
 }
 
 void ConvertVectorToColorOperation::executePixelSampled(float output[4],
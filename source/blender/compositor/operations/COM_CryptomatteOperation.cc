@@ -28,6 +28,8 @@ CryptomatteOperation::CryptomatteOperation(size_t num_inputs)
   }
   this->addOutputSocket(DataType::Color);
   this->flags.complex = true;
+  /* Inputs store object hashes as floats. */
+  this->flags.use_full_precision = true;
 }
 
 void CryptomatteOperation::initExecution()
@@ -404,6 +404,13 @@ void *FastGaussianBlurValueOperation::initializeTileData(rcti *rect)
   return this->m_iirgaus;
 }
 
+void FastGaussianBlurValueOperation::hash_output_params()
+{
+  /* Sigma is only set on execution initialization by the depth to radius operation read as
+   * input, from parameters hashed with the input. */
+  hash_param(m_overlay);
+}
+
 void FastGaussianBlurValueOperation::get_area_of_interest(const int UNUSED(input_idx),
                                                           const rcti &UNUSED(output_area),
                                                           rcti &r_input_area)
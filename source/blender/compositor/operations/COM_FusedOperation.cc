@@ -0,0 +1,136 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "COM_FusedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * \param operations: Operations in evaluation order. Each one but the last must be read only by
+ * operations after it in the chain.
+ */
+FusedOperation::FusedOperation(Span<MultiThreadedOperation *> operations)
+    : operations_(operations)
+{
+  BLI_assert(operations.size() > 1);
+  for (const int op_index : operations_.index_range()) {
+    MultiThreadedOperation *op = operations_[op_index];
+    Vector<int> sources;
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      const int fused_index = operations_.first_index_of_try(
+          static_cast<MultiThreadedOperation *>(input_op));
+      if (fused_index != -1) {
+        BLI_assert(fused_index < op_index);
+        sources.append(fused_index);
+      }
+      else {
+        addInputSocket(op->getInputSocket(i)->getDataType());
+        sources.append(-int(getNumberOfInputSockets()));
+      }
+    }
+    input_sources_.append(std::move(sources));
+  }
+
+  NodeOperation *output_op = operations_.last();
+  addOutputSocket(output_op->getOutputSocket()->getDataType());
+  set_canvas(output_op->get_canvas());
+  flags.can_be_constant = false;
+}
+
+FusedOperation::~FusedOperation()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    delete op;
+  }
+}
+
+void FusedOperation::init_data()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->init_data();
+  }
+}
+
+void FusedOperation::initExecution()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->initExecution();
+  }
+}
+
+void FusedOperation::deinitExecution()
+{
+  for (MultiThreadedOperation *op : operations_) {
+    op->deinitExecution();
+  }
+}
+
+/**
+ * Fused operations results can be identified only when all their operations implement
+ * #hash_output_params.
+ */
+void FusedOperation::hash_output_params()
+{
+  for (const int op_index : operations_.index_range()) {
+    std::optional<NodeOperationHash> op_hash = operations_[op_index]->generate_hash();
+    if (!op_hash) {
+      NodeOperation::hash_output_params();
+      return;
+    }
+    hash_params(op_hash->get_type_hash(), op_hash->get_params_hash());
+    for (const int source : input_sources_[op_index]) {
+      hash_param(source);
+    }
+  }
+}
+
+void FusedOperation::update_memory_buffer_partial(MemoryBuffer *output,
+                                                  const rcti &area,
+                                                  Span<MemoryBuffer *> inputs)
+{
+  /* Row buffers for every operation result but the last one, which is written to output. They
+   * are allocated once per area and moved from row to row. */
+  rcti row_area;
+  BLI_rcti_init(&row_area, area.xmin, area.xmax, area.ymin, area.ymin + 1);
+  Vector<std::unique_ptr<MemoryBuffer>> row_buffers;
+  for (int i = 0; i < operations_.size() - 1; i++) {
+    const DataType data_type = operations_[i]->getOutputSocket()->getDataType();
+    row_buffers.append(std::make_unique<MemoryBuffer>(data_type, row_area));
+  }
+
+  Vector<MemoryBuffer *> op_inputs;
+  for (int y = area.ymin; y < area.ymax; y++) {
+    BLI_rcti_init(&row_area, area.xmin, area.xmax, y, y + 1);
+    for (std::unique_ptr<MemoryBuffer> &row_buffer : row_buffers) {
+      row_buffer->move_to(area.xmin, y);
+    }
+
+    for (const int op_index : operations_.index_range()) {
+      op_inputs.clear();
+      for (const int source : input_sources_[op_index]) {
+        op_inputs.append(source >= 0 ? row_buffers[source].get() : inputs[-source - 1]);
+      }
+      MemoryBuffer *op_output = (op_index == operations_.size() - 1) ? output :
+                                                                       row_buffers[op_index].get();
+      operations_[op_index]->update_memory_buffer_partial(op_output, row_area, op_inputs);
+    }
+  }
+}
+
+}  // namespace blender::compositor
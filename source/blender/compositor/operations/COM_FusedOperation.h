@@ -0,0 +1,63 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "COM_MultiThreadedOperation.h"
+
+namespace blender::compositor {
+
+/**
+ * Evaluates a chain of per-pixel operations one row at a time, so that intermediate results are
+ * kept in small row buffers instead of full frame buffers. Created by #OperationFuser.
+ *
+ * Fused operations keep the links between each other in their input sockets. Inputs coming from
+ * outside of the chain are inputs of the fused operation.
+ */
+class FusedOperation : public MultiThreadedOperation {
+ private:
+  /** Fused operations in evaluation order, last one writes the output. */
+  Vector<MultiThreadedOperation *> operations_;
+
+  /**
+   * Where each fused operation input is read from: the index of a fused operation when
+   * positive or zero, otherwise the fused operation input at index `-source - 1`.
+   */
+  Vector<Vector<int>> input_sources_;
+
+ public:
+  FusedOperation(Span<MultiThreadedOperation *> operations);
+  ~FusedOperation();
+
+  Span<MultiThreadedOperation *> get_operations() const
+  {
+    return operations_;
+  }
+
+  void init_data() override;
+  void initExecution() override;
+  void deinitExecution() override;
+
+ protected:
+  void hash_output_params() override;
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
+};
+
+}  // namespace blender::compositor
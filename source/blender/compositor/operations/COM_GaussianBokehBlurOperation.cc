@@ -17,6 +17,7 @@
  */
 
 #include "COM_GaussianBokehBlurOperation.h"
+#include "COM_FFTConvolution.h"
 #include "BLI_math.h"
 #include "MEM_guardedalloc.h"
 
@@ -210,10 +211,55 @@ void GaussianBokehBlurOperation::get_area_of_interest(const int input_idx,
   r_input_area.ymin = output_area.ymin - m_rady;
 }
 
+bool GaussianBokehBlurOperation::use_fft_convolution() const
+{
+  /* FFT can't skip pixels, so lower quality steps are faster when done directly. */
+  return QualityStepHelper::getStep() == 1 &&
+         (2 * m_radx + 1) * (2 * m_rady + 1) >= FFT_CONVOLUTION_MIN_KERNEL_AREA;
+}
+
+void GaussianBokehBlurOperation::update_memory_buffer_started(MemoryBuffer *output,
+                                                              const rcti &area,
+                                                              Span<MemoryBuffer *> inputs)
+{
+  if (!use_fft_convolution()) {
+    return;
+  }
+
+  /* Gauss table is symmetric, so it can be convolved as is. */
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, 2 * m_radx + 1, 0, 2 * m_rady + 1);
+  const MemoryBuffer kernel(m_gausstab, 1, kernel_rect);
+
+  /* Weighted colors sum is written to output, weights sum of the pixels inside the image is
+   * calculated by convolving an image mask. */
+  const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
+  convolve_fft(*input, kernel, m_radx, m_rady, *output, area);
+  MemoryBuffer image_mask(DataType::Value, input->get_rect(), true);
+  *image_mask.getBuffer() = 1.0f;
+  fft_weights_ = std::make_unique<MemoryBuffer>(DataType::Value, area);
+  convolve_fft(image_mask, kernel, m_radx, m_rady, *fft_weights_, area);
+}
+
 void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                               const rcti &area,
                                                               Span<MemoryBuffer *> inputs)
 {
+  if (fft_weights_) {
+    for (BuffersIterator<float> it = output->iterate_with({fft_weights_.get()}, area);
+         !it.is_end();
+         ++it) {
+      const float multiplier_accum = *it.in(0);
+      if (multiplier_accum > FLT_EPSILON) {
+        mul_v4_fl(it.out, 1.0f / multiplier_accum);
+      }
+      else {
+        zero_v4(it.out);
+      }
+    }
+    return;
+  }
+
   const MemoryBuffer *input = inputs[IMAGE_INPUT_INDEX];
   BuffersIterator<float> it = output->iterate_with({}, area);
   const rcti &input_rect = input->get_rect();
@@ -247,6 +293,12 @@ void GaussianBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *outp
   }
 }
 
+void GaussianBokehBlurOperation::update_memory_buffer_finished(
+    MemoryBuffer *UNUSED(output), const rcti &UNUSED(area), Span<MemoryBuffer *> UNUSED(inputs))
+{
+  fft_weights_.reset();
+}
+
 // reference image
 GaussianBlurReferenceOperation::GaussianBlurReferenceOperation()
     : BlurBaseOperation(DataType::Color)
@@ -22,6 +22,8 @@
 #include "COM_NodeOperation.h"
 #include "COM_QualityStepHelper.h"
 
+#include <memory>
+
 namespace blender::compositor {
 
 class GaussianBokehBlurOperation : public BlurBaseOperation {
@@ -30,6 +32,9 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   int m_radx, m_rady;
   float radxf_;
   float radyf_;
+  /** Sum of gaussian weights of every pixel when blurring with #convolve_fft. */
+  std::unique_ptr<MemoryBuffer> fft_weights_;
+
   void updateGauss();
 
  public:
@@ -54,9 +59,19 @@ class GaussianBokehBlurOperation : public BlurBaseOperation {
   void get_area_of_interest(const int input_idx,
                             const rcti &output_area,
                             rcti &r_input_area) override;
+  void update_memory_buffer_started(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override;
   void update_memory_buffer_partial(MemoryBuffer *output,
                                     const rcti &area,
                                     Span<MemoryBuffer *> inputs) override;
+  void update_memory_buffer_finished(MemoryBuffer *output,
+                                     const rcti &area,
+                                     Span<MemoryBuffer *> inputs) override;
+
+ protected:
+  /** Whether the blur is done with #convolve_fft rather than the direct loop. */
+  virtual bool use_fft_convolution() const;
 };
 
 class GaussianBlurReferenceOperation : public BlurBaseOperation {
@@ -18,6 +18,7 @@
 
 #include "COM_GlareStreaksOperation.h"
 #include "BLI_math.h"
+#include "BLI_task.hh"
 
 namespace blender::compositor {
 
@@ -25,9 +26,8 @@ void GlareStreaksOperation::generateGlare(float *data,
                                           MemoryBuffer *inputTile,
                                           NodeGlare *settings)
 {
-  int x, y, n;
+  int n;
   unsigned int nump = 0;
-  float c1[4], c2[4], c3[4], c4[4];
   float a, ang = DEG2RADF(360.0f) / (float)settings->streaks;
 
   int size = inputTile->getWidth() * inputTile->getHeight();
@@ -51,38 +51,42 @@ void GlareStreaksOperation::generateGlare(float *data,
       /* Color-modulation amount relative to current pass. */
       const float cmo = 1.0f - (float)pow((double)settings->colmod, (double)n + 1);
 
-      float *tdstcol = tdst.getBuffer();
-      for (y = 0; y < tsrc.getHeight() && (!breaked); y++) {
-        for (x = 0; x < tsrc.getWidth(); x++, tdstcol += 4) {
-          /* First pass no offset, always same for every pass, exact copy,
-           * otherwise results in uneven brightness, only need once. */
-          if (n == 0) {
-            tsrc.read(c1, x, y);
-          }
-          else {
-            c1[0] = c1[1] = c1[2] = 0;
-          }
-          tsrc.readBilinear(c2, x + vxp, y + vyp);
-          tsrc.readBilinear(c3, x + vxp * 2.0f, y + vyp * 2.0f);
-          tsrc.readBilinear(c4, x + vxp * 3.0f, y + vyp * 3.0f);
-          /* Modulate color to look vaguely similar to a color spectrum. */
-          c2[1] *= cmo;
-          c2[2] *= cmo;
+      /* Rows only read the previous pass, so they can be done in parallel. */
+      threading::parallel_for(IndexRange(tsrc.getHeight()), 8, [&](const IndexRange rows) {
+        float c1[4], c2[4], c3[4], c4[4];
+        for (const int64_t y : rows) {
+          float *tdstcol = tdst.getBuffer() + y * tdst.row_stride;
+          for (int x = 0; x < tsrc.getWidth(); x++, tdstcol += 4) {
+            /* First pass no offset, always same for every pass, exact copy,
+             * otherwise results in uneven brightness, only need once. */
+            if (n == 0) {
+              tsrc.read(c1, x, y);
+            }
+            else {
+              c1[0] = c1[1] = c1[2] = 0;
+            }
+            tsrc.readBilinear(c2, x + vxp, y + vyp);
+            tsrc.readBilinear(c3, x + vxp * 2.0f, y + vyp * 2.0f);
+            tsrc.readBilinear(c4, x + vxp * 3.0f, y + vyp * 3.0f);
+            /* Modulate color to look vaguely similar to a color spectrum. */
+            c2[1] *= cmo;
+            c2[2] *= cmo;
 
-          c3[0] *= cmo;
-          c3[1] *= cmo;
+            c3[0] *= cmo;
+            c3[1] *= cmo;
 
-          c4[0] *= cmo;
-          c4[2] *= cmo;
+            c4[0] *= cmo;
+            c4[2] *= cmo;
 
-          tdstcol[0] = 0.5f * (tdstcol[0] + c1[0] + wt * (c2[0] + wt * (c3[0] + wt * c4[0])));
-          tdstcol[1] = 0.5f * (tdstcol[1] + c1[1] + wt * (c2[1] + wt * (c3[1] + wt * c4[1])));
-          tdstcol[2] = 0.5f * (tdstcol[2] + c1[2] + wt * (c2[2] + wt * (c3[2] + wt * c4[2])));
-          tdstcol[3] = 1.0f;
-        }
-        if (isBraked()) {
-          breaked = true;
+            tdstcol[0] = 0.5f * (tdstcol[0] + c1[0] + wt * (c2[0] + wt * (c3[0] + wt * c4[0])));
+            tdstcol[1] = 0.5f * (tdstcol[1] + c1[1] + wt * (c2[1] + wt * (c3[1] + wt * c4[1])));
+            tdstcol[2] = 0.5f * (tdstcol[2] + c1[2] + wt * (c2[2] + wt * (c3[2] + wt * c4[2])));
+            tdstcol[3] = 1.0f;
+          }
         }
+      });
+      if (isBraked()) {
+        breaked = true;
       }
       memcpy(tsrc.getBuffer(), tdst.getBuffer(), sizeof(float) * size4);
     }
@@ -35,6 +35,7 @@ MathBaseOperation::MathBaseOperation()
   this->m_inputValue3Operation = nullptr;
   this->m_useClamp = false;
   this->flags.can_be_constant = true;
+  this->flags.is_per_pixel_operation = true;
 }
 
 void MathBaseOperation::initExecution()
@@ -73,6 +74,11 @@ void MathBaseOperation::clampIfNeeded(float *color)
   }
 }
 
+void MathBaseOperation::hash_output_params()
+{
+  hash_param(m_useClamp);
+}
+
 void MathBaseOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                      const rcti &area,
                                                      Span<MemoryBuffer *> inputs)
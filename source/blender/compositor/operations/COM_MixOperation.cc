@@ -36,6 +36,7 @@ MixBaseOperation::MixBaseOperation()
   this->setUseValueAlphaMultiply(false);
   this->setUseClamp(false);
   flags.can_be_constant = true;
+  flags.is_per_pixel_operation = true;
 }
 
 void MixBaseOperation::initExecution()
@@ -96,6 +97,11 @@ void MixBaseOperation::deinitExecution()
   this->m_inputColor2Operation = nullptr;
 }
 
+void MixBaseOperation::hash_output_params()
+{
+  hash_params(m_valueAlphaMultiply, m_useClamp);
+}
+
 void MixBaseOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                     const rcti &area,
                                                     Span<MemoryBuffer *> inputs)
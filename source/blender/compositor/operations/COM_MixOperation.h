@@ -107,6 +107,7 @@ class MixBaseOperation : public MultiThreadedOperation {
                                     Span<MemoryBuffer *> inputs) final;
 
  protected:
+  void hash_output_params() override;
   virtual void update_memory_buffer_row(PixelCursor &p);
 };
 
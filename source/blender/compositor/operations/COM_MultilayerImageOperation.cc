@@ -18,6 +18,10 @@
 
 #include "COM_MultilayerImageOperation.h"
 
+#include "BLI_string.h"
+
+#include "DNA_scene_types.h"
+
 #include "IMB_imbuf.h"
 #include "IMB_imbuf_types.h"
 
@@ -31,6 +35,8 @@ MultilayerBaseOperation::MultilayerBaseOperation(RenderLayer *render_layer,
   this->m_view = view;
   this->m_renderLayer = render_layer;
   this->m_renderPass = render_pass;
+  /* Same as render layer passes, only the combined pass is known to be color data. */
+  this->flags.use_full_precision = !STREQ(render_pass->name, RE_PASSNAME_COMBINED);
 }
 
 ImBuf *MultilayerBaseOperation::getImBuf()
@@ -55,6 +55,11 @@ class QualityStepHelper {
   {
     this->m_quality = quality;
   }
+
+  eCompositorQuality get_quality() const
+  {
+    return m_quality;
+  }
 };
 
 }  // namespace blender::compositor
@@ -23,9 +23,12 @@
 #include "BKE_image.h"
 #include "BKE_scene.h"
 
+#include "BLI_array.hh"
+#include "BLI_hash_mm2a.h"
 #include "BLI_listbase.h"
 #include "BLI_string.h"
 #include "BLI_string_ref.hh"
+#include "BLI_task.hh"
 
 #include "DNA_scene_types.h"
 
@@ -46,6 +49,9 @@ RenderLayersProg::RenderLayersProg(const char *passName, DataType type, int elem
   layer_buffer_ = nullptr;
 
   this->addOutputSocket(type);
+  /* Besides combined, passes stored in color buffers hold motion vectors, cryptomatte hashes or
+   * arbitrary AOV data. */
+  this->flags.use_full_precision = !STREQ(passName, RE_PASSNAME_COMBINED);
 }
 
 void RenderLayersProg::initExecution()
@@ -59,17 +65,9 @@ void RenderLayersProg::initExecution()
   }
 
   if (rr) {
-    ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&scene->view_layers, getLayerId());
-    if (view_layer) {
-
-      RenderLayer *rl = RE_GetRenderLayer(rr, view_layer->name);
-      if (rl) {
-        this->m_inputBuffer = RE_RenderLayerGetPass(
-            rl, this->m_passName.c_str(), this->m_viewName);
-        if (m_inputBuffer) {
-          layer_buffer_ = new MemoryBuffer(m_inputBuffer, m_elementsize, getWidth(), getHeight());
-        }
-      }
+    this->m_inputBuffer = get_pass_buffer(rr);
+    if (m_inputBuffer) {
+      layer_buffer_ = new MemoryBuffer(m_inputBuffer, m_elementsize, getWidth(), getHeight());
     }
   }
   if (re) {
@@ -78,6 +76,70 @@ void RenderLayersProg::initExecution()
   }
 }
 
+/**
+ * Get the render pass buffer of this operation from given render result, nullptr if it doesn't
+ * exist. Render result must be acquired for reading.
+ */
+float *RenderLayersProg::get_pass_buffer(RenderResult *rr)
+{
+  ViewLayer *view_layer = (ViewLayer *)BLI_findlink(&m_scene->view_layers, getLayerId());
+  RenderLayer *rl = view_layer ? RE_GetRenderLayer(rr, view_layer->name) : nullptr;
+  return rl ? RE_RenderLayerGetPass(rl, m_passName.c_str(), m_viewName) : nullptr;
+}
+
+/**
+ * Hash of the render pass content. Results depending on the render pass are identified by it,
+ * so that they are invalidated when rendering again.
+ */
+uint32_t RenderLayersProg::get_pass_content_hash()
+{
+  if (pass_content_hash_) {
+    return *pass_content_hash_;
+  }
+
+  Scene *scene = this->getScene();
+  Render *re = (scene) ? RE_GetSceneRender(scene) : nullptr;
+  RenderResult *rr = (re) ? RE_AcquireResultRead(re) : nullptr;
+  const float *buffer = (rr) ? get_pass_buffer(rr) : nullptr;
+
+  uint32_t hash = 0;
+  if (buffer) {
+    /* Hash rows in chunks of fixed size, so that the result doesn't depend on threading. */
+    constexpr int chunk_rows = 64;
+    const int height = getHeight();
+    const size_t row_len = (size_t)getWidth() * m_elementsize;
+    Array<uint32_t> chunk_hashes((height + chunk_rows - 1) / chunk_rows);
+    threading::parallel_for(chunk_hashes.index_range(), 1, [&](const IndexRange chunks) {
+      for (const int64_t chunk : chunks) {
+        const int ymin = chunk * chunk_rows;
+        const int ymax = MIN2(ymin + chunk_rows, height);
+        chunk_hashes[chunk] = BLI_hash_mm2((const unsigned char *)(buffer + ymin * row_len),
+                                           sizeof(float) * row_len * (ymax - ymin),
+                                           0);
+      }
+    });
+    hash = BLI_hash_mm2((const unsigned char *)chunk_hashes.data(),
+                        sizeof(uint32_t) * chunk_hashes.size(),
+                        0);
+  }
+
+  if (re) {
+    RE_ReleaseResult(re);
+  }
+  pass_content_hash_ = hash;
+  return hash;
+}
+
+void RenderLayersProg::hash_output_params()
+{
+  hash_params(m_layerId, m_passName, m_elementsize);
+}
+
+void RenderLayersProg::hash_output_content()
+{
+  hash_param(get_pass_content_hash());
+}
+
 void RenderLayersProg::doInterpolation(float output[4], float x, float y, PixelSampler sampler)
 {
   unsigned int offset;
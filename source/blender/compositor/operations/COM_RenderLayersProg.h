@@ -26,6 +26,8 @@
 
 #include "RE_pipeline.h"
 
+#include <optional>
+
 namespace blender::compositor {
 
 /**
@@ -65,6 +67,11 @@ class RenderLayersProg : public MultiThreadedOperation {
 
   int m_elementsize;
 
+  /**
+   * Hash of the render pass content, calculated once per execution.
+   */
+  std::optional<uint32_t> pass_content_hash_;
+
   /**
    * \brief render data used for active rendering
    */
@@ -85,6 +92,12 @@ class RenderLayersProg : public MultiThreadedOperation {
 
   void doInterpolation(float output[4], float x, float y, PixelSampler sampler);
 
+  float *get_pass_buffer(RenderResult *rr);
+  uint32_t get_pass_content_hash();
+
+  void hash_output_params() override;
+  void hash_output_content() override;
+
  public:
   /**
    * Constructor
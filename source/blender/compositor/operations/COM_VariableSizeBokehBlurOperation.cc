@@ -386,6 +386,12 @@ static void blur_pixel(int x, int y, PixelData &p)
   }
 }
 
+void VariableSizeBokehBlurOperation::hash_output_params()
+{
+  hash_params(m_maxBlur, m_threshold, m_do_size_scale);
+  hash_param(get_quality());
+}
+
 void VariableSizeBokehBlurOperation::update_memory_buffer_partial(MemoryBuffer *output,
                                                                   const rcti &area,
                                                                   Span<MemoryBuffer *> inputs)
@@ -58,6 +58,8 @@ VectorBlurOperation::VectorBlurOperation()
   this->m_inputZProgram = nullptr;
   flags.complex = true;
   flags.is_fullframe_operation = true;
+  /* Speed input holds motion vectors in a color buffer. */
+  flags.use_full_precision = true;
 }
 void VectorBlurOperation::initExecution()
 {
@@ -0,0 +1,287 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BLI_rand.hh"
+
+#include "COM_BokehBlurOperation.h"
+#include "COM_FFTConvolution.h"
+#include "COM_GaussianBokehBlurOperation.h"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::compositor::tests {
+
+static void fill_random(MemoryBuffer &buf, RandomNumberGenerator &rng)
+{
+  for (float *elem : buf.as_range()) {
+    for (int ch = 0; ch < buf.get_num_channels(); ch++) {
+      elem[ch] = rng.get_float();
+    }
+  }
+}
+
+/* Reference direct convolution, see #convolve_fft. */
+static void convolve_direct(const MemoryBuffer &image,
+                            const MemoryBuffer &kernel,
+                            const int center_x,
+                            const int center_y,
+                            MemoryBuffer &output,
+                            const rcti &area)
+{
+  const rcti &image_rect = image.get_rect();
+  const rcti &kernel_rect = kernel.get_rect();
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      float *out = output.get_elem(x, y);
+      for (int ch = 0; ch < output.get_num_channels(); ch++) {
+        const int image_ch = image.get_num_channels() == 1 ? 0 : ch;
+        const int kernel_ch = kernel.get_num_channels() == 1 ? 0 : ch;
+        float sum = 0.0f;
+        for (int j = 0; j < kernel.getHeight(); j++) {
+          for (int i = 0; i < kernel.getWidth(); i++) {
+            const int image_x = x - i + center_x;
+            const int image_y = y - j + center_y;
+            if (BLI_rcti_isect_pt(&image_rect, image_x, image_y) &&
+                image_x < image_rect.xmax && image_y < image_rect.ymax) {
+              sum += kernel.get_elem(kernel_rect.xmin + i, kernel_rect.ymin + j)[kernel_ch] *
+                     image.get_elem(image_x, image_y)[image_ch];
+            }
+          }
+        }
+        out[ch] = sum;
+      }
+    }
+  }
+}
+
+static void expect_convolutions_equal(const MemoryBuffer &image,
+                                      const MemoryBuffer &kernel,
+                                      const int center_x,
+                                      const int center_y,
+                                      const rcti &area)
+{
+  const DataType data_type = image.get_num_channels() == 1 && kernel.get_num_channels() == 1 ?
+                                 DataType::Value :
+                                 DataType::Color;
+  MemoryBuffer expected(data_type, area);
+  MemoryBuffer result(data_type, area);
+  convolve_direct(image, kernel, center_x, center_y, expected, area);
+  convolve_fft(image, kernel, center_x, center_y, result, area);
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      for (int ch = 0; ch < result.get_num_channels(); ch++) {
+        EXPECT_NEAR(result.get_elem(x, y)[ch], expected.get_elem(x, y)[ch], 1e-3f);
+      }
+    }
+  }
+}
+
+/* Operation of given size, only used as input of blur operations for their canvas. */
+class SizedOperation : public NodeOperation {
+ public:
+  SizedOperation(const int width, const int height)
+  {
+    addOutputSocket(DataType::Color);
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, width, 0, height);
+    set_canvas(canvas);
+  }
+};
+
+class TestBokehBlurOperation : public BokehBlurOperation {
+ public:
+  bool use_fft = false;
+
+ protected:
+  bool use_fft_convolution(const int UNUSED(pixel_size)) const override
+  {
+    return use_fft;
+  }
+};
+
+class TestGaussianBokehBlurOperation : public GaussianBokehBlurOperation {
+ public:
+  bool use_fft = false;
+
+ protected:
+  bool use_fft_convolution() const override
+  {
+    return use_fft;
+  }
+};
+
+/* Renders given area with both the direct loop and #convolve_fft, expecting equal results. */
+template<typename BlurOperation>
+static void expect_blur_paths_equal(BlurOperation &op,
+                                    Span<MemoryBuffer *> inputs,
+                                    const rcti &area)
+{
+  MemoryBuffer expected(DataType::Color, area);
+  MemoryBuffer result(DataType::Color, area);
+  op.use_fft = false;
+  op.update_memory_buffer_started(&expected, area, inputs);
+  op.update_memory_buffer_partial(&expected, area, inputs);
+  op.update_memory_buffer_finished(&expected, area, inputs);
+  op.use_fft = true;
+  op.update_memory_buffer_started(&result, area, inputs);
+  op.update_memory_buffer_partial(&result, area, inputs);
+  op.update_memory_buffer_finished(&result, area, inputs);
+
+  for (int y = area.ymin; y < area.ymax; y++) {
+    for (int x = area.xmin; x < area.xmax; x++) {
+      for (int ch = 0; ch < COM_DATA_TYPE_COLOR_CHANNELS; ch++) {
+        EXPECT_NEAR(result.get_elem(x, y)[ch], expected.get_elem(x, y)[ch], 1e-3f);
+      }
+    }
+  }
+}
+
+TEST(FFTConvolution, ColorKernel)
+{
+  RandomNumberGenerator rng(1);
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 3, 40, -5, 25);
+  MemoryBuffer image(DataType::Color, image_rect);
+  fill_random(image, rng);
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, 7, 0, 5);
+  MemoryBuffer kernel(DataType::Color, kernel_rect);
+  fill_random(kernel, rng);
+
+  expect_convolutions_equal(image, kernel, 3, 2, image_rect);
+  /* Area outside of the image rect. */
+  rcti area;
+  BLI_rcti_init(&area, 0, 45, -10, 20);
+  expect_convolutions_equal(image, kernel, 6, 0, area);
+}
+
+TEST(FFTConvolution, ValueKernel)
+{
+  RandomNumberGenerator rng(2);
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 0, 30, 0, 20);
+  MemoryBuffer image(DataType::Color, image_rect);
+  fill_random(image, rng);
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, 9, 0, 9);
+  MemoryBuffer kernel(DataType::Value, kernel_rect);
+  fill_random(kernel, rng);
+
+  rcti area;
+  BLI_rcti_init(&area, 5, 20, 8, 12);
+  expect_convolutions_equal(image, kernel, 4, 4, area);
+}
+
+TEST(FFTConvolution, MultipleBlocks)
+{
+  /* Image bigger than the transform size, so it's convolved in blocks. */
+  RandomNumberGenerator rng(3);
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 0, 300, 0, 270);
+  MemoryBuffer image(DataType::Value, image_rect);
+  fill_random(image, rng);
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, 4, 0, 3);
+  MemoryBuffer kernel(DataType::Value, kernel_rect);
+  fill_random(kernel, rng);
+
+  expect_convolutions_equal(image, kernel, 1, 1, image_rect);
+}
+
+TEST(FFTConvolution, ZeroKernelChannel)
+{
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 0, 8, 0, 8);
+  MemoryBuffer image(DataType::Color, image_rect);
+  image.fill(image_rect, COM_COLOR_BLACK);
+  rcti kernel_rect;
+  BLI_rcti_init(&kernel_rect, 0, 3, 0, 3);
+  MemoryBuffer kernel(DataType::Color, kernel_rect);
+  const float kernel_color[4] = {1.0f, 1.0f, 1.0f, 0.0f};
+  kernel.fill(kernel_rect, kernel_color);
+
+  MemoryBuffer result(DataType::Color, image_rect);
+  convolve_fft(image, kernel, 1, 1, result, image_rect);
+  EXPECT_FLOAT_EQ(result.get_elem(4, 4)[3], 0.0f);
+  EXPECT_FLOAT_EQ(result.get_elem(0, 0)[3], 0.0f);
+}
+
+TEST(FFTConvolution, BokehBlur)
+{
+  RandomNumberGenerator rng(4);
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 0, 40, 0, 30);
+  MemoryBuffer image(DataType::Color, image_rect);
+  fill_random(image, rng);
+  rcti bokeh_rect;
+  BLI_rcti_init(&bokeh_rect, 0, 16, 0, 16);
+  MemoryBuffer bokeh(DataType::Color, bokeh_rect);
+  fill_random(bokeh, rng);
+  float bounding_box = 1.0f;
+  MemoryBuffer bounding_box_input(&bounding_box, 1, image_rect, true);
+
+  SizedOperation bokeh_op(BLI_rcti_size_x(&bokeh_rect), BLI_rcti_size_y(&bokeh_rect));
+  TestBokehBlurOperation op;
+  op.getInputSocket(1)->setLink(bokeh_op.getOutputSocket());
+  op.set_execution_model(eExecutionModel::FullFrame);
+  op.set_canvas(image_rect);
+  /* Blur window of 2 * 10 pixels. */
+  op.setSize(25.0f);
+  op.init_data();
+  op.initExecution();
+
+  const Vector<MemoryBuffer *> inputs = {&image, &bokeh, &bounding_box_input};
+  expect_blur_paths_equal(op, inputs, image_rect);
+  rcti area;
+  BLI_rcti_init(&area, 5, 15, 20, 30);
+  expect_blur_paths_equal(op, inputs, area);
+  op.deinitExecution();
+}
+
+TEST(FFTConvolution, GaussianBokehBlur)
+{
+  RandomNumberGenerator rng(5);
+  rcti image_rect;
+  BLI_rcti_init(&image_rect, 0, 40, 0, 30);
+  MemoryBuffer image(DataType::Color, image_rect);
+  fill_random(image, rng);
+
+  NodeBlurData data = {};
+  data.sizex = 9;
+  data.sizey = 6;
+  data.filtertype = R_FILTER_GAUSS;
+  TestGaussianBokehBlurOperation op;
+  op.setData(&data);
+  op.set_execution_model(eExecutionModel::FullFrame);
+  op.set_canvas(image_rect);
+  op.setSize(1.0f);
+  op.init_data();
+  op.initExecution();
+
+  const Vector<MemoryBuffer *> inputs = {&image};
+  expect_blur_paths_equal(op, inputs, image_rect);
+  rcti area;
+  BLI_rcti_init(&area, 30, 40, 0, 12);
+  expect_blur_paths_equal(op, inputs, area);
+  op.deinitExecution();
+}
+
+}  // namespace blender::compositor::tests
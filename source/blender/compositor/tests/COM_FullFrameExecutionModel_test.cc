@@ -0,0 +1,192 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_ExecutionSystem.h"
+#include "COM_FullFrameExecutionModel.h"
+#include "COM_SharedOperationBuffers.h"
+
+#include "BLI_math_vector.h"
+
+#include "DNA_node_types.h"
+#include "DNA_scene_types.h"
+
+namespace blender::compositor::tests {
+
+constexpr int FRAME_WIDTH = 3;
+constexpr int FRAME_HEIGHT = 7;
+/* Rows of each band, the last band is smaller. */
+constexpr int BAND_HEIGHT = 2;
+
+/* Full frame operation with frame size canvas. */
+class FrameOperation : public NodeOperation {
+ public:
+  FrameOperation(const int id, const int num_inputs, const bool has_output)
+  {
+    set_id(id);
+    for (int i = 0; i < num_inputs; i++) {
+      addInputSocket(DataType::Color);
+    }
+    if (has_output) {
+      addOutputSocket(DataType::Color);
+    }
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, FRAME_WIDTH, 0, FRAME_HEIGHT);
+    set_canvas(canvas);
+    flags.is_fullframe_operation = true;
+  }
+};
+
+/* Renders elements coordinates. */
+class CoordsOperation : public FrameOperation {
+ public:
+  CoordsOperation(const int id) : FrameOperation(id, 0, true)
+  {
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> UNUSED(inputs)) override
+  {
+    for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+      const float coords[4] = {(float)it.x, (float)it.y, 0.0f, 1.0f};
+      copy_v4_v4(it.out, coords);
+    }
+  }
+};
+
+/* Flips input vertically, so that any output row reads the whole input. */
+class FlipOperation : public FrameOperation {
+ public:
+  FlipOperation(const int id) : FrameOperation(id, 1, true)
+  {
+  }
+
+  void get_area_of_interest(const int input_idx,
+                            const rcti &UNUSED(output_area),
+                            rcti &r_input_area) override
+  {
+    r_input_area = get_input_operation(input_idx)->get_canvas();
+  }
+
+  void update_memory_buffer(MemoryBuffer *output,
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override
+  {
+    for (BuffersIterator<float> it = output->iterate_with({}, area); !it.is_end(); ++it) {
+      inputs[0]->read_elem(it.x, FRAME_HEIGHT - 1 - it.y, it.out);
+    }
+  }
+};
+
+/* Writes input into a frame allocated on initialization and kept on deinitialization, like
+ * compositor and file outputs do. */
+class FrameOutputOperation : public FrameOperation {
+ private:
+  Vector<float> frame_;
+
+ public:
+  Vector<float> result;
+  int num_inits = 0;
+
+  FrameOutputOperation(const int id) : FrameOperation(id, 1, false)
+  {
+  }
+
+  bool isOutputOperation(bool UNUSED(rendering)) const override
+  {
+    return true;
+  }
+
+  void initExecution() override
+  {
+    num_inits++;
+    frame_ = Vector<float>(FRAME_WIDTH * FRAME_HEIGHT * COM_DATA_TYPE_COLOR_CHANNELS, 0.0f);
+  }
+
+  void deinitExecution() override
+  {
+    result = std::move(frame_);
+  }
+
+  void update_memory_buffer(MemoryBuffer *UNUSED(output),
+                            const rcti &area,
+                            Span<MemoryBuffer *> inputs) override
+  {
+    MemoryBuffer frame_buf(frame_.data(), COM_DATA_TYPE_COLOR_CHANNELS, FRAME_WIDTH, FRAME_HEIGHT);
+    frame_buf.copy_from(inputs[0], area);
+  }
+};
+
+static void no_progress(void *UNUSED(handle), float UNUSED(progress))
+{
+}
+
+static void no_stats_draw(void *UNUSED(handle), const char *UNUSED(str))
+{
+}
+
+static int no_break(void *UNUSED(handle))
+{
+  return 0;
+}
+
+TEST(FullFrameExecutionModel, StreamingRendersWholeOutput)
+{
+  bNodeTree tree = {};
+  tree.flag = NTREE_COM_STREAMING;
+  tree.chunksize = BAND_HEIGHT;
+  tree.progress = no_progress;
+  tree.stats_draw = no_stats_draw;
+  tree.test_break = no_break;
+  RenderData rd = {};
+  ExecutionSystem exec_system(&rd, nullptr, &tree, false, false, nullptr, nullptr, "", nullptr);
+
+  CompositorContext context;
+  context.setbNodeTree(&tree);
+  context.setRenderData(&rd);
+  context.setRendering(false);
+  context.setFastCalculation(false);
+
+  CoordsOperation coords(0);
+  FlipOperation flip(1);
+  FrameOutputOperation output(2);
+  flip.getInputSocket(0)->setLink(coords.getOutputSocket());
+  output.getInputSocket(0)->setLink(flip.getOutputSocket());
+  const Vector<NodeOperation *> operations = {&coords, &flip, &output};
+
+  SharedOperationBuffers shared_buffers;
+  FullFrameExecutionModel model(context, shared_buffers, operations);
+  model.execute(exec_system);
+
+  /* Output is initialized once for all bands, each band writing its rows. */
+  EXPECT_EQ(output.num_inits, 1);
+  ASSERT_EQ(output.result.size(), FRAME_WIDTH * FRAME_HEIGHT * COM_DATA_TYPE_COLOR_CHANNELS);
+  for (int y = 0; y < FRAME_HEIGHT; y++) {
+    for (int x = 0; x < FRAME_WIDTH; x++) {
+      const float *elem = &output.result[(y * FRAME_WIDTH + x) * COM_DATA_TYPE_COLOR_CHANNELS];
+      EXPECT_EQ(elem[0], x);
+      EXPECT_EQ(elem[1], FRAME_HEIGHT - 1 - y);
+      EXPECT_EQ(elem[2], 0.0f);
+      EXPECT_EQ(elem[3], 1.0f);
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,91 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_MemoryBuffer.h"
+
+namespace blender::compositor::tests {
+
+static MemoryBuffer create_half_float_buffer(const rcti &rect, const float *values)
+{
+  MemoryBuffer buf(DataType::Color, rect);
+  int i = 0;
+  for (float *elem : buf.as_range()) {
+    copy_v4_v4(elem, &values[i]);
+    i += 4;
+  }
+  buf.convert_to_half_float();
+  return buf;
+}
+
+TEST(MemoryBuffer, HalfFloatReadElem)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, -1, 1, 2, 3);
+  const float values[] = {0.0f, 1.0f, -2.5f, 0.125f, 65504.0f, 1e6f, 1e-8f, 0.1f};
+  MemoryBuffer buf = create_half_float_buffer(rect, values);
+  EXPECT_TRUE(buf.is_half_float());
+
+  float elem[4];
+  buf.read_elem(-1, 2, elem);
+  EXPECT_EQ(elem[0], 0.0f);
+  EXPECT_EQ(elem[1], 1.0f);
+  EXPECT_EQ(elem[2], -2.5f);
+  EXPECT_EQ(elem[3], 0.125f);
+
+  buf.read_elem(0, 2, elem);
+  /* Largest half float, overflow, underflow and rounding. */
+  EXPECT_EQ(elem[0], 65504.0f);
+  EXPECT_EQ(elem[1], std::numeric_limits<float>::infinity());
+  EXPECT_EQ(elem[2], 0.0f);
+  EXPECT_NEAR(elem[3], 0.1f, 1e-4f);
+
+  buf.read_elem_checked(1, 2, elem);
+  EXPECT_EQ(elem[0], 0.0f);
+}
+
+TEST(MemoryBuffer, HalfFloatCopy)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, 2, 0, 1);
+  const float values[] = {0.5f, 0.25f, 3.0f, 1.0f, 2.0f, -4.0f, 1e-5f, 0.0f};
+  const MemoryBuffer half_buf = create_half_float_buffer(rect, values);
+
+  /* Copies are full float. */
+  MemoryBuffer copy(half_buf);
+  EXPECT_FALSE(copy.is_half_float());
+  EXPECT_EQ(copy.get_elem(0, 0)[2], 3.0f);
+  EXPECT_EQ(copy.get_elem(1, 0)[1], -4.0f);
+  EXPECT_NEAR(copy.get_elem(1, 0)[2], 1e-5f, 1e-7f);
+
+  rcti to_rect;
+  BLI_rcti_init(&to_rect, 10, 12, 5, 6);
+  MemoryBuffer translated(DataType::Color, to_rect);
+  translated.copy_from(&half_buf, rect, 10, 5);
+  EXPECT_EQ(translated.get_elem(10, 5)[0], 0.5f);
+  EXPECT_EQ(translated.get_elem(11, 5)[0], 2.0f);
+
+  /* Single channel copy. */
+  MemoryBuffer value(DataType::Value, rect);
+  value.copy_from(&half_buf, rect, 1, 1, 0);
+  EXPECT_EQ(*value.get_elem(0, 0), 0.25f);
+  EXPECT_EQ(*value.get_elem(1, 0), -4.0f);
+}
+
+}  // namespace blender::compositor::tests
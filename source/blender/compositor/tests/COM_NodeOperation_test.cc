@@ -86,6 +86,23 @@ class HashedOperation : public NodeOperation {
   }
 };
 
+/* Reads content that may change between executions, like render passes. */
+class ContentHashedOperation : public HashedOperation {
+ public:
+  int content = 0;
+  int num_content_hashes = 0;
+
+  ContentHashedOperation(NodeOperation &input) : HashedOperation(input, 6, 4)
+  {
+  }
+
+  void hash_output_content() override
+  {
+    num_content_hashes++;
+    hash_param(content);
+  }
+};
+
 static void test_non_equal_hashes_compare(NodeOperationHash &h1,
                                           NodeOperationHash &h2,
                                           NodeOperationHash &h3)
@@ -166,4 +183,23 @@ TEST(NodeOperation, generate_hash)
   }
 }
 
+TEST(NodeOperation, generate_hash_content)
+{
+  NonHashedOperation input_op(1);
+  ContentHashedOperation op(input_op);
+
+  /* Content is only hashed when requested, e.g. not when merging equal operations. */
+  const NodeOperationHash hash1 = *op.generate_hash();
+  EXPECT_EQ(op.num_content_hashes, 0);
+  op.content = 1;
+  EXPECT_EQ(*op.generate_hash(), hash1);
+  EXPECT_EQ(op.num_content_hashes, 0);
+
+  const NodeOperationHash content_hash1 = *op.generate_hash(true);
+  EXPECT_EQ(op.num_content_hashes, 1);
+  EXPECT_NE(content_hash1, hash1);
+  op.content = 2;
+  EXPECT_NE(*op.generate_hash(true), content_hash1);
+}
+
 }  // namespace blender::compositor::tests
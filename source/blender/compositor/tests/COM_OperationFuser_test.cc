@@ -0,0 +1,216 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "DNA_node_types.h"
+
+#include "COM_CompositorContext.h"
+#include "COM_FusedOperation.h"
+#include "COM_NodeOperationBuilder.h"
+#include "COM_OperationFuser.h"
+
+namespace blender::compositor::tests {
+
+static rcti create_canvas(const int width, const int height)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, 0, width, 0, height);
+  return rect;
+}
+
+class SourceOperation : public NodeOperation {
+ public:
+  SourceOperation(const rcti &canvas)
+  {
+    addOutputSocket(DataType::Value);
+    set_canvas(canvas);
+  }
+};
+
+/** Per-pixel operation computing `input * scale + offset`. */
+class ScaleOperation : public MultiThreadedOperation {
+ private:
+  float scale_;
+  float offset_;
+
+ public:
+  ScaleOperation(const rcti &canvas, const float scale, const float offset)
+      : scale_(scale), offset_(offset)
+  {
+    addInputSocket(DataType::Value);
+    addOutputSocket(DataType::Value);
+    set_canvas(canvas);
+    flags.is_per_pixel_operation = true;
+  }
+
+  void update_memory_buffer_partial(MemoryBuffer *output,
+                                    const rcti &area,
+                                    Span<MemoryBuffer *> inputs) override
+  {
+    for (BuffersIterator<float> it = output->iterate_with(inputs, area); !it.is_end(); ++it) {
+      *it.out = *it.in(0) * scale_ + offset_;
+    }
+  }
+};
+
+class TestFusedOperation : public FusedOperation {
+ public:
+  using FusedOperation::FusedOperation;
+  using FusedOperation::update_memory_buffer_partial;
+};
+
+static void link(NodeOperation &from, NodeOperation &to)
+{
+  to.getInputSocket(0)->setLink(from.getOutputSocket());
+}
+
+TEST(OperationFuser, FusedEqualsUnfused)
+{
+  const rcti canvas = create_canvas(5, 3);
+
+  MemoryBuffer input(DataType::Value, canvas);
+  for (BuffersIterator<float> it = input.iterate_with({}); !it.is_end(); ++it) {
+    *it.out = it.x * 0.5f + it.y * 3.0f;
+  }
+
+  SourceOperation source(canvas);
+  ScaleOperation *op1 = new ScaleOperation(canvas, 2.0f, 1.0f);
+  ScaleOperation *op2 = new ScaleOperation(canvas, -0.5f, 4.0f);
+  ScaleOperation *op3 = new ScaleOperation(canvas, 3.0f, -2.0f);
+  link(source, *op1);
+  link(*op1, *op2);
+  link(*op2, *op3);
+
+  /* Unfused chain with a full buffer for every intermediate result. */
+  MemoryBuffer buf1(DataType::Value, canvas);
+  MemoryBuffer buf2(DataType::Value, canvas);
+  MemoryBuffer unfused_output(DataType::Value, canvas);
+  op1->update_memory_buffer_partial(&buf1, canvas, {&input});
+  op2->update_memory_buffer_partial(&buf2, canvas, {&buf1});
+  op3->update_memory_buffer_partial(&unfused_output, canvas, {&buf2});
+
+  /* Fused chain, rendered in two areas as it would be by different threads. */
+  TestFusedOperation fused({op1, op2, op3});
+  ASSERT_EQ(fused.getNumberOfInputSockets(), 1);
+  MemoryBuffer fused_output(DataType::Value, canvas);
+  rcti area1, area2;
+  BLI_rcti_init(&area1, 0, 5, 0, 2);
+  BLI_rcti_init(&area2, 0, 5, 2, 3);
+  fused.update_memory_buffer_partial(&fused_output, area1, {&input});
+  fused.update_memory_buffer_partial(&fused_output, area2, {&input});
+
+  for (int y = canvas.ymin; y < canvas.ymax; y++) {
+    for (int x = canvas.xmin; x < canvas.xmax; x++) {
+      EXPECT_EQ(*fused_output.get_elem(x, y), *unfused_output.get_elem(x, y));
+    }
+  }
+}
+
+class OperationFuserTest : public testing::Test {
+ protected:
+  bNodeTree tree_ = {};
+  CompositorContext context_;
+  std::unique_ptr<NodeOperationBuilder> builder_;
+
+  void SetUp() override
+  {
+    context_.setbNodeTree(&tree_);
+    context_.setRendering(false);
+    builder_ = std::make_unique<NodeOperationBuilder>(&context_, &tree_, nullptr);
+  }
+
+  void TearDown() override
+  {
+    for (NodeOperation *op : builder_->get_operations()) {
+      delete op;
+    }
+  }
+
+  template<typename T> T *add(T *operation)
+  {
+    builder_->addOperation(operation);
+    return operation;
+  }
+
+  void add_link(NodeOperation *from, NodeOperation *to)
+  {
+    builder_->addLink(from->getOutputSocket(), to->getInputSocket(0));
+  }
+
+  int fuse()
+  {
+    OperationFuser fuser(*builder_);
+    return fuser.fuse_operations();
+  }
+};
+
+TEST_F(OperationFuserTest, FuseChain)
+{
+  const rcti canvas = create_canvas(4, 4);
+  SourceOperation *source = add(new SourceOperation(canvas));
+  ScaleOperation *op1 = add(new ScaleOperation(canvas, 2.0f, 0.0f));
+  ScaleOperation *op2 = add(new ScaleOperation(canvas, 3.0f, 0.0f));
+  add_link(source, op1);
+  add_link(op1, op2);
+
+  EXPECT_EQ(fuse(), 1);
+  ASSERT_EQ(builder_->get_operations().size(), 2);
+  EXPECT_TRUE(builder_->get_operations().contains(source));
+
+  const FusedOperation *fused = nullptr;
+  for (NodeOperation *op : builder_->get_operations()) {
+    if (op != source) {
+      fused = dynamic_cast<FusedOperation *>(op);
+    }
+  }
+  ASSERT_NE(fused, nullptr);
+  ASSERT_EQ(fused->get_operations().size(), 2);
+  EXPECT_EQ(fused->get_operations()[0], op1);
+  EXPECT_EQ(fused->get_operations()[1], op2);
+}
+
+TEST_F(OperationFuserTest, NoFusionWithMultipleReaders)
+{
+  const rcti canvas = create_canvas(4, 4);
+  SourceOperation *source = add(new SourceOperation(canvas));
+  ScaleOperation *op1 = add(new ScaleOperation(canvas, 2.0f, 0.0f));
+  ScaleOperation *op2 = add(new ScaleOperation(canvas, 3.0f, 0.0f));
+  ScaleOperation *op3 = add(new ScaleOperation(canvas, 4.0f, 0.0f));
+  add_link(source, op1);
+  add_link(op1, op2);
+  add_link(op1, op3);
+
+  /* op1 result is needed by two operations, so it has to be kept in a full buffer. */
+  EXPECT_EQ(fuse(), 0);
+  EXPECT_EQ(builder_->get_operations().size(), 4);
+}
+
+TEST_F(OperationFuserTest, NoFusionAcrossCanvasChange)
+{
+  SourceOperation *source = add(new SourceOperation(create_canvas(4, 4)));
+  ScaleOperation *op1 = add(new ScaleOperation(create_canvas(4, 4), 2.0f, 0.0f));
+  ScaleOperation *op2 = add(new ScaleOperation(create_canvas(8, 8), 3.0f, 0.0f));
+  add_link(source, op1);
+  add_link(op1, op2);
+
+  EXPECT_EQ(fuse(), 0);
+  EXPECT_EQ(builder_->get_operations().size(), 3);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_NodeOperation.h"
+#include "COM_RenderOrder.h"
+
+namespace blender::compositor::tests {
+
+class TestOperation : public NodeOperation {
+ public:
+  TestOperation(const int num_inputs, const int size)
+  {
+    for (int i = 0; i < num_inputs; i++) {
+      addInputSocket(DataType::Color);
+    }
+    addOutputSocket(DataType::Color);
+    rcti canvas;
+    BLI_rcti_init(&canvas, 0, size, 0, size);
+    set_canvas(canvas);
+  }
+};
+
+static void link(NodeOperation &from, NodeOperation &to, const int input_index)
+{
+  to.getInputSocket(input_index)->setLink(from.getOutputSocket());
+}
+
+static bool no_result_available(NodeOperation *UNUSED(op))
+{
+  return false;
+}
+
+/**
+ * Every operation is ordered once and after all the operations it reads.
+ */
+static void expect_dependencies_first(Span<NodeOperation *> order)
+{
+  for (const int64_t i : order.index_range()) {
+    NodeOperation *op = order[i];
+    EXPECT_EQ(order.first_index(op), i);
+    for (int j = 0; j < op->getNumberOfInputSockets(); j++) {
+      const int64_t input_index = order.first_index_try(op->get_input_operation(j));
+      EXPECT_NE(input_index, -1);
+      EXPECT_LT(input_index, i);
+    }
+  }
+}
+
+/**
+ * Simulates rendering operations in given order, keeping results alive until their last reader is
+ * rendered. Returns peak memory.
+ */
+static size_t simulate_peak_mem(Span<NodeOperation *> order)
+{
+  Map<NodeOperation *, int> reads_left;
+  for (NodeOperation *op : order) {
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      reads_left.lookup_or_add(op->get_input_operation(i), 0)++;
+    }
+  }
+
+  size_t mem = 0;
+  size_t peak = 0;
+  for (NodeOperation *op : order) {
+    mem += RenderOrder::get_result_mem_size(op);
+    peak = MAX2(peak, mem);
+    for (int i = 0; i < op->getNumberOfInputSockets(); i++) {
+      NodeOperation *input_op = op->get_input_operation(i);
+      if (--reads_left.lookup(input_op) == 0) {
+        mem -= RenderOrder::get_result_mem_size(input_op);
+      }
+    }
+  }
+  return peak;
+}
+
+TEST(RenderOrder, DependenciesFirst)
+{
+  /* Diamond: source is read by both branches, and branch_b also by output. */
+  TestOperation source(0, 4);
+  TestOperation branch_a(1, 4);
+  TestOperation branch_b(1, 4);
+  TestOperation mix(2, 4);
+  TestOperation output(2, 4);
+  link(source, branch_a, 0);
+  link(source, branch_b, 0);
+  link(branch_a, mix, 0);
+  link(branch_b, mix, 1);
+  link(mix, output, 0);
+  link(branch_b, output, 1);
+
+  RenderOrder order;
+  order.append(&output, no_result_available);
+  /* Appending already ordered operations doesn't change the order. */
+  order.append(&branch_b, no_result_available);
+  order.append(&output, no_result_available);
+
+  EXPECT_EQ(order.size(), 5);
+  expect_dependencies_first(order.get_operations());
+  EXPECT_EQ(order.get_operations().last(), &output);
+}
+
+TEST(RenderOrder, LowerPeakMemory)
+{
+  /*
+   * output reads a leaf and a branch that needs two large inputs. Rendering inputs in socket
+   * order keeps the leaf result alive while rendering the whole branch.
+   */
+  TestOperation leaf(0, 8);
+  TestOperation large_a(0, 8);
+  TestOperation large_b(0, 8);
+  TestOperation branch(2, 8);
+  TestOperation output(2, 8);
+  link(large_a, branch, 0);
+  link(large_b, branch, 1);
+  link(leaf, output, 0);
+  link(branch, output, 1);
+
+  RenderOrder order;
+  order.append(&output, no_result_available);
+  expect_dependencies_first(order.get_operations());
+  EXPECT_EQ(order.get_operations().first(), &large_a);
+
+  const Vector<NodeOperation *> socket_order = {&leaf, &large_a, &large_b, &branch, &output};
+  expect_dependencies_first(socket_order);
+
+  const size_t result_size = RenderOrder::get_result_mem_size(&output);
+  EXPECT_EQ(result_size, 8 * 8 * 4 * sizeof(float));
+  EXPECT_EQ(simulate_peak_mem(socket_order), 4 * result_size);
+  EXPECT_EQ(simulate_peak_mem(order.get_operations()), 3 * result_size);
+}
+
+TEST(RenderOrder, AvailableResultSkipsInputs)
+{
+  TestOperation source(0, 4);
+  TestOperation cached(1, 4);
+  TestOperation output(1, 4);
+  link(source, cached, 0);
+  link(cached, output, 0);
+
+  RenderOrder order;
+  order.append(&output, [&](NodeOperation *op) { return op == &cached; });
+  ASSERT_EQ(order.size(), 2);
+  EXPECT_EQ(order.get_operations()[0], &cached);
+  EXPECT_EQ(order.get_operations()[1], &output);
+
+  order.clear();
+  EXPECT_EQ(order.size(), 0);
+  order.append(&output, no_result_available);
+  EXPECT_EQ(order.size(), 3);
+  expect_dependencies_first(order.get_operations());
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "COM_ResultCache.h"
+#include "COM_buffer_test_utils.h"
+
+namespace blender::compositor::tests {
+
+static ResultCache::ResultKey create_key(const size_t result_hash)
+{
+  ResultCache::ResultKey key;
+  key.result_hash = result_hash;
+  key.type_hash = 1;
+  key.params_hash = 2;
+  BLI_rcti_init(&key.canvas, 0, 2, 0, 2);
+  return key;
+}
+
+TEST(ResultCache, AddAndGet)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_EQ(cache.get_result(create_key(1)), nullptr);
+
+  std::unique_ptr<MemoryBuffer> buf = create_test_buffer(3.0f);
+  EXPECT_TRUE(cache.add_result(create_key(1), *buf));
+  EXPECT_EQ(cache.get_num_results(), 1);
+  EXPECT_EQ(cache.get_mem_used(), TEST_BUFFER_MEM_SIZE);
+
+  /* Result is a copy of the added buffer. */
+  buf->fill(buf->get_rect(), COM_COLOR_TRANSPARENT);
+  MemoryBuffer *result = cache.get_result(create_key(1));
+  ASSERT_NE(result, nullptr);
+  EXPECT_NE(result->getBuffer(), buf->getBuffer());
+  expect_test_buffer(*result, 3.0f);
+
+  /* Adding an existing result doesn't use more memory. */
+  EXPECT_TRUE(cache.add_result(create_key(1), *buf));
+  EXPECT_EQ(cache.get_mem_used(), TEST_BUFFER_MEM_SIZE);
+}
+
+TEST(ResultCache, DiscardLeastRecentlyUsed)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(2), *create_test_buffer(2.0f)));
+
+  cache.begin_execution();
+  EXPECT_NE(cache.get_result(create_key(1)), nullptr);
+  EXPECT_TRUE(cache.add_result(create_key(3), *create_test_buffer(3.0f)));
+  EXPECT_EQ(cache.get_num_results(), 2);
+  EXPECT_EQ(cache.get_mem_used(), 2 * TEST_BUFFER_MEM_SIZE);
+  EXPECT_NE(cache.get_result(create_key(1)), nullptr);
+  EXPECT_EQ(cache.get_result(create_key(2)), nullptr);
+  EXPECT_NE(cache.get_result(create_key(3)), nullptr);
+}
+
+TEST(ResultCache, KeepResultsInUse)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+  EXPECT_TRUE(cache.add_result(create_key(2), *create_test_buffer(2.0f)));
+
+  /* Results used by current execution are not discarded. */
+  EXPECT_FALSE(cache.add_result(create_key(3), *create_test_buffer(3.0f)));
+  EXPECT_EQ(cache.get_num_results(), 2);
+
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(3), *create_test_buffer(3.0f)));
+  EXPECT_EQ(cache.get_num_results(), 2);
+
+  /* Results larger than the memory limit are never cached. */
+  ResultCache small_cache(TEST_BUFFER_MEM_SIZE / 2);
+  small_cache.begin_execution();
+  EXPECT_FALSE(small_cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+  EXPECT_EQ(small_cache.get_mem_used(), 0);
+}
+
+TEST(ResultCache, HashCollision)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+
+  /* Results of other operations with the same hash are not returned. */
+  ResultCache::ResultKey key = create_key(1);
+  key.type_hash = 3;
+  EXPECT_EQ(cache.get_result(key), nullptr);
+
+  key = create_key(1);
+  key.params_hash = 3;
+  EXPECT_EQ(cache.get_result(key), nullptr);
+
+  key = create_key(1);
+  BLI_rcti_init(&key.canvas, 1, 3, 0, 2);
+  EXPECT_EQ(cache.get_result(key), nullptr);
+
+  EXPECT_NE(cache.get_result(create_key(1)), nullptr);
+}
+
+TEST(ResultCache, LowerMemLimit)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(2), *create_test_buffer(2.0f)));
+
+  /* Least recently used results exceeding the new limit are discarded on next execution. */
+  cache.set_mem_limit(TEST_BUFFER_MEM_SIZE);
+  EXPECT_EQ(cache.get_num_results(), 2);
+  cache.begin_execution();
+  EXPECT_EQ(cache.get_num_results(), 1);
+  EXPECT_EQ(cache.get_mem_used(), TEST_BUFFER_MEM_SIZE);
+  EXPECT_EQ(cache.get_result(create_key(1)), nullptr);
+  EXPECT_NE(cache.get_result(create_key(2)), nullptr);
+}
+
+TEST(ResultCache, Clear)
+{
+  ResultCache cache(2 * TEST_BUFFER_MEM_SIZE);
+  cache.begin_execution();
+  EXPECT_TRUE(cache.add_result(create_key(1), *create_test_buffer(1.0f)));
+  cache.clear();
+  EXPECT_EQ(cache.get_num_results(), 0);
+  EXPECT_EQ(cache.get_mem_used(), 0);
+  EXPECT_EQ(cache.get_result(create_key(1)), nullptr);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,87 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#include "testing/testing.h"
+
+#include "BKE_appdir.h"
+
+#include "COM_StreamedResults.h"
+#include "COM_buffer_test_utils.h"
+
+namespace blender::compositor::tests {
+
+class StreamedResultsTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite()
+  {
+    BKE_tempdir_init("");
+  }
+};
+
+TEST_F(StreamedResultsTest, KeepInMemory)
+{
+  StreamedResults results(BKE_tempdir_session(), 2 * TEST_BUFFER_MEM_SIZE);
+  EXPECT_FALSE(results.contains(1));
+
+  std::unique_ptr<MemoryBuffer> buf = create_test_buffer(3.0f);
+  const float *data = buf->getBuffer();
+  results.add_result(1, std::move(buf));
+  EXPECT_TRUE(results.contains(1));
+  EXPECT_EQ(results.get_mem_used(), TEST_BUFFER_MEM_SIZE);
+  EXPECT_EQ(results.get_num_files(), 0);
+
+  /* Result in memory is returned as a view. */
+  std::unique_ptr<MemoryBuffer> result = results.get_result(1, TEST_BUFFER_YMIN, TEST_BUFFER_YMAX);
+  EXPECT_EQ(result->getBuffer(), data);
+  expect_test_buffer(*result, 3.0f);
+}
+
+TEST_F(StreamedResultsTest, StoreInFile)
+{
+  StreamedResults results(BKE_tempdir_session(), TEST_BUFFER_MEM_SIZE);
+  results.add_result(1, create_test_buffer(1.0f));
+  results.add_result(2, create_test_buffer(2.0f));
+  EXPECT_EQ(results.get_mem_used(), TEST_BUFFER_MEM_SIZE);
+  EXPECT_EQ(results.get_num_files(), 1);
+
+  /* Results are read again every time they are requested. */
+  for (int i = 0; i < 2; i++) {
+    std::unique_ptr<MemoryBuffer> result = results.get_result(
+        2, TEST_BUFFER_YMIN, TEST_BUFFER_YMAX);
+    expect_test_buffer(*result, 2.0f);
+  }
+  expect_test_buffer(*results.get_result(1, TEST_BUFFER_YMIN, TEST_BUFFER_YMAX), 1.0f);
+}
+
+TEST_F(StreamedResultsTest, ReadBandFromFile)
+{
+  StreamedResults results(BKE_tempdir_session(), 0);
+  results.add_result(1, create_test_buffer(1.0f));
+  EXPECT_EQ(results.get_num_files(), 1);
+
+  /* Only requested rows are read, in a buffer of the band size. */
+  std::unique_ptr<MemoryBuffer> band = results.get_result(1, 3, 5);
+  EXPECT_EQ(band->get_mem_size(), TEST_BUFFER_MEM_SIZE / 2);
+  expect_test_buffer(*band, 1.0f, 3, 5);
+
+  /* Rows outside of the result are clamped. */
+  band = results.get_result(1, 4, 10);
+  expect_test_buffer(*band, 1.0f, 4, TEST_BUFFER_YMAX);
+}
+
+}  // namespace blender::compositor::tests
@@ -0,0 +1,85 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Copyright 2021, Blender Foundation.
+ */
+
+#pragma once
+
+#include "testing/testing.h"
+
+#include "BLI_math_vector.h"
+
+#include "COM_MemoryBuffer.h"
+
+#include <memory>
+
+namespace blender::compositor::tests {
+
+/* Rect of buffers created by #create_test_buffer. */
+constexpr int TEST_BUFFER_XMIN = 1;
+constexpr int TEST_BUFFER_XMAX = 4;
+constexpr int TEST_BUFFER_YMIN = 2;
+constexpr int TEST_BUFFER_YMAX = 6;
+
+/* Size in bytes of buffers created by #create_test_buffer. */
+constexpr size_t TEST_BUFFER_MEM_SIZE = (TEST_BUFFER_XMAX - TEST_BUFFER_XMIN) *
+                                        (TEST_BUFFER_YMAX - TEST_BUFFER_YMIN) *
+                                        COM_DATA_TYPE_COLOR_CHANNELS * sizeof(float);
+
+/**
+ * Creates a color buffer with `value` in the red channel and element coordinates in the green
+ * and blue channels, so that rows read back can be told apart.
+ */
+inline std::unique_ptr<MemoryBuffer> create_test_buffer(const float value)
+{
+  rcti rect;
+  BLI_rcti_init(&rect, TEST_BUFFER_XMIN, TEST_BUFFER_XMAX, TEST_BUFFER_YMIN, TEST_BUFFER_YMAX);
+  std::unique_ptr<MemoryBuffer> buf = std::make_unique<MemoryBuffer>(DataType::Color, rect);
+  for (int y = rect.ymin; y < rect.ymax; y++) {
+    for (int x = rect.xmin; x < rect.xmax; x++) {
+      const float color[4] = {value, (float)x, (float)y, 1.0f};
+      copy_v4_v4(buf->get_elem(x, y), color);
+    }
+  }
+  return buf;
+}
+
+/**
+ * Expects given buffer to have rows `ymin` to `ymax` of a buffer created by #create_test_buffer.
+ */
+inline void expect_test_buffer(const MemoryBuffer &buf,
+                               const float value,
+                               const int ymin = TEST_BUFFER_YMIN,
+                               const int ymax = TEST_BUFFER_YMAX)
+{
+  EXPECT_EQ(buf.get_num_channels(), COM_DATA_TYPE_COLOR_CHANNELS);
+  EXPECT_EQ(buf.get_rect().xmin, TEST_BUFFER_XMIN);
+  EXPECT_EQ(buf.get_rect().xmax, TEST_BUFFER_XMAX);
+  EXPECT_EQ(buf.get_rect().ymin, ymin);
+  EXPECT_EQ(buf.get_rect().ymax, ymax);
+  for (int y = ymin; y < ymax; y++) {
+    for (int x = TEST_BUFFER_XMIN; x < TEST_BUFFER_XMAX; x++) {
+      float color[4];
+      buf.read_elem(x, y, color);
+      EXPECT_EQ(color[0], value);
+      EXPECT_EQ(color[1], x);
+      EXPECT_EQ(color[2], y);
+      EXPECT_EQ(color[3], 1.0f);
+    }
+  }
+}
+
+}  // namespace blender::compositor::tests
@@ -62,6 +62,15 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Tracing */
+
+/* Start recording of every evaluated operation of all dependency graphs, together with the
+ * thread it was evaluated on. The trace is written as Chrome trace JSON to the given file by
+ * DEG_debug_trace_end(). */
+void DEG_debug_trace_begin(const char *filepath);
+void DEG_debug_trace_end(void);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
@@ -0,0 +1,331 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_trace.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+
+#include "BLI_fileops.h"
+#include "BLI_utildefines.h"
+#include "BLI_vector.hh"
+
+#include "PIL_time.h"
+
+#include "DEG_depsgraph_debug.h"
+
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_type.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace deg = blender::deg;
+
+namespace blender::deg {
+namespace {
+
+struct TraceOperation {
+  int evaluation_index;
+  string name;
+  double start_time;
+  double end_time;
+};
+
+struct TraceEvaluation {
+  string graph_name;
+  double start_time;
+  double end_time;
+};
+
+/* Upper limit of recorded operations, so that tracing a long session does not run out of
+ * memory. Operations past the limit are counted but not recorded. */
+constexpr int64_t TRACE_MAX_OPERATIONS = 4 * 1024 * 1024;
+
+struct TraceThread {
+  /* Stable index of the thread in the trace, in order of the first recorded operation. */
+  int index;
+  Vector<TraceOperation> operations;
+};
+
+struct TraceState {
+  string filepath;
+
+  /* Identifies the tracing session, so that threads notice when their #TraceThread belongs to
+   * a previous session. */
+  int session;
+
+  /* Point in time which corresponds to zero timestamp in the trace file. */
+  double start_time;
+
+  /* Operations are stored per thread, so that recording only needs synchronization the first
+   * time a thread records an operation. */
+  std::mutex threads_mutex;
+  Vector<std::unique_ptr<TraceThread>> threads;
+
+  std::atomic<int64_t> num_operations = 0;
+
+  /* Evaluations can be started from different threads (for example, viewport and final render
+   * depsgraphs), so they are guarded by a mutex. */
+  std::mutex evaluations_mutex;
+  Vector<TraceEvaluation> evaluations;
+};
+
+TraceState *trace_state = nullptr;
+int trace_session_counter = 0;
+
+struct TraceThreadLocal {
+  int session = -1;
+  TraceThread *thread = nullptr;
+};
+thread_local TraceThreadLocal trace_thread_local;
+
+TraceThread &trace_thread_get()
+{
+  TraceThreadLocal &local = trace_thread_local;
+  if (local.session != trace_state->session) {
+    std::scoped_lock lock(trace_state->threads_mutex);
+    TraceThread *thread = new TraceThread();
+    thread->index = trace_state->threads.size();
+    trace_state->threads.append(std::unique_ptr<TraceThread>(thread));
+    local.session = trace_state->session;
+    local.thread = thread;
+  }
+  return *local.thread;
+}
+
+inline double trace_timestamp_us(double time)
+{
+  return (time - trace_state->start_time) * 1e6;
+}
+
+string trace_json_escape(const string &str)
+{
+  string result;
+  result.reserve(str.size());
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      result += '\\';
+      result += c;
+    }
+    else if (static_cast<unsigned char>(c) < 0x20) {
+      result += ' ';
+    }
+    else {
+      result += c;
+    }
+  }
+  return result;
+}
+
+void trace_write_slice(FILE *file,
+                       bool *is_first,
+                       const char *category,
+                       const string &name,
+                       int thread_index,
+                       double start_time,
+                       double end_time,
+                       const char *args = nullptr)
+{
+  fprintf(file,
+          "%s\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, "
+          "\"ts\": %.3f, \"dur\": %.3f%s%s}",
+          *is_first ? "" : ",",
+          trace_json_escape(name).c_str(),
+          category,
+          thread_index,
+          trace_timestamp_us(start_time),
+          (end_time - start_time) * 1e6,
+          args ? ", \"args\": " : "",
+          args ? args : "");
+  *is_first = false;
+}
+
+/* Write operations of all threads which participated in the evaluation, and the idle gaps in
+ * between of them. Returns accumulated time threads spent evaluating operations. */
+double trace_write_evaluation(FILE *file,
+                              bool *is_first,
+                              const int evaluation_index,
+                              const TraceEvaluation &evaluation)
+{
+  double busy_time = 0.0;
+  Vector<const TraceOperation *> operations;
+  for (const std::unique_ptr<TraceThread> &thread : trace_state->threads) {
+    const int thread_index = thread->index;
+    operations.clear();
+    for (const TraceOperation &operation : thread->operations) {
+      if (operation.evaluation_index == evaluation_index) {
+        operations.append(&operation);
+      }
+    }
+    std::sort(operations.begin(),
+              operations.end(),
+              [](const TraceOperation *a, const TraceOperation *b) {
+                return a->start_time < b->start_time;
+              });
+    /* Thread which did not pick any task is idle for the entire evaluation, which is exactly
+     * what is important to see when looking for the lack of parallelism. */
+    double idle_start_time = evaluation.start_time;
+    for (const TraceOperation *operation : operations) {
+      if (operation->start_time > idle_start_time) {
+        trace_write_slice(
+            file, is_first, "idle", "Idle", thread_index, idle_start_time, operation->start_time);
+      }
+      trace_write_slice(file,
+                        is_first,
+                        "operation",
+                        operation->name,
+                        thread_index,
+                        operation->start_time,
+                        operation->end_time);
+      busy_time += operation->end_time - operation->start_time;
+      idle_start_time = max(idle_start_time, operation->end_time);
+    }
+    if (evaluation.end_time > idle_start_time) {
+      trace_write_slice(
+          file, is_first, "idle", "Idle", thread_index, idle_start_time, evaluation.end_time);
+    }
+  }
+  return busy_time;
+}
+
+void trace_write(FILE *file)
+{
+  bool is_first = true;
+  fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  /* Only threads which evaluated at least one operation during the tracing are known. */
+  for (const std::unique_ptr<TraceThread> &thread : trace_state->threads) {
+    const int thread_index = thread->index;
+    fprintf(file,
+            "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+            "\"args\": {\"name\": \"Thread %d\"}}",
+            is_first ? "" : ",",
+            thread_index,
+            thread_index);
+    is_first = false;
+  }
+
+  const int evaluation_track = -1;
+  fprintf(file,
+          "%s\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %d, "
+          "\"args\": {\"name\": \"Evaluations\"}}",
+          is_first ? "" : ",",
+          evaluation_track);
+  is_first = false;
+  for (const int evaluation_index : trace_state->evaluations.index_range()) {
+    const TraceEvaluation &evaluation = trace_state->evaluations[evaluation_index];
+    const double busy_time = trace_write_evaluation(
+        file, &is_first, evaluation_index, evaluation);
+    const double wall_time = evaluation.end_time - evaluation.start_time;
+    char args[256];
+    snprintf(args,
+             sizeof(args),
+             "{\"busy_ms\": %.3f, \"wall_ms\": %.3f, \"parallelism\": %.2f}",
+             busy_time * 1e3,
+             wall_time * 1e3,
+             wall_time > 0.0 ? busy_time / wall_time : 0.0);
+    trace_write_slice(file,
+                      &is_first,
+                      "evaluation",
+                      evaluation.graph_name.empty() ? "Depsgraph" : evaluation.graph_name,
+                      evaluation_track,
+                      evaluation.start_time,
+                      evaluation.end_time,
+                      args);
+  }
+  fprintf(file, "\n]}\n");
+}
+
+}  // namespace
+
+bool deg_debug_trace_is_enabled()
+{
+  return trace_state != nullptr;
+}
+
+int deg_debug_trace_begin_evaluation(const Depsgraph *graph)
+{
+  std::scoped_lock lock(trace_state->evaluations_mutex);
+  const double current_time = PIL_check_seconds_timer();
+  trace_state->evaluations.append({graph->debug.name, current_time, current_time});
+  return trace_state->evaluations.size() - 1;
+}
+
+void deg_debug_trace_end_evaluation(const int evaluation_index)
+{
+  std::scoped_lock lock(trace_state->evaluations_mutex);
+  trace_state->evaluations[evaluation_index].end_time = PIL_check_seconds_timer();
+}
+
+void deg_debug_trace_operation(const int evaluation_index,
+                               const OperationNode *operation_node,
+                               const double start_time,
+                               const double end_time)
+{
+  if (trace_state->num_operations.fetch_add(1, std::memory_order_relaxed) >=
+      TRACE_MAX_OPERATIONS) {
+    return;
+  }
+  trace_thread_get().operations.append(
+      {evaluation_index, operation_node->full_identifier(), start_time, end_time});
+}
+
+}  // namespace blender::deg
+
+void DEG_debug_trace_begin(const char *filepath)
+{
+  if (deg::trace_state != nullptr) {
+    DEG_debug_trace_end();
+  }
+  deg::trace_state = new deg::TraceState();
+  deg::trace_state->filepath = filepath;
+  deg::trace_state->session = deg::trace_session_counter++;
+  deg::trace_state->start_time = PIL_check_seconds_timer();
+}
+
+void DEG_debug_trace_end(void)
+{
+  if (deg::trace_state == nullptr) {
+    return;
+  }
+  FILE *file = BLI_fopen(deg::trace_state->filepath.c_str(), "w");
+  if (file != nullptr) {
+    deg::trace_write(file);
+    fclose(file);
+    printf("Depsgraph evaluation trace written to %s\n", deg::trace_state->filepath.c_str());
+    const int64_t num_operations = deg::trace_state->num_operations;
+    if (num_operations > deg::TRACE_MAX_OPERATIONS) {
+      printf("Trace is limited to %lld operations, %lld were not recorded\n",
+             (long long)deg::TRACE_MAX_OPERATIONS,
+             (long long)(num_operations - deg::TRACE_MAX_OPERATIONS));
+    }
+  }
+  else {
+    fprintf(stderr,
+            "Error writing depsgraph evaluation trace to %s\n",
+            deg::trace_state->filepath.c_str());
+  }
+  delete deg::trace_state;
+  deg::trace_state = nullptr;
+}
@@ -0,0 +1,51 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ *
+ * Evaluation tracing: per-thread timeline of every evaluated operation, written out as a
+ * Chrome trace (`chrome://tracing`, Perfetto) JSON file.
+ */
+
+#pragma once
+
+namespace blender {
+namespace deg {
+
+struct Depsgraph;
+struct OperationNode;
+
+/* Is true when tracing was requested via #DEG_debug_trace_begin(). Cheap to call from the
+ * evaluation hot path. */
+bool deg_debug_trace_is_enabled();
+
+/* Mark boundaries of a single graph evaluation. Returns identifier of the evaluation which is
+ * to be passed to the operation recording. */
+int deg_debug_trace_begin_evaluation(const Depsgraph *graph);
+void deg_debug_trace_end_evaluation(int evaluation_index);
+
+/* Record evaluation of the operation. Is to be called from the thread which evaluated it. */
+void deg_debug_trace_operation(int evaluation_index,
+                               const OperationNode *operation_node,
+                               double start_time,
+                               double end_time);
+
+}  // namespace deg
+}  // namespace blender
@@ -417,6 +417,15 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
                                 IMB_Timecode_Type tc /* = 1 = IMB_TC_RECORD_RUN */,
                                 IMB_Proxy_Size preview_size /* = 0 = IMB_PROXY_NONE */);
 
+/**
+ * Decode frames ahead of the last requested one in a background thread while frames are
+ * requested in sequence, keeping at most \a mem_budget bytes of decoded frames.
+ * A budget of 0 disables decoding ahead.
+ *
+ * \attention Defined in anim_movie.c
+ */
+void IMB_anim_set_decode_ahead(struct anim *anim, size_t mem_budget);
+
 /**
  *
  * \attention Defined in anim_movie.c
@@ -80,6 +80,7 @@
 
 #define MAXNUMSTREAMS 50
 
+struct AnimDecodeAhead;
 struct IDProperty;
 struct _AviMovie;
 struct anim_index;
@@ -136,8 +137,14 @@ struct anim {
   int64_t cur_pts;
   int64_t cur_key_frame_pts;
   AVPacket *cur_packet;
+
+  /* Ring of frames decoded ahead of playback, created on demand. */
+  struct AnimDecodeAhead *decode_ahead;
 #endif
 
+  /* Memory budget for frames decoded ahead, 0 when disabled. */
+  size_t decode_ahead_budget;
+
   char index_dir[768];
 
   int proxies_tried;
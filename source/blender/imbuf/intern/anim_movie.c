@@ -1459,12 +1459,248 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   return anim->cur_frame_final;
 }
 
+/* Decode-ahead: while frames are requested in sequence, a background thread keeps decoding the
+ * frames which follow the last requested one (the playhead) in the playback direction. Frames
+ * are stored after color conversion, so a request which hits the ring only hands the ImBuf over.
+ * The ring and its thread are only created once two requests in sequence are detected.
+ *
+ * The ring has as many slots as frames fit into the memory budget, the frame at `position` is
+ * stored in slot `position % capacity`. Since the thread never decodes further ahead than
+ * `capacity` frames, slots of frames which are still ahead of the playhead are never reused. */
+
+#  define DECODE_AHEAD_MAX_FRAMES 32
+/* Largest distance between two requests which is still considered sequential playback,
+ * playback drops frames when it can't keep up. */
+#  define DECODE_AHEAD_MAX_STEP 2
+
+typedef struct AnimDecodeAhead {
+  ListBase threads;
+
+  /* Protects all members below. */
+  ThreadMutex mutex;
+  ThreadCondition cond;
+
+  struct ImBuf **frames;
+  int *positions;
+  int capacity;
+
+  int playhead;
+  /* 1 or -1 during playback, 0 when frames are not requested in sequence. */
+  int direction;
+  IMB_Timecode_Type tc;
+  bool stop;
+
+  /* Held while the FFmpeg decoding state of the anim is in use, taken after `mutex`. */
+  ThreadMutex decode_mutex;
+} AnimDecodeAhead;
+
+static void decode_ahead_clear(AnimDecodeAhead *da)
+{
+  for (int i = 0; i < da->capacity; i++) {
+    IMB_freeImBuf(da->frames[i]);
+    da->frames[i] = NULL;
+    da->positions[i] = -1;
+  }
+}
+
+static bool decode_ahead_in_window(const AnimDecodeAhead *da, int position)
+{
+  const int offset = (position - da->playhead) * da->direction;
+  return da->direction != 0 && offset >= 1 && offset <= da->capacity;
+}
+
+/* Closest frame ahead of the playhead which is not decoded yet, -1 when there is none. */
+static int decode_ahead_next_position(const struct anim *anim, const AnimDecodeAhead *da)
+{
+  if (da->direction == 0) {
+    return -1;
+  }
+
+  for (int i = 1; i <= da->capacity; i++) {
+    const int position = da->playhead + i * da->direction;
+    if (position < 0 || position >= anim->duration_in_frames) {
+      break;
+    }
+    if (da->positions[position % da->capacity] != position) {
+      return position;
+    }
+  }
+  return -1;
+}
+
+static void *decode_ahead_thread(void *data)
+{
+  struct anim *anim = data;
+  AnimDecodeAhead *da = anim->decode_ahead;
+
+  BLI_mutex_lock(&da->mutex);
+  while (!da->stop) {
+    const int position = decode_ahead_next_position(anim, da);
+    if (position == -1) {
+      BLI_condition_wait(&da->cond, &da->mutex);
+      continue;
+    }
+
+    const IMB_Timecode_Type tc = da->tc;
+    BLI_mutex_unlock(&da->mutex);
+
+    BLI_mutex_lock(&da->decode_mutex);
+    ImBuf *ibuf = ffmpeg_fetchibuf(anim, position, tc);
+    BLI_mutex_unlock(&da->decode_mutex);
+
+    BLI_mutex_lock(&da->mutex);
+    if (ibuf == NULL) {
+      /* Stop decoding ahead until playback continues. */
+      da->direction = 0;
+      continue;
+    }
+
+    /* The playhead could have moved past the frame while it was decoded. */
+    if (tc == da->tc && decode_ahead_in_window(da, position)) {
+      const int slot = position % da->capacity;
+      IMB_freeImBuf(da->frames[slot]);
+      da->frames[slot] = ibuf;
+      da->positions[slot] = position;
+    }
+    else {
+      IMB_freeImBuf(ibuf);
+    }
+  }
+  BLI_mutex_unlock(&da->mutex);
+
+  return NULL;
+}
+
+static bool decode_ahead_is_sequential_step(int step)
+{
+  return step != 0 && abs(step) <= DECODE_AHEAD_MAX_STEP;
+}
+
+/* Whether the requested frame follows the previously decoded one, so that single frame requests
+ * and random access (thumbnails, scrubbing) don't start the thread. */
+static bool decode_ahead_is_sequential(const struct anim *anim, int position)
+{
+  return anim->cur_position >= 0 &&
+         decode_ahead_is_sequential_step(position - anim->cur_position);
+}
+
+static void decode_ahead_init(struct anim *anim)
+{
+  const size_t frame_size = (size_t)4 * anim->x * anim->y;
+  if (frame_size == 0) {
+    return;
+  }
+
+  const int capacity = (int)MIN2(anim->decode_ahead_budget / frame_size,
+                                 DECODE_AHEAD_MAX_FRAMES);
+  if (capacity < 2) {
+    return;
+  }
+
+  AnimDecodeAhead *da = MEM_callocN(sizeof(AnimDecodeAhead), "AnimDecodeAhead");
+  da->frames = MEM_callocN(sizeof(*da->frames) * capacity, "AnimDecodeAhead frames");
+  da->positions = MEM_mallocN(sizeof(*da->positions) * capacity, "AnimDecodeAhead positions");
+  da->capacity = capacity;
+  /* Continue from the previous request, so the next one sets the playback direction. */
+  da->playhead = anim->cur_position;
+  da->direction = 0;
+  da->tc = IMB_TC_NONE;
+  for (int i = 0; i < capacity; i++) {
+    da->positions[i] = -1;
+  }
+
+  BLI_mutex_init(&da->mutex);
+  BLI_mutex_init(&da->decode_mutex);
+  BLI_condition_init(&da->cond);
+
+  anim->decode_ahead = da;
+
+  BLI_threadpool_init(&da->threads, decode_ahead_thread, 1);
+  BLI_threadpool_insert(&da->threads, anim);
+}
+
+static void decode_ahead_free(struct anim *anim)
+{
+  AnimDecodeAhead *da = anim->decode_ahead;
+  if (da == NULL) {
+    return;
+  }
+
+  BLI_mutex_lock(&da->mutex);
+  da->stop = true;
+  BLI_condition_notify_all(&da->cond);
+  BLI_mutex_unlock(&da->mutex);
+
+  BLI_threadpool_end(&da->threads);
+
+  decode_ahead_clear(da);
+  BLI_condition_end(&da->cond);
+  BLI_mutex_end(&da->decode_mutex);
+  BLI_mutex_end(&da->mutex);
+  MEM_freeN(da->frames);
+  MEM_freeN(da->positions);
+  MEM_freeN(da);
+
+  anim->decode_ahead = NULL;
+}
+
+static ImBuf *decode_ahead_fetchibuf(struct anim *anim, int position, IMB_Timecode_Type tc)
+{
+  AnimDecodeAhead *da = anim->decode_ahead;
+  ImBuf *ibuf = NULL;
+
+  BLI_mutex_lock(&da->mutex);
+
+  if (tc != da->tc) {
+    decode_ahead_clear(da);
+    da->tc = tc;
+  }
+
+  /* Hand the frame over, the caller is free to modify it. */
+  const int slot = position % da->capacity;
+  if (da->positions[slot] == position) {
+    ibuf = da->frames[slot];
+    da->frames[slot] = NULL;
+    da->positions[slot] = -1;
+  }
+
+  const int step = position - da->playhead;
+  if (decode_ahead_is_sequential_step(step)) {
+    da->direction = (step > 0) ? 1 : -1;
+  }
+  else if (step != 0) {
+    /* Random access, frames in the ring are unlikely to be requested. */
+    da->direction = 0;
+    if (ibuf == NULL) {
+      decode_ahead_clear(da);
+    }
+  }
+  da->playhead = position;
+  BLI_condition_notify_one(&da->cond);
+
+  if (ibuf) {
+    BLI_mutex_unlock(&da->mutex);
+    return ibuf;
+  }
+
+  /* Take the decoder before the thread is able to continue with the frames ahead, otherwise
+   * decoding the requested frame would need a seek back. */
+  BLI_mutex_lock(&da->decode_mutex);
+  BLI_mutex_unlock(&da->mutex);
+  ibuf = ffmpeg_fetchibuf(anim, position, tc);
+  BLI_mutex_unlock(&da->decode_mutex);
+
+  return ibuf;
+}
+
 static void free_anim_ffmpeg(struct anim *anim)
 {
   if (anim == NULL) {
     return;
   }
 
+  decode_ahead_free(anim);
+
   if (anim->pCodecCtx) {
     avcodec_free_context(&anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
@@ -1610,6 +1846,14 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
     struct anim *proxy = IMB_anim_open_proxy(anim, preview_size);
 
     if (proxy) {
+      size_t proxy_decode_ahead_budget = anim->decode_ahead_budget;
+#ifdef WITH_FFMPEG
+      /* Only one thread decodes ahead for a movie, the proxy doesn't when the movie does. */
+      if (anim->decode_ahead) {
+        proxy_decode_ahead_budget = 0;
+      }
+#endif
+      IMB_anim_set_decode_ahead(proxy, proxy_decode_ahead_budget);
       position = IMB_anim_index_get_frame_index(anim, tc, position);
 
       return IMB_anim_absolute(proxy, position, IMB_TC_NONE, IMB_PROXY_NONE);
@@ -1643,9 +1887,19 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
 #endif
 #ifdef WITH_FFMPEG
     case ANIM_FFMPEG:
-      ibuf = ffmpeg_fetchibuf(anim, position, tc);
-      if (ibuf) {
-        anim->cur_position = position;
+      if (anim->decode_ahead == NULL && anim->decode_ahead_budget != 0 &&
+          decode_ahead_is_sequential(anim, position)) {
+        decode_ahead_init(anim);
+      }
+      if (anim->decode_ahead) {
+        /* The decoding position is owned by the decode-ahead thread. */
+        ibuf = decode_ahead_fetchibuf(anim, position, tc);
+      }
+      else {
+        ibuf = ffmpeg_fetchibuf(anim, position, tc);
+        if (ibuf) {
+          anim->cur_position = position;
+        }
       }
       filter_y = 0; /* done internally */
       break;
@@ -1656,11 +1910,24 @@ struct ImBuf *IMB_anim_absolute(struct anim *anim,
     if (filter_y) {
       IMB_filtery(ibuf);
     }
-    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, anim->cur_position + 1);
+    BLI_snprintf(ibuf->name, sizeof(ibuf->name), "%s.%04d", anim->name, position + 1);
   }
   return ibuf;
 }
 
+void IMB_anim_set_decode_ahead(struct anim *anim, size_t mem_budget)
+{
+  if (anim == NULL || anim->decode_ahead_budget == mem_budget) {
+    return;
+  }
+
+  anim->decode_ahead_budget = mem_budget;
+#ifdef WITH_FFMPEG
+  /* Created again with the new budget on the next request. */
+  decode_ahead_free(anim);
+#endif
+}
+
 /***/
 
 int IMB_anim_get_duration(struct anim *anim, IMB_Timecode_Type tc)
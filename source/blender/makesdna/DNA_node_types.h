@@ -583,6 +583,8 @@ typedef struct bNodeTree {
 
 /* tree is localized copy, free when deleting node groups */
 /* #define NTREE_IS_LOCALIZED           (1 << 5) */
+#define NTREE_COM_HALF_BUFFERS (1 << 6) /* store color buffers as half float */
+#define NTREE_COM_STREAMING (1 << 7)    /* render full frame in horizontal bands */
 
 /* ntree->update */
 typedef enum eNodeTreeUpdate {
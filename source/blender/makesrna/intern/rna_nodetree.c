@@ -12521,6 +12521,21 @@ static void rna_def_composite_nodetree(BlenderRNA *brna)
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_GROUPNODE_BUFFER);
   RNA_def_property_ui_text(prop, "Buffer Groups", "Enable buffering of group nodes");
 
+  prop = RNA_def_property(srna, "use_half_buffers", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_HALF_BUFFERS);
+  RNA_def_property_ui_text(prop,
+                           "Half Float Buffers",
+                           "Store color results waiting to be read as half float to reduce "
+                           "memory usage, at the cost of precision (Full Frame only)");
+
+  prop = RNA_def_property(srna, "use_streaming", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_COM_STREAMING);
+  RNA_def_property_ui_text(prop,
+                           "Streaming",
+                           "Render outputs in horizontal bands of chunk size rows to reduce "
+                           "memory usage of very large frames, results depending on the whole "
+                           "frame are stored on disk (Full Frame only)");
+
   prop = RNA_def_property(srna, "use_two_pass", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_sdna(prop, NULL, "flag", NTREE_TWO_PASS);
   RNA_def_property_ui_text(prop,
@@ -0,0 +1,799 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup sequencer
+ */
+
+#include <string.h>
+
+#include "atomic_ops.h"
+
+#include "BLI_math_base.h"
+#include "BLI_math_color.h"
+#include "BLI_simd.h"
+#include "BLI_system.h"
+#include "BLI_utildefines.h"
+
+#include "effects_kernels.h"
+
+/* -------------------------------------------------------------------- */
+/** \name Scalar Kernels
+ * \{ */
+
+static void alphaover_byte_scalar(const unsigned char *src1,
+                                  const unsigned char *src2,
+                                  unsigned char *dst,
+                                  int len,
+                                  float fac)
+{
+  float tempc[4], rt1[4], rt2[4];
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    /* dst = src1 over src2 (alpha from src1) */
+    straight_uchar_to_premul_float(rt1, src1);
+    straight_uchar_to_premul_float(rt2, src2);
+
+    const float mfac = 1.0f - fac * rt1[3];
+
+    if (fac <= 0.0f) {
+      memcpy(dst, src2, 4);
+    }
+    else if (mfac <= 0.0f) {
+      memcpy(dst, src1, 4);
+    }
+    else {
+      tempc[0] = fac * rt1[0] + mfac * rt2[0];
+      tempc[1] = fac * rt1[1] + mfac * rt2[1];
+      tempc[2] = fac * rt1[2] + mfac * rt2[2];
+      tempc[3] = fac * rt1[3] + mfac * rt2[3];
+
+      premul_float_to_straight_uchar(dst, tempc);
+    }
+  }
+}
+
+static void alphaover_float_scalar(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    /* dst = src1 over src2 (alpha from src1) */
+    const float mfac = 1.0f - (fac * src1[3]);
+
+    if (fac <= 0.0f) {
+      memcpy(dst, src2, sizeof(float[4]));
+    }
+    else if (mfac <= 0.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+    }
+    else {
+      dst[0] = fac * src1[0] + mfac * src2[0];
+      dst[1] = fac * src1[1] + mfac * src2[1];
+      dst[2] = fac * src1[2] + mfac * src2[2];
+      dst[3] = fac * src1[3] + mfac * src2[3];
+    }
+  }
+}
+
+static void alphaunder_byte_scalar(const unsigned char *src1,
+                                   const unsigned char *src2,
+                                   unsigned char *dst,
+                                   int len,
+                                   float fac)
+{
+  float tempc[4], rt1[4], rt2[4];
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    /* dst = src1 under src2 (alpha from src2) */
+    straight_uchar_to_premul_float(rt1, src1);
+    straight_uchar_to_premul_float(rt2, src2);
+
+    /* This complex optimization is because the 'skybuf' can be crossed in. */
+    if (rt2[3] <= 0.0f && fac >= 1.0f) {
+      memcpy(dst, src1, 4);
+    }
+    else if (rt2[3] >= 1.0f) {
+      memcpy(dst, src2, 4);
+    }
+    else {
+      const float mfac = fac * (1.0f - rt2[3]);
+
+      if (mfac <= 0) {
+        memcpy(dst, src2, 4);
+      }
+      else {
+        tempc[0] = (mfac * rt1[0] + rt2[0]);
+        tempc[1] = (mfac * rt1[1] + rt2[1]);
+        tempc[2] = (mfac * rt1[2] + rt2[2]);
+        tempc[3] = (mfac * rt1[3] + rt2[3]);
+
+        premul_float_to_straight_uchar(dst, tempc);
+      }
+    }
+  }
+}
+
+static void alphaunder_float_scalar(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    /* dst = src1 under src2 (alpha from src2) */
+
+    /* This complex optimization is because the 'skybuf' can be crossed in. */
+    if (src2[3] <= 0 && fac >= 1.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+    }
+    else if (src2[3] >= 1.0f) {
+      memcpy(dst, src2, sizeof(float[4]));
+    }
+    else {
+      const float mfac = fac * (1.0f - src2[3]);
+
+      if (mfac == 0) {
+        memcpy(dst, src2, sizeof(float[4]));
+      }
+      else {
+        dst[0] = mfac * src1[0] + src2[0];
+        dst[1] = mfac * src1[1] + src2[1];
+        dst[2] = mfac * src1[2] + src2[2];
+        dst[3] = mfac * src1[3] + src2[3];
+      }
+    }
+  }
+}
+
+static void cross_byte_scalar(const unsigned char *src1,
+                              const unsigned char *src2,
+                              unsigned char *dst,
+                              int len,
+                              float fac)
+{
+  const int fac2 = (int)(256.0f * fac);
+  const int fac1 = 256 - fac2;
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    dst[0] = (fac1 * src1[0] + fac2 * src2[0]) >> 8;
+    dst[1] = (fac1 * src1[1] + fac2 * src2[1]) >> 8;
+    dst[2] = (fac1 * src1[2] + fac2 * src2[2]) >> 8;
+    dst[3] = (fac1 * src1[3] + fac2 * src2[3]) >> 8;
+  }
+}
+
+static void cross_float_scalar(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  const float fac2 = fac;
+  const float fac1 = 1.0f - fac2;
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    dst[0] = fac1 * src1[0] + fac2 * src2[0];
+    dst[1] = fac1 * src1[1] + fac2 * src2[1];
+    dst[2] = fac1 * src1[2] + fac2 * src2[2];
+    dst[3] = fac1 * src1[3] + fac2 * src2[3];
+  }
+}
+
+static void add_byte_scalar(const unsigned char *src1,
+                            const unsigned char *src2,
+                            unsigned char *dst,
+                            int len,
+                            float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const int m = fac1 * (int)src2[3];
+    dst[0] = min_ii(src1[0] + ((m * src2[0]) >> 16), 255);
+    dst[1] = min_ii(src1[1] + ((m * src2[1]) >> 16), 255);
+    dst[2] = min_ii(src1[2] + ((m * src2[2]) >> 16), 255);
+    dst[3] = src1[3];
+  }
+}
+
+static void add_float_scalar(const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const float m = (1.0f - (src1[3] * (1.0f - fac))) * src2[3];
+    dst[0] = src1[0] + m * src2[0];
+    dst[1] = src1[1] + m * src2[1];
+    dst[2] = src1[2] + m * src2[2];
+    dst[3] = src1[3];
+  }
+}
+
+static void mul_byte_scalar(const unsigned char *src1,
+                            const unsigned char *src2,
+                            unsigned char *dst,
+                            int len,
+                            float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+
+  /* Formula:
+   * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + a`. */
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    dst[0] = src1[0] + ((fac1 * src1[0] * (src2[0] - 255)) >> 16);
+    dst[1] = src1[1] + ((fac1 * src1[1] * (src2[1] - 255)) >> 16);
+    dst[2] = src1[2] + ((fac1 * src1[2] * (src2[2] - 255)) >> 16);
+    dst[3] = src1[3] + ((fac1 * src1[3] * (src2[3] - 255)) >> 16);
+  }
+}
+
+static void mul_float_scalar(const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  /* Formula:
+   * `fac * (a * b) + (1 - fac) * a => fac * a * (b - 1) + a`. */
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    dst[0] = src1[0] + fac * src1[0] * (src2[0] - 1.0f);
+    dst[1] = src1[1] + fac * src1[1] * (src2[1] - 1.0f);
+    dst[2] = src1[2] + fac * src1[2] * (src2[2] - 1.0f);
+    dst[3] = src1[3] + fac * src1[3] * (src2[3] - 1.0f);
+  }
+}
+
+const SeqEffectKernels seq_effect_kernels_scalar = {
+    alphaover_byte_scalar,
+    alphaover_float_scalar,
+    alphaunder_byte_scalar,
+    alphaunder_float_scalar,
+    cross_byte_scalar,
+    cross_float_scalar,
+    add_byte_scalar,
+    add_float_scalar,
+    mul_byte_scalar,
+    mul_float_scalar,
+};
+
+/** \} */
+
+#ifdef BLI_HAVE_SSE2
+
+/* -------------------------------------------------------------------- */
+/** \name SSE2 Kernels
+ *
+ * Operations are done in the same order as in the scalar kernels, so that results match.
+ * Byte kernels which work on integers fall back to the scalar kernels for factors outside of
+ * the 0..1 range, where the intermediate values don't fit into 16 bits.
+ * \{ */
+
+BLI_INLINE __m128 load_uchar4(const unsigned char *src)
+{
+  int packed;
+  memcpy(&packed, src, sizeof(packed));
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+  return _mm_cvtepi32_ps(v);
+}
+
+/* Same as #straight_uchar_to_premul_float. */
+BLI_INLINE __m128 straight_uchar_to_premul_m128(const unsigned char *src)
+{
+  const float alpha = src[3] * (1.0f / 255.0f);
+  const float fac = alpha * (1.0f / 255.0f);
+  return _mm_mul_ps(load_uchar4(src), _mm_setr_ps(fac, fac, fac, 1.0f / 255.0f));
+}
+
+/* Same as #premul_float_to_straight_uchar. */
+BLI_INLINE void premul_m128_to_straight_uchar(unsigned char *dst, __m128 color)
+{
+  const float alpha = _mm_cvtss_f32(_mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3)));
+  if (alpha != 0.0f && alpha != 1.0f) {
+    const float alpha_inv = 1.0f / alpha;
+    color = _mm_mul_ps(color, _mm_setr_ps(alpha_inv, alpha_inv, alpha_inv, 1.0f));
+  }
+
+  /* Same rounding as #unit_float_to_uchar_clamp. */
+  color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+  color = _mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  __m128i v = _mm_cvttps_epi32(color);
+  v = _mm_packs_epi32(v, v);
+  v = _mm_packus_epi16(v, v);
+  const int packed = _mm_cvtsi128_si32(v);
+  memcpy(dst, &packed, sizeof(packed));
+}
+
+static void alphaover_byte_sse2(const unsigned char *src1,
+                                const unsigned char *src2,
+                                unsigned char *dst,
+                                int len,
+                                float fac)
+{
+  if (fac <= 0.0f) {
+    memcpy(dst, src2, (size_t)len * 4);
+    return;
+  }
+
+  const __m128 fac_v = _mm_set1_ps(fac);
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const float mfac = 1.0f - fac * (src1[3] * (1.0f / 255.0f));
+
+    if (mfac <= 0.0f) {
+      memcpy(dst, src1, 4);
+      continue;
+    }
+
+    const __m128 rt1 = straight_uchar_to_premul_m128(src1);
+    const __m128 rt2 = straight_uchar_to_premul_m128(src2);
+    const __m128 color = _mm_add_ps(_mm_mul_ps(fac_v, rt1), _mm_mul_ps(_mm_set1_ps(mfac), rt2));
+    premul_m128_to_straight_uchar(dst, color);
+  }
+}
+
+static void alphaover_float_sse2(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  if (fac <= 0.0f) {
+    memcpy(dst, src2, sizeof(float[4]) * len);
+    return;
+  }
+
+  const __m128 fac_v = _mm_set1_ps(fac);
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const float mfac = 1.0f - (fac * src1[3]);
+
+    if (mfac <= 0.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+      continue;
+    }
+
+    const __m128 color = _mm_add_ps(_mm_mul_ps(fac_v, _mm_loadu_ps(src1)),
+                                    _mm_mul_ps(_mm_set1_ps(mfac), _mm_loadu_ps(src2)));
+    _mm_storeu_ps(dst, color);
+  }
+}
+
+static void alphaunder_byte_sse2(const unsigned char *src1,
+                                 const unsigned char *src2,
+                                 unsigned char *dst,
+                                 int len,
+                                 float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const float alpha2 = src2[3] * (1.0f / 255.0f);
+
+    if (alpha2 <= 0.0f && fac >= 1.0f) {
+      memcpy(dst, src1, 4);
+      continue;
+    }
+    if (alpha2 >= 1.0f) {
+      memcpy(dst, src2, 4);
+      continue;
+    }
+
+    const float mfac = fac * (1.0f - alpha2);
+    if (mfac <= 0) {
+      memcpy(dst, src2, 4);
+      continue;
+    }
+
+    const __m128 rt1 = straight_uchar_to_premul_m128(src1);
+    const __m128 rt2 = straight_uchar_to_premul_m128(src2);
+    const __m128 color = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mfac), rt1), rt2);
+    premul_m128_to_straight_uchar(dst, color);
+  }
+}
+
+static void alphaunder_float_sse2(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    if (src2[3] <= 0 && fac >= 1.0f) {
+      memcpy(dst, src1, sizeof(float[4]));
+      continue;
+    }
+    if (src2[3] >= 1.0f) {
+      memcpy(dst, src2, sizeof(float[4]));
+      continue;
+    }
+
+    const float mfac = fac * (1.0f - src2[3]);
+    if (mfac == 0) {
+      memcpy(dst, src2, sizeof(float[4]));
+      continue;
+    }
+
+    const __m128 color = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mfac), _mm_loadu_ps(src1)),
+                                    _mm_loadu_ps(src2));
+    _mm_storeu_ps(dst, color);
+  }
+}
+
+static void cross_byte_sse2(const unsigned char *src1,
+                            const unsigned char *src2,
+                            unsigned char *dst,
+                            int len,
+                            float fac)
+{
+  const int fac2 = (int)(256.0f * fac);
+  const int fac1 = 256 - fac2;
+  if (fac2 < 0 || fac2 > 256) {
+    cross_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  /* With `fac1 + fac2 == 256` the weighted sum of two bytes fits into 16 bits. */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i fac1_v = _mm_set1_epi16((short)fac1);
+  const __m128i fac2_v = _mm_set1_epi16((short)fac2);
+  int i = 0;
+  for (; i + 4 <= len; i += 4, src1 += 16, src2 += 16, dst += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)src1);
+    const __m128i b = _mm_loadu_si128((const __m128i *)src2);
+    const __m128i lo = _mm_srli_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), fac1_v),
+                      _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), fac2_v)),
+        8);
+    const __m128i hi = _mm_srli_epi16(
+        _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), fac1_v),
+                      _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), fac2_v)),
+        8);
+    _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(lo, hi));
+  }
+  cross_byte_scalar(src1, src2, dst, len - i, fac);
+}
+
+static void cross_float_sse2(const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  const __m128 fac2 = _mm_set1_ps(fac);
+  const __m128 fac1 = _mm_set1_ps(1.0f - fac);
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const __m128 color = _mm_add_ps(_mm_mul_ps(fac1, _mm_loadu_ps(src1)),
+                                    _mm_mul_ps(fac2, _mm_loadu_ps(src2)));
+    _mm_storeu_ps(dst, color);
+  }
+}
+
+/* Alpha of every pixel in all of its channels. */
+BLI_INLINE __m128i broadcast_alpha_epi16(__m128i v)
+{
+  v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+static void add_byte_sse2(const unsigned char *src1,
+                          const unsigned char *src2,
+                          unsigned char *dst,
+                          int len,
+                          float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+  if (fac1 < 0 || fac1 > 256) {
+    add_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i fac_v = _mm_set1_epi16((short)fac1);
+  const __m128i alpha_mask = _mm_set1_epi32((int)0xff000000);
+  int i = 0;
+  for (; i + 4 <= len; i += 4, src1 += 16, src2 += 16, dst += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)src1);
+    const __m128i b = _mm_loadu_si128((const __m128i *)src2);
+    const __m128i b_lo = _mm_unpacklo_epi8(b, zero);
+    const __m128i b_hi = _mm_unpackhi_epi8(b, zero);
+    /* `(m * b) >> 16` with `m = fac * alpha` below 2^16. */
+    const __m128i add_lo = _mm_mulhi_epu16(_mm_mullo_epi16(broadcast_alpha_epi16(b_lo), fac_v),
+                                           b_lo);
+    const __m128i add_hi = _mm_mulhi_epu16(_mm_mullo_epi16(broadcast_alpha_epi16(b_hi), fac_v),
+                                           b_hi);
+    /* Alpha is taken from the first input. */
+    const __m128i add = _mm_andnot_si128(alpha_mask, _mm_packus_epi16(add_lo, add_hi));
+    _mm_storeu_si128((__m128i *)dst, _mm_adds_epu8(a, add));
+  }
+  add_byte_scalar(src1, src2, dst, len - i, fac);
+}
+
+static void add_float_sse2(const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const float m = (1.0f - (src1[3] * (1.0f - fac))) * src2[3];
+    const float alpha = src1[3];
+    _mm_storeu_ps(dst,
+                  _mm_add_ps(_mm_loadu_ps(src1), _mm_mul_ps(_mm_set1_ps(m), _mm_loadu_ps(src2))));
+    dst[3] = alpha;
+  }
+}
+
+static void mul_byte_sse2(const unsigned char *src1,
+                          const unsigned char *src2,
+                          unsigned char *dst,
+                          int len,
+                          float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+  if (fac1 < 0 || fac1 > 256) {
+    mul_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  /* `(fac * a * (b - 255)) >> 16` rounds towards negative infinity, so it's computed as
+   * `-ceil(p * q / 2^16)` with `p = fac * a` and `q = 255 - b`, which both fit into 16 bits. */
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i fac_v = _mm_set1_epi16((short)fac1);
+  const __m128i max_v = _mm_set1_epi16(255);
+  int i = 0;
+  for (; i + 4 <= len; i += 4, src1 += 16, src2 += 16, dst += 16) {
+    const __m128i a = _mm_loadu_si128((const __m128i *)src1);
+    const __m128i b = _mm_loadu_si128((const __m128i *)src2);
+    __m128i result[2];
+    for (int half = 0; half < 2; half++) {
+      const __m128i a16 = half ? _mm_unpackhi_epi8(a, zero) : _mm_unpacklo_epi8(a, zero);
+      const __m128i b16 = half ? _mm_unpackhi_epi8(b, zero) : _mm_unpacklo_epi8(b, zero);
+      const __m128i p = _mm_mullo_epi16(a16, fac_v);
+      const __m128i q = _mm_sub_epi16(max_v, b16);
+      const __m128i prod_hi = _mm_mulhi_epu16(p, q);
+      const __m128i prod_lo = _mm_mullo_epi16(p, q);
+      /* Adds one when the low part is not zero, the comparison gives -1 for zero. */
+      const __m128i ceil = _mm_add_epi16(_mm_add_epi16(prod_hi, one),
+                                         _mm_cmpeq_epi16(prod_lo, zero));
+      result[half] = _mm_sub_epi16(a16, ceil);
+    }
+    _mm_storeu_si128((__m128i *)dst, _mm_packus_epi16(result[0], result[1]));
+  }
+  mul_byte_scalar(src1, src2, dst, len - i, fac);
+}
+
+static void mul_float_sse2(const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  const __m128 fac_v = _mm_set1_ps(fac);
+  const __m128 one = _mm_set1_ps(1.0f);
+
+  for (int i = 0; i < len; i++, src1 += 4, src2 += 4, dst += 4) {
+    const __m128 a = _mm_loadu_ps(src1);
+    const __m128 b = _mm_loadu_ps(src2);
+    _mm_storeu_ps(dst, _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(fac_v, a), _mm_sub_ps(b, one))));
+  }
+}
+
+static const SeqEffectKernels seq_effect_kernels_sse2_table = {
+    alphaover_byte_sse2,
+    alphaover_float_sse2,
+    alphaunder_byte_sse2,
+    alphaunder_float_sse2,
+    cross_byte_sse2,
+    cross_float_sse2,
+    add_byte_sse2,
+    add_float_sse2,
+    mul_byte_sse2,
+    mul_float_sse2,
+};
+
+/** \} */
+
+#endif /* BLI_HAVE_SSE2 */
+
+/* AVX2 kernels are compiled for the SSE2 baseline with a target attribute, and only used when
+ * the CPU supports them. */
+#if defined(BLI_HAVE_SSE2) && (defined(__x86_64__) || defined(_M_X64)) && \
+    (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+#  include <immintrin.h>
+#  if defined(__GNUC__) || defined(__clang__)
+#    define ATTR_AVX2 __attribute__((target("avx2")))
+#  else
+#    define ATTR_AVX2
+#  endif
+#  define SEQ_HAVE_AVX2_KERNELS
+#endif
+
+#ifdef SEQ_HAVE_AVX2_KERNELS
+
+/* -------------------------------------------------------------------- */
+/** \name AVX2 Kernels
+ *
+ * Same operations as the SSE2 kernels on twice as many pixels at once, remaining pixels are done
+ * by the SSE2 kernels. Kernels which branch per pixel are the SSE2 ones.
+ * \{ */
+
+ATTR_AVX2 static void cross_byte_avx2(const unsigned char *src1,
+                                      const unsigned char *src2,
+                                      unsigned char *dst,
+                                      int len,
+                                      float fac)
+{
+  const int fac2 = (int)(256.0f * fac);
+  const int fac1 = 256 - fac2;
+  if (fac2 < 0 || fac2 > 256) {
+    cross_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i fac1_v = _mm256_set1_epi16((short)fac1);
+  const __m256i fac2_v = _mm256_set1_epi16((short)fac2);
+  int i = 0;
+  for (; i + 8 <= len; i += 8, src1 += 32, src2 += 32, dst += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)src1);
+    const __m256i b = _mm256_loadu_si256((const __m256i *)src2);
+    /* Unpacking and packing both work per 128 bit lane, so pixels keep their order. */
+    const __m256i lo = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(a, zero), fac1_v),
+                         _mm256_mullo_epi16(_mm256_unpacklo_epi8(b, zero), fac2_v)),
+        8);
+    const __m256i hi = _mm256_srli_epi16(
+        _mm256_add_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(a, zero), fac1_v),
+                         _mm256_mullo_epi16(_mm256_unpackhi_epi8(b, zero), fac2_v)),
+        8);
+    _mm256_storeu_si256((__m256i *)dst, _mm256_packus_epi16(lo, hi));
+  }
+  cross_byte_sse2(src1, src2, dst, len - i, fac);
+}
+
+ATTR_AVX2 static void cross_float_avx2(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  const __m256 fac2 = _mm256_set1_ps(fac);
+  const __m256 fac1 = _mm256_set1_ps(1.0f - fac);
+
+  int i = 0;
+  for (; i + 2 <= len; i += 2, src1 += 8, src2 += 8, dst += 8) {
+    const __m256 color = _mm256_add_ps(_mm256_mul_ps(fac1, _mm256_loadu_ps(src1)),
+                                       _mm256_mul_ps(fac2, _mm256_loadu_ps(src2)));
+    _mm256_storeu_ps(dst, color);
+  }
+  cross_float_sse2(src1, src2, dst, len - i, fac);
+}
+
+/* Alpha of every pixel in all of its channels. */
+ATTR_AVX2 BLI_INLINE __m256i broadcast_alpha_epi16_avx2(__m256i v)
+{
+  v = _mm256_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+  return _mm256_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+ATTR_AVX2 static void add_byte_avx2(const unsigned char *src1,
+                                    const unsigned char *src2,
+                                    unsigned char *dst,
+                                    int len,
+                                    float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+  if (fac1 < 0 || fac1 > 256) {
+    add_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i fac_v = _mm256_set1_epi16((short)fac1);
+  const __m256i alpha_mask = _mm256_set1_epi32((int)0xff000000);
+  int i = 0;
+  for (; i + 8 <= len; i += 8, src1 += 32, src2 += 32, dst += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)src1);
+    const __m256i b = _mm256_loadu_si256((const __m256i *)src2);
+    const __m256i b_lo = _mm256_unpacklo_epi8(b, zero);
+    const __m256i b_hi = _mm256_unpackhi_epi8(b, zero);
+    const __m256i add_lo = _mm256_mulhi_epu16(
+        _mm256_mullo_epi16(broadcast_alpha_epi16_avx2(b_lo), fac_v), b_lo);
+    const __m256i add_hi = _mm256_mulhi_epu16(
+        _mm256_mullo_epi16(broadcast_alpha_epi16_avx2(b_hi), fac_v), b_hi);
+    const __m256i add = _mm256_andnot_si256(alpha_mask, _mm256_packus_epi16(add_lo, add_hi));
+    _mm256_storeu_si256((__m256i *)dst, _mm256_adds_epu8(a, add));
+  }
+  add_byte_sse2(src1, src2, dst, len - i, fac);
+}
+
+ATTR_AVX2 static void mul_byte_avx2(const unsigned char *src1,
+                                    const unsigned char *src2,
+                                    unsigned char *dst,
+                                    int len,
+                                    float fac)
+{
+  const int fac1 = (int)(256.0f * fac);
+  if (fac1 < 0 || fac1 > 256) {
+    mul_byte_scalar(src1, src2, dst, len, fac);
+    return;
+  }
+
+  /* Same rounding as #mul_byte_sse2. */
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i one = _mm256_set1_epi16(1);
+  const __m256i fac_v = _mm256_set1_epi16((short)fac1);
+  const __m256i max_v = _mm256_set1_epi16(255);
+  int i = 0;
+  for (; i + 8 <= len; i += 8, src1 += 32, src2 += 32, dst += 32) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)src1);
+    const __m256i b = _mm256_loadu_si256((const __m256i *)src2);
+    __m256i result[2];
+    for (int half = 0; half < 2; half++) {
+      const __m256i a16 = half ? _mm256_unpackhi_epi8(a, zero) : _mm256_unpacklo_epi8(a, zero);
+      const __m256i b16 = half ? _mm256_unpackhi_epi8(b, zero) : _mm256_unpacklo_epi8(b, zero);
+      const __m256i p = _mm256_mullo_epi16(a16, fac_v);
+      const __m256i q = _mm256_sub_epi16(max_v, b16);
+      const __m256i prod_hi = _mm256_mulhi_epu16(p, q);
+      const __m256i prod_lo = _mm256_mullo_epi16(p, q);
+      const __m256i ceil = _mm256_add_epi16(_mm256_add_epi16(prod_hi, one),
+                                            _mm256_cmpeq_epi16(prod_lo, zero));
+      result[half] = _mm256_sub_epi16(a16, ceil);
+    }
+    _mm256_storeu_si256((__m256i *)dst, _mm256_packus_epi16(result[0], result[1]));
+  }
+  mul_byte_sse2(src1, src2, dst, len - i, fac);
+}
+
+ATTR_AVX2 static void mul_float_avx2(
+    const float *src1, const float *src2, float *dst, int len, float fac)
+{
+  const __m256 fac_v = _mm256_set1_ps(fac);
+  const __m256 one = _mm256_set1_ps(1.0f);
+
+  int i = 0;
+  for (; i + 2 <= len; i += 2, src1 += 8, src2 += 8, dst += 8) {
+    const __m256 a = _mm256_loadu_ps(src1);
+    const __m256 b = _mm256_loadu_ps(src2);
+    const __m256 color = _mm256_add_ps(
+        a, _mm256_mul_ps(_mm256_mul_ps(fac_v, a), _mm256_sub_ps(b, one)));
+    _mm256_storeu_ps(dst, color);
+  }
+  mul_float_sse2(src1, src2, dst, len - i, fac);
+}
+
+static const SeqEffectKernels seq_effect_kernels_avx2_table = {
+    alphaover_byte_sse2,
+    alphaover_float_sse2,
+    alphaunder_byte_sse2,
+    alphaunder_float_sse2,
+    cross_byte_avx2,
+    cross_float_avx2,
+    add_byte_avx2,
+    add_float_sse2,
+    mul_byte_avx2,
+    mul_float_avx2,
+};
+
+/** \} */
+
+#endif /* SEQ_HAVE_AVX2_KERNELS */
+
+const SeqEffectKernels *seq_effect_kernels_sse2(void)
+{
+#ifdef BLI_HAVE_SSE2
+  return &seq_effect_kernels_sse2_table;
+#else
+  return NULL;
+#endif
+}
+
+const SeqEffectKernels *seq_effect_kernels_avx2(void)
+{
+#ifdef SEQ_HAVE_AVX2_KERNELS
+  return BLI_cpu_support_avx2() ? &seq_effect_kernels_avx2_table : NULL;
+#else
+  return NULL;
+#endif
+}
+
+const SeqEffectKernels *seq_effect_kernels_get(void)
+{
+  /* CPU features are only checked once. Effects render from multiple threads, so the kernels are
+   * read and stored atomically. Threads racing to store them all find the same kernels. */
+  static const SeqEffectKernels *kernels = NULL;
+  const SeqEffectKernels *found = atomic_cas_ptr((void **)&kernels, NULL, NULL);
+  if (found == NULL) {
+    found = seq_effect_kernels_avx2();
+    if (found == NULL) {
+      found = seq_effect_kernels_sse2();
+    }
+    if (found == NULL) {
+      found = &seq_effect_kernels_scalar;
+    }
+    atomic_cas_ptr((void **)&kernels, NULL, (void *)found);
+  }
+  return found;
+}
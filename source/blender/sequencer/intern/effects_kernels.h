@@ -0,0 +1,70 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2021 Blender Foundation.
+ * All rights reserved.
+ */
+
+#pragma once
+
+/** \file
+ * \ingroup sequencer
+ *
+ * Per-row pixel kernels of the blending effects, operating on 4 channel pixels.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*SeqEffectKernelByte)(const unsigned char *src1,
+                                    const unsigned char *src2,
+                                    unsigned char *dst,
+                                    int len,
+                                    float fac);
+typedef void (*SeqEffectKernelFloat)(const float *src1,
+                                     const float *src2,
+                                     float *dst,
+                                     int len,
+                                     float fac);
+
+typedef struct SeqEffectKernels {
+  SeqEffectKernelByte alphaover_byte;
+  SeqEffectKernelFloat alphaover_float;
+  SeqEffectKernelByte alphaunder_byte;
+  SeqEffectKernelFloat alphaunder_float;
+  SeqEffectKernelByte cross_byte;
+  SeqEffectKernelFloat cross_float;
+  SeqEffectKernelByte add_byte;
+  SeqEffectKernelFloat add_float;
+  SeqEffectKernelByte mul_byte;
+  SeqEffectKernelFloat mul_float;
+} SeqEffectKernels;
+
+/* Reference implementation, used when SIMD kernels are not available. */
+extern const SeqEffectKernels seq_effect_kernels_scalar;
+/* SSE2 implementation (NEON through sse2neon), giving the same results as the scalar one.
+ * NULL when the build has no SSE2 support. */
+const SeqEffectKernels *seq_effect_kernels_sse2(void);
+/* AVX2 implementation, giving the same results as the scalar one.
+ * NULL when the build or the CPU has no AVX2 support. */
+const SeqEffectKernels *seq_effect_kernels_avx2(void);
+
+/* Fastest kernels supported by the CPU. */
+const SeqEffectKernels *seq_effect_kernels_get(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -20,6 +20,7 @@
  * \ingroup bke
  */
 
+#include <fcntl.h>
 #include <memory.h>
 #include <stddef.h>
 #include <time.h>
@@ -42,9 +43,16 @@
 #include "BLI_ghash.h"
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
+#include "BLI_mmap.h"
 #include "BLI_path_util.h"
 #include "BLI_threads.h"
 
+#ifdef WIN32
+#  include <io.h>
+#else
+#  include <unistd.h>
+#endif
+
 #include "BKE_main.h"
 #include "BKE_scene.h"
 
@@ -89,7 +97,9 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * Zlib compression with user definable level can be used to compress image data(per image)
+ * Zstd compression with user definable level can be used to compress image data(per image),
+ * using multiple threads when writing.
+ * Files are memory mapped when reading, image data is decompressed directly into the image.
  * Images are written in order in which they are rendered.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
@@ -502,30 +512,55 @@ static size_t deflate_imbuf_to_file(ImBuf *ibuf,
 
   /* Apply compression if wanted, otherwise just write directly to the file. */
   if (level > 0) {
-    return BLI_file_zstd_from_mem_at_pos(
-        data, header_entry->size_raw, file, header_entry->offset, level);
+    return BLI_file_zstd_from_mem_at_pos(data,
+                                         header_entry->size_raw,
+                                         file,
+                                         header_entry->offset,
+                                         level,
+                                         BLI_system_thread_count());
   }
 
   fseek(file, header_entry->offset, SEEK_SET);
   return fwrite(data, 1, header_entry->size_raw, file);
 }
 
-static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
+static size_t inflate_file_to_imbuf(ImBuf *ibuf,
+                                    BLI_mmap_file *mmap_file,
+                                    DiskCacheHeaderEntry *header_entry)
 {
   void *data = (ibuf->rect != NULL) ? (void *)ibuf->rect : (void *)ibuf->rect_float;
   char header[4];
-  fseek(file, header_entry->offset, SEEK_SET);
-  if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+  if (header_entry->offset + header_entry->size_compressed > BLI_mmap_get_length(mmap_file) ||
+      !BLI_mmap_read(mmap_file, header, header_entry->offset, sizeof(header))) {
     return 0;
   }
 
   /* Check if the data is compressed or raw. */
   if (BLI_file_magic_is_zstd(header)) {
-    return BLI_file_unzstd_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+    /* Decompress from the mapped file without copying compressed data. */
+    const char *compressed_data = (const char *)BLI_mmap_get_pointer(mmap_file) +
+                                  header_entry->offset;
+    const size_t size = BLI_file_unzstd_from_mem(
+        data, header_entry->size_raw, compressed_data, header_entry->size_compressed);
+    return BLI_mmap_any_io_error(mmap_file) ? 0 : size;
   }
 
-  fseek(file, header_entry->offset, SEEK_SET);
-  return fread(data, 1, header_entry->size_raw, file);
+  if (!BLI_mmap_read(mmap_file, data, header_entry->offset, header_entry->size_raw)) {
+    return 0;
+  }
+  return header_entry->size_raw;
+}
+
+static void seq_disk_cache_header_to_native_endian(DiskCacheHeader *header)
+{
+  for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
+    if ((ENDIAN_ORDER == B_ENDIAN) && header->entry[i].encoding == 0) {
+      BLI_endian_switch_uint64(&header->entry[i].frameno);
+      BLI_endian_switch_uint64(&header->entry[i].offset);
+      BLI_endian_switch_uint64(&header->entry[i].size_compressed);
+      BLI_endian_switch_uint64(&header->entry[i].size_raw);
+    }
+  }
 }
 
 static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -538,15 +573,17 @@ static bool seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
     return false;
   }
 
-  for (int i = 0; i < DCACHE_IMAGES_PER_FILE; i++) {
-    if ((ENDIAN_ORDER == B_ENDIAN) && header->entry[i].encoding == 0) {
-      BLI_endian_switch_uint64(&header->entry[i].frameno);
-      BLI_endian_switch_uint64(&header->entry[i].offset);
-      BLI_endian_switch_uint64(&header->entry[i].size_compressed);
-      BLI_endian_switch_uint64(&header->entry[i].size_raw);
-    }
+  seq_disk_cache_header_to_native_endian(header);
+  return true;
+}
+
+static bool seq_disk_cache_read_mapped_header(BLI_mmap_file *mmap_file, DiskCacheHeader *header)
+{
+  if (!BLI_mmap_read(mmap_file, header, 0, sizeof(*header))) {
+    return false;
   }
 
+  seq_disk_cache_header_to_native_endian(header);
   return true;
 }
 
@@ -672,20 +709,27 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
   seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
   BLI_make_existing_file(path);
 
-  FILE *file = BLI_fopen(path, "rb");
-  if (!file) {
+  const int file = BLI_open(path, O_BINARY | O_RDONLY, 0);
+  if (file == -1) {
+    return NULL;
+  }
+  BLI_mmap_file *mmap_file = BLI_mmap_open(file);
+  if (mmap_file == NULL) {
+    close(file);
     return NULL;
   }
 
-  if (!seq_disk_cache_read_header(file, &header)) {
-    fclose(file);
+  if (!seq_disk_cache_read_mapped_header(mmap_file, &header)) {
+    BLI_mmap_free(mmap_file);
+    close(file);
     return NULL;
   }
   int entry_index = seq_disk_cache_get_header_entry(key, &header);
 
   /* Item not found. */
   if (entry_index < 0) {
-    fclose(file);
+    BLI_mmap_free(mmap_file);
+    close(file);
     return NULL;
   }
 
@@ -705,21 +749,22 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
     IMB_colormanagement_assign_float_colorspace(ibuf, header.entry[entry_index].colorspace_name);
   }
   else {
-    fclose(file);
+    BLI_mmap_free(mmap_file);
+    close(file);
     return NULL;
   }
 
-  size_t bytes_read = inflate_file_to_imbuf(ibuf, file, &header.entry[entry_index]);
+  size_t bytes_read = inflate_file_to_imbuf(ibuf, mmap_file, &header.entry[entry_index]);
+  BLI_mmap_free(mmap_file);
+  close(file);
 
   /* Sanity check. */
   if (bytes_read != expected_size) {
-    fclose(file);
     IMB_freeImBuf(ibuf);
     return NULL;
   }
   BLI_file_touch(path);
   seq_disk_cache_update_file(disk_cache, path);
-  fclose(file);
 
   return ibuf;
 }
@@ -34,10 +34,12 @@
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h"
 
+#include "BLI_ghash.h"
 #include "BLI_linklist.h"
 #include "BLI_listbase.h"
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
+#include "BLI_task.h"
 
 #include "BKE_anim_data.h"
 #include "BKE_animsys.h"
@@ -84,6 +86,9 @@
 #include "strip_time.h"
 #include "utils.h"
 
+/* Memory used by each movie for frames decoded ahead of the current frame. */
+#define SEQ_DECODE_AHEAD_MEM_BUDGET (256 * 1024 * 1024)
+
 static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      SeqRenderState *state,
                                      ListBase *seqbasep,
@@ -721,6 +726,139 @@ ImBuf *seq_render_effect_execute_threaded(struct SeqEffectHandle *sh,
   return out;
 }
 
+/**
+ * Whether a strip and all strips it reads from can be rendered from a worker thread. Scenes,
+ * meta-strips, movie clips, masks and text use data that is not safe to access from multiple
+ * threads, multi-cam and adjustment strips read other channels of the stack.
+ * Strips read while rendering are added to \a r_strips.
+ */
+static bool seq_render_strip_is_thread_safe(Sequence *seq, GSet *r_strips)
+{
+  if (!BLI_gset_add(r_strips, seq)) {
+    return true;
+  }
+
+  switch (seq->type) {
+    case SEQ_TYPE_IMAGE:
+    case SEQ_TYPE_MOVIE:
+      break;
+    case SEQ_TYPE_MULTICAM:
+    case SEQ_TYPE_ADJUSTMENT:
+    case SEQ_TYPE_TEXT:
+      return false;
+    default: {
+      if ((seq->type & SEQ_TYPE_EFFECT) == 0) {
+        return false;
+      }
+      Sequence *inputs[3] = {seq->seq1, seq->seq2, seq->seq3};
+      for (int i = 0; i < 3; i++) {
+        if (inputs[i] && !seq_render_strip_is_thread_safe(inputs[i], r_strips)) {
+          return false;
+        }
+      }
+      break;
+    }
+  }
+
+  LISTBASE_FOREACH (SequenceModifierData *, smd, &seq->modifiers) {
+    if (smd->mask_id) {
+      return false;
+    }
+    if (smd->mask_sequence && !seq_render_strip_is_thread_safe(smd->mask_sequence, r_strips)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+typedef struct RenderStripTask {
+  const SeqRenderData *context;
+  SeqRenderState *state;
+  Sequence *seq;
+  float timeline_frame;
+  ImBuf *ibuf;
+} RenderStripTask;
+
+static void render_strip_task_run(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  RenderStripTask *task = (RenderStripTask *)taskdata;
+  task->ibuf = seq_render_strip(task->context, task->state, task->seq, task->timeline_frame);
+}
+
+/**
+ * Render strips that are combined afterwards, like effect inputs or channels of a stack.
+ * Strips that can be rendered from worker threads and don't share any input are rendered
+ * concurrently on a task pool, the others are rendered afterwards on the calling thread.
+ * NULL strips are skipped and get a NULL buffer.
+ */
+static void seq_render_strips(const SeqRenderData *context,
+                              SeqRenderState *state,
+                              Sequence **seqs,
+                              const int count,
+                              const float timeline_frame,
+                              ImBuf **r_ibufs)
+{
+  RenderStripTask *tasks = MEM_callocN(sizeof(RenderStripTask) * count, __func__);
+  bool *use_task = MEM_callocN(sizeof(bool) * count, __func__);
+  int num_tasks = 0;
+
+  GSet *task_strips = BLI_gset_ptr_new(__func__);
+  for (int i = 0; i < count; i++) {
+    r_ibufs[i] = NULL;
+    if (seqs[i] == NULL) {
+      continue;
+    }
+
+    GSet *strips = BLI_gset_ptr_new(__func__);
+    use_task[i] = seq_render_strip_is_thread_safe(seqs[i], strips);
+    GSetIterator gs_iter;
+    GSET_ITER (gs_iter, strips) {
+      if (BLI_gset_haskey(task_strips, BLI_gsetIterator_getKey(&gs_iter))) {
+        use_task[i] = false;
+        break;
+      }
+    }
+    if (use_task[i]) {
+      GSET_ITER (gs_iter, strips) {
+        BLI_gset_add(task_strips, BLI_gsetIterator_getKey(&gs_iter));
+      }
+      num_tasks++;
+    }
+    BLI_gset_free(strips, NULL);
+  }
+  BLI_gset_free(task_strips, NULL);
+
+  if (num_tasks > 1) {
+    TaskPool *pool = BLI_task_pool_create(NULL, TASK_PRIORITY_HIGH);
+    for (int i = 0; i < count; i++) {
+      if (use_task[i]) {
+        tasks[i].context = context;
+        tasks[i].state = state;
+        tasks[i].seq = seqs[i];
+        tasks[i].timeline_frame = timeline_frame;
+        BLI_task_pool_push(pool, render_strip_task_run, &tasks[i], false, NULL);
+      }
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  for (int i = 0; i < count; i++) {
+    if (seqs[i] == NULL) {
+      continue;
+    }
+    if (use_task[i] && num_tasks > 1) {
+      r_ibufs[i] = tasks[i].ibuf;
+    }
+    else {
+      r_ibufs[i] = seq_render_strip(context, state, seqs[i], timeline_frame);
+    }
+  }
+
+  MEM_freeN(tasks);
+  MEM_freeN(use_task);
+}
+
 static ImBuf *seq_render_effect_strip_impl(const SeqRenderData *context,
                                            SeqRenderState *state,
                                            Sequence *seq,
@@ -769,17 +907,15 @@ static ImBuf *seq_render_effect_strip_impl(const SeqRenderData *context,
       out = sh.execute(context, seq, timeline_frame, fac, facf, NULL, NULL, NULL);
       break;
     case EARLY_DO_EFFECT:
-      for (i = 0; i < 3; i++) {
+      if (input[0] && seq->type == SEQ_TYPE_SPEED) {
         /* Speed effect requires time remapping of `timeline_frame` for input(s). */
-        if (input[0] && seq->type == SEQ_TYPE_SPEED) {
+        for (i = 0; i < 3; i++) {
           float target_frame = seq_speed_effect_target_frame_get(scene, seq, timeline_frame, i);
           ibuf[i] = seq_render_strip(context, state, input[0], target_frame);
         }
-        else { /* Other effects. */
-          if (input[i]) {
-            ibuf[i] = seq_render_strip(context, state, input[i], timeline_frame);
-          }
-        }
+      }
+      else { /* Other effects. */
+        seq_render_strips(context, state, input, 3, timeline_frame, ibuf);
       }
 
       if (ibuf[0] && (ibuf[1] || SEQ_effect_get_num_inputs(seq->type) == 1)) {
@@ -994,6 +1130,9 @@ static ImBuf *seq_render_movie_strip_view(const SeqRenderData *context,
   ImBuf *ibuf = NULL;
   IMB_Proxy_Size psize = SEQ_rendersize_to_proxysize(context->preview_render_size);
 
+  /* Only kicks in while frames are requested in sequence, as during playback and rendering. */
+  IMB_anim_set_decode_ahead(sanim->anim, SEQ_DECODE_AHEAD_MEM_BUDGET);
+
   if (SEQ_can_use_proxy(context, seq, psize)) {
     /* Try to get a proxy image.
      * Movie proxies are handled by ImBuf module with exception of `custom file` setting. */
@@ -1770,8 +1909,12 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
                                      int chanshown)
 {
   Sequence *seq_arr[MAXSEQ + 1];
+  /* Strips to render, blended in channel order once all of them are rendered. */
+  Sequence *render_seq_arr[MAXSEQ + 1] = {NULL};
+  ImBuf *ibuf_arr[MAXSEQ + 1];
   int count;
   int i;
+  int base_early_out = EARLY_USE_INPUT_2;
   ImBuf *out = NULL;
 
   count = seq_get_shown_sequences(seqbasep, timeline_frame, chanshown, (Sequence **)&seq_arr);
@@ -1780,8 +1923,8 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
     return NULL;
   }
 
+  /* Find the base of the stack, the highest strip that isn't blended with strips below. */
   for (i = count - 1; i >= 0; i--) {
-    int early_out;
     Sequence *seq = seq_arr[i];
 
     out = seq_cache_get(context, seq, timeline_frame, SEQ_CACHE_STORE_COMPOSITE);
@@ -1790,16 +1933,17 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
       break;
     }
     if (seq->blend_mode == SEQ_BLEND_REPLACE) {
-      out = seq_render_strip(context, state, seq, timeline_frame);
+      render_seq_arr[i] = seq;
+      base_early_out = EARLY_USE_INPUT_2;
       break;
     }
 
-    early_out = seq_get_early_out_for_blend_mode(seq);
+    base_early_out = seq_get_early_out_for_blend_mode(seq);
 
-    switch (early_out) {
+    switch (base_early_out) {
       case EARLY_NO_INPUT:
       case EARLY_USE_INPUT_2:
-        out = seq_render_strip(context, state, seq, timeline_frame);
+        render_seq_arr[i] = seq;
         break;
       case EARLY_USE_INPUT_1:
         if (i == 0) {
@@ -1808,30 +1952,45 @@ static ImBuf *seq_render_strip_stack(const SeqRenderData *context,
         break;
       case EARLY_DO_EFFECT:
         if (i == 0) {
-          ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
-          ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
-
-          out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
-
-          seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
-
-          IMB_freeImBuf(ibuf1);
-          IMB_freeImBuf(ibuf2);
+          render_seq_arr[i] = seq;
         }
         break;
     }
-    if (out) {
+    if (out || render_seq_arr[i]) {
       break;
     }
   }
 
+  /* Strips above the base don't depend on each other, render them together with the base. */
+  for (int j = i + 1; j < count; j++) {
+    if (seq_get_early_out_for_blend_mode(seq_arr[j]) == EARLY_DO_EFFECT) {
+      render_seq_arr[j] = seq_arr[j];
+    }
+  }
+  seq_render_strips(context, state, render_seq_arr + i, count - i, timeline_frame, ibuf_arr + i);
+
+  if (render_seq_arr[i]) {
+    out = ibuf_arr[i];
+    if (base_early_out == EARLY_DO_EFFECT) {
+      ImBuf *ibuf1 = IMB_allocImBuf(context->rectx, context->recty, 32, IB_rect);
+      ImBuf *ibuf2 = out;
+
+      out = seq_render_strip_stack_apply_effect(context, seq_arr[i], timeline_frame, ibuf1, ibuf2);
+
+      seq_cache_put(context, seq_arr[i], timeline_frame, SEQ_CACHE_STORE_COMPOSITE, out);
+
+      IMB_freeImBuf(ibuf1);
+      IMB_freeImBuf(ibuf2);
+    }
+  }
+
   i++;
   for (; i < count; i++) {
     Sequence *seq = seq_arr[i];
 
-    if (seq_get_early_out_for_blend_mode(seq) == EARLY_DO_EFFECT) {
+    if (render_seq_arr[i]) {
       ImBuf *ibuf1 = out;
-      ImBuf *ibuf2 = seq_render_strip(context, state, seq, timeline_frame);
+      ImBuf *ibuf2 = ibuf_arr[i];
 
       out = seq_render_strip_stack_apply_effect(context, seq, timeline_frame, ibuf1, ibuf2);
 
@@ -0,0 +1,154 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include <vector>
+
+#include "BLI_utildefines.h"
+
+#include "effects_kernels.h"
+
+namespace blender::seq::tests {
+
+/* Pixel counts covering the SIMD loops and their remainders. */
+static const int test_lengths[] = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+/* Factors inside and outside of the 0..1 range, which byte kernels handle differently. */
+static const float test_factors[] = {0.0f, 0.5f, 1.0f, -0.5f, 1.5f};
+
+static uint gen_pseudo_random_number(uint num)
+{
+  num += ~(num << 16);
+  num ^= (num >> 5);
+  num += (num << 3);
+  num ^= (num >> 13);
+  num += ~(num << 9);
+  num ^= (num >> 17);
+  return num;
+}
+
+/* Mix of transparent, opaque and partially transparent pixels. */
+static std::vector<uchar> create_byte_pixels(const int len, const uint seed)
+{
+  std::vector<uchar> pixels(len * 4);
+  for (int i = 0; i < len * 4; i++) {
+    const uint num = gen_pseudo_random_number(seed + (uint)i);
+    pixels[i] = (i % 4 == 3 && num % 3 != 0) ? ((num % 3 == 1) ? 0 : 255) : (uchar)num;
+  }
+  return pixels;
+}
+
+static std::vector<float> create_float_pixels(const int len, const uint seed)
+{
+  std::vector<float> pixels(len * 4);
+  for (int i = 0; i < len * 4; i++) {
+    const uint num = gen_pseudo_random_number(seed + (uint)i);
+    pixels[i] = (i % 4 == 3 && num % 3 != 0) ? (float)(num % 3 - 1) : (num % 1024) / 1023.0f;
+  }
+  return pixels;
+}
+
+/* SIMD kernels supported by the build and the CPU. */
+static std::vector<const SeqEffectKernels *> get_simd_kernels()
+{
+  std::vector<const SeqEffectKernels *> kernels;
+  for (const SeqEffectKernels *simd : {seq_effect_kernels_sse2(), seq_effect_kernels_avx2()}) {
+    if (simd != nullptr) {
+      kernels.push_back(simd);
+    }
+  }
+  return kernels;
+}
+
+/* Buffers are exactly as large as the pixels, so that reads past the end are caught by the
+ * address sanitizer. */
+template<typename T, typename KernelFn>
+static void expect_kernels_match(KernelFn SeqEffectKernels::*kernel)
+{
+  for (const SeqEffectKernels *simd : get_simd_kernels()) {
+    for (const int len : test_lengths) {
+      std::vector<T> src1, src2;
+      if constexpr (std::is_same_v<T, uchar>) {
+        src1 = create_byte_pixels(len, 0);
+        src2 = create_byte_pixels(len, 1000);
+      }
+      else {
+        src1 = create_float_pixels(len, 0);
+        src2 = create_float_pixels(len, 1000);
+      }
+
+      for (const float fac : test_factors) {
+        std::vector<T> dst_scalar(len * 4), dst_simd(len * 4);
+        (seq_effect_kernels_scalar.*kernel)(src1.data(), src2.data(), dst_scalar.data(), len, fac);
+        (simd->*kernel)(src1.data(), src2.data(), dst_simd.data(), len, fac);
+        EXPECT_EQ(dst_scalar, dst_simd) << "len " << len << ", fac " << fac;
+      }
+    }
+  }
+}
+
+TEST(seq_effect_kernels, AlphaOverByte)
+{
+  expect_kernels_match<uchar>(&SeqEffectKernels::alphaover_byte);
+}
+
+TEST(seq_effect_kernels, AlphaOverFloat)
+{
+  expect_kernels_match<float>(&SeqEffectKernels::alphaover_float);
+}
+
+TEST(seq_effect_kernels, AlphaUnderByte)
+{
+  expect_kernels_match<uchar>(&SeqEffectKernels::alphaunder_byte);
+}
+
+TEST(seq_effect_kernels, AlphaUnderFloat)
+{
+  expect_kernels_match<float>(&SeqEffectKernels::alphaunder_float);
+}
+
+TEST(seq_effect_kernels, CrossByte)
+{
+  expect_kernels_match<uchar>(&SeqEffectKernels::cross_byte);
+}
+
+TEST(seq_effect_kernels, CrossFloat)
+{
+  expect_kernels_match<float>(&SeqEffectKernels::cross_float);
+}
+
+TEST(seq_effect_kernels, AddByte)
+{
+  expect_kernels_match<uchar>(&SeqEffectKernels::add_byte);
+}
+
+TEST(seq_effect_kernels, AddFloat)
+{
+  expect_kernels_match<float>(&SeqEffectKernels::add_float);
+}
+
+TEST(seq_effect_kernels, MulByte)
+{
+  expect_kernels_match<uchar>(&SeqEffectKernels::mul_byte);
+}
+
+TEST(seq_effect_kernels, MulFloat)
+{
+  expect_kernels_match<float>(&SeqEffectKernels::mul_float);
+}
+
+TEST(seq_effect_kernels, Get)
+{
+  const SeqEffectKernels *kernels = seq_effect_kernels_get();
+  ASSERT_NE(kernels, nullptr);
+  if (seq_effect_kernels_avx2()) {
+    EXPECT_EQ(kernels, seq_effect_kernels_avx2());
+  }
+  else if (seq_effect_kernels_sse2()) {
+    EXPECT_EQ(kernels, seq_effect_kernels_sse2());
+  }
+  else {
+    EXPECT_EQ(kernels, &seq_effect_kernels_scalar);
+  }
+}
+
+}  // namespace blender::seq::tests
@@ -0,0 +1,159 @@
+/* Apache License, Version 2.0 */
+
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+#include "BLI_utildefines.h"
+
+#include "PIL_time.h"
+
+#include "effects_kernels.h"
+
+#define NUM_RUN_AVERAGED 20
+
+/* Full HD frame. */
+#define IMAGE_WIDTH 1920
+#define IMAGE_HEIGHT 1080
+#define IMAGE_SIZE (IMAGE_WIDTH * IMAGE_HEIGHT * 4)
+
+/* Mix of transparent, opaque and partially transparent pixels, so every code path of the kernels
+ * gets its share. */
+static uint gen_pseudo_random_number(uint num)
+{
+  num += ~(num << 16);
+  num ^= (num >> 5);
+  num += (num << 3);
+  num ^= (num >> 13);
+  num += ~(num << 9);
+  num ^= (num >> 17);
+  return num;
+}
+
+static void fill_byte_buffer(uchar *buffer, uint seed)
+{
+  for (int i = 0; i < IMAGE_SIZE; i++) {
+    const uint num = gen_pseudo_random_number(seed + (uint)i);
+    buffer[i] = (i % 4 == 3 && num % 3 != 0) ? ((num % 3 == 1) ? 0 : 255) : (uchar)num;
+  }
+}
+
+static void fill_float_buffer(float *buffer, uint seed)
+{
+  for (int i = 0; i < IMAGE_SIZE; i++) {
+    const uint num = gen_pseudo_random_number(seed + (uint)i);
+    buffer[i] = (i % 4 == 3 && num % 3 != 0) ? (float)(num % 3 - 1) : (num % 1024) / 1023.0f;
+  }
+}
+
+template<typename T, typename KernelFn>
+static double kernel_timing(KernelFn kernel, const T *src1, const T *src2, T *dst, float fac)
+{
+  double averaged_timing = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    const double init_time = PIL_check_seconds_timer();
+    for (int y = 0; y < IMAGE_HEIGHT; y++) {
+      const size_t offset = (size_t)y * IMAGE_WIDTH * 4;
+      kernel(src1 + offset, src2 + offset, dst + offset, IMAGE_WIDTH, fac);
+    }
+    averaged_timing += PIL_check_seconds_timer() - init_time;
+  }
+  return averaged_timing / NUM_RUN_AVERAGED;
+}
+
+template<typename T, typename KernelFn>
+static void kernel_test(const char *id, KernelFn SeqEffectKernels::*kernel)
+{
+  T *src1 = (T *)MEM_mallocN(sizeof(T) * IMAGE_SIZE, __func__);
+  T *src2 = (T *)MEM_mallocN(sizeof(T) * IMAGE_SIZE, __func__);
+  T *dst_scalar = (T *)MEM_mallocN(sizeof(T) * IMAGE_SIZE, __func__);
+  T *dst_simd = (T *)MEM_mallocN(sizeof(T) * IMAGE_SIZE, __func__);
+  if constexpr (std::is_same_v<T, uchar>) {
+    fill_byte_buffer(src1, 0);
+    fill_byte_buffer(src2, IMAGE_SIZE);
+  }
+  else {
+    fill_float_buffer(src1, 0);
+    fill_float_buffer(src2, IMAGE_SIZE);
+  }
+
+  printf("\n========== STARTING %s ==========\n", id);
+
+  const std::pair<const char *, const SeqEffectKernels *> simd_kernels[] = {
+      {"SSE2", seq_effect_kernels_sse2()},
+      {"AVX2", seq_effect_kernels_avx2()},
+  };
+
+  for (const float fac : {0.25f, 1.0f}) {
+    const double time_scalar = kernel_timing(
+        seq_effect_kernels_scalar.*kernel, src1, src2, dst_scalar, fac);
+    printf("\tfac %.2f: scalar %fs on average over %d runs\n", fac, time_scalar, NUM_RUN_AVERAGED);
+
+    for (const auto &[name, simd] : simd_kernels) {
+      if (simd == nullptr) {
+        printf("\t\t%s: not supported\n", name);
+        continue;
+      }
+      const double time_simd = kernel_timing(simd->*kernel, src1, src2, dst_simd, fac);
+      EXPECT_EQ(memcmp(dst_scalar, dst_simd, sizeof(T) * IMAGE_SIZE), 0);
+      printf("\t\t%s: %fs (%.2fx)\n", name, time_simd, time_scalar / time_simd);
+    }
+  }
+
+  printf("========== ENDED %s ==========\n\n", id);
+
+  MEM_freeN(src1);
+  MEM_freeN(src2);
+  MEM_freeN(dst_scalar);
+  MEM_freeN(dst_simd);
+}
+
+TEST(seq_effects, AlphaOverByte)
+{
+  kernel_test<uchar>("Alpha Over Byte", &SeqEffectKernels::alphaover_byte);
+}
+
+TEST(seq_effects, AlphaOverFloat)
+{
+  kernel_test<float>("Alpha Over Float", &SeqEffectKernels::alphaover_float);
+}
+
+TEST(seq_effects, AlphaUnderByte)
+{
+  kernel_test<uchar>("Alpha Under Byte", &SeqEffectKernels::alphaunder_byte);
+}
+
+TEST(seq_effects, AlphaUnderFloat)
+{
+  kernel_test<float>("Alpha Under Float", &SeqEffectKernels::alphaunder_float);
+}
+
+TEST(seq_effects, CrossByte)
+{
+  kernel_test<uchar>("Cross Byte", &SeqEffectKernels::cross_byte);
+}
+
+TEST(seq_effects, CrossFloat)
+{
+  kernel_test<float>("Cross Float", &SeqEffectKernels::cross_float);
+}
+
+TEST(seq_effects, AddByte)
+{
+  kernel_test<uchar>("Add Byte", &SeqEffectKernels::add_byte);
+}
+
+TEST(seq_effects, AddFloat)
+{
+  kernel_test<float>("Add Float", &SeqEffectKernels::add_float);
+}
+
+TEST(seq_effects, MulByte)
+{
+  kernel_test<uchar>("Multiply Byte", &SeqEffectKernels::mul_byte);
+}
+
+TEST(seq_effects, MulFloat)
+{
+  kernel_test<float>("Multiply Float", &SeqEffectKernels::mul_float);
+}
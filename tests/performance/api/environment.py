@@ -10,7 +10,7 @@ import platform
 import pickle
 import subprocess
 import sys
-from typing import Callable, Dict, List
+from typing import Callable, Dict, List, Optional
 
 from .config import TestConfig
 from .device import TestMachine
@@ -106,10 +106,12 @@ class TestEnvironment:
         self._init_default_blender_executable()
         return True
 
-    def set_blender_executable(self, executable_path: pathlib.Path, environment: Dict = {}) -> None:
+    def set_blender_executable(self,
+                               executable_path: pathlib.Path,
+                               environment: Optional[Dict] = None) -> None:
         # Run all Blender commands with this executable.
         self.blender_executable = executable_path
-        self.blender_executable_environment = environment
+        self.blender_executable_environment = environment or {}
 
     def _blender_executable_name(self) -> pathlib.Path:
         if platform.system() == "Windows":
@@ -165,7 +167,11 @@ class TestEnvironment:
     def unset_log_file(self) -> None:
         self.log_file = None
 
-    def call(self, args: List[str], cwd: pathlib.Path, silent: bool=False, environment: Dict={}) -> List[str]:
+    def call(self,
+             args: List[str],
+             cwd: pathlib.Path,
+             silent: bool=False,
+             environment: Optional[Dict] = None) -> List[str]:
         # Execute command with arguments in specified directory,
         # and return combined stdout and stderr output.
 
@@ -178,7 +184,7 @@ class TestEnvironment:
             f.write('\n' + ' '.join([str(arg) for arg in args]) + '\n\n')
 
         env = os.environ
-        if len(environment):
+        if environment:
             env = env.copy()
             for key, value in environment.items():
                 env[key] = value
@@ -206,7 +212,10 @@ class TestEnvironment:
 
         return lines
 
-    def call_blender(self, args: List[str], foreground=False) -> List[str]:
+    def call_blender(self,
+                     args: List[str],
+                     foreground=False,
+                     environment: Optional[Dict] = None) -> List[str]:
         # Execute Blender command with arguments.
         common_args = ['--factory-startup', '--enable-autoexec', '--python-exit-code', '1']
         if foreground:
@@ -214,14 +223,16 @@ class TestEnvironment:
         else:
             common_args += ['--background']
 
+        environment = {**self.blender_executable_environment, **(environment or {})}
         return self.call([self.blender_executable] + common_args + args, cwd=self.base_dir,
-                         environment=self.blender_executable_environment)
+                         environment=environment)
 
     def run_in_blender(self,
                        function: Callable[[Dict], Dict],
                        args: Dict,
                        blender_args: List=[],
-                       foreground=False) -> Dict:
+                       foreground=False,
+                       environment: Optional[Dict] = None) -> Dict:
         # Run function in a Blender instance. Arguments and return values are
         # passed as a Python object that must be serializable with pickle.
 
@@ -243,7 +254,7 @@ class TestEnvironment:
                       f'print("{output_prefix}" + result.decode())\n')
 
         expr_args = blender_args + ['--python-expr', expression]
-        lines = self.call_blender(expr_args, foreground=foreground)
+        lines = self.call_blender(expr_args, foreground=foreground, environment=environment)
 
         # Parse output.
         for line in lines:
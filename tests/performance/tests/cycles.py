@@ -52,10 +52,13 @@ def _run(args):
 
 
 class CyclesTest(api.Test):
-    def __init__(self, filepath):
+    def __init__(self, filepath, work_tile_size=None):
         self.filepath = filepath
+        self.work_tile_size = work_tile_size
 
     def name(self):
+        if self.work_tile_size is not None:
+            return f"{self.filepath.stem}_work_tile_{self.work_tile_size}"
         return self.filepath.stem
 
     def category(self):
@@ -72,7 +75,14 @@ class CyclesTest(api.Test):
                 'device_index': device_index,
                 'render_filepath': str(env.log_file.parent / (env.log_file.stem + '.png'))}
 
-        _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath])
+        # Override the size of the tiles CPU threads render at a time, to compare
+        # against scheduling individual pixels.
+        environment = {}
+        if self.work_tile_size is not None:
+            environment['CYCLES_CPU_WORK_TILE_SIZE'] = str(self.work_tile_size)
+
+        _, lines = env.run_in_blender(_run, args, ['--debug-cycles', '--verbose', '2', self.filepath],
+                                      environment=environment)
 
         # Parse render time from output
         prefix_time = "Render time (without synchronization): "
@@ -109,4 +119,11 @@ class CyclesTest(api.Test):
 
 def generate(env):
     filepaths = env.find_blend_files('cycles/*')
-    return [CyclesTest(filepath) for filepath in filepaths]
+    tests = [CyclesTest(filepath) for filepath in filepaths]
+
+    # Opt-in variant of every test overriding the CPU work tile size, which only
+    # affects CPU devices. For example CYCLES_BENCHMARK_WORK_TILE_SIZE=1.
+    work_tile_size = os.environ.get('CYCLES_BENCHMARK_WORK_TILE_SIZE')
+    if work_tile_size:
+        tests += [CyclesTest(filepath, work_tile_size=int(work_tile_size)) for filepath in filepaths]
+    return tests